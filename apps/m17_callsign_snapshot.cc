@@ -0,0 +1,113 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+// Convert callsign mapping tables between the text format and the binary
+// snapshot format loaded by callsign_mapper::load_mappings_from_file().
+//
+//   m17_callsign_snapshot import <mappings.txt> <mappings.snap>
+//   m17_callsign_snapshot export <mappings.snap> <mappings.txt>
+
+#include <gnuradio/m17_bridge/callsign_snapshot.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct text_table {
+    std::map<std::string, std::string> forward; //!< M17 -> AX.25
+    std::map<std::string, std::string> reverse; //!< AX.25 -> M17
+};
+
+int add_text_mapping(void* ctx, const char* m17_callsign, const char* ax25_callsign) {
+    // Later lines win, as with repeated callsign_mapper::add_mapping() calls
+    text_table* table = static_cast<text_table*>(ctx);
+    table->forward[m17_callsign] = ax25_callsign;
+    table->reverse[ax25_callsign] = m17_callsign;
+    return 0;
+}
+
+std::vector<callsign_snapshot_record_t>
+to_records(const std::map<std::string, std::string>& entries) {
+    std::vector<callsign_snapshot_record_t> records(entries.size());
+    size_t i = 0;
+    for (const auto& entry : entries) {
+        callsign_snapshot_record_set(&records[i++], entry.first.c_str(), entry.second.c_str());
+    }
+    return records;
+}
+
+int import_text(const char* text_file, const char* snapshot_file) {
+    text_table table;
+    int count = callsign_snapshot_parse_text(text_file, add_text_mapping, &table);
+    if (count < 0) {
+        fprintf(stderr, "Failed to parse %s\n", text_file);
+        return 1;
+    }
+
+    std::vector<callsign_snapshot_record_t> forward = to_records(table.forward);
+    std::vector<callsign_snapshot_record_t> reverse = to_records(table.reverse);
+    if (callsign_snapshot_write(snapshot_file, forward.data(), (uint32_t)forward.size(),
+                                reverse.data(), (uint32_t)reverse.size()) != 0) {
+        fprintf(stderr, "Failed to write %s\n", snapshot_file);
+        return 1;
+    }
+
+    printf("Wrote %zu mappings to %s\n", forward.size(), snapshot_file);
+    return 0;
+}
+
+int export_text(const char* snapshot_file, const char* text_file) {
+    callsign_snapshot_t snap;
+    if (callsign_snapshot_open(&snap, snapshot_file) != 0) {
+        fprintf(stderr, "Invalid callsign snapshot %s\n", snapshot_file);
+        return 1;
+    }
+
+    int ret = 0;
+    if (callsign_snapshot_write_text(text_file, snap.forward, snap.forward_count) != 0) {
+        fprintf(stderr, "Failed to write %s\n", text_file);
+        ret = 1;
+    } else {
+        printf("Wrote %u mappings to %s\n", snap.forward_count, text_file);
+    }
+
+    callsign_snapshot_close(&snap);
+    return ret;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s import <mappings.txt> <mappings.snap>\n"
+            "       %s export <mappings.snap> <mappings.txt>\n",
+            prog, prog);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (strcmp(argv[1], "import") == 0) {
+        return import_text(argv[2], argv[3]);
+    }
+    if (strcmp(argv[1], "export") == 0) {
+        return export_text(argv[2], argv[3]);
+    }
+
+    usage(argv[0]);
+    return 2;
+}
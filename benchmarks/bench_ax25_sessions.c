@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------
+// AX.25 Session Table Benchmark
+//
+// Opens 10k connected-mode sessions on one TNC, looks each of them up,
+// then closes them all, for several rounds. A linear scan over a flat
+// session array (the previous connection lookup) is timed on the same
+// addresses for comparison.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "ax25_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SESSIONS        10000
+#define BENCH_ROUNDS          20
+#define BENCH_LOOKUPS         4       // Lookups per session per round
+#define BENCH_LINEAR_LOOKUPS  20000   // Linear scan is timed on fewer lookups
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_station(uint32_t index, ax25_address_t* addr) {
+    char callsign[7] = "N0";
+    callsign[2] = (char)('A' + index % 26);
+    callsign[3] = (char)('A' + (index / 26) % 26);
+    callsign[4] = (char)('A' + (index / 676) % 26);
+    callsign[5] = '\0';
+    ax25_set_address(addr, callsign, (index / 17576) % 16, false);
+}
+
+int main(void) {
+    ax25_address_t* remotes = malloc(BENCH_SESSIONS * sizeof(ax25_address_t));
+    if (!remotes) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+        bench_station(i * 7919 % BENCH_SESSIONS, &remotes[i]);
+    }
+
+    ax25_tnc_t tnc;
+    ax25_init(&tnc);
+    ax25_set_address(&tnc.config.my_address, "N0NODE", 0, false);
+
+    double t_open = 0, t_lookup = 0, t_close = 0;
+    uint64_t found = 0;
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = bench_now();
+        for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+            if (ax25_connect(&tnc, &remotes[i]) != 0) {
+                fprintf(stderr, "connect failed\n");
+                return 1;
+            }
+        }
+        double t1 = bench_now();
+        for (int pass = 0; pass < BENCH_LOOKUPS; pass++) {
+            for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+                uint32_t j = (i * 31 + pass) % BENCH_SESSIONS;
+                found += ax25_session_find(&tnc.sessions, &tnc.config.my_address, &remotes[j]) != NULL;
+            }
+        }
+        double t2 = bench_now();
+        for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+            ax25_disconnect(&tnc, &remotes[BENCH_SESSIONS - 1 - i]);
+        }
+        double t3 = bench_now();
+        t_open += t1 - t0;
+        t_lookup += t2 - t1;
+        t_close += t3 - t2;
+    }
+
+    // Previous scheme: scan the whole array comparing remote addresses
+    ax25_connection_t* flat = malloc(BENCH_SESSIONS * sizeof(ax25_connection_t));
+    if (!flat) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+        flat[i].remote_addr = remotes[i];
+    }
+    uint64_t linear_found = 0;
+    double t0 = bench_now();
+    for (uint32_t n = 0; n < BENCH_LINEAR_LOOKUPS; n++) {
+        const ax25_address_t* target = &remotes[n * 31 % BENCH_SESSIONS];
+        for (uint32_t i = 0; i < BENCH_SESSIONS; i++) {
+            if (ax25_address_equal(&flat[i].remote_addr, target)) {
+                linear_found++;
+                break;
+            }
+        }
+    }
+    double t_linear = bench_now() - t0;
+
+    double ops = (double)BENCH_SESSIONS * BENCH_ROUNDS;
+    printf("AX.25 sessions, %d open/close cycles of %d sessions\n", BENCH_ROUNDS, BENCH_SESSIONS);
+    printf("  open          : %7.1f ns/session\n", t_open / ops * 1e9);
+    printf("  lookup        : %7.1f ns/lookup\n", t_lookup / (ops * BENCH_LOOKUPS) * 1e9);
+    printf("  close         : %7.1f ns/session\n", t_close / ops * 1e9);
+    printf("  linear lookup : %7.1f ns/lookup (flat array of %d)\n",
+           t_linear / BENCH_LINEAR_LOOKUPS * 1e9, BENCH_SESSIONS);
+    printf("  found         : %llu hashed, %llu linear\n", (unsigned long long)found,
+           (unsigned long long)linear_found);
+
+    ax25_cleanup(&tnc);
+    free(flat);
+    free(remotes);
+    return 0;
+}
@@ -0,0 +1,67 @@
+//--------------------------------------------------------------------
+// Callsign Mapping Snapshot Benchmark
+//
+// Measures how long a 100k-entry binary snapshot takes to open
+// (map, checksum, validate) and the cost of in-place lookups
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "callsign_snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ENTRIES   100000
+#define BENCH_LOOKUPS   1000000
+#define BENCH_FILE      "bench_callsign_snapshot.snap"
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+    static callsign_snapshot_record_t forward[BENCH_ENTRIES];
+    static callsign_snapshot_record_t reverse[BENCH_ENTRIES];
+    static char keys[BENCH_ENTRIES][CALLSIGN_SNAPSHOT_FIELD_LEN];
+
+    for (int i = 0; i < BENCH_ENTRIES; i++) {
+        char ax25[CALLSIGN_SNAPSHOT_FIELD_LEN];
+        snprintf(keys[i], sizeof(keys[i]), "M%06d", i);
+        snprintf(ax25, sizeof(ax25), "A%05d-%d", i % 100000, i % 16);
+        callsign_snapshot_record_set(&forward[i], keys[i], ax25);
+        callsign_snapshot_record_set(&reverse[i], ax25, keys[i]);
+    }
+
+    if (callsign_snapshot_write(BENCH_FILE, forward, BENCH_ENTRIES, reverse, BENCH_ENTRIES) != 0) {
+        fprintf(stderr, "Failed to write %s\n", BENCH_FILE);
+        return 1;
+    }
+
+    callsign_snapshot_t snap;
+    double t0 = bench_now();
+    if (callsign_snapshot_open(&snap, BENCH_FILE) != 0) {
+        fprintf(stderr, "Failed to open %s\n", BENCH_FILE);
+        return 1;
+    }
+    double t_open = bench_now() - t0;
+
+    srand(17);
+    size_t found = 0;
+    t0 = bench_now();
+    for (int i = 0; i < BENCH_LOOKUPS; i++) {
+        found += callsign_snapshot_lookup_forward(&snap, keys[rand() % BENCH_ENTRIES]) != NULL;
+    }
+    double t_lookup = bench_now() - t0;
+
+    printf("Callsign snapshot, %d entries\n", BENCH_ENTRIES);
+    printf("  open + verify    : %8.2f ms\n", t_open * 1e3);
+    printf("  forward lookup   : %8.2f ns/lookup (%zu found)\n", t_lookup * 1e9 / BENCH_LOOKUPS,
+           found);
+
+    callsign_snapshot_close(&snap);
+    remove(BENCH_FILE);
+    return 0;
+}
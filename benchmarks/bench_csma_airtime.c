@@ -0,0 +1,232 @@
+//--------------------------------------------------------------------
+// CSMA Channel Occupancy Benchmark
+//
+// Four stations share a simulated 1200 bit/s half-duplex channel. Each
+// one receives batches of 1..7 frames at random intervals (a window of
+// connected-mode data, say) and contends for the channel through its
+// own CSMA scheduler. Carrier detect sees another station 50 ms after it
+// keys up, so stations that key up within that window collide and lose
+// the frames of both bursts. One frame per key-up is compared with
+// bursts of up to 7 frames on channel occupancy, keying overhead,
+// collisions and queueing delay.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "csma_tx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_STATIONS      4
+#define BENCH_BIT_RATE      1200
+#define BENCH_DCD_MS        50
+#define BENCH_DURATION_MS   (4ULL * 3600 * 1000)
+#define BENCH_QUEUE         64
+#define BENCH_MIN_FRAME     36      // Header and FCS plus 18 bytes
+#define BENCH_MAX_FRAME     146     // Header and FCS plus 128 bytes
+
+typedef struct {
+    csma_tx_t* tx;
+    int index;
+    bool keyed;
+    uint64_t keyed_since;
+    bool collided;                      // Current burst overlapped another
+    uint32_t burst_frames;              // Frames handed over in the current burst
+    uint64_t burst_delay_ms;            // Their summed queueing delay
+    uint64_t queued_at[BENCH_QUEUE];    // Enqueue times, oldest at head
+    uint32_t head;
+    uint32_t count;
+    uint64_t next_arrival;
+} bench_station_t;
+
+typedef struct {
+    uint64_t frames_sent;
+    uint64_t frames_lost;
+    uint64_t frames_refused;
+    uint64_t delay_ms;                  // Summed over delivered frames
+    uint64_t busy_ms;                   // Time at least one station was keyed
+} bench_result_t;
+
+static bench_station_t bench_stations[BENCH_STATIONS];
+static bench_result_t bench_result;
+static uint64_t bench_now_ms;
+static uint32_t bench_rng;
+
+static double bench_random(void) {
+    bench_rng = bench_rng * 1664525u + 1013904223u;
+    return (bench_rng >> 8) / 16777216.0;
+}
+
+// Interval uniform over 1..2 * mean
+static uint64_t bench_interval(double mean_ms) {
+    return 1 + (uint64_t)(bench_random() * 2 * mean_ms);
+}
+
+static int bench_send(void* ctx, const uint8_t* data, uint16_t length) {
+    bench_station_t* station = (bench_station_t*)ctx;
+    (void)data;
+    (void)length;
+    station->burst_delay_ms += bench_now_ms - station->queued_at[station->head];
+    station->head = (station->head + 1) % BENCH_QUEUE;
+    station->count--;
+    station->burst_frames++;
+    return 0;
+}
+
+static void bench_ptt(void* ctx, bool keyed) {
+    bench_station_t* station = (bench_station_t*)ctx;
+    if (keyed) {
+        station->keyed = true;
+        station->keyed_since = bench_now_ms;
+        station->collided = false;
+        station->burst_frames = 0;
+        station->burst_delay_ms = 0;
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            if (i != station->index && bench_stations[i].keyed) {
+                bench_stations[i].collided = true;
+                station->collided = true;
+            }
+        }
+        return;
+    }
+
+    station->keyed = false;
+    if (station->collided) {
+        bench_result.frames_lost += station->burst_frames;
+    } else {
+        bench_result.frames_sent += station->burst_frames;
+        bench_result.delay_ms += station->burst_delay_ms;
+    }
+}
+
+// Carrier detect at station j: another station keyed long enough to be heard
+static bool bench_carrier(int j) {
+    for (int i = 0; i < BENCH_STATIONS; i++) {
+        if (i != j && bench_stations[i].keyed &&
+            bench_now_ms >= bench_stations[i].keyed_since + BENCH_DCD_MS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void bench_arrival(bench_station_t* station) {
+    uint8_t frame[BENCH_MAX_FRAME];
+    memset(frame, 0x55, sizeof(frame));
+    int batch = 1 + (int)(bench_random() * 7);
+    for (int i = 0; i < batch; i++) {
+        uint16_t length = BENCH_MIN_FRAME +
+                          (uint16_t)(bench_random() * (BENCH_MAX_FRAME - BENCH_MIN_FRAME + 1));
+        if (station->count == BENCH_QUEUE ||
+            csma_tx_enqueue(station->tx, CSMA_TX_PRIO_DATA, frame, length) != 0) {
+            bench_result.frames_refused++;
+            continue;
+        }
+        station->queued_at[(station->head + station->count) % BENCH_QUEUE] = bench_now_ms;
+        station->count++;
+    }
+}
+
+static void bench_run(uint8_t max_burst, double batch_interval_ms) {
+    csma_tx_config_t config;
+    csma_tx_config_init(&config);
+    config.tx_delay = 30;       // 300ms
+    config.tx_tail = 3;         // 30ms
+    config.bit_rate = BENCH_BIT_RATE;
+    config.max_burst_frames = max_burst;
+
+    memset(bench_stations, 0, sizeof(bench_stations));
+    memset(&bench_result, 0, sizeof(bench_result));
+    bench_now_ms = 0;
+    bench_rng = 2024;
+    for (int i = 0; i < BENCH_STATIONS; i++) {
+        bench_station_t* station = &bench_stations[i];
+        config.seed = 1000 + i;
+        station->tx = csma_tx_create(&config, BENCH_QUEUE);
+        station->index = i;
+        csma_tx_set_handlers(station->tx, bench_send, bench_ptt, station);
+        station->next_arrival = bench_interval(batch_interval_ms);
+    }
+
+    for (;;) {
+        // Next event: an arrival or a scheduler transition
+        uint64_t next = CSMA_TX_IDLE_EVENT;
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            bench_station_t* station = &bench_stations[i];
+            uint64_t event = csma_tx_next_event(station->tx);
+            if (station->next_arrival < BENCH_DURATION_MS && station->next_arrival < event) {
+                event = station->next_arrival;
+            }
+            if (event < next) {
+                next = event;
+            }
+        }
+        if (next == CSMA_TX_IDLE_EVENT) {
+            break;
+        }
+
+        bool busy = false;
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            busy |= bench_stations[i].keyed;
+        }
+        if (busy) {
+            bench_result.busy_ms += next - bench_now_ms;
+        }
+        bench_now_ms = next;
+
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            bench_station_t* station = &bench_stations[i];
+            if (station->next_arrival == bench_now_ms) {
+                bench_arrival(station);
+                station->next_arrival += bench_interval(batch_interval_ms);
+            }
+        }
+        // Carrier is sampled before anyone acts on this instant
+        bool carrier[BENCH_STATIONS];
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            carrier[i] = bench_carrier(i);
+        }
+        for (int i = 0; i < BENCH_STATIONS; i++) {
+            csma_tx_set_carrier(bench_stations[i].tx, carrier[i]);
+            csma_tx_poll(bench_stations[i].tx, bench_now_ms);
+        }
+    }
+
+    csma_tx_stats_t total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i < BENCH_STATIONS; i++) {
+        csma_tx_stats_t stats;
+        csma_tx_get_stats(bench_stations[i].tx, &stats);
+        total.keyups += stats.keyups;
+        total.keyed_ms += stats.keyed_ms;
+        total.overhead_ms += stats.overhead_ms;
+        csma_tx_destroy(bench_stations[i].tx);
+    }
+
+    uint64_t on_air = bench_result.frames_sent + bench_result.frames_lost;
+    printf("  burst %d: %6llu frames, %5llu key-ups, channel busy %5.1f%%, "
+           "%4.0f ms keyed/frame (%4.1f%% TXDELAY+TXTAIL), %5.2f%% lost to collisions, "
+           "%6.0f ms mean delay\n",
+           max_burst, (unsigned long long)on_air, (unsigned long long)total.keyups,
+           100.0 * bench_result.busy_ms / bench_now_ms,
+           (double)total.keyed_ms / on_air, 100.0 * total.overhead_ms / total.keyed_ms,
+           100.0 * bench_result.frames_lost / on_air,
+           (double)bench_result.delay_ms / bench_result.frames_sent);
+    if (bench_result.frames_refused) {
+        printf("           %llu frames refused by full queues\n",
+               (unsigned long long)bench_result.frames_refused);
+    }
+}
+
+int main(void) {
+    const double intervals_ms[] = { 60000, 30000, 20000 };
+
+    printf("CSMA, %d stations at %d bit/s, p = 64/256, slot 100 ms, TXDELAY 300 ms, "
+           "TXTAIL 30 ms\n", BENCH_STATIONS, BENCH_BIT_RATE);
+    for (size_t i = 0; i < sizeof(intervals_ms) / sizeof(intervals_ms[0]); i++) {
+        printf("batch of 1..7 frames every %.0f s per station:\n", intervals_ms[i] / 1000);
+        bench_run(1, intervals_ms[i]);
+        bench_run(CSMA_TX_DEFAULT_BURST, intervals_ms[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------
+// KISS Stream Decoder Benchmark
+//
+// Compares the bulk decoder (vector scan + memcpy of clean runs) with
+// the per-byte state machine on a stream of APRS-sized frames. The bulk
+// decoder is fed socket-read sized chunks and drains the frame queue
+// after each one.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "kiss_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES      16384
+#define BENCH_FRAME_LEN   200
+#define BENCH_ROUNDS      8
+#define BENCH_READ_SIZE   1024    // Fewer frames per read than KISS_RX_SLOTS
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_count_frame(void* ctx, const uint8_t* data, uint16_t length, uint8_t port) {
+    (void)ctx;
+    (void)data;
+    (void)length;
+    (void)port;
+}
+
+int main(void) {
+    size_t capacity = (size_t)BENCH_FRAMES * (2 * BENCH_FRAME_LEN + 3);
+    uint8_t* stream = malloc(capacity);
+    if (!stream) {
+        return 1;
+    }
+
+    // Mostly printable payloads with an occasional byte needing escape
+    srand(34);
+    size_t stream_len = 0;
+    uint8_t payload[BENCH_FRAME_LEN];
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        for (int i = 0; i < BENCH_FRAME_LEN; i++) {
+            int r = rand() % 256;
+            payload[i] = (r == 0) ? KISS_FEND : (r == 1) ? KISS_FESC : (uint8_t)(0x20 + r % 0x5F);
+        }
+        stream[stream_len++] = KISS_FEND;
+        stream[stream_len++] = KISS_CMD_DATA;
+        uint16_t escaped_len = 2 * BENCH_FRAME_LEN;
+        if (kiss_escape_data(payload, BENCH_FRAME_LEN, &stream[stream_len], &escaped_len) != 0) {
+            return 1;
+        }
+        stream_len += escaped_len;
+        stream[stream_len++] = KISS_FEND;
+    }
+
+    kiss_tnc_t tnc;
+    uint8_t frame[1024];
+    uint16_t frame_len;
+
+    // Per-byte state machine
+    kiss_init(&tnc);
+    long bytewise_frames = 0;
+    double t0 = bench_now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (size_t i = 0; i < stream_len; i++) {
+            kiss_process_byte(&tnc, stream[i]);
+            if (kiss_frame_ready(&tnc)) {
+                frame_len = sizeof(frame);
+                kiss_receive_frame(&tnc, frame, &frame_len, NULL);
+                bytewise_frames++;
+            }
+        }
+    }
+    double t_bytewise = bench_now() - t0;
+    kiss_cleanup(&tnc);
+
+    // Bulk decoder
+    kiss_init(&tnc);
+    long bulk_frames = 0;
+    t0 = bench_now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (size_t pos = 0; pos < stream_len; pos += BENCH_READ_SIZE) {
+            size_t chunk = stream_len - pos < BENCH_READ_SIZE ? stream_len - pos : BENCH_READ_SIZE;
+            if (kiss_process_buffer(&tnc, &stream[pos], chunk) > 0) {
+                bulk_frames += kiss_receive_frames(&tnc, bench_count_frame, NULL, KISS_RX_SLOTS);
+            }
+        }
+    }
+    double t_bulk = bench_now() - t0;
+    kiss_cleanup(&tnc);
+
+    double mbytes = (double)stream_len * BENCH_ROUNDS / 1e6;
+    printf("KISS decode, %zu bytes x %d rounds\n", stream_len, BENCH_ROUNDS);
+    printf("  per-byte : %8.1f MB/s (%ld frames)\n", mbytes / t_bytewise, bytewise_frames);
+    printf("  bulk     : %8.1f MB/s (%ld frames)\n", mbytes / t_bulk, bulk_frames);
+
+    free(stream);
+    return (bytewise_frames == bulk_frames) ? 0 : 1;
+}
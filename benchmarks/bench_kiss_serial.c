@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------
+// KISS Serial Loopback Benchmark
+//
+// Frames per second through a pty pair. The transmit side is either the
+// per-frame kiss_send_frame path on a blocking descriptor or the
+// non-blocking kiss_serial backend, which coalesces every frame queued
+// since the last write into one writev. The receive side is a
+// kiss_serial port on the pty master in both cases.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#define _GNU_SOURCE // posix_openpt, ptsname
+#include "kiss_protocol.h"
+#include "kiss_serial.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_FRAMES      200000
+#define BENCH_FRAME_LEN   64      // Short APRS/KISS frames are syscall bound
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_count_frame(void* ctx, const uint8_t* data, uint16_t length, uint8_t port,
+                              uint8_t command) {
+    (void)data;
+    (void)length;
+    (void)port;
+    (void)command;
+    (*(long*)ctx)++;
+}
+
+int main(void) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("pty");
+        return 1;
+    }
+    const char* slave_name = ptsname(master);
+
+    long received = 0;
+    kiss_serial_config_t config;
+    kiss_serial_default_config(&config);
+    config.on_frame = bench_count_frame;
+    config.ctx = &received;
+    kiss_serial_t* rx = kiss_serial_attach(master, &config);
+
+    config.on_frame = NULL;
+    config.ctx = NULL;
+    kiss_serial_t* tx = kiss_serial_open(slave_name, &config);
+    if (!rx || !tx) {
+        fprintf(stderr, "failed to open %s\n", slave_name);
+        return 1;
+    }
+
+    uint8_t payload[BENCH_FRAME_LEN];
+    for (int i = 0; i < BENCH_FRAME_LEN; i++) {
+        payload[i] = (uint8_t)(0x20 + i);
+    }
+
+    // Per-frame writes on a blocking descriptor
+    kiss_tnc_t tnc;
+    kiss_init(&tnc);
+    tnc.serial_fd = open(slave_name, O_RDWR | O_NOCTTY);
+    if (tnc.serial_fd < 0) {
+        perror("open");
+        return 1;
+    }
+    double t0 = bench_now();
+    for (long i = 0; i < BENCH_FRAMES; i++) {
+        if (kiss_send_frame(&tnc, payload, BENCH_FRAME_LEN, 0) < 0) {
+            return 1;
+        }
+        kiss_serial_read(rx);
+    }
+    while (received < BENCH_FRAMES && kiss_serial_poll(rx, 100) > 0) {
+    }
+    double t_per_frame = bench_now() - t0;
+    long per_frame_received = received;
+    close(tnc.serial_fd);
+    tnc.serial_fd = -1;
+    kiss_cleanup(&tnc);
+
+    // Queued frames, one writev per event loop iteration
+    received = 0;
+    long sent = 0;
+    t0 = bench_now();
+    while (received < BENCH_FRAMES) {
+        while (sent < BENCH_FRAMES &&
+               kiss_serial_queue(tx, payload, BENCH_FRAME_LEN, 0) == 0) {
+            sent++;
+        }
+        if (kiss_serial_poll(tx, 0) < 0 || kiss_serial_poll(rx, 10) < 0) {
+            return 1;
+        }
+    }
+    double t_batched = bench_now() - t0;
+
+    kiss_serial_stats_t stats;
+    kiss_serial_get_stats(tx, &stats);
+
+    printf("KISS over pty loopback, %d frames of %d bytes\n", BENCH_FRAMES, BENCH_FRAME_LEN);
+    printf("  per-frame write : %10.0f frames/s (%ld frames)\n",
+           per_frame_received / t_per_frame, per_frame_received);
+    printf("  batched writev  : %10.0f frames/s (%ld frames, %.1f frames per write)\n",
+           received / t_batched, received, (double)stats.frames_out / stats.writes);
+
+    kiss_serial_close(tx);
+    kiss_serial_close(rx);
+    return (per_frame_received == BENCH_FRAMES && received == BENCH_FRAMES) ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+//--------------------------------------------------------------------
+// M17 Packet Aggregation Benchmark
+//
+// An APRS gateway hands the bridge UI frames with 30..80-byte
+// information fields at random intervals. Each is sent either as its own
+// M17 packet or batched with whatever else arrives within the window.
+// Reports the airtime per frame, the share saved and the mean delay
+// batching adds, for several arrival rates and windows.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_packet.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_FRAMES        100000
+#define BENCH_HEADER        16      // Two addresses, control and PID
+#define BENCH_MIN_INFO      30
+#define BENCH_MAX_INFO      80
+
+static uint32_t bench_rng;
+
+static double bench_random(void) {
+    bench_rng = bench_rng * 1664525u + 1013904223u;
+    return (bench_rng >> 8) / 16777216.0;
+}
+
+typedef struct {
+    uint64_t delay_ms;          // Summed over frames
+    uint64_t opened_sum_ms;     // Arrival times of the frames waiting
+    uint32_t waiting;
+} bench_delay_t;
+
+static void bench_flush(m17_packet_batch_t* batch, bench_delay_t* delay, uint64_t now_ms) {
+    uint8_t frames[M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN];
+    m17_packet_batch_flush(batch, frames, sizeof(frames));
+    delay->delay_ms += (uint64_t)delay->waiting * now_ms - delay->opened_sum_ms;
+    delay->opened_sum_ms = 0;
+    delay->waiting = 0;
+}
+
+static void bench_run(double interval_ms, uint32_t window_ms) {
+    m17_packet_batch_t batch;
+    m17_packet_batch_init(&batch, M17_PACKET_MAX_DATA);
+    bench_delay_t delay;
+    memset(&delay, 0, sizeof(delay));
+    bench_rng = 2024;
+
+    uint8_t frame[BENCH_HEADER + BENCH_MAX_INFO];
+    memset(frame, 0x55, sizeof(frame));
+    uint64_t separate_ms = 0;
+    uint64_t now_ms = 0;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        // Interval uniform over 1..2 * mean
+        uint64_t arrival = now_ms + 1 + (uint64_t)(bench_random() * 2 * interval_ms);
+        uint16_t length = BENCH_HEADER + BENCH_MIN_INFO +
+                          (uint16_t)(bench_random() * (BENCH_MAX_INFO - BENCH_MIN_INFO + 1));
+        separate_ms += m17_packet_airtime_ms(length);
+
+        // The window may close before this frame arrives
+        if (m17_packet_batch_due(&batch, window_ms, arrival)) {
+            bench_flush(&batch, &delay, batch.opened_ms + window_ms);
+        }
+        now_ms = arrival;
+        if (m17_packet_batch_add(&batch, frame, length, now_ms) != 0) {
+            bench_flush(&batch, &delay, now_ms);
+            m17_packet_batch_add(&batch, frame, length, now_ms);
+        }
+        delay.opened_sum_ms += now_ms;
+        delay.waiting++;
+        if (window_ms == 0) {
+            bench_flush(&batch, &delay, now_ms);
+        }
+    }
+    if (batch.count > 0) {
+        bench_flush(&batch, &delay, batch.opened_ms + window_ms);
+    }
+
+    m17_packet_batch_stats_t stats;
+    m17_packet_batch_get_stats(&batch, &stats);
+    printf("  window %5u ms: %7llu packets, %6.1f ms airtime/frame, %5.1f%% saved, "
+           "%6.0f ms mean added delay\n",
+           window_ms, (unsigned long long)stats.packets, (double)stats.airtime_ms / BENCH_FRAMES,
+           100.0 * stats.airtime_saved_ms / separate_ms, (double)delay.delay_ms / BENCH_FRAMES);
+}
+
+int main(void) {
+    const double intervals_ms[] = { 500, 2000, 5000 };
+    const uint32_t windows_ms[] = { 0, 250, 500, 1000, 2000 };
+
+    printf("M17 packet aggregation, %d frames of %d..%d bytes, %d ms per frame, "
+           "%d frames of overhead per packet\n", BENCH_FRAMES, BENCH_HEADER + BENCH_MIN_INFO,
+           BENCH_HEADER + BENCH_MAX_INFO, M17_FRAME_MS, M17_PACKET_OVERHEAD_FRAMES);
+    for (size_t i = 0; i < sizeof(intervals_ms) / sizeof(intervals_ms[0]); i++) {
+        printf("one frame every %.1f s on average:\n", intervals_ms[i] / 1000);
+        for (size_t j = 0; j < sizeof(windows_ms) / sizeof(windows_ms[0]); j++) {
+            bench_run(intervals_ms[i], windows_ms[j]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+//--------------------------------------------------------------------
+// M17 Base-40 Callsign Codec Benchmark
+//
+// Compares the table-driven batch codec against a straightforward
+// per-digit divide/modulo and strchr implementation
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_callsign.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ADDRESSES 65536
+#define BENCH_ROUNDS    64
+
+static const char bench_charset[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-/.";
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Reference encoder: character search per position
+static uint64_t ref_encode(const char* callsign) {
+    uint64_t value = 0;
+    for (int i = (int)strlen(callsign) - 1; i >= 0; i--) {
+        const char* p = strchr(bench_charset, callsign[i]);
+        value = value * 40 + (p ? (uint64_t)(p - bench_charset) : 0);
+    }
+    return value;
+}
+
+// Reference decoder: one divide/modulo per character
+static void ref_decode(const uint8_t* addr, char* callsign) {
+    uint64_t value = 0;
+    for (int i = 0; i < M17_ADDR_LEN; i++) {
+        value = (value << 8) | addr[i];
+    }
+    int pos = 0;
+    while (value) {
+        callsign[pos++] = bench_charset[value % 40];
+        value /= 40;
+    }
+    callsign[pos] = '\0';
+}
+
+int main(void) {
+    static char names[BENCH_ADDRESSES][M17_CALLSIGN_BUF_LEN];
+    static const char* name_ptrs[BENCH_ADDRESSES];
+    static uint8_t addrs[BENCH_ADDRESSES][M17_ADDR_LEN];
+    static char decoded[BENCH_ADDRESSES][M17_CALLSIGN_BUF_LEN];
+    static uint64_t values[BENCH_ADDRESSES];
+
+    srand(17);
+    for (int i = 0; i < BENCH_ADDRESSES; i++) {
+        int len = 4 + rand() % 6;
+        for (int j = 0; j < len; j++) {
+            names[i][j] = bench_charset[1 + rand() % 39];
+        }
+        names[i][len] = '\0';
+        name_ptrs[i] = names[i];
+    }
+
+    const double total = (double)BENCH_ADDRESSES * BENCH_ROUNDS;
+    volatile uint64_t sink = 0;
+
+    double t0 = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_ADDRESSES; i++) {
+            values[i] = ref_encode(names[i]);
+        }
+        sink += values[r];
+    }
+    double t_ref_enc = bench_now() - t0;
+
+    t0 = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        m17_callsign_encode_batch(name_ptrs, addrs, BENCH_ADDRESSES);
+        sink += addrs[r][5];
+    }
+    double t_lut_enc = bench_now() - t0;
+
+    t0 = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_ADDRESSES; i++) {
+            ref_decode(addrs[i], decoded[i]);
+        }
+        sink += decoded[r][0];
+    }
+    double t_ref_dec = bench_now() - t0;
+
+    t0 = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        m17_callsign_decode_batch((const uint8_t(*)[M17_ADDR_LEN])addrs, decoded, BENCH_ADDRESSES);
+        sink += decoded[r][0];
+    }
+    double t_lut_dec = bench_now() - t0;
+
+    printf("M17 base-40 codec, %d addresses x %d rounds\n", BENCH_ADDRESSES, BENCH_ROUNDS);
+    printf("  encode reference : %8.2f ns/address\n", t_ref_enc * 1e9 / total);
+    printf("  encode batch LUT : %8.2f ns/address\n", t_lut_enc * 1e9 / total);
+    printf("  decode reference : %8.2f ns/address\n", t_ref_dec * 1e9 / total);
+    printf("  decode batch LUT : %8.2f ns/address\n", t_lut_dec * 1e9 / total);
+    (void)sink;
+
+    return 0;
+}
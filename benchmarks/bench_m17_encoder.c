@@ -0,0 +1,120 @@
+//--------------------------------------------------------------------
+// M17 Channel Encoder Benchmark
+//
+// Encodes LSF, stream and packet frames with the table-driven encoder
+// and with a bit-serial reference (m17_conv_encode, then interleaving
+// and randomising one bit at a time), and reports frames per second and
+// how many M17 channels one core keeps up with (25 frames/s each).
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_encoder.h"
+#include "m17_viterbi.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES    500000
+#define BENCH_VARIANTS  64
+#define BENCH_FRAME_RATE 25     // 40 ms frames
+
+static const uint8_t bench_randomiser[M17_FRAME_CODED_BITS / 8] = {
+    0xD6, 0xB5, 0xE2, 0x30, 0x82, 0xFF, 0x84, 0x62, 0xBA, 0x4E, 0x96, 0x90, 0xD8, 0x98, 0xDD, 0x5D,
+    0x0C, 0xC8, 0x52, 0x43, 0x91, 0x1D, 0xF8, 0x6E, 0x68, 0x2F, 0x35, 0xDA, 0x14, 0xEA, 0xCD, 0x76,
+    0x19, 0x8D, 0xD5, 0x80, 0xD1, 0x33, 0x87, 0x13, 0x57, 0x18, 0x2D, 0x29, 0x78, 0xC3
+};
+
+static uint32_t bench_rng = 1;
+
+static uint32_t bench_random(void) {
+    bench_rng = bench_rng * 1664525u + 1013904223u;
+    return bench_rng >> 8;
+}
+
+static double bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Bit-serial encoding of an LSF or packet frame
+static void bench_reference(const uint8_t* payload, uint16_t sync, m17_puncture_t puncture,
+                            uint16_t payload_bits, uint8_t* dibits) {
+    uint8_t coded[M17_FRAME_CODED_BITS];
+    m17_conv_encode(payload, payload_bits, puncture, coded, sizeof(coded));
+
+    memset(dibits, 0, M17_FRAME_SYMBOLS);
+    for (int i = 0; i < M17_SYNC_SYMBOLS; i++) {
+        dibits[i] = (sync >> (14 - 2 * i)) & 3;
+    }
+    for (uint32_t i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        uint8_t bit = coded[(45 * i + 92 * i * i) % M17_FRAME_CODED_BITS];
+        bit ^= (bench_randomiser[i / 8] >> (7 - i % 8)) & 1;
+        dibits[M17_SYNC_SYMBOLS + i / 2] |= bit << (1 - i % 2);
+    }
+}
+
+static void bench_report(const char* name, double rate, double reference_rate, uint32_t checksum) {
+    printf("  %-13s %10.0f frames/s, %7.0f channels per core, %5.1fx bit-serial (check %08x)\n",
+           name, rate, rate / BENCH_FRAME_RATE, rate / reference_rate, checksum);
+}
+
+int main(void) {
+    static uint8_t payloads[BENCH_VARIANTS][M17_LICH_CODED_BYTES + M17_LSF_PAYLOAD_BITS / 8];
+    uint8_t dibits[M17_FRAME_SYMBOLS];
+    for (int v = 0; v < BENCH_VARIANTS; v++) {
+        for (size_t i = 0; i < sizeof(payloads[v]); i++) {
+            payloads[v][i] = bench_random() & 0xFF;
+        }
+    }
+
+    printf("M17 channel encoding, %d frames per run\n", BENCH_FRAMES);
+    const struct {
+        const char* name;
+        uint16_t sync;
+        m17_puncture_t puncture;
+        uint16_t payload_bits;
+    } types[] = {
+        { "LSF", M17_SYNC_LSF, M17_PUNCTURE_LSF, M17_LSF_PAYLOAD_BITS },
+        { "packet", M17_SYNC_PACKET, M17_PUNCTURE_PACKET, M17_PACKET_PAYLOAD_BITS },
+    };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        printf("%s frames:\n", types[t].name);
+
+        uint32_t checksum = 0;
+        double start = bench_seconds();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            bench_reference(payloads[i % BENCH_VARIANTS], types[t].sync, types[t].puncture,
+                            types[t].payload_bits, dibits);
+            checksum = checksum * 31 + dibits[i % M17_FRAME_SYMBOLS];
+        }
+        double reference_rate = BENCH_FRAMES / (bench_seconds() - start);
+        bench_report("bit-serial", reference_rate, reference_rate, checksum);
+
+        checksum = 0;
+        start = bench_seconds();
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            if (types[t].puncture == M17_PUNCTURE_LSF) {
+                m17_encode_lsf(payloads[i % BENCH_VARIANTS], dibits);
+            } else {
+                m17_encode_packet(payloads[i % BENCH_VARIANTS], dibits);
+            }
+            checksum = checksum * 31 + dibits[i % M17_FRAME_SYMBOLS];
+        }
+        bench_report("table-driven", BENCH_FRAMES / (bench_seconds() - start), reference_rate,
+                     checksum);
+    }
+
+    printf("stream frames:\n");
+    uint32_t checksum = 0;
+    double start = bench_seconds();
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        const uint8_t* payload = payloads[i % BENCH_VARIANTS];
+        m17_encode_stream(payload, payload + M17_LICH_CODED_BYTES, dibits);
+        checksum = checksum * 31 + dibits[i % M17_FRAME_SYMBOLS];
+    }
+    double rate = BENCH_FRAMES / (bench_seconds() - start);
+    printf("  %-13s %10.0f frames/s, %7.0f channels per core (check %08x)\n", "table-driven",
+           rate, rate / BENCH_FRAME_RATE, checksum);
+    return 0;
+}
@@ -0,0 +1,104 @@
+//--------------------------------------------------------------------
+// M17 LICH Benchmark
+//
+// Golay(24,12) decodes per second with up to three bit errors, and LICH
+// chunks per second through the LSF cache: Golay-decoding every chunk
+// vs confirming chunks of a known LSF against the predicted LICH.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_lich.h"
+#include "m17_packet.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CODEWORDS  10000000
+#define BENCH_CHUNKS     5000000
+#define BENCH_VARIANTS   256
+
+static uint32_t bench_rng = 1;
+
+static uint32_t bench_random(void) {
+    bench_rng = bench_rng * 1664525u + 1013904223u;
+    return bench_rng >> 8;
+}
+
+static double bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    static uint32_t codewords[BENCH_VARIANTS];
+    for (int i = 0; i < BENCH_VARIANTS; i++) {
+        uint32_t codeword = m17_golay_encode(bench_random() & 0xFFF);
+        for (int e = 0; e < i % 4; e++) {
+            codeword ^= 1u << (bench_random() % 24);
+        }
+        codewords[i] = codeword;
+    }
+
+    uint32_t checksum = 0;
+    double start = bench_seconds();
+    for (int i = 0; i < BENCH_CODEWORDS; i++) {
+        uint16_t data = 0;
+        checksum += m17_golay_decode(codewords[i % BENCH_VARIANTS], &data) + data;
+    }
+    double rate = BENCH_CODEWORDS / (bench_seconds() - start);
+    printf("Golay(24,12) syndrome decoding: %.1fM codewords/s (check %u)\n", rate / 1e6, checksum);
+
+    // A stream's LICH, a quarter of chunks with one or two bit errors
+    uint8_t lsf[M17_LICH_LSF_LEN];
+    for (int i = 0; i < M17_LICH_LSF_LEN - 2; i++) {
+        lsf[i] = bench_random() & 0xFF;
+    }
+    uint16_t crc = m17_crc(lsf, M17_LICH_LSF_LEN - 2);
+    lsf[M17_LICH_LSF_LEN - 2] = crc >> 8;
+    lsf[M17_LICH_LSF_LEN - 1] = crc & 0xFF;
+    static uint8_t coded[BENCH_VARIANTS * M17_LICH_CHUNKS][M17_LICH_CODED_BYTES];
+    for (int i = 0; i < BENCH_VARIANTS * M17_LICH_CHUNKS; i++) {
+        m17_lich_encode(lsf, i % M17_LICH_CHUNKS, coded[i]);
+        for (int e = 0; e < (i % 8 < 2 ? i % 8 + 1 : 0); e++) {
+            int bit = bench_random() % 96;
+            coded[i][bit / 8] ^= 0x80 >> (bit % 8);
+        }
+    }
+
+    // Without the cache: decode every chunk, rebuild and check the LSF
+    // once per superframe
+    uint8_t rebuilt[M17_LICH_LSF_LEN];
+    start = bench_seconds();
+    checksum = 0;
+    for (int i = 0; i < BENCH_CHUNKS; i++) {
+        uint8_t chunk[M17_LICH_CHUNK_LEN];
+        if (m17_lich_decode(coded[i % (BENCH_VARIANTS * M17_LICH_CHUNKS)], chunk) < 0) {
+            continue;
+        }
+        uint8_t counter = chunk[M17_LICH_LSF_BYTES] >> M17_LICH_COUNTER_SHIFT;
+        memcpy(&rebuilt[counter * M17_LICH_LSF_BYTES], chunk, M17_LICH_LSF_BYTES);
+        if (counter == M17_LICH_CHUNKS - 1) {
+            checksum += m17_crc(rebuilt, M17_LICH_LSF_LEN - 2);
+        }
+    }
+    double decode_rate = BENCH_CHUNKS / (bench_seconds() - start);
+    printf("LICH chunks, decode and rebuild the LSF: %6.1fM chunks/s (check %u)\n",
+           decode_rate / 1e6, checksum);
+
+    m17_lsf_cache_t cache;
+    m17_lsf_cache_init(&cache, M17_LSF_CACHE_TIMEOUT_MS);
+    m17_lsf_cache_seed(&cache, 0, lsf, 0);
+    uint8_t out[M17_LICH_LSF_LEN];
+    start = bench_seconds();
+    for (int i = 0; i < BENCH_CHUNKS; i++) {
+        m17_lsf_cache_push(&cache, 0, coded[i % (BENCH_VARIANTS * M17_LICH_CHUNKS)],
+                           (uint64_t)i * 40, out);
+    }
+    double cache_rate = BENCH_CHUNKS / (bench_seconds() - start);
+    m17_lsf_cache_stats_t stats;
+    m17_lsf_cache_get_stats(&cache, &stats);
+    printf("LICH chunks, LSF cache with known LSF:   %6.1fM chunks/s, %.1fx, %.1f%% without decoding\n",
+           cache_rate / 1e6, cache_rate / decode_rate, 100.0 * stats.fast_matches / stats.chunks);
+    return 0;
+}
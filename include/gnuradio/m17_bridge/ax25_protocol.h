@@ -12,6 +12,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <sys/uio.h>
+#include "timer_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +35,7 @@ extern "C" {
 #define AX25_CTRL_RR     0x01    // Receive Ready
 #define AX25_CTRL_RNR    0x05    // Receive Not Ready
 #define AX25_CTRL_REJ    0x09    // Reject
+#define AX25_CTRL_SREJ   0x0D    // Selective Reject
 #define AX25_CTRL_SABM   0x2F    // Set Asynchronous Balanced Mode
 #define AX25_CTRL_SABME  0x6F    // Set Asynchronous Balanced Mode Extended
 #define AX25_CTRL_DISC   0x43    // Disconnect
@@ -41,6 +44,21 @@ extern "C" {
 #define AX25_CTRL_FRMR   0x87    // Frame Reject
 #define AX25_CTRL_UI     0x03    // Unnumbered Information
 
+// AX.25 Control Field Bits (modulo 8)
+#define AX25_CTRL_PF     0x10    // Poll/Final bit
+#define AX25_CTRL_S_MASK 0x0F    // Supervisory type (RR/RNR/REJ)
+#define AX25_CTRL_U_MASK 0xEF    // Unnumbered type without P/F
+
+// AX.25 Extended Control Field (modulo 128, after SABME)
+// I and S frames carry a 16-bit control field, first octet on the air
+// first: N(S) in bits 1-7, P/F in bit 8, N(R) in bits 9-15. U frames keep
+// their single octet.
+#define AX25_CTRL_EXT_PF       0x0100  // Poll/Final bit
+#define AX25_MODULO            8       // Sequence numbers after SABM
+#define AX25_MODULO_EXT        128     // Sequence numbers after SABME
+#define AX25_MAX_WINDOW        7       // Largest window, modulo 8
+#define AX25_MAX_WINDOW_EXT    127     // Largest window, modulo 128
+
 // AX.25 PID Types
 #define AX25_PID_NONE    0xF0    // No layer 3 protocol
 #define AX25_PID_IP      0xCC    // Internet Protocol
@@ -68,6 +86,71 @@ typedef struct {
     bool valid;                                // Frame validity
 } ax25_frame_t;
 
+// AX.25 Frame View
+// Records offsets into the caller's buffer; fields are decoded on demand
+// by the ax25_frame_view_* accessors and nothing is copied. The buffer
+// must outlive the view.
+typedef struct {
+    const uint8_t* data;       // Frame bytes without flags, including FCS
+    uint16_t length;           // Length of data
+    uint8_t num_addresses;     // Number of address fields
+    uint16_t control_offset;   // Offset of the control field
+    uint16_t info_offset;      // Offset of the information field
+    uint16_t info_length;      // Information field length (0 if none)
+    uint8_t control_length;    // 1, or 2 for modulo 128 I and S frames
+    bool has_pid;              // PID field present (I and UI frames)
+} ax25_frame_view_t;
+
+// AX.25 Header Template
+// Address, control and PID bytes encoded once and reused for every frame
+// on the same path. The FCS register after the header is cached, so per
+// frame only the information field is run through the CRC.
+typedef struct {
+    uint8_t bytes[AX25_MAX_ADDRS * AX25_ADDR_LEN + 2];  // Encoded header
+    uint16_t length;                                   // Header length
+    uint16_t fcs_state;                                // FCS register after the header
+    uint16_t control_offset;                           // Offset of the control field
+    uint8_t control_length;                            // 1, or 2 for modulo 128 I and S frames
+} ax25_header_template_t;
+
+// Segments produced by ax25_encode_iov: header, information field, FCS
+#define AX25_IOV_SEGMENTS 3
+
+// Transmit hook: receives an encoded frame (without flags) as an iovec list
+typedef int (*ax25_tx_handler_t)(void* ctx, const struct iovec* iov, int iovcnt);
+
+// AX.25 Receive Queues
+// Single-producer/single-consumer rings of parsed frames, one for I
+// frames and one for UI frames, so a reader of one type is never held up
+// by a frame of the other. The decoder side enqueues, the application
+// side receives; neither needs a lock.
+#define AX25_RX_QUEUE_LEN 16     // Frames held per queue between receive calls (power of two)
+
+typedef enum {
+    AX25_RX_QUEUE_DATA,          // I frames, for ax25_receive_data
+    AX25_RX_QUEUE_UI,            // UI frames, for ax25_receive_ui_frame
+    AX25_RX_QUEUES
+} ax25_rx_queue_id_t;
+
+typedef enum {
+    AX25_RX_DROP_NEWEST,         // Full queue refuses the incoming frame
+    AX25_RX_DROP_OLDEST          // Full queue discards its oldest frame
+} ax25_rx_policy_t;
+
+typedef struct {
+    uint32_t frames_in;          // Frames enqueued
+    uint32_t dropped;            // Frames lost to a full queue
+    uint32_t high_water;         // Most frames queued at once, both queues together
+} ax25_rx_stats_t;
+
+typedef struct {
+    ax25_frame_t frames[AX25_RX_QUEUE_LEN];    // Received frames, oldest at head
+    uint32_t order[AX25_RX_QUEUE_LEN];         // Arrival number of each frame
+    uint32_t seq[AX25_RX_QUEUE_LEN];           // Per-slot write count, odd while being written
+    uint32_t head;                             // Consumer index (free-running)
+    uint32_t tail;                             // Producer index (free-running)
+} ax25_rx_queue_t;
+
 // AX.25 Connection State
 typedef enum {
     AX25_STATE_DISCONNECTED,
@@ -76,6 +159,16 @@ typedef enum {
     AX25_STATE_DISCONNECTING
 } ax25_state_t;
 
+// Connected-mode window slot: an I frame kept for retransmission, or
+// received out of sequence and held until the gap is filled
+typedef struct {
+    uint16_t length;         // Information field length
+    uint8_t pid;             // Protocol ID
+    bool present;            // Slot holds a frame
+    bool srej_sent;          // Receive side: SREJ already sent for this sequence number
+    uint8_t info[AX25_MAX_INFO];
+} ax25_window_slot_t;
+
 // AX.25 Connection
 typedef struct {
     ax25_address_t local_addr;
@@ -83,11 +176,53 @@ typedef struct {
     ax25_state_t state;
     uint8_t send_seq;        // Send sequence number
     uint8_t recv_seq;        // Receive sequence number
+    uint8_t ack_seq;         // Oldest unacknowledged send sequence number
+    uint8_t recv_high;       // One past the highest N(S) received (modulo 128)
     uint8_t window_size;     // Window size
+    uint8_t modulo;          // Sequence number modulus: 8 (SABM) or 128 (SABME)
+    uint8_t window_mask;     // Window slots - 1 (power of two, >= window_size)
+    ax25_window_slot_t* tx_window;  // Unacknowledged I frames by N(S) (NULL until connected)
+    ax25_window_slot_t* rx_window;  // Out-of-sequence I frames by N(S) (modulo 128 only)
     uint32_t timeout;        // Connection timeout
     uint32_t retry_count;    // Retry counter
+    bool poll_pending;       // Enquiry sent, waiting for a response with F set
+    bool ack_pending;        // Received I frames not yet acknowledged
+    bool reject_sent;        // REJ outstanding for a sequence gap
+    uint32_t retransmits;    // I frames sent again after REJ, SREJ or a poll
+    timer_wheel_timer_t t1;  // Acknowledgement / retry timer
+    timer_wheel_timer_t t2;  // Response delay timer
+    timer_wheel_timer_t t3;  // Idle link check timer
 } ax25_connection_t;
 
+// AX.25 Session Table
+// Connected-mode sessions indexed by their packed (local, remote) address
+// pair in an open-addressing hash table with linear probing. Session state
+// lives in slabs that never move, so a session pointer stays valid until
+// the session is removed. Nothing is allocated until the first insert.
+#define AX25_SESSION_SLAB_SIZE    256   // Sessions allocated at a time
+#define AX25_SESSION_MIN_BUCKETS  64    // Initial index size (power of two)
+
+typedef struct {
+    uint64_t local_key;                 // ax25_address_key of the local address
+    uint64_t remote_key;                // ax25_address_key of the remote address
+    uint32_t hash;                      // Cached hash of the key pair
+    ax25_connection_t* session;         // NULL = empty bucket
+} ax25_session_bucket_t;
+
+struct ax25_session_node;
+
+typedef struct {
+    ax25_session_bucket_t* buckets;     // Index, load factor kept below 3/4
+    uint32_t mask;                      // Bucket count - 1
+    uint32_t count;                     // Live sessions
+    struct ax25_session_node** slabs;   // Session storage
+    uint32_t num_slabs;
+    struct ax25_session_node* free_list;  // Released sessions, reused first
+    timer_wheel_t* timers;              // Wheel the T1/T2/T3 timers run on (NULL = none)
+} ax25_session_table_t;
+
+typedef void (*ax25_session_visit_t)(void* ctx, ax25_connection_t* session);
+
 // AX.25 TNC Configuration
 typedef struct {
     ax25_address_t my_address;       // My callsign
@@ -97,7 +232,9 @@ typedef struct {
     uint8_t tx_tail;                 // TX tail (10ms units)
     bool full_duplex;                // Full duplex mode
     uint8_t max_frame_length;        // Maximum frame length
-    uint8_t window_size;             // Window size
+    uint8_t window_size;             // Window size, modulo 8 (1..7)
+    uint8_t window_size_ext;         // Window size, modulo 128 (1..127)
+    bool extended;                   // Connect with SABME (modulo 128, SREJ)
     uint32_t t1_timeout;             // T1 timeout (ms)
     uint32_t t2_timeout;             // T2 timeout (ms)
     uint32_t t3_timeout;             // T3 timeout (ms)
@@ -105,13 +242,20 @@ typedef struct {
 } ax25_config_t;
 
 // AX.25 TNC Interface
+// Timer resolution for T1/T2/T3
+#define AX25_TIMER_TICK_MS 10
+
 typedef struct {
     ax25_config_t config;
-    ax25_connection_t connections[16];  // Multiple connections
-    uint8_t num_connections;
-    ax25_frame_t rx_frame;
+    ax25_session_table_t sessions;      // Connected-mode sessions
+    timer_wheel_t timers;               // T1/T2/T3 of every session
+    ax25_rx_queue_t rx_queues[AX25_RX_QUEUES];  // Received frames by type
+    uint32_t rx_order;                  // Next arrival number (producer only)
+    ax25_rx_policy_t rx_policy;         // Behaviour when the queue is full
+    ax25_rx_stats_t rx_stats;           // Updated by the producer
     ax25_frame_t tx_frame;
-    bool frame_ready;
+    ax25_tx_handler_t tx_handler;       // Encoded frame sink (NULL = encode only)
+    void* tx_ctx;                       // Context passed to tx_handler
 } ax25_tnc_t;
 
 // AX.25 Protocol Functions
@@ -132,6 +276,38 @@ int ax25_parse_frame(const uint8_t* data, uint16_t length, ax25_frame_t* frame);
 int ax25_encode_frame(const ax25_frame_t* frame, uint8_t* data, uint16_t* length);
 int ax25_validate_frame(const ax25_frame_t* frame);
 
+// Scatter-Gather Encoding
+// The information field is referenced in place; fcs[2] receives the
+// trailer and must outlive the iovec list. Returns the segment count.
+int ax25_header_template_init(ax25_header_template_t* tmpl, const ax25_address_t* addresses,
+                              uint8_t num_addresses, uint8_t control, uint8_t pid);
+// Modulo 128: I and S frames get the 16-bit control field
+int ax25_header_template_init_ext(ax25_header_template_t* tmpl, const ax25_address_t* addresses,
+                                  uint8_t num_addresses, uint16_t control, uint8_t pid);
+int ax25_header_template_set_control(ax25_header_template_t* tmpl, uint8_t control);
+int ax25_encode_iov(const ax25_header_template_t* tmpl, const uint8_t* info, uint16_t info_len,
+                    uint8_t fcs[2], struct iovec* iov);
+int ax25_set_tx_handler(ax25_tnc_t* tnc, ax25_tx_handler_t handler, void* ctx);
+
+// Frame View Functions
+int ax25_frame_view_init(ax25_frame_view_t* view, const uint8_t* data, uint16_t length);
+// The control field length is not self-describing: extended selects the
+// modulo 128 layout negotiated by SABME
+int ax25_frame_view_init_ext(ax25_frame_view_t* view, const uint8_t* data, uint16_t length,
+                             bool extended);
+int ax25_frame_view_get_address(const ax25_frame_view_t* view, uint8_t index, ax25_address_t* addr);
+int ax25_frame_view_get_callsign(const ax25_frame_view_t* view, uint8_t index,
+                                 char* callsign, uint8_t* ssid);
+bool ax25_frame_view_address_equal(const ax25_frame_view_t* view, uint8_t index,
+                                   const ax25_address_t* addr);
+uint8_t ax25_frame_view_control(const ax25_frame_view_t* view);  // First control octet
+uint16_t ax25_frame_view_control_ext(const ax25_frame_view_t* view);
+uint8_t ax25_frame_view_pid(const ax25_frame_view_t* view);
+const uint8_t* ax25_frame_view_info(const ax25_frame_view_t* view, uint16_t* length);
+uint16_t ax25_frame_view_fcs(const ax25_frame_view_t* view);
+bool ax25_frame_view_check_fcs(const ax25_frame_view_t* view);
+int ax25_frame_view_to_frame(const ax25_frame_view_t* view, ax25_frame_t* frame);
+
 // Connection Functions
 int ax25_connect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr);
 int ax25_disconnect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr);
@@ -139,6 +315,40 @@ int ax25_send_data(ax25_tnc_t* tnc, const ax25_address_t* remote_addr,
                    const uint8_t* data, uint16_t length);
 int ax25_receive_data(ax25_tnc_t* tnc, ax25_address_t* remote_addr, 
                       uint8_t* data, uint16_t* length);
+// Handle one received frame (addresses through FCS, no flags): drives the
+// connection state machine and queues UI and in-sequence I frames
+int ax25_input_frame(ax25_tnc_t* tnc, const uint8_t* data, uint16_t length);
+// Run the T1/T2/T3 timers due by now_ms (see timer_wheel_clock_ms);
+// returns timers expired
+int ax25_timer_tick(ax25_tnc_t* tnc, uint64_t now_ms);
+
+// Session Table Functions
+uint64_t ax25_address_key(const ax25_address_t* addr);  // Callsign and SSID packed in 52 bits
+int ax25_session_table_init(ax25_session_table_t* table);
+void ax25_session_table_free(ax25_session_table_t* table);
+// Returns the existing session for the pair or a new DISCONNECTED one (NULL on allocation failure)
+ax25_connection_t* ax25_session_insert(ax25_session_table_t* table, const ax25_address_t* local,
+                                       const ax25_address_t* remote);
+ax25_connection_t* ax25_session_find(const ax25_session_table_t* table,
+                                     const ax25_address_t* local, const ax25_address_t* remote);
+// Cancels the session's timers before releasing it
+int ax25_session_remove(ax25_session_table_t* table, const ax25_address_t* local,
+                        const ax25_address_t* remote);
+uint32_t ax25_session_count(const ax25_session_table_t* table);
+// The visitor must not insert or remove sessions
+int ax25_session_foreach(ax25_session_table_t* table, ax25_session_visit_t visit, void* ctx);
+
+// Receive Queue Functions
+// Producer side: copies or decodes a frame into the queue for its type;
+// -1 if it was refused. Only I and UI frames are queued.
+int ax25_rx_enqueue(ax25_tnc_t* tnc, const ax25_frame_t* frame);
+int ax25_rx_enqueue_view(ax25_tnc_t* tnc, const ax25_frame_view_t* view);
+// Consumer side: returns 1 with the oldest frame of either type, 0 if
+// both queues are empty
+int ax25_rx_dequeue(ax25_tnc_t* tnc, ax25_frame_t* frame);
+uint32_t ax25_rx_pending(const ax25_tnc_t* tnc);
+int ax25_rx_set_policy(ax25_tnc_t* tnc, ax25_rx_policy_t policy);
+int ax25_rx_get_stats(const ax25_tnc_t* tnc, ax25_rx_stats_t* stats);
 
 // UI Frame Functions (for APRS)
 int ax25_send_ui_frame(ax25_tnc_t* tnc, const ax25_address_t* src, const ax25_address_t* dst,
@@ -149,8 +359,11 @@ int ax25_receive_ui_frame(ax25_tnc_t* tnc, ax25_address_t* src, ax25_address_t*
                           uint8_t* pid, uint8_t* info, uint16_t* info_len);
 
 // FCS Functions
+uint16_t ax25_fcs_update(uint16_t reg, const uint8_t* data, uint16_t length);
 uint16_t ax25_calculate_fcs(const uint8_t* data, uint16_t length);
 bool ax25_check_fcs(const uint8_t* data, uint16_t length, uint16_t fcs);
+uint16_t ax25_fcs_patch(uint16_t fcs, uint16_t length, uint16_t offset,
+                        const uint8_t* old_bytes, const uint8_t* new_bytes, uint16_t count);
 
 // Utility Functions
 int ax25_bit_stuff(const uint8_t* input, uint16_t input_len, uint8_t* output, uint16_t* output_len);
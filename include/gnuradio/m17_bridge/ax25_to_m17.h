@@ -11,7 +11,7 @@
 #ifndef INCLUDED_M17_BRIDGE_AX25_TO_M17_H
 #define INCLUDED_M17_BRIDGE_AX25_TO_M17_H
 
-#include <gnuradio/sync_block.h>
+#include <gnuradio/block.h>
 #include <m17_bridge/api.h>
 
 namespace gr {
@@ -23,8 +23,15 @@ namespace m17_bridge {
  *
  * This block converts AX.25 packet radio frames to M17 digital radio frames.
  * It handles the protocol conversion, callsign mapping, and frame formatting.
+ *
+ * With a batching window set, frames arriving within the window are
+ * packed into one M17 packet (each behind a two-byte length) instead of
+ * one packet apiece, so short APRS frames share a single preamble, LSF
+ * and EOT. While the block runs, a timer sends the batch when the window
+ * closes even if no more input arrives; a message on the "flush" port
+ * sends it at once.
  */
-class M17_BRIDGE_API ax25_to_m17 : virtual public gr::sync_block
+class M17_BRIDGE_API ax25_to_m17 : virtual public gr::block
 {
 public:
     typedef std::shared_ptr<ax25_to_m17> sptr;
@@ -35,10 +42,15 @@ public:
      * \param callsign Source callsign for M17 frames
      * \param destination Destination callsign for M17 frames
      * \param enable_fec Enable Forward Error Correction
+     * \param batch_window_ms Longest a frame waits for others to share its
+     *        packet; 0 sends every frame on its own
+     * \param batch_max_bytes Largest aggregated packet, at most 822 bytes
      */
     static sptr make(const std::string& callsign,
                      const std::string& destination,
-                     bool enable_fec = false);
+                     bool enable_fec = false,
+                     int batch_window_ms = 0,
+                     int batch_max_bytes = 822);
 
     /*!
      * \brief Set the destination callsign
@@ -54,6 +66,23 @@ public:
      * \brief Enable or disable FEC
      */
     virtual void set_fec_enabled(bool enabled) = 0;
+
+    /*!
+     * \brief Set the batching window in milliseconds (0 disables batching)
+     */
+    virtual void set_batch_window(int window_ms) = 0;
+
+    /*!
+     * \brief Set the largest aggregated packet in bytes
+     */
+    virtual void set_batch_max_bytes(int max_bytes) = 0;
+
+    /*!
+     * \brief Get the airtime saved by batching
+     * \return Milliseconds of preamble, LSF and EOT not sent because frames
+     *         shared a packet
+     */
+    virtual uint64_t airtime_saved_ms() const = 0;
 };
 
 } // namespace m17_bridge
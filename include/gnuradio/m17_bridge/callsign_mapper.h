@@ -34,8 +34,9 @@ public:
 
     /*!
      * \brief Return a shared_ptr to a new instance of m17_bridge::callsign_mapper.
+     * \param auto_mapping_capacity Maximum number of auto-generated mappings kept
      */
-    static sptr make();
+    static sptr make(int auto_mapping_capacity = 1024);
 
     /*!
      * \brief Add a callsign mapping
@@ -77,9 +78,23 @@ public:
      */
     virtual bool is_auto_mapping_enabled() const = 0;
 
+    /*!
+     * \brief Set the capacity of the auto-mapping cache
+     * \param capacity Maximum number of auto-generated mappings; the least
+     *        recently used ones are evicted beyond this
+     */
+    virtual void set_auto_mapping_capacity(int capacity) = 0;
+
+    /*!
+     * \brief Get the capacity of the auto-mapping cache
+     * \return Maximum number of auto-generated mappings
+     */
+    virtual int auto_mapping_capacity() const = 0;
+
     /*!
      * \brief Get the current mapping table
-     * \return Map of M17 to AX.25 callsign mappings
+     * \return Map of pinned (manually added) M17 to AX.25 callsign mappings;
+     *         auto-generated mappings are not included
      */
     virtual std::map<std::string, std::string> get_mapping_table() const = 0;
 
@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------
+// Callsign Mapping Snapshot
+//
+// Versioned, checksummed binary format for callsign mapping tables.
+// Records are fixed width and sorted, so a memory-mapped file is
+// searched in place without parsing.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Snapshot Constants
+#define CALLSIGN_SNAPSHOT_MAGIC         "M17CSNAP"  // File magic (8 bytes, no terminator)
+#define CALLSIGN_SNAPSHOT_MAGIC_LEN     8
+#define CALLSIGN_SNAPSHOT_VERSION       1
+#define CALLSIGN_SNAPSHOT_FIELD_LEN     16          // Callsign field incl. NUL padding
+#define CALLSIGN_SNAPSHOT_MAX_CALLSIGN  (CALLSIGN_SNAPSHOT_FIELD_LEN - 1)
+#define CALLSIGN_SNAPSHOT_HEADER_LEN    32
+
+// File layout (all integers little-endian):
+//   header (32 bytes)      magic[8], version u16, record_len u16, forward_count u32,
+//                          reverse_count u32, crc32 u32, reserved[8]
+//   forward records        forward_count x record, sorted by key (M17 -> AX.25)
+//   reverse records        reverse_count x record, sorted by key (AX.25 -> M17)
+// The CRC-32C (Castagnoli) covers every byte after the header.
+
+typedef struct {
+    char key[CALLSIGN_SNAPSHOT_FIELD_LEN];
+    char value[CALLSIGN_SNAPSHOT_FIELD_LEN];
+} callsign_snapshot_record_t;
+
+// Open snapshot; records point directly into the mapping
+typedef struct {
+    void* map_base;
+    size_t map_len;
+    const callsign_snapshot_record_t* forward;
+    uint32_t forward_count;
+    const callsign_snapshot_record_t* reverse;
+    uint32_t reverse_count;
+} callsign_snapshot_t;
+
+// Record Functions
+int callsign_snapshot_record_set(callsign_snapshot_record_t* record, const char* key,
+                                 const char* value);
+
+// Snapshot File Functions
+bool callsign_snapshot_probe(const char* filename);
+int callsign_snapshot_open(callsign_snapshot_t* snap, const char* filename);
+void callsign_snapshot_close(callsign_snapshot_t* snap);
+int callsign_snapshot_write(const char* filename,
+                            callsign_snapshot_record_t* forward, uint32_t forward_count,
+                            callsign_snapshot_record_t* reverse, uint32_t reverse_count);
+
+// Text Format Functions
+// One "M17CALL AX25CALL" pair per line; '#' starts a comment
+typedef int (*callsign_snapshot_text_cb)(void* ctx, const char* m17_callsign,
+                                         const char* ax25_callsign);
+int callsign_snapshot_parse_text(const char* filename, callsign_snapshot_text_cb callback,
+                                 void* ctx);
+int callsign_snapshot_write_text(const char* filename,
+                                 const callsign_snapshot_record_t* records, uint32_t count);
+
+// Lookup Functions (binary search; return NULL when not found)
+const char* callsign_snapshot_lookup_forward(const callsign_snapshot_t* snap, const char* key);
+const char* callsign_snapshot_lookup_reverse(const callsign_snapshot_t* snap, const char* key);
+
+// Checksum (CRC-32C)
+uint32_t callsign_snapshot_crc32c(const uint8_t* data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
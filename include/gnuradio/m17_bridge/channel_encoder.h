@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_H
+#define INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_H
+
+#include <gnuradio/sync_block.h>
+#include <m17_bridge/api.h>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief M17 transmit channel encoder
+ * \ingroup m17_bridge
+ *
+ * Each input item is one frame's payload: the 30-byte LSF, a stream
+ * frame's 12-byte Golay-coded LICH chunk followed by the 18-byte frame
+ * number and payload, or a packet frame's 25-byte chunk and metadata
+ * byte. Each output item is the frame's 192 dibits (sync word, then the
+ * payload convolutionally coded, punctured, interleaved and
+ * randomised), one per byte with values 0..3, ready for a 4FSK
+ * modulator mapping 0, 1, 2, 3 to +1, +3, -1, -3.
+ */
+class M17_BRIDGE_API channel_encoder : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<channel_encoder> sptr;
+
+    //! Frame types, selecting the sync word, puncture pattern and input size
+    enum frame_type_t { FRAME_LSF = 0, FRAME_STREAM = 1, FRAME_PACKET = 2 };
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of m17_bridge::channel_encoder.
+     * \param frame_type LSF, stream or packet frames
+     */
+    static sptr make(int frame_type = FRAME_PACKET);
+
+    /*!
+     * \brief Get the number of bytes in each input item
+     */
+    virtual int payload_bytes() const = 0;
+
+    /*!
+     * \brief Get the number of dibits in each output item
+     */
+    virtual int frame_symbols() const = 0;
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_H */
@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------
+// CSMA Transmit Scheduler
+//
+// Decides when a half-duplex packet station keys up. Frames wait in
+// strict-priority queues; while any are waiting the channel is checked
+// once per slot time and, when clear, the station transmits with
+// probability (persistence + 1) / 256 (p-persistent CSMA, as in the
+// KISS TNC parameters). Frames from csma_tx_ax25_output are never
+// reordered within one link: priority only lets one link's frames pass
+// another's. A key-up asserts PTT, waits TXDELAY, sends as
+// many queued frames as the burst limits allow back to back, then holds
+// the carrier for TXTAIL, so the keying overhead is paid once per burst
+// rather than once per frame.
+//
+// The scheduler keeps no clock of its own: the caller reports carrier
+// detect and calls csma_tx_poll with the current time, at the latest by
+// csma_tx_next_event.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+#include "ax25_protocol.h"
+#include "kiss_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Scheduler Constants
+#define CSMA_TX_MAX_FRAME_LEN   1024    // Largest frame a queue slot holds
+#define CSMA_TX_DEFAULT_DEPTH   32      // Frames queued per priority
+#define CSMA_TX_DEFAULT_BURST   7       // Frames per key-up
+#define CSMA_TX_IDLE_EVENT      UINT64_MAX
+
+// Transmit Priorities (lower value goes first)
+#define CSMA_TX_PRIO_CONTROL    0       // Link control: S frames and U frames other than UI
+#define CSMA_TX_PRIO_DATA       1       // Connected-mode I frames
+#define CSMA_TX_PRIO_UNPROTO    2       // UI frames (APRS, beacons)
+#define CSMA_TX_PRIORITIES      3
+
+// Sends one frame of a burst (e.g. to the modem or a KISS link);
+// returns 0, or -1 if the frame was not sent
+typedef int (*csma_tx_handler_t)(void* ctx, const uint8_t* data, uint16_t length);
+// Asserts (keyed = true) or releases PTT
+typedef void (*csma_tx_ptt_handler_t)(void* ctx, bool keyed);
+
+// Scheduler Configuration
+typedef struct {
+    uint16_t tx_delay;          // TX delay (10ms units)
+    uint8_t persistence;        // Persistence factor (transmit if random 0..255 <= p)
+    uint16_t slot_time;         // Slot time (10ms units)
+    uint8_t tx_tail;            // TX tail (10ms units)
+    bool full_duplex;           // Key up at once, ignoring carrier detect
+    uint32_t bit_rate;          // Channel bit rate, for burst airtime
+    uint8_t max_burst_frames;   // Frames per key-up (1 = one frame per transmission)
+    uint16_t max_burst_bytes;   // Frame bytes per key-up (0 = no limit)
+    uint32_t seed;              // Persistence random seed (0 = default)
+} csma_tx_config_t;
+
+// Scheduler State
+typedef enum {
+    CSMA_TX_IDLE,               // Nothing queued
+    CSMA_TX_DEFER,              // Waiting for a clear slot that wins the persistence draw
+    CSMA_TX_KEYUP,              // PTT on, TXDELAY running
+    CSMA_TX_SENDING,            // Burst on the air
+    CSMA_TX_TAIL                // TXTAIL running
+} csma_tx_state_t;
+
+// Scheduler Statistics
+typedef struct {
+    uint64_t frames;            // Frames sent
+    uint64_t bytes;             // Frame bytes sent
+    uint64_t keyups;            // Transmissions
+    uint64_t dropped;           // Frames refused because their queue was full
+    uint64_t busy_slots;        // Slots deferred for carrier detect
+    uint64_t persist_slots;     // Clear slots lost to the persistence draw
+    uint64_t keyed_ms;          // Time PTT was asserted
+    uint64_t overhead_ms;       // Part of keyed_ms spent in TXDELAY and TXTAIL
+} csma_tx_stats_t;
+
+typedef struct csma_tx csma_tx_t;
+
+// Scheduler Functions
+csma_tx_t* csma_tx_create(const csma_tx_config_t* config, uint16_t depth);
+void csma_tx_destroy(csma_tx_t* tx);
+void csma_tx_config_init(csma_tx_config_t* config);
+// Take TXDELAY, persistence, slot time, TXTAIL and duplex from TNC settings
+void csma_tx_config_from_kiss(csma_tx_config_t* config, const kiss_config_t* kiss);
+void csma_tx_config_from_ax25(csma_tx_config_t* config, const ax25_config_t* ax25);
+// Applies from the next contention; a burst on the air is not affected
+int csma_tx_set_config(csma_tx_t* tx, const csma_tx_config_t* config);
+int csma_tx_set_handlers(csma_tx_t* tx, csma_tx_handler_t handler,
+                         csma_tx_ptt_handler_t ptt, void* ctx);
+
+// Queueing
+int csma_tx_enqueue(csma_tx_t* tx, uint8_t priority, const uint8_t* data, uint16_t length);
+int csma_tx_enqueue_iov(csma_tx_t* tx, uint8_t priority, const struct iovec* iov, int iovcnt);
+// ax25_tx_handler_t for ax25_set_tx_handler (ctx is the scheduler); the
+// priority is taken from the frame's control field, lowered if needed to
+// stay behind frames the same link already queued
+int csma_tx_ax25_output(void* ctx, const struct iovec* iov, int iovcnt);
+size_t csma_tx_pending(const csma_tx_t* tx, uint8_t priority);
+
+// Channel Access
+void csma_tx_set_carrier(csma_tx_t* tx, bool busy);
+// Runs the state machine up to now_ms; returns frames sent or -1
+int csma_tx_poll(csma_tx_t* tx, uint64_t now_ms);
+// Time the next poll is due (CSMA_TX_IDLE_EVENT when nothing is queued)
+uint64_t csma_tx_next_event(const csma_tx_t* tx);
+csma_tx_state_t csma_tx_get_state(const csma_tx_t* tx);
+
+// Statistics
+int csma_tx_get_stats(const csma_tx_t* tx, csma_tx_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
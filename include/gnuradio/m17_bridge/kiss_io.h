@@ -0,0 +1,93 @@
+//--------------------------------------------------------------------
+// KISS Link I/O Engine
+//
+// Drives many KISS links (TCP sockets, serial ports, ptys) from one
+// event loop. On Linux with io_uring the engine uses multishot receive
+// into a registered provided-buffer ring and submits each link's queued
+// frames as linked sends, so one io_uring_enter call serves every link.
+// Where io_uring is unavailable (old kernel, seccomp, build without the
+// header) the same API runs on poll() with non-blocking read/writev.
+//
+// An engine is not locked: any thread may create, poll and destroy it,
+// as long as calls on one engine do not overlap.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Engine Constants
+#define KISS_IO_DEFAULT_MAX_LINKS   16
+#define KISS_IO_DEFAULT_TX_BUFFER   65536   // Per-link transmit ring (power of two)
+
+typedef enum {
+    KISS_IO_BACKEND_POSIX,      // poll() + read/writev
+    KISS_IO_BACKEND_URING       // io_uring
+} kiss_io_backend_t;
+
+// Called for every decoded frame. command is the KISS command
+// (KISS_CMD_DATA for data frames, otherwise a parameter or return frame).
+typedef void (*kiss_io_frame_handler_t)(void* ctx, int link_id, const uint8_t* data,
+                                        uint16_t length, uint8_t port, uint8_t command);
+// Called when a link hangs up or fails; the link is closed afterwards
+typedef void (*kiss_io_close_handler_t)(void* ctx, int link_id);
+
+// Engine Configuration
+typedef struct {
+    int max_links;                      // Link table size
+    size_t tx_buffer_size;              // Per-link transmit ring, rounded up to a power of two
+    bool force_posix;                   // Do not try io_uring
+    kiss_io_frame_handler_t on_frame;   // Frame handler (may be NULL)
+    kiss_io_close_handler_t on_close;   // Hangup handler (may be NULL)
+    void* ctx;                          // Context passed to the handlers
+} kiss_io_config_t;
+
+// Engine Statistics
+typedef struct {
+    uint64_t syscalls;          // System calls issued by the engine
+    uint32_t frames_in;         // Frames decoded from all links
+    uint32_t frames_out;        // Frames queued on all links
+    uint32_t frames_dropped;    // Frames refused because a ring was full
+    uint64_t bytes_in;          // Bytes received
+    uint64_t bytes_out;         // Bytes written
+} kiss_io_stats_t;
+
+typedef struct kiss_io kiss_io_t;
+
+// Engine Functions
+void kiss_io_default_config(kiss_io_config_t* config);
+kiss_io_t* kiss_io_create(const kiss_io_config_t* config);
+void kiss_io_destroy(kiss_io_t* io);
+kiss_io_backend_t kiss_io_backend(const kiss_io_t* io);
+
+// Link Management
+// Takes ownership of a connected socket or an open tty; returns the link id or -1.
+// The engine sets or clears O_NONBLOCK to suit its backend and restores
+// the original file status flags before it closes the descriptor, since
+// they are shared with any duplicate of it.
+int kiss_io_add_link(kiss_io_t* io, int fd);
+int kiss_io_remove_link(kiss_io_t* io, int link_id);
+
+// Frame Output
+// Frames are queued; the next kiss_io_poll writes them
+int kiss_io_send(kiss_io_t* io, int link_id, const uint8_t* data, uint16_t length, uint8_t port);
+size_t kiss_io_pending(const kiss_io_t* io, int link_id);
+
+// Event Loop
+// Submits queued output, waits up to timeout_ms (-1 = forever) for I/O
+// and handles it; returns frames delivered or -1 on error
+int kiss_io_poll(kiss_io_t* io, int timeout_ms);
+
+// Statistics
+int kiss_io_get_stats(const kiss_io_t* io, kiss_io_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,87 @@
+//--------------------------------------------------------------------
+// Multi-Port KISS Multiplexer
+//
+// Splits one KISS link into its 16 ports. Received frames are routed
+// on the port nibble of the command byte into per-port queues, each
+// optionally drained into its own bridge instance. Outgoing frames are
+// queued per port and interleaved onto the link by deficit round robin,
+// so each port gets link time in proportion to its weight no matter how
+// much the other ports have queued.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "m17_ax25_bridge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multiplexer Constants
+#define KISS_MUX_PORTS          16      // KISS port nibble range
+#define KISS_MUX_DEFAULT_DEPTH  32      // Frames queued per port and direction
+#define KISS_MUX_DEFAULT_WEIGHT 1
+#define KISS_MUX_QUANTUM        256     // Bytes of TX credit per unit of weight per round
+
+// Writes one outgoing frame to the link (e.g. kiss_serial_queue);
+// returns 0, or -1 when the link cannot take it now
+typedef int (*kiss_mux_tx_handler_t)(void* ctx, const uint8_t* data, uint16_t length,
+                                     uint8_t port);
+
+// Per-Port Statistics
+typedef struct {
+    uint32_t rx_frames;         // Frames routed to the port
+    uint32_t rx_dropped;        // Frames lost because the receive queue was full
+    uint32_t rx_errors;         // Frames the attached bridge rejected
+    uint32_t rx_commands;       // Parameter frames (TXDELAY, P, ...) seen and not queued
+    uint32_t tx_frames;         // Frames handed to the link
+    uint32_t tx_dropped;        // Frames refused because the transmit queue was full
+    uint64_t rx_bytes;          // Payload bytes routed to the port
+    uint64_t tx_bytes;          // Payload bytes handed to the link
+} kiss_mux_port_stats_t;
+
+typedef struct kiss_mux kiss_mux_t;
+
+// Multiplexer Functions
+kiss_mux_t* kiss_mux_create(void);
+void kiss_mux_destroy(kiss_mux_t* mux);
+
+// Port Management
+// Frames for ports that are not open are counted and discarded
+int kiss_mux_open_port(kiss_mux_t* mux, uint8_t port, uint16_t weight, uint16_t depth);
+int kiss_mux_close_port(kiss_mux_t* mux, uint8_t port);
+int kiss_mux_set_weight(kiss_mux_t* mux, uint8_t port, uint16_t weight);
+// Received frames go to the bridge and its KISS output is queued on the
+// port (NULL detaches); the bridge must outlive the attachment
+int kiss_mux_attach_bridge(kiss_mux_t* mux, uint8_t port, m17_ax25_bridge_t* bridge);
+
+// Receive Path
+// Decodes bytes read from the link; only data frames are queued, other
+// commands are counted per port. Returns frames decoded or -1
+int kiss_mux_input(kiss_mux_t* mux, const uint8_t* data, size_t length);
+// Pops the oldest frame of a port without a bridge; *length is the buffer size on entry
+int kiss_mux_receive(kiss_mux_t* mux, uint8_t port, uint8_t* data, uint16_t* length);
+// Hands up to max_frames queued frames to the attached bridges, one
+// port at a time in turn; returns frames delivered
+int kiss_mux_dispatch(kiss_mux_t* mux, int max_frames);
+
+// Transmit Path
+int kiss_mux_send(kiss_mux_t* mux, uint8_t port, const uint8_t* data, uint16_t length);
+size_t kiss_mux_pending(const kiss_mux_t* mux, uint8_t port);
+// Writes queued frames in weighted round-robin order until the queues are
+// empty, max_bytes of payload have gone out (0 = no limit) or the handler
+// refuses a frame; returns frames written or -1
+int kiss_mux_transmit(kiss_mux_t* mux, kiss_mux_tx_handler_t handler, void* ctx,
+                      size_t max_bytes);
+
+// Statistics
+uint32_t kiss_mux_unrouted(const kiss_mux_t* mux);
+int kiss_mux_get_port_stats(const kiss_mux_t* mux, uint8_t port, kiss_mux_port_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,10 @@ extern "C" {
 #define KISS_CMD_SETHARD 0x06    // Set Hardware
 #define KISS_CMD_RETURN  0xFF    // Return
 
+// KISS Receive Queue
+#define KISS_RX_SLOTS         8       // Frames queued between receive calls
+#define KISS_MAX_FRAME_LEN    1024    // Unescaped frame capacity per slot
+
 // KISS Frame Structure
 typedef struct {
     uint8_t* data;          // Frame data
@@ -42,12 +47,44 @@ typedef struct {
     bool escaped;           // Escape sequence flag
 } kiss_frame_t;
 
+// KISS Scatter-Gather Frame
+// Escaped KISS frame as an iovec list: runs of payload bytes are referenced
+// in place and each FEND/FESC is replaced by a static two-byte escape.
+#define KISS_IOV_MAX 64
+
+typedef struct {
+    struct iovec iov[KISS_IOV_MAX];
+    int count;
+    uint8_t head[3];        // FEND + command byte (escaped if needed)
+} kiss_iov_t;
+
+// KISS Receive Slot
+// Frames are unescaped straight into a slot while bytes arrive
+typedef struct {
+    uint8_t data[KISS_MAX_FRAME_LEN];
+    uint16_t length;
+    uint8_t command;
+    uint8_t port;
+} kiss_rx_slot_t;
+
+// Receives queued frames in place; the slot is released when it returns
+typedef void (*kiss_frame_handler_t)(void* ctx, const uint8_t* data, uint16_t length,
+                                     uint8_t port);
+// Receives each frame from kiss_decode_frames, command byte included;
+// the slot is released when it returns
+typedef void (*kiss_rx_handler_t)(void* ctx, const kiss_rx_slot_t* frame);
+
+// Takes over frame output from the serial/TCP interface; receives the
+// unescaped payload segments and returns 0 or -1
+typedef int (*kiss_tx_handler_t)(void* ctx, const struct iovec* iov, int iovcnt, uint8_t port);
+
 // KISS TNC State
 typedef enum {
     KISS_STATE_IDLE,
     KISS_STATE_FEND,
     KISS_STATE_DATA,
-    KISS_STATE_ESCAPE
+    KISS_STATE_ESCAPE,
+    KISS_STATE_CMD_ESCAPE   // Escaped command byte (port 12 data/0xDB)
 } kiss_state_t;
 
 // KISS TNC Configuration
@@ -64,12 +101,16 @@ typedef struct {
 typedef struct {
     kiss_state_t state;
     kiss_config_t config;
-    uint8_t buffer[1024];   // Receive buffer
-    uint16_t buffer_pos;
-    kiss_frame_t current_frame;
-    bool frame_ready;
+    kiss_rx_slot_t rx_slots[KISS_RX_SLOTS];  // Completed frames, oldest at rx_head
+    uint8_t rx_head;
+    uint8_t rx_count;
+    kiss_rx_slot_t* rx_frame;               // Slot being filled (NULL = queue full)
+    uint16_t buffer_pos;                    // Bytes received for the current frame
+    uint32_t rx_dropped;                    // Frames dropped because the queue was full
     int serial_fd;          // File descriptor for USB CDC serial
     int tcp_socket;         // Socket descriptor for TCP interface
+    kiss_tx_handler_t tx_handler;           // Frame output override (NULL = serial/TCP)
+    void* tx_ctx;                           // Context passed to tx_handler
 } kiss_tnc_t;
 
 // KISS Protocol Functions
@@ -77,26 +118,44 @@ int kiss_init(kiss_tnc_t* tnc);
 int kiss_cleanup(kiss_tnc_t* tnc);
 int kiss_set_config(kiss_tnc_t* tnc, const kiss_config_t* config);
 int kiss_get_config(const kiss_tnc_t* tnc, kiss_config_t* config);
+int kiss_set_tx_handler(kiss_tnc_t* tnc, kiss_tx_handler_t handler, void* ctx);
 
 // Frame Processing
 int kiss_send_frame(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length, uint8_t port);
 int kiss_receive_frame(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length, uint8_t* port);
 int kiss_process_byte(kiss_tnc_t* tnc, uint8_t byte);
+int kiss_process_buffer(kiss_tnc_t* tnc, const uint8_t* data, size_t length);
 int kiss_frame_ready(const kiss_tnc_t* tnc);
+int kiss_receive_frames(kiss_tnc_t* tnc, kiss_frame_handler_t handler, void* ctx, int max_frames);
+// Decodes received bytes and hands over each frame as it completes, so
+// the receive queue never fills however short the frames are
+int kiss_decode_frames(kiss_tnc_t* tnc, const uint8_t* data, size_t length,
+                       kiss_rx_handler_t handler, void* ctx);
+
+// Scatter-Gather Frame Processing
+// Payload segments are referenced, not copied; they must outlive the frame
+int kiss_encode_iov(const struct iovec* in, int in_count, uint8_t port, uint8_t command,
+                    kiss_iov_t* out);
+int kiss_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt, uint8_t port);
 
 // USB Serial Interface (Primary interface for current hardware)
 int kiss_serial_send(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length);
 int kiss_serial_receive(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length);
+int kiss_serial_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt);
 
 // TCP/IP Interface
 int kiss_tcp_send(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length);
 int kiss_tcp_receive(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length);
+int kiss_tcp_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt);
 
 // Bluetooth Interface (FUTURE FEATURE - not available on current hardware)
 int kiss_bt_send(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length);
 int kiss_bt_receive(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length);
 
 // Utility Functions
+// Worst-case encoded size of a data frame: FEND, escaped command, escaped data, FEND
+#define KISS_ENCODED_MAX(len)  (2 * (size_t)(len) + 4)
+int kiss_encode_frame(const uint8_t* data, uint16_t length, uint8_t port, uint8_t* out);
 int kiss_escape_data(const uint8_t* input, uint16_t input_len, uint8_t* output, uint16_t* output_len);
 int kiss_unescape_data(const uint8_t* input, uint16_t input_len, uint8_t* output, uint16_t* output_len);
 int kiss_validate_frame(const kiss_frame_t* frame);
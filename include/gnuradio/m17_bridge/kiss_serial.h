@@ -0,0 +1,82 @@
+//--------------------------------------------------------------------
+// KISS Serial Port
+//
+// Non-blocking KISS serial backend. Outgoing frames are encoded into a
+// transmit ring and written by the event loop, so every frame queued
+// since the last write leaves in a single writev. Incoming bytes are
+// read in large blocks and fed to the bulk KISS decoder.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include "kiss_protocol.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Serial Constants
+#define KISS_SERIAL_DEFAULT_BAUD       115200
+#define KISS_SERIAL_DEFAULT_TX_BUFFER  65536   // Transmit ring size (power of two)
+
+// Called for every decoded frame. command is the KISS command
+// (KISS_CMD_DATA for data frames, otherwise a parameter or return frame).
+typedef void (*kiss_serial_frame_handler_t)(void* ctx, const uint8_t* data, uint16_t length,
+                                            uint8_t port, uint8_t command);
+
+// Serial Port Configuration
+typedef struct {
+    uint32_t baud_rate;                 // Line speed (0 = keep the current speed)
+    size_t tx_buffer_size;              // Transmit ring size, rounded up to a power of two
+    kiss_serial_frame_handler_t on_frame; // Receives decoded frames (may be NULL)
+    void* ctx;                          // Context passed to on_frame
+} kiss_serial_config_t;
+
+// Serial Port Statistics
+typedef struct {
+    uint32_t frames_in;         // Frames decoded from the port
+    uint32_t frames_out;        // Frames queued for transmission
+    uint32_t frames_dropped;    // Frames refused because the ring was full
+    uint32_t writes;            // writev calls that wrote data
+    uint32_t reads;             // read calls that returned data
+    uint64_t bytes_out;         // Bytes written to the port
+    uint64_t bytes_in;          // Bytes read from the port
+} kiss_serial_stats_t;
+
+typedef struct kiss_serial kiss_serial_t;
+
+// Port Functions
+void kiss_serial_default_config(kiss_serial_config_t* config);
+kiss_serial_t* kiss_serial_open(const char* device, const kiss_serial_config_t* config);
+// Takes ownership of an open descriptor (e.g. a pty); line settings are not changed
+kiss_serial_t* kiss_serial_attach(int fd, const kiss_serial_config_t* config);
+void kiss_serial_close(kiss_serial_t* serial);
+int kiss_serial_fd(const kiss_serial_t* serial);
+
+// Transmit
+// Frames are only queued; the event loop (or kiss_serial_flush) writes them
+int kiss_serial_queue(kiss_serial_t* serial, const uint8_t* data, uint16_t length, uint8_t port);
+// Writes as much of the ring as the port accepts; returns bytes still pending or -1
+int kiss_serial_flush(kiss_serial_t* serial);
+size_t kiss_serial_pending(const kiss_serial_t* serial);
+
+// Receive
+// Reads until the port is drained; returns frames delivered or -1 on error/hangup
+int kiss_serial_read(kiss_serial_t* serial);
+
+// Event Loop
+// Waits up to timeout_ms (-1 = forever) for the port, then reads and
+// writes as it allows; returns frames delivered or -1 on error
+int kiss_serial_poll(kiss_serial_t* serial, int timeout_ms);
+
+// Statistics
+int kiss_serial_get_stats(const kiss_serial_t* serial, kiss_serial_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
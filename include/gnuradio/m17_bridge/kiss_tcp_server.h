@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------
+// KISS-over-TCP Server
+//
+// Multi-client KISS TCP server (Dire Wolf style, port 8001) driven by
+// a single epoll loop. Frames broadcast to clients are encoded once
+// into a shared, reference-counted buffer; each client has a bounded
+// output queue and slow clients lose frames instead of stalling others.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Server Constants
+#define KISS_TCP_DEFAULT_PORT          8001
+#define KISS_TCP_DEFAULT_MAX_CLIENTS   256
+#define KISS_TCP_DEFAULT_QUEUE_BYTES   65536   // Per-client output limit
+#define KISS_TCP_CLIENT_QUEUE_LEN      128     // Per-client queued frames
+
+// Called for every frame a client sends; client_id identifies the sender
+// until it disconnects. command is the KISS command (KISS_CMD_DATA for
+// data frames, otherwise a parameter such as KISS_CMD_TXDELAY).
+typedef void (*kiss_tcp_frame_handler_t)(void* ctx, int client_id, const uint8_t* data,
+                                         uint16_t length, uint8_t port, uint8_t command);
+
+// Server Configuration
+typedef struct {
+    const char* bind_address;           // IPv4 address to listen on (NULL = any)
+    uint16_t port;                      // TCP port (0 = ephemeral)
+    int max_clients;                    // Further connections are refused
+    size_t max_queued_bytes;            // Per-client output queue limit
+    bool relay_clients;                 // Forward client data frames to the other clients
+    kiss_tcp_frame_handler_t on_frame;  // Frame handler (may be NULL)
+    void* ctx;                          // Context passed to on_frame
+} kiss_tcp_server_config_t;
+
+// Server Statistics
+typedef struct {
+    uint32_t clients;           // Currently connected clients
+    uint32_t accepted;          // Connections accepted
+    uint32_t rejected;          // Connections refused (client limit)
+    uint32_t accept_pauses;     // Times accepting stopped for lack of descriptors
+    uint32_t frames_in;         // Frames received from clients
+    uint32_t frames_out;        // Frames queued to clients
+    uint32_t frames_dropped;    // Frames dropped by back-pressure
+    uint64_t bytes_out;         // Bytes written to clients
+} kiss_tcp_server_stats_t;
+
+typedef struct kiss_tcp_server kiss_tcp_server_t;
+
+// Server Functions
+void kiss_tcp_server_default_config(kiss_tcp_server_config_t* config);
+kiss_tcp_server_t* kiss_tcp_server_create(const kiss_tcp_server_config_t* config);
+void kiss_tcp_server_destroy(kiss_tcp_server_t* server);
+uint16_t kiss_tcp_server_port(const kiss_tcp_server_t* server);
+
+// Event Loop
+// Waits up to timeout_ms (-1 = forever) and handles all ready events;
+// returns the number of events handled or -1 on error
+int kiss_tcp_server_poll(kiss_tcp_server_t* server, int timeout_ms);
+
+// Frame Output
+int kiss_tcp_server_broadcast(kiss_tcp_server_t* server, const uint8_t* data, uint16_t length,
+                              uint8_t port);
+int kiss_tcp_server_send(kiss_tcp_server_t* server, int client_id, const uint8_t* data,
+                         uint16_t length, uint8_t port);
+
+// Statistics
+int kiss_tcp_server_get_stats(const kiss_tcp_server_t* server, kiss_tcp_server_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
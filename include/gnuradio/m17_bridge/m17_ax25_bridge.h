@@ -17,6 +17,9 @@
 #include "ax25_protocol.h"
 #include "fx25_protocol.h"
 #include "il2p_protocol.h"
+#include "m17_callsign.h"
+#include "m17_packet.h"
+#include "m17_lich.h"
 
 // Debug logging macros
 #ifdef DEBUG
@@ -49,6 +52,33 @@ typedef struct {
     uint16_t length;
 } m17_frame_t;
 
+// M17 LSF Layout (offsets into a bridge frame: 2 marker bytes + frame type)
+#define M17_LSF_OFFSET      3
+#define M17_LSF_DST_OFFSET  (M17_LSF_OFFSET)
+#define M17_LSF_SRC_OFFSET  (M17_LSF_OFFSET + M17_ADDR_LEN)
+#define M17_LSF_LEN         30
+#define M17_BRIDGE_LSF_LEN  (M17_LSF_OFFSET + M17_LSF_LEN)
+
+// M17 Bridge Frame Types (byte after the 0x5D 0x5F marker)
+#define M17_FRAME_TYPE_LSF     0x00
+#define M17_FRAME_TYPE_STREAM  0x01
+#define M17_FRAME_TYPE_PACKET  0x02
+
+// M17 Stream Frame Layout: marker, frame type, coded LICH, frame number
+// (top bit marks the last frame) and 16-byte payload
+#define M17_STREAM_LICH_OFFSET   3
+#define M17_STREAM_FN_OFFSET     (M17_STREAM_LICH_OFFSET + M17_LICH_CODED_BYTES)
+#define M17_STREAM_PAYLOAD_OFFSET (M17_STREAM_FN_OFFSET + 2)
+#define M17_BRIDGE_STREAM_LEN    (M17_STREAM_PAYLOAD_OFFSET + 16)
+#define M17_STREAM_FN_EOS        0x80
+
+// M17 Packet Frame Layout: marker, frame type, chunk and metadata byte
+#define M17_PACKET_FRAME_OFFSET  3
+#define M17_BRIDGE_PACKET_LEN    (M17_PACKET_FRAME_OFFSET + M17_PACKET_FRAME_LEN)
+// Largest output of m17_ax25_bridge_packet_to_ax25: an aggregated packet
+// of minimum-size frames gains flags and FCS on each
+#define M17_BRIDGE_PACKET_AX25_MAX  1024
+
 // M17 Packet Types
 #define M17_PACKET_TYPE_DATA  0
 #define M17_PACKET_TYPE_APRS  1
@@ -116,6 +146,7 @@ typedef struct {
     ax25_tnc_t ax25_tnc;
     m17_ax25_mapping_t mappings[16];
     uint8_t num_mappings;
+    m17_lsf_cache_t lsf_cache;      // LSFs of incoming streams, from their LICH
     bridge_event_handler_t event_handler;
     bool event_handler_registered;
     bool debug_enabled;
@@ -144,6 +175,11 @@ int m17_ax25_bridge_convert_m17_lsf_to_aprs(m17_ax25_bridge_t* bridge, const uin
                                            uint8_t* ax25_data, uint16_t* ax25_length);
 int m17_ax25_bridge_convert_m17_packet_to_ax25(m17_ax25_bridge_t* bridge, const uint8_t* m17_data, uint16_t m17_length,
                                               uint8_t* ax25_data, uint16_t* ax25_length);
+// Flagged AX.25 frames from a reassembled packet: AX.25 packets carry the
+// frame itself, aggregated packets several frames (written back to back),
+// other protocols become the info field of a UI frame
+int m17_ax25_bridge_packet_to_ax25(m17_ax25_bridge_t* bridge, const m17_packet_t* packet,
+                                   uint8_t* ax25_data, uint16_t* ax25_length);
 
 // M17 Processing Functions
 int m17_ax25_bridge_process_m17_tx(m17_ax25_bridge_t* bridge, const uint8_t* data, uint16_t length);
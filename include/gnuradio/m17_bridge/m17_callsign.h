@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------
+// M17 Base-40 Callsign Codec
+//
+// Lookup-table driven encoder/decoder for the 6-byte base-40
+// addresses carried in M17 Link Setup Frames
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// M17 Address Constants
+#define M17_ADDR_LEN            6                   // Encoded address length (bytes)
+#define M17_CALLSIGN_MAX_LEN    9                   // Maximum callsign length (characters)
+#define M17_CALLSIGN_BUF_LEN    (M17_CALLSIGN_MAX_LEN + 1)
+#define M17_ADDR_MAX_BASE40     262143999999999ULL  // 40^9 - 1
+#define M17_ADDR_BROADCAST      0xFFFFFFFFFFFFULL   // Broadcast address
+#define M17_CALLSIGN_BROADCAST  "@ALL"              // Broadcast callsign
+
+// Single Address Functions
+int m17_callsign_encode(const char* callsign, uint8_t addr[M17_ADDR_LEN]);
+int m17_callsign_decode(const uint8_t addr[M17_ADDR_LEN], char callsign[M17_CALLSIGN_BUF_LEN]);
+
+// Numeric Address Functions (48-bit value, no byte packing)
+int m17_callsign_to_value(const char* callsign, uint64_t* value);
+int m17_callsign_from_value(uint64_t value, char callsign[M17_CALLSIGN_BUF_LEN]);
+
+// Batch Functions
+// Return the number of entries that failed to convert; failed entries are
+// left zeroed (encode) or empty (decode).
+size_t m17_callsign_encode_batch(const char* const* callsigns, uint8_t (*addrs)[M17_ADDR_LEN],
+                                 size_t count);
+size_t m17_callsign_decode_batch(const uint8_t (*addrs)[M17_ADDR_LEN],
+                                 char (*callsigns)[M17_CALLSIGN_BUF_LEN], size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------
+// M17 Channel Encoder
+//
+// Turns LSF, stream and packet frame payloads into the 192 dibits of an
+// M17 frame: sync word, then the payload convolutionally coded,
+// punctured, interleaved with the 368-bit quadratic permutation and
+// XORed with the randomiser sequence. The encoder codes eight input bits
+// per table lookup; puncturing and interleaving are one precomputed
+// gather per frame type, and the sync word and randomiser are a single
+// precomputed mask applied 16 dibits at a time.
+//
+// Dibits are 0..3 (first bit in bit 1) and map to 4FSK symbols
+// 0 -> +1, 1 -> +3, 2 -> -1, 3 -> -3.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "m17_lich.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sync Words
+#define M17_SYNC_LSF           0x55F7
+#define M17_SYNC_STREAM        0xFF5D
+#define M17_SYNC_PACKET        0x75FF
+#define M17_SYNC_BERT          0xDF55
+#define M17_SYNC_EOT           0x555D
+
+// Frame Sizes
+#define M17_FRAME_SYMBOLS      192     // 40 ms at 4800 symbols/s
+#define M17_SYNC_SYMBOLS       8
+#define M17_PAYLOAD_SYMBOLS    (M17_FRAME_SYMBOLS - M17_SYNC_SYMBOLS)
+#define M17_FRAME_CODED_BITS   368     // Interleaved and randomised bits after the sync word
+
+// Dibit to 4FSK symbol, indexed by dibit
+#define M17_DIBIT_SYMBOLS      { 1, 3, -1, -3 }
+
+// Encodes the 30-byte link setup frame
+int m17_encode_lsf(const uint8_t* lsf, uint8_t* dibits);
+
+// Encodes a stream frame: the coded LICH from m17_lich_encode and the
+// 18-byte frame number and payload
+int m17_encode_stream(const uint8_t* lich, const uint8_t* frame, uint8_t* dibits);
+
+// Encodes a packet frame: 25-byte chunk and the metadata byte (top six
+// bits used)
+int m17_encode_packet(const uint8_t* frame, uint8_t* dibits);
+
+// Preamble ahead of an LSF (+3, -3 alternating) and the end of
+// transmission frame (the EOT word repeated)
+void m17_encode_preamble(uint8_t* dibits);
+void m17_encode_eot(uint8_t* dibits);
+
+// Maps dibits to 4FSK symbol levels
+void m17_dibits_to_symbols(const uint8_t* dibits, size_t count, float* symbols);
+
+// Receive side: undoes the randomiser and interleaver on the 368 soft
+// bits after the sync word (one byte per bit, 255 = certain 1), giving
+// the punctured coded bits for m17_viterbi_decode, behind the 96 LICH
+// bits in a stream frame
+int m17_deinterleave_soft(const uint8_t* soft, uint8_t* coded);
+
+#ifdef __cplusplus
+}
+#endif
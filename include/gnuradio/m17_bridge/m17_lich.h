@@ -0,0 +1,109 @@
+//--------------------------------------------------------------------
+// M17 LICH: Golay(24,12) Coding and LSF Reassembly
+//
+// Stream frames carry the link setup frame a piece at a time in the
+// Link Information Channel: each frame holds one 48-bit chunk (40 LSF
+// bits, a 3-bit counter 0..5 and 5 reserved bits) as four extended
+// Golay(24,12) codewords. Six frames make a superframe with the whole
+// LSF.
+//
+// The Golay decoder looks the 12-bit syndrome up in a table of every
+// error pattern of up to three bits; four-bit errors are detected.
+//
+// The LSF cache collects chunks per stream, keyed by the caller, and
+// checks the CRC once all six counters are in. After that each LICH is
+// first compared with the coded chunk the counter sequence predicts and
+// only Golay-decoded when it differs by more than a few bits; a chunk
+// that decodes to something else means a new LSF and starts over.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LICH Layout
+#define M17_LICH_CHUNK_LEN       6       // LSF bytes, then counter and reserved bits
+#define M17_LICH_LSF_BYTES       5       // LSF bytes per chunk
+#define M17_LICH_CHUNKS          6       // Chunks per LSF
+#define M17_LICH_COUNTER_SHIFT   5
+#define M17_LICH_CODED_BYTES     12      // Four Golay(24,12) codewords
+#define M17_LICH_LSF_LEN         (M17_LICH_CHUNKS * M17_LICH_LSF_BYTES)
+
+// LSF Cache Defaults
+#define M17_LSF_CACHE_SLOTS       4
+#define M17_LSF_CACHE_TIMEOUT_MS  1000   // Longest gap between frames of a stream
+#define M17_LSF_CACHE_MATCH_BITS  3      // Bit errors accepted without decoding
+
+// m17_lsf_cache_push Results
+#define M17_LSF_CACHE_PENDING     0      // Chunks still missing
+#define M17_LSF_CACHE_COMPLETE    1      // LSF just assembled
+#define M17_LSF_CACHE_CONFIRMED   2      // Chunk matches the known LSF
+
+// LSF Cache Statistics
+typedef struct {
+    uint32_t chunks;            // LICH chunks pushed
+    uint32_t corrected_bits;    // Bit errors fixed by the Golay decoder
+    uint32_t rejected;          // Chunks beyond repair or with a bad counter
+    uint32_t lsfs;              // LSFs assembled with a good CRC
+    uint32_t crc_errors;        // Complete sets of chunks failing the CRC
+    uint32_t confirmed;         // Chunks matching a known LSF
+    uint32_t fast_matches;      // Of those, confirmed without Golay decoding
+    uint32_t changes;           // Known LSFs replaced by a different one
+    uint32_t timeouts;          // Streams dropped after the timeout
+    uint32_t evictions;         // Streams dropped to free a slot
+} m17_lsf_cache_stats_t;
+
+// LSF of one stream
+typedef struct {
+    uint64_t key;               // Stream identity chosen by the caller
+    uint64_t last_ms;           // Time of the last chunk
+    uint8_t received;           // Bit n set once chunk n is in
+    uint8_t next_counter;       // Counter the next frame should carry
+    bool known;                 // Assembled and CRC-checked
+    bool active;
+    uint8_t lsf[M17_LICH_LSF_LEN];
+    uint8_t coded[M17_LICH_CHUNKS][M17_LICH_CODED_BYTES];  // Expected LICH per counter, once known
+} m17_lsf_cache_slot_t;
+
+typedef struct {
+    m17_lsf_cache_slot_t slots[M17_LSF_CACHE_SLOTS];
+    uint32_t timeout_ms;
+    m17_lsf_cache_stats_t stats;
+} m17_lsf_cache_t;
+
+// Golay(24,12): 12 data bits above 12 parity bits
+uint32_t m17_golay_encode(uint16_t data);
+// Returns the number of bits corrected (0..3) with the data in *data, or
+// -1 if the codeword is beyond repair
+int m17_golay_decode(uint32_t codeword, uint16_t* data);
+
+// LICH chunk counter of the 30-byte LSF, Golay-coded
+int m17_lich_encode(const uint8_t* lsf, uint8_t counter, uint8_t* coded);
+// Decodes a coded LICH into its 6-byte chunk; returns the bits corrected
+// or -1
+int m17_lich_decode(const uint8_t* coded, uint8_t* chunk);
+
+// LSF Cache
+int m17_lsf_cache_init(m17_lsf_cache_t* cache, uint32_t timeout_ms);
+// Feeds the coded LICH of a stream frame. Returns M17_LSF_CACHE_COMPLETE
+// or M17_LSF_CACHE_CONFIRMED with the LSF in lsf, M17_LSF_CACHE_PENDING,
+// or -1 if the LICH was rejected.
+int m17_lsf_cache_push(m17_lsf_cache_t* cache, uint64_t key, const uint8_t* coded,
+                       uint64_t now_ms, uint8_t* lsf);
+// Marks the LSF of a stream as known, e.g. from the LSF frame opening it
+int m17_lsf_cache_seed(m17_lsf_cache_t* cache, uint64_t key, const uint8_t* lsf,
+                       uint64_t now_ms);
+// Forgets a stream once it has ended
+int m17_lsf_cache_end(m17_lsf_cache_t* cache, uint64_t key);
+int m17_lsf_cache_get_stats(const m17_lsf_cache_t* cache, m17_lsf_cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,158 @@
+//--------------------------------------------------------------------
+// M17 Packet Mode Segmentation and Reassembly
+//
+// A packet superframe is one protocol byte, up to 822 bytes of data and
+// the M17 CRC (polynomial 0x5935, initial value 0xFFFF, big-endian).
+// It is carried in 25-byte chunks, each followed by a metadata byte:
+// bit 7 marks the last frame, and bits 6..2 hold the frame counter, or
+// in the last frame the number of chunk bytes in use (1..25).
+//
+// The reassembler rebuilds superframes from several interleaved
+// senders in a fixed set of slots allocated up front. A slot whose
+// sender has gone quiet for longer than the timeout is reclaimed; when
+// every slot is busy the least recently fed one is given up.
+//
+// Small frames for the same destination can be aggregated: each frame
+// goes into a container behind a two-byte big-endian length, and the
+// container is sent as one packet once the batching window closes or it
+// is full, so the preamble, LSF and EOT are paid once for all of them.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Packet Mode Constants
+#define M17_PACKET_CHUNK_LEN       25      // Superframe bytes per frame
+#define M17_PACKET_FRAME_LEN       26      // Chunk plus metadata byte
+#define M17_PACKET_MAX_FRAMES      33
+#define M17_PACKET_MAX_SUPERFRAME  (M17_PACKET_MAX_FRAMES * M17_PACKET_CHUNK_LEN)
+#define M17_PACKET_MAX_DATA        (M17_PACKET_MAX_SUPERFRAME - 3)  // Less protocol byte and CRC
+#define M17_PACKET_META_EOF        0x80
+#define M17_PACKET_META_SHIFT      2
+#define M17_PACKET_META_MASK       0x1F
+
+// Packet Protocol Identifiers
+#define M17_PACKET_PROTO_RAW       0x00
+#define M17_PACKET_PROTO_AX25      0x01    // AX.25 frame, addresses through info, no FCS
+#define M17_PACKET_PROTO_APRS      0x02
+#define M17_PACKET_PROTO_SMS       0x05
+#define M17_PACKET_PROTO_AX25_BATCH 0x81   // Bridge-local: length-prefixed AX.25 frames
+
+// Airtime (4800 symbols/s, 40 ms per frame)
+#define M17_FRAME_MS                40
+#define M17_PACKET_OVERHEAD_FRAMES  3       // Preamble, LSF and EOT
+
+// Reassembler Defaults
+#define M17_PACKET_REASM_SLOTS       8
+#define M17_PACKET_REASM_TIMEOUT_MS  1000  // Longest gap between frames of a packet
+
+// Reassembled Packet
+typedef struct {
+    uint8_t protocol;
+    uint16_t length;                        // Data bytes (protocol byte and CRC removed)
+    uint8_t data[M17_PACKET_MAX_DATA];
+} m17_packet_t;
+
+// Reassembler Statistics
+typedef struct {
+    uint32_t frames;            // Frames pushed
+    uint32_t packets;           // Superframes completed with a good CRC
+    uint32_t crc_errors;        // Superframes discarded for a bad CRC
+    uint32_t sequence_errors;   // Frames out of order, or with no packet start
+    uint32_t timeouts;          // Partial packets dropped after the timeout
+    uint32_t evictions;         // Partial packets dropped to free a slot
+} m17_packet_stats_t;
+
+// Partial superframe of one sender
+typedef struct {
+    uint64_t key;               // Sender identity chosen by the caller
+    uint64_t last_ms;           // Time of the last frame
+    uint16_t length;            // Superframe bytes collected
+    uint8_t next_counter;       // Counter the next frame must carry
+    bool active;
+    uint8_t data[M17_PACKET_MAX_SUPERFRAME];
+} m17_packet_slot_t;
+
+typedef struct {
+    m17_packet_slot_t* slots;
+    uint16_t num_slots;
+    uint32_t timeout_ms;
+    m17_packet_stats_t stats;
+} m17_packet_reasm_t;
+
+// Aggregation Statistics
+typedef struct {
+    uint32_t frames;            // Frames added
+    uint32_t packets;           // Packets flushed
+    uint64_t airtime_ms;        // Airtime of the packets flushed
+    uint64_t airtime_saved_ms;  // Less than one packet per frame would take
+} m17_packet_batch_stats_t;
+
+// Frames waiting to go out as one packet
+typedef struct {
+    uint16_t max_length;        // Container limit, at most M17_PACKET_MAX_DATA
+    uint16_t length;            // Container bytes in use
+    uint16_t count;             // Frames in the container
+    uint64_t opened_ms;         // Time the first frame was added
+    uint32_t separate_ms;       // Airtime the frames would take one packet each
+    m17_packet_batch_stats_t stats;
+    uint8_t data[M17_PACKET_MAX_DATA];
+} m17_packet_batch_t;
+
+// CRC
+uint16_t m17_crc(const uint8_t* data, size_t length);
+
+// Segmentation
+// Number of frames a packet of length data bytes needs (0 if too long)
+int m17_packet_frame_count(uint16_t length);
+// Writes the frames back to back into frames (M17_PACKET_FRAME_LEN each);
+// returns the frame count or -1
+int m17_packet_encode(uint8_t protocol, const uint8_t* data, uint16_t length,
+                      uint8_t* frames, size_t frames_size);
+// On-air time of a packet of length data bytes, overhead included
+uint32_t m17_packet_airtime_ms(uint16_t length);
+
+// Reassembly
+int m17_packet_reasm_init(m17_packet_reasm_t* reasm, uint16_t num_slots, uint32_t timeout_ms);
+void m17_packet_reasm_free(m17_packet_reasm_t* reasm);
+// Feeds one frame from the sender identified by key. Returns 1 with the
+// completed packet in *packet, 0 if more frames are needed, -1 if the
+// frame or the packet it completed was rejected.
+int m17_packet_reasm_push(m17_packet_reasm_t* reasm, uint64_t key,
+                          const uint8_t frame[M17_PACKET_FRAME_LEN], uint64_t now_ms,
+                          m17_packet_t* packet);
+// Drops partial packets idle for longer than the timeout; returns how many
+int m17_packet_reasm_expire(m17_packet_reasm_t* reasm, uint64_t now_ms);
+uint16_t m17_packet_reasm_active(const m17_packet_reasm_t* reasm);
+int m17_packet_reasm_get_stats(const m17_packet_reasm_t* reasm, m17_packet_stats_t* stats);
+
+// Aggregation
+int m17_packet_batch_init(m17_packet_batch_t* batch, uint16_t max_length);
+int m17_packet_batch_set_max_length(m17_packet_batch_t* batch, uint16_t max_length);
+// Adds a frame; returns -1 if it does not fit, in which case flush first
+// (a frame that fits no container has to go on its own)
+int m17_packet_batch_add(m17_packet_batch_t* batch, const uint8_t* frame, uint16_t length,
+                         uint64_t now_ms);
+// True once the oldest frame has waited window_ms
+bool m17_packet_batch_due(const m17_packet_batch_t* batch, uint32_t window_ms, uint64_t now_ms);
+// Encodes the waiting frames as one packet and empties the batch; a lone
+// frame goes as a plain AX.25 packet. Returns the frame count (0 if the
+// batch was empty) or -1.
+int m17_packet_batch_flush(m17_packet_batch_t* batch, uint8_t* frames, size_t frames_size);
+// Walks a container from *offset: returns 1 with the next frame, 0 at
+// the end, -1 if a length runs past the end
+int m17_packet_batch_next(const m17_packet_t* packet, uint16_t* offset,
+                          const uint8_t** frame, uint16_t* length);
+int m17_packet_batch_get_stats(const m17_packet_batch_t* batch, m17_packet_batch_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
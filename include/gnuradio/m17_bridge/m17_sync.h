@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------
+// M17 Sync Word Search
+//
+// Correlates a stream of 4FSK symbols with the LSF, stream, packet and
+// BERT sync words and reports correlation peaks. Correlation runs a
+// block of window positions at a time with VOLK kernels: each sync word
+// symbol adds or subtracts the input shifted by its tap, and the window
+// energy is a running sum of squares. A scalar pass then normalises,
+// picks the best sync word per position and looks for peaks.
+//
+// After a peak the search holds off for a frame, less a couple of
+// symbols so a receiver whose clock slips still finds the next sync.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "m17_encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Search Constants
+#define M17_SYNC_SLIP_SYMBOLS  2       // Timing slip tolerated per frame
+#define M17_SYNC_HOLDOFF       (M17_FRAME_SYMBOLS - 1 - M17_SYNC_SLIP_SYMBOLS)
+#define M17_SYNC_MIN_ENERGY    1e-6f   // Per symbol, squared; quieter windows hold no sync
+
+// Most peaks a search over count positions can report
+#define M17_SYNC_MAX_HITS(count) ((count) / (M17_SYNC_HOLDOFF + 1) + 1)
+
+// Sync Word Types
+typedef enum {
+    M17_SYNC_TYPE_LSF = 0,
+    M17_SYNC_TYPE_STREAM,
+    M17_SYNC_TYPE_PACKET,
+    M17_SYNC_TYPE_BERT,
+    M17_SYNC_TYPES
+} m17_sync_type_t;
+
+// Correlation Peak
+typedef struct {
+    size_t offset;              // Window position, from the start of this search
+    m17_sync_type_t type;       // Sync word found
+    float strength;             // Normalised correlation (0..1)
+} m17_sync_hit_t;
+
+// Search State, carried from one block of symbols to the next
+typedef struct {
+    float signs[M17_SYNC_TYPES][M17_SYNC_SYMBOLS];  // Sync word symbols as +1/-1
+    float previous;             // Best correlation one position back
+    int holdoff;                // Positions left in the frame last reported
+} m17_sync_search_t;
+
+// Search Functions
+void m17_sync_search_init(m17_sync_search_t* search);
+
+// Decides window positions 0..count-1: symbols must hold
+// count + M17_SYNC_SYMBOLS values, the last window only showing whether
+// position count - 1 peaks. The next call continues at symbols + count.
+// Peaks of at least threshold go to hits, which must have room for
+// M17_SYNC_MAX_HITS(count); returns the number of peaks or -1.
+int m17_sync_search(m17_sync_search_t* search, const float* symbols, size_t count,
+                    float threshold, m17_sync_hit_t* hits, size_t max_hits);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------
+// M17 Convolutional Code and Soft-Decision Viterbi Decoder
+//
+// M17 frames are coded with a K=5, rate 1/2 convolutional code
+// (G1 = 0x19, G2 = 0x17), flushed with four zero bits and punctured:
+// P1 for the LSF (46 of 61), P2 for stream frames (11 of 12) and P3 for
+// packet frames (7 of 8). Payload bits are MSB first.
+//
+// The decoder takes one soft bit per byte (0 = certain 0, 255 = certain
+// 1, 128 = no information), re-inserts punctured bits as erasures and
+// runs a 16-state Viterbi with 16-bit saturated path metrics. AVX2 or
+// SSE2 is picked at first use when the CPU has it; all three
+// implementations make the same decisions.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Code Constants
+#define M17_CONV_K             5
+#define M17_CONV_STATES        16
+#define M17_CONV_TAIL_BITS     4       // Zero bits flushing the encoder
+#define M17_SOFT_ERASURE       128
+
+// Payload and Coded Sizes (bits)
+#define M17_LSF_PAYLOAD_BITS     240
+#define M17_STREAM_PAYLOAD_BITS  144     // Frame number and 16-byte payload
+#define M17_PACKET_PAYLOAD_BITS  206     // 25-byte chunk and 6-bit metadata
+#define M17_LSF_CODED_BITS       368
+#define M17_STREAM_CODED_BITS    272
+#define M17_PACKET_CODED_BITS    368
+#define M17_CONV_MAX_BITS        M17_LSF_PAYLOAD_BITS
+
+// Puncture Patterns
+typedef enum {
+    M17_PUNCTURE_NONE = 0,      // Plain rate 1/2
+    M17_PUNCTURE_LSF,           // P1
+    M17_PUNCTURE_STREAM,        // P2
+    M17_PUNCTURE_PACKET         // P3
+} m17_puncture_t;
+
+// Decoder Implementations
+typedef enum {
+    M17_VITERBI_AUTO = 0,       // Best the CPU supports
+    M17_VITERBI_SCALAR,
+    M17_VITERBI_SSE2,
+    M17_VITERBI_AVX2
+} m17_viterbi_impl_t;
+
+// Puncture pattern (1 = coded bit sent) and its length, or NULL
+const uint8_t* m17_conv_puncture_pattern(m17_puncture_t puncture, uint16_t* length);
+
+// Coded bits after puncturing for num_bits payload bits (0 if too long)
+uint16_t m17_conv_coded_bits(m17_puncture_t puncture, uint16_t num_bits);
+
+// Encodes num_bits payload bits (packed, MSB first) into punctured coded
+// bits, one 0/1 value per byte; returns the coded bit count or -1
+int m17_conv_encode(const uint8_t* data, uint16_t num_bits, m17_puncture_t puncture,
+                    uint8_t* coded, size_t coded_size);
+
+// Decodes punctured soft bits into num_bits payload bits (packed, MSB
+// first, trailing bits of the last byte cleared). soft_len must be
+// m17_conv_coded_bits(puncture, num_bits). Returns the path cost, the
+// summed confidence of received bits that disagree with the decoded
+// path (0 for a clean frame, about 128 per hard error), or -1.
+int32_t m17_viterbi_decode(const uint8_t* soft, uint16_t soft_len, m17_puncture_t puncture,
+                           uint8_t* data, uint16_t num_bits);
+
+// Process-wide implementation choice, for tests and benchmarks;
+// returns -1 if the CPU lacks the instructions
+int m17_viterbi_set_impl(m17_viterbi_impl_t impl);
+m17_viterbi_impl_t m17_viterbi_get_impl(void);
+bool m17_viterbi_impl_supported(m17_viterbi_impl_t impl);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_H
+#define INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_H
+
+#include <gnuradio/sync_block.h>
+#include <m17_bridge/api.h>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief M17 4FSK frame sync correlator
+ * \ingroup m17_bridge
+ *
+ * Input is demodulated 4FSK symbols, one float per symbol at any scale
+ * (nominally +3, +1, -1, -3). Every 8-symbol window is correlated with
+ * the LSF, stream, packet and BERT sync words; where the best normalised
+ * correlation peaks at or above the threshold, the first sync symbol is
+ * tagged "m17_sync" with a pair of the sync type ("lsf", "stream",
+ * "packet" or "bert") and the correlation strength (1.0 for a perfect
+ * match). Payload symbols cannot start another frame, so the rest of a
+ * tagged frame is not searched, bar its last two symbols in case the
+ * symbol clock slips.
+ *
+ * Symbols pass through unchanged, delayed by the 8-symbol window so that
+ * each tag lands on its frame's first symbol.
+ */
+class M17_BRIDGE_API sync_correlator : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<sync_correlator> sptr;
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of m17_bridge::sync_correlator.
+     * \param threshold Lowest normalised correlation reported (0..1)
+     */
+    static sptr make(float threshold = 0.9f);
+
+    /*!
+     * \brief Set the detection threshold
+     * \param threshold Lowest normalised correlation reported (0..1)
+     */
+    virtual void set_threshold(float threshold) = 0;
+
+    /*!
+     * \brief Get the detection threshold
+     */
+    virtual float threshold() const = 0;
+
+    /*!
+     * \brief Get the number of sync words found so far
+     */
+    virtual uint64_t syncs_found() const = 0;
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_H */
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------
+// Hierarchical Timer Wheel
+//
+// Protocol timers (AX.25 T1/T2/T3 and the like) for many sessions.
+// Timers are intrusive list nodes kept in one of four 64-slot wheels by
+// how far away they expire; arming and cancelling are O(1), and each
+// tick only looks at the slots that come due. Timers further out are
+// moved to a finer wheel when their slot comes round (at most three
+// times over a timer's life), so per-tick work does not grow with the
+// number of armed timers.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wheel Constants
+#define TIMER_WHEEL_LEVELS      4
+#define TIMER_WHEEL_SLOT_BITS   6
+#define TIMER_WHEEL_SLOTS       (1 << TIMER_WHEEL_SLOT_BITS)
+// Delays beyond the top wheel (2^24 ticks) are re-filed when they come round
+#define TIMER_WHEEL_RANGE       (1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS))
+
+typedef struct timer_wheel_timer timer_wheel_timer_t;
+
+// Called once when the timer expires; the timer may be re-armed from here
+typedef void (*timer_wheel_cb_t)(void* ctx, timer_wheel_timer_t* timer);
+
+// Timer; embed in the owning object and initialise before first use
+struct timer_wheel_timer {
+    timer_wheel_timer_t* next;
+    timer_wheel_timer_t** pprev;    // Link to this node (NULL = not armed)
+    uint64_t expires;               // Tick the timer is due
+    timer_wheel_cb_t callback;
+    void* ctx;                      // Passed to the callback
+};
+
+// Wheel Statistics
+typedef struct {
+    uint64_t ticks;             // Ticks processed
+    uint64_t expired;           // Callbacks run
+    uint64_t cascaded;          // Timers moved to a finer wheel
+} timer_wheel_stats_t;
+
+typedef struct {
+    timer_wheel_timer_t* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS];  // Non-empty slot bitmap per level
+    uint64_t tick;              // Last tick processed
+    uint64_t base_ms;           // Clock time of tick 0
+    uint32_t tick_ms;           // Tick length
+    uint32_t armed;             // Timers in the wheel
+    timer_wheel_stats_t stats;
+} timer_wheel_t;
+
+// Wheel Functions
+// Starts at now_ms with no timers; armed timers are forgotten, not run
+int timer_wheel_init(timer_wheel_t* wheel, uint32_t tick_ms, uint64_t now_ms);
+// Runs every timer due at or before now_ms; returns callbacks run or -1
+int timer_wheel_advance(timer_wheel_t* wheel, uint64_t now_ms);
+uint64_t timer_wheel_now(const timer_wheel_t* wheel);
+int timer_wheel_get_stats(const timer_wheel_t* wheel, timer_wheel_stats_t* stats);
+
+// Timer Functions
+void timer_wheel_timer_init(timer_wheel_timer_t* timer, timer_wheel_cb_t callback, void* ctx);
+// Expires delay_ms from the wheel's current time, rounded up to a whole tick
+// (at least one); an armed timer is moved
+int timer_wheel_arm(timer_wheel_t* wheel, timer_wheel_timer_t* timer, uint32_t delay_ms);
+void timer_wheel_cancel(timer_wheel_t* wheel, timer_wheel_timer_t* timer);
+bool timer_wheel_armed(const timer_wheel_timer_t* timer);
+
+// Monotonic clock in milliseconds
+uint64_t timer_wheel_clock_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_VITERBI_DECODER_H
+#define INCLUDED_M17_BRIDGE_VITERBI_DECODER_H
+
+#include <gnuradio/sync_block.h>
+#include <m17_bridge/api.h>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Soft-decision Viterbi decoder for M17 frames
+ * \ingroup m17_bridge
+ *
+ * Each input item is one frame's punctured, de-interleaved and
+ * de-randomized coded bits as soft values (one byte per bit, 0 = certain
+ * 0, 255 = certain 1, 128 = erased): 368 for LSF and packet frames, 272
+ * for stream frames. Each output item is the decoded payload, packed MSB
+ * first: 30 bytes for the LSF, 18 for a stream frame (frame number and
+ * payload) and 26 for a packet frame (chunk and metadata in the top six
+ * bits of the last byte).
+ *
+ * Every output item carries a "viterbi_cost" tag: 0 for a clean frame,
+ * about 128 per corrected hard bit error.
+ */
+class M17_BRIDGE_API viterbi_decoder : virtual public gr::sync_block
+{
+public:
+    typedef std::shared_ptr<viterbi_decoder> sptr;
+
+    //! Frame types, selecting the puncture pattern and frame sizes
+    enum frame_type_t { FRAME_LSF = 0, FRAME_STREAM = 1, FRAME_PACKET = 2 };
+
+    /*!
+     * \brief Return a shared_ptr to a new instance of m17_bridge::viterbi_decoder.
+     * \param frame_type LSF (P1), stream (P2) or packet (P3) frames
+     */
+    static sptr make(int frame_type = FRAME_LSF);
+
+    /*!
+     * \brief Get the number of soft bits in each input item
+     */
+    virtual int coded_bits() const = 0;
+
+    /*!
+     * \brief Get the number of bytes in each output item
+     */
+    virtual int payload_bytes() const = 0;
+
+    /*!
+     * \brief Get the path cost of the last frame decoded
+     */
+    virtual int last_cost() const = 0;
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_VITERBI_DECODER_H */
@@ -0,0 +1,677 @@
+//--------------------------------------------------------------------
+// AX.25 Connected Mode
+//
+// Data link state machine for connected-mode sessions, driven by
+// received frames and the T1/T2/T3 timer wheel. SABM links use modulo 8
+// sequence numbers and go-back-N recovery (REJ); SABME links use modulo
+// 128, windows up to 127 frames and selective reject (SREJ), holding
+// out-of-sequence frames until the gap is filled.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "ax25_protocol.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Session owning an embedded timer
+#define AX25_SESSION_OF(timer, member) \
+    ((ax25_connection_t*)((char*)(timer) - offsetof(ax25_connection_t, member)))
+
+static void ax25_t1_expired(void* ctx, timer_wheel_timer_t* timer);
+static void ax25_t2_expired(void* ctx, timer_wheel_timer_t* timer);
+static void ax25_t3_expired(void* ctx, timer_wheel_timer_t* timer);
+
+// Transmit a frame to the session's remote station. Commands carry the C
+// bit in the destination SSID, responses in the source SSID (AX.25 v2).
+static int ax25_link_send(ax25_tnc_t* tnc, const ax25_connection_t* conn, uint16_t control,
+                          bool command, uint8_t pid, const uint8_t* info, uint16_t info_len) {
+    ax25_address_t addresses[2] = { conn->remote_addr, conn->local_addr };
+    addresses[0].ssid = (addresses[0].ssid & 0x7F) | (command ? 0x80 : 0x00);
+    addresses[1].ssid = (addresses[1].ssid & 0x7F) | (command ? 0x00 : 0x80);
+
+    ax25_header_template_t tmpl;
+    int result = (conn->modulo == AX25_MODULO_EXT)
+                     ? ax25_header_template_init_ext(&tmpl, addresses, 2, control, pid)
+                     : ax25_header_template_init(&tmpl, addresses, 2, control & 0xFF, pid);
+    if (result != 0) {
+        return -1;
+    }
+
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, info, info_len, fcs, iov);
+    if (iovcnt < 0) {
+        return -1;
+    }
+
+    // Send via the transmit hook (normally the KISS interface)
+    if (tnc->tx_handler && tnc->tx_handler(tnc->tx_ctx, iov, iovcnt) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static uint8_t ax25_seq_mask(const ax25_connection_t* conn) {
+    return conn->modulo - 1;
+}
+
+// I frame control field; N(R) acknowledges everything received so far
+static uint16_t ax25_link_i_control(const ax25_connection_t* conn, uint8_t ns) {
+    if (conn->modulo == AX25_MODULO_EXT) {
+        return (uint16_t)(ns << 1) | (uint16_t)(conn->recv_seq << 9);
+    }
+    return AX25_CTRL_I | (uint8_t)(conn->recv_seq << 5) | (uint8_t)(ns << 1);
+}
+
+static int ax25_link_send_s(ax25_tnc_t* tnc, const ax25_connection_t* conn, uint8_t type,
+                            uint8_t nr, bool command, bool pf) {
+    uint16_t control;
+    if (conn->modulo == AX25_MODULO_EXT) {
+        control = type | (pf ? AX25_CTRL_EXT_PF : 0) | (uint16_t)(nr << 9);
+    } else {
+        control = type | (pf ? AX25_CTRL_PF : 0) | (uint8_t)(nr << 5);
+    }
+    return ax25_link_send(tnc, conn, control, command, AX25_PID_NONE, NULL, 0);
+}
+
+static int ax25_link_send_u(ax25_tnc_t* tnc, const ax25_connection_t* conn, uint8_t type,
+                            bool command, bool pf) {
+    return ax25_link_send(tnc, conn, type | (pf ? AX25_CTRL_PF : 0), command, AX25_PID_NONE,
+                          NULL, 0);
+}
+
+// Find or create a session; new sessions get their timers attached
+static ax25_connection_t* ax25_link_open(ax25_tnc_t* tnc, const ax25_address_t* local,
+                                         const ax25_address_t* remote) {
+    ax25_connection_t* conn = ax25_session_insert(&tnc->sessions, local, remote);
+    if (conn && !conn->t1.callback) {
+        timer_wheel_timer_init(&conn->t1, ax25_t1_expired, tnc);
+        timer_wheel_timer_init(&conn->t2, ax25_t2_expired, tnc);
+        timer_wheel_timer_init(&conn->t3, ax25_t3_expired, tnc);
+    }
+    return conn;
+}
+
+// Clear sequence state for a new link and size its windows. The send
+// window keeps every unacknowledged I frame for retransmission; modulo
+// 128 links also get a receive window for frames that arrive after a gap.
+static int ax25_link_reset(ax25_tnc_t* tnc, ax25_connection_t* conn, uint8_t modulo) {
+    uint8_t window = (modulo == AX25_MODULO_EXT) ? tnc->config.window_size_ext
+                                                 : tnc->config.window_size;
+    uint8_t max_window = (modulo == AX25_MODULO_EXT) ? AX25_MAX_WINDOW_EXT : AX25_MAX_WINDOW;
+    if (window < 1) {
+        window = 1;
+    } else if (window > max_window) {
+        window = max_window;
+    }
+
+    uint32_t slots = 1;
+    while (slots < window) {
+        slots <<= 1;
+    }
+
+    free(conn->tx_window);
+    free(conn->rx_window);
+    conn->tx_window = calloc(slots, sizeof(ax25_window_slot_t));
+    conn->rx_window = (modulo == AX25_MODULO_EXT) ? calloc(slots, sizeof(ax25_window_slot_t))
+                                                  : NULL;
+    if (!conn->tx_window || (modulo == AX25_MODULO_EXT && !conn->rx_window)) {
+        free(conn->tx_window);
+        free(conn->rx_window);
+        conn->tx_window = NULL;
+        conn->rx_window = NULL;
+        return -1;
+    }
+
+    conn->modulo = modulo;
+    conn->window_size = window;
+    conn->window_mask = (uint8_t)(slots - 1);
+    conn->send_seq = 0;
+    conn->recv_seq = 0;
+    conn->recv_high = 0;
+    conn->ack_seq = 0;
+    conn->timeout = tnc->config.t1_timeout;
+    conn->retry_count = 0;
+    conn->poll_pending = false;
+    conn->ack_pending = false;
+    conn->reject_sent = false;
+    return 0;
+}
+
+static ax25_window_slot_t* ax25_window_slot(ax25_window_slot_t* window,
+                                            const ax25_connection_t* conn, uint8_t seq) {
+    return &window[seq & conn->window_mask];
+}
+
+// Release the session; removal stops its timers
+static void ax25_link_drop(ax25_tnc_t* tnc, ax25_connection_t* conn) {
+    ax25_address_t local = conn->local_addr;
+    ax25_address_t remote = conn->remote_addr;
+    ax25_session_remove(&tnc->sessions, &local, &remote);
+}
+
+// T1 while frames are unacknowledged (or a poll is unanswered), T3 while idle
+static void ax25_link_restart_timers(ax25_tnc_t* tnc, ax25_connection_t* conn, bool progress) {
+    if (conn->poll_pending) {
+        return; // T1 runs until the poll is answered
+    }
+
+    if (conn->ack_seq == conn->send_seq) {
+        timer_wheel_cancel(&tnc->timers, &conn->t1);
+        timer_wheel_arm(&tnc->timers, &conn->t3, tnc->config.t3_timeout);
+    } else if (progress || !timer_wheel_armed(&conn->t1)) {
+        timer_wheel_cancel(&tnc->timers, &conn->t3);
+        timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+    }
+}
+
+static void ax25_link_established(ax25_tnc_t* tnc, ax25_connection_t* conn) {
+    conn->state = AX25_STATE_CONNECTED;
+    conn->retry_count = 0;
+    conn->poll_pending = false;
+    ax25_link_restart_timers(tnc, conn, false);
+}
+
+// Apply a received N(R), releasing the acknowledged frames; returns frames
+// newly acknowledged or -1 if N(R) acknowledges frames that were never sent
+static int ax25_link_ack(ax25_connection_t* conn, uint8_t nr) {
+    uint8_t mask = ax25_seq_mask(conn);
+    uint8_t outstanding = (conn->send_seq - conn->ack_seq) & mask;
+    uint8_t acked = (nr - conn->ack_seq) & mask;
+    if (acked > outstanding) {
+        return -1;
+    }
+
+    for (uint8_t seq = conn->ack_seq; seq != nr; seq = (seq + 1) & mask) {
+        ax25_window_slot(conn->tx_window, conn, seq)->present = false;
+    }
+    conn->ack_seq = nr;
+    if (acked > 0) {
+        conn->retry_count = 0;
+    }
+    return acked;
+}
+
+// Pass held frames that now follow in sequence to the receive queue. A
+// full queue stops delivery; the rest moves on at the next I frame or
+// acknowledgement, once the application has read some frames.
+static void ax25_link_deliver_held(ax25_tnc_t* tnc, ax25_connection_t* conn) {
+    if (!conn->rx_window) {
+        return;
+    }
+
+    ax25_window_slot_t* slot = ax25_window_slot(conn->rx_window, conn, conn->recv_seq);
+    while (slot->present) {
+        ax25_frame_t frame;
+        ax25_create_frame(&frame, &conn->remote_addr, &conn->local_addr,
+                          AX25_CTRL_I | (uint8_t)(conn->recv_seq << 1), slot->pid, slot->info,
+                          slot->length);
+        if (ax25_rx_enqueue(tnc, &frame) != 0) {
+            return; // Receive queue full: hold the rest
+        }
+        slot->present = false;
+        slot->srej_sent = false;
+        conn->recv_seq = (conn->recv_seq + 1) & ax25_seq_mask(conn);
+        slot = ax25_window_slot(conn->rx_window, conn, conn->recv_seq);
+    }
+}
+
+// Acknowledge received I frames now
+static void ax25_link_send_ack(ax25_tnc_t* tnc, ax25_connection_t* conn, bool final) {
+    ax25_link_deliver_held(tnc, conn);
+    conn->ack_pending = false;
+    timer_wheel_cancel(&tnc->timers, &conn->t2);
+    ax25_link_send_s(tnc, conn, AX25_CTRL_RR, conn->recv_seq, false, final);
+}
+
+// Send I frame N(S) again from the send window, with the current N(R)
+static bool ax25_link_resend(ax25_tnc_t* tnc, ax25_connection_t* conn, uint8_t ns) {
+    const ax25_window_slot_t* slot = ax25_window_slot(conn->tx_window, conn, ns);
+    if (!slot->present ||
+        ax25_link_send(tnc, conn, ax25_link_i_control(conn, ns), true, slot->pid, slot->info,
+                       slot->length) != 0) {
+        return false;
+    }
+    conn->retransmits++;
+    conn->ack_pending = false;
+    timer_wheel_cancel(&tnc->timers, &conn->t2);
+    return true;
+}
+
+// Go back N: send every unacknowledged frame again, oldest first
+static bool ax25_link_resend_all(ax25_tnc_t* tnc, ax25_connection_t* conn) {
+    bool sent = false;
+    uint8_t mask = ax25_seq_mask(conn);
+    for (uint8_t ns = conn->ack_seq; ns != conn->send_seq; ns = (ns + 1) & mask) {
+        sent |= ax25_link_resend(tnc, conn, ns);
+    }
+    return sent;
+}
+
+// Connect request for the session's modulus
+static uint8_t ax25_link_sabm(const ax25_connection_t* conn) {
+    return (conn->modulo == AX25_MODULO_EXT) ? AX25_CTRL_SABME : AX25_CTRL_SABM;
+}
+
+// T1: no acknowledgement in time; repeat the last request up to max_retries
+static void ax25_t1_expired(void* ctx, timer_wheel_timer_t* timer) {
+    ax25_tnc_t* tnc = (ax25_tnc_t*)ctx;
+    ax25_connection_t* conn = AX25_SESSION_OF(timer, t1);
+
+    if (++conn->retry_count > tnc->config.max_retries) {
+        ax25_link_drop(tnc, conn); // Link failure
+        return;
+    }
+
+    switch (conn->state) {
+    case AX25_STATE_CONNECTING:
+        ax25_link_send_u(tnc, conn, ax25_link_sabm(conn), true, true);
+        break;
+    case AX25_STATE_DISCONNECTING:
+        ax25_link_send_u(tnc, conn, AX25_CTRL_DISC, true, true);
+        break;
+    case AX25_STATE_CONNECTED:
+        // Enquiry: the response's N(R) says what arrived
+        conn->ack_pending = false;
+        timer_wheel_cancel(&tnc->timers, &conn->t2);
+        ax25_link_send_s(tnc, conn, AX25_CTRL_RR, conn->recv_seq, true, true);
+        conn->poll_pending = true;
+        break;
+    default:
+        return;
+    }
+
+    timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+}
+
+// T2: acknowledge received I frames that no outgoing frame has covered
+static void ax25_t2_expired(void* ctx, timer_wheel_timer_t* timer) {
+    ax25_tnc_t* tnc = (ax25_tnc_t*)ctx;
+    ax25_connection_t* conn = AX25_SESSION_OF(timer, t2);
+
+    if (conn->state == AX25_STATE_CONNECTED && conn->ack_pending) {
+        ax25_link_send_ack(tnc, conn, false);
+    }
+}
+
+// T3: link idle; poll the remote station to check it is still there
+static void ax25_t3_expired(void* ctx, timer_wheel_timer_t* timer) {
+    ax25_tnc_t* tnc = (ax25_tnc_t*)ctx;
+    ax25_connection_t* conn = AX25_SESSION_OF(timer, t3);
+
+    if (conn->state != AX25_STATE_CONNECTED || timer_wheel_armed(&conn->t1)) {
+        return;
+    }
+
+    conn->retry_count = 0;
+    ax25_link_send_s(tnc, conn, AX25_CTRL_RR, conn->recv_seq, true, true);
+    conn->poll_pending = true;
+    timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+}
+
+// Connect to remote station
+int ax25_connect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr) {
+    if (!tnc || !remote_addr) {
+        return -1;
+    }
+
+    // Find or create the session (an existing one is re-established)
+    ax25_connection_t* conn = ax25_link_open(tnc, &tnc->config.my_address, remote_addr);
+    if (!conn) {
+        return -1; // Out of memory
+    }
+
+    if (ax25_link_reset(tnc, conn, tnc->config.extended ? AX25_MODULO_EXT : AX25_MODULO) != 0) {
+        ax25_link_drop(tnc, conn);
+        return -1;
+    }
+    conn->state = AX25_STATE_CONNECTING;
+    timer_wheel_cancel(&tnc->timers, &conn->t2);
+    timer_wheel_cancel(&tnc->timers, &conn->t3);
+
+    // SABM(E) is repeated by T1 until UA or DM arrives
+    ax25_link_send_u(tnc, conn, ax25_link_sabm(conn), true, true);
+    timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+    return 0;
+}
+
+// Disconnect from remote station
+int ax25_disconnect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr) {
+    if (!tnc || !remote_addr) {
+        return -1;
+    }
+
+    ax25_connection_t* conn = ax25_session_find(&tnc->sessions, &tnc->config.my_address,
+                                                remote_addr);
+    if (!conn) {
+        return -1; // Connection not found
+    }
+
+    switch (conn->state) {
+    case AX25_STATE_CONNECTED:
+        // DISC is repeated by T1; the session is released on UA or DM
+        conn->state = AX25_STATE_DISCONNECTING;
+        conn->retry_count = 0;
+        conn->poll_pending = false;
+        timer_wheel_cancel(&tnc->timers, &conn->t2);
+        timer_wheel_cancel(&tnc->timers, &conn->t3);
+        ax25_link_send_u(tnc, conn, AX25_CTRL_DISC, true, true);
+        timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+        break;
+    case AX25_STATE_DISCONNECTING:
+        break;
+    default:
+        ax25_link_drop(tnc, conn); // Abandon a connect attempt
+        break;
+    }
+    return 0;
+}
+
+// Send data to remote station
+int ax25_send_data(ax25_tnc_t* tnc, const ax25_address_t* remote_addr,
+                   const uint8_t* data, uint16_t length) {
+    if (!tnc || !remote_addr || !data || length == 0 || length > AX25_MAX_INFO) {
+        return -1;
+    }
+
+    // Find connection
+    ax25_connection_t* conn = ax25_session_find(&tnc->sessions, &tnc->config.my_address,
+                                                remote_addr);
+    if (!conn || conn->state != AX25_STATE_CONNECTED) {
+        return -1; // No active connection
+    }
+
+    // Window full: wait for acknowledgements
+    if (((conn->send_seq - conn->ack_seq) & ax25_seq_mask(conn)) >= conn->window_size) {
+        return -1;
+    }
+
+    // Keep the frame until it is acknowledged
+    ax25_window_slot_t* slot = ax25_window_slot(conn->tx_window, conn, conn->send_seq);
+    memcpy(slot->info, data, length);
+    slot->length = length;
+    slot->pid = AX25_PID_IP;
+    slot->present = true;
+
+    if (ax25_link_send(tnc, conn, ax25_link_i_control(conn, conn->send_seq), true, slot->pid,
+                       data, length) != 0) {
+        slot->present = false;
+        return -1;
+    }
+
+    conn->send_seq = (conn->send_seq + 1) & ax25_seq_mask(conn);
+    conn->ack_pending = false;
+    timer_wheel_cancel(&tnc->timers, &conn->t2);
+    ax25_link_restart_timers(tnc, conn, false);
+    return 0;
+}
+
+// Track the highest N(S) received; returns true if N(S) lies below it,
+// i.e. the frame fills a hole rather than extending the sequence
+static bool ax25_link_note_received(ax25_connection_t* conn, uint8_t ns) {
+    uint8_t mask = ax25_seq_mask(conn);
+    uint8_t ahead = (ns - conn->recv_seq) & mask;
+    if (ahead < ((conn->recv_high - conn->recv_seq) & mask)) {
+        return true;
+    }
+    conn->recv_high = (ns + 1) & mask;
+    return false;
+}
+
+// Out-of-sequence frame on a modulo 128 link: hold it and ask for each
+// missing frame before it. Selective retransmissions arrive in the order
+// they were requested, so when one fills a hole while an earlier
+// requested frame is still missing, that request or its answer was lost
+// and the frame is asked for again rather than waiting for T1.
+static void ax25_link_hold(ax25_tnc_t* tnc, ax25_connection_t* conn,
+                           const ax25_frame_view_t* view, uint8_t ns) {
+    bool refill = ax25_link_note_received(conn, ns);
+
+    ax25_window_slot_t* slot = ax25_window_slot(conn->rx_window, conn, ns);
+    if (!slot->present) {
+        uint16_t length;
+        const uint8_t* info = ax25_frame_view_info(view, &length);
+        memcpy(slot->info, info, length);
+        slot->length = length;
+        slot->pid = ax25_frame_view_pid(view);
+        slot->present = true;
+    }
+
+    uint8_t mask = ax25_seq_mask(conn);
+    for (uint8_t seq = conn->recv_seq; seq != ns; seq = (seq + 1) & mask) {
+        ax25_window_slot_t* missing = ax25_window_slot(conn->rx_window, conn, seq);
+        if (!missing->present && (!missing->srej_sent || refill)) {
+            missing->srej_sent = true;
+            ax25_link_send_s(tnc, conn, AX25_CTRL_SREJ, seq, false, false);
+        }
+    }
+}
+
+// I frame on an established link
+static void ax25_link_input_i(ax25_tnc_t* tnc, ax25_connection_t* conn,
+                              const ax25_frame_view_t* view, uint8_t ns, uint8_t nr, bool pf) {
+    if (conn->state != AX25_STATE_CONNECTED) {
+        return;
+    }
+
+    int acked = ax25_link_ack(conn, nr);
+    ax25_link_restart_timers(tnc, conn, acked > 0);
+    ax25_link_deliver_held(tnc, conn);
+
+    uint8_t ahead = (ns - conn->recv_seq) & ax25_seq_mask(conn);
+    if (ahead == 0 && ax25_rx_enqueue_view(tnc, view) == 0) {
+        ax25_link_note_received(conn, ns);
+        conn->recv_seq = (conn->recv_seq + 1) & ax25_seq_mask(conn);
+        conn->reject_sent = false;
+        if (conn->rx_window) {
+            ax25_window_slot_t* slot = ax25_window_slot(conn->rx_window, conn, ns);
+            slot->present = false; // A held copy is superseded
+            slot->srej_sent = false;
+            ax25_link_deliver_held(tnc, conn);
+        }
+        if (pf) {
+            ax25_link_send_ack(tnc, conn, true);
+        } else {
+            // Wait up to T2 for an outgoing frame to carry the acknowledgement
+            conn->ack_pending = true;
+            if (!timer_wheel_armed(&conn->t2)) {
+                timer_wheel_arm(&tnc->timers, &conn->t2, tnc->config.t2_timeout);
+            }
+        }
+    } else if (ahead != 0 && conn->rx_window && ahead < conn->window_size) {
+        // Modulo 128: keep the frame, fetch only what is missing
+        ax25_link_hold(tnc, conn, view, ns);
+        if (pf) {
+            ax25_link_send_ack(tnc, conn, true);
+        }
+    } else if (ahead != 0 && !conn->rx_window && !conn->reject_sent) {
+        // Modulo 8 sequence gap: ask once for retransmission from N(R)
+        conn->reject_sent = true;
+        conn->ack_pending = false;
+        timer_wheel_cancel(&tnc->timers, &conn->t2);
+        ax25_link_send_s(tnc, conn, AX25_CTRL_REJ, conn->recv_seq, false, pf);
+    } else if (pf) {
+        // Duplicate, or no room in the receive queue: restate N(R)
+        ax25_link_send_ack(tnc, conn, true);
+    }
+}
+
+// RR, RNR, REJ or SREJ on an established link
+static void ax25_link_input_s(ax25_tnc_t* tnc, ax25_connection_t* conn, uint8_t type,
+                              uint8_t nr, bool command, bool pf) {
+    if (conn->state != AX25_STATE_CONNECTED) {
+        return;
+    }
+
+    bool answered = !command && pf && conn->poll_pending;
+    if (answered) {
+        conn->poll_pending = false;
+        conn->retry_count = 0;
+    }
+
+    bool resent = false;
+    if (type == AX25_CTRL_SREJ) {
+        // Selective reject: N(R) names the one frame to send again
+        uint8_t mask = ax25_seq_mask(conn);
+        if (((nr - conn->ack_seq) & mask) < ((conn->send_seq - conn->ack_seq) & mask)) {
+            resent = ax25_link_resend(tnc, conn, nr);
+        }
+    } else {
+        int acked = ax25_link_ack(conn, nr);
+        if (acked >= 0 && (type == AX25_CTRL_REJ || answered)) {
+            // Go back N from N(R): after REJ, or when a poll shows frames missing
+            resent = ax25_link_resend_all(tnc, conn);
+        }
+        answered |= acked > 0;
+    }
+    ax25_link_restart_timers(tnc, conn, answered || resent);
+
+    if (command && pf) {
+        ax25_link_send_ack(tnc, conn, true);
+    }
+}
+
+// SABM(E), DISC, UA, DM or FRMR for an existing session
+static void ax25_link_input_u(ax25_tnc_t* tnc, ax25_connection_t* conn, uint8_t control,
+                              bool pf) {
+    switch (control & AX25_CTRL_U_MASK) {
+    case AX25_CTRL_SABM:
+    case AX25_CTRL_SABME: {
+        uint8_t modulo = ((control & AX25_CTRL_U_MASK) == AX25_CTRL_SABME) ? AX25_MODULO_EXT
+                                                                           : AX25_MODULO;
+        timer_wheel_cancel(&tnc->timers, &conn->t2);
+        if (ax25_link_reset(tnc, conn, modulo) != 0) {
+            ax25_link_send_u(tnc, conn, AX25_CTRL_DM, false, pf);
+            ax25_link_drop(tnc, conn);
+            break;
+        }
+        ax25_link_send_u(tnc, conn, AX25_CTRL_UA, false, pf);
+        ax25_link_established(tnc, conn);
+        break;
+    }
+    case AX25_CTRL_DISC:
+        ax25_link_send_u(tnc, conn, AX25_CTRL_UA, false, pf);
+        ax25_link_drop(tnc, conn);
+        break;
+    case AX25_CTRL_UA:
+        if (conn->state == AX25_STATE_CONNECTING) {
+            ax25_link_established(tnc, conn);
+        } else if (conn->state == AX25_STATE_DISCONNECTING) {
+            ax25_link_drop(tnc, conn);
+        }
+        break;
+    case AX25_CTRL_DM:
+    case AX25_CTRL_FRMR:
+        if (conn->state == AX25_STATE_CONNECTING && conn->modulo == AX25_MODULO_EXT &&
+            ax25_link_reset(tnc, conn, AX25_MODULO) == 0) {
+            // AX.25 v2.0 station refused SABME: fall back to SABM
+            ax25_link_send_u(tnc, conn, AX25_CTRL_SABM, true, true);
+            timer_wheel_arm(&tnc->timers, &conn->t1, conn->timeout);
+            break;
+        }
+        ax25_link_drop(tnc, conn); // Refused, or the remote lost the link
+        break;
+    default:
+        break;
+    }
+}
+
+// Handle one received frame
+int ax25_input_frame(ax25_tnc_t* tnc, const uint8_t* data, uint16_t length) {
+    if (!tnc || !data) {
+        return -1;
+    }
+
+    // The addresses decide the session, and the session's modulus decides
+    // the control field length. A long modulo 128 I frame only parses with
+    // the two-octet layout, so try that if the one-octet layout fails.
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data, length) != 0 &&
+        ax25_frame_view_init_ext(&view, data, length, true) != 0) {
+        return -1;
+    }
+    if (!ax25_frame_view_check_fcs(&view)) {
+        return -1;
+    }
+
+    // UI frames need no link; a full receive queue counts the drop
+    uint8_t control = ax25_frame_view_control(&view);
+    if ((control & AX25_CTRL_U_MASK) == AX25_CTRL_UI) {
+        ax25_rx_enqueue_view(tnc, &view);
+        return 0;
+    }
+
+    ax25_address_t dst, src;
+    ax25_frame_view_get_address(&view, 0, &dst);
+    ax25_frame_view_get_address(&view, 1, &src);
+    bool command = dst.command && !src.command;
+
+    ax25_connection_t* conn = ax25_session_find(&tnc->sessions, &dst, &src);
+    if (!conn || conn->state == AX25_STATE_DISCONNECTED) {
+        if (!ax25_address_equal(&dst, &tnc->config.my_address) || view.control_length != 1) {
+            return 0; // Not for this station
+        }
+
+        uint8_t type = control & AX25_CTRL_U_MASK;
+        bool pf = (control & AX25_CTRL_PF) != 0;
+        if (type == AX25_CTRL_SABM || type == AX25_CTRL_SABME) {
+            // Incoming connection
+            conn = ax25_link_open(tnc, &tnc->config.my_address, &src);
+            if (!conn) {
+                return -1;
+            }
+            ax25_link_input_u(tnc, conn, control, pf);
+        } else if (command && pf) {
+            // No link: answer polls with DM
+            ax25_connection_t none;
+            memset(&none, 0, sizeof(none));
+            none.local_addr = tnc->config.my_address;
+            none.remote_addr = src;
+            none.modulo = AX25_MODULO;
+            ax25_link_send_u(tnc, &none, AX25_CTRL_DM, false, true);
+        }
+        return 0;
+    }
+
+    // Re-read I and S frames of a modulo 128 link with the two-octet control field
+    bool extended = conn->modulo == AX25_MODULO_EXT && (control & 0x03) != AX25_FRAME_U;
+    if (extended != (view.control_length == 2) &&
+        ax25_frame_view_init_ext(&view, data, length, extended) != 0) {
+        return -1;
+    }
+
+    if ((control & 0x03) == AX25_FRAME_U) {
+        ax25_link_input_u(tnc, conn, control, (control & AX25_CTRL_PF) != 0);
+        return 0;
+    }
+
+    uint16_t ctl = ax25_frame_view_control_ext(&view);
+    uint8_t ns, nr;
+    bool pf;
+    if (extended) {
+        ns = (ctl >> 1) & 0x7F;
+        nr = ctl >> 9;
+        pf = (ctl & AX25_CTRL_EXT_PF) != 0;
+    } else {
+        ns = (ctl >> 1) & 0x07;
+        nr = (ctl >> 5) & 0x07;
+        pf = (ctl & AX25_CTRL_PF) != 0;
+    }
+
+    if ((control & 0x01) == 0) {
+        ax25_link_input_i(tnc, conn, &view, ns, nr, pf);
+    } else {
+        ax25_link_input_s(tnc, conn, control & AX25_CTRL_S_MASK, nr, command, pf);
+    }
+    return 0;
+}
+
+// Run the session timers up to now_ms
+int ax25_timer_tick(ax25_tnc_t* tnc, uint64_t now_ms) {
+    if (!tnc) {
+        return -1;
+    }
+
+    return timer_wheel_advance(&tnc->timers, now_ms);
+}
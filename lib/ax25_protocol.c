@@ -11,6 +11,71 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <pthread.h>
+
+// CRC-16/X.25 table (reflected polynomial 0x8408)
+static const uint16_t ax25_fcs_table[256] = {
+    0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+    0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+    0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+    0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+    0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+    0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+    0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+    0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+    0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+    0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+    0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+    0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+    0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+    0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+    0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+    0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+    0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+    0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+    0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+    0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+    0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+    0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+    0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+    0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+    0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+    0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+    0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+    0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+    0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+    0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+    0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+    0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78,
+};
+
+// Zero-advance matrices: ax25_fcs_zero_matrix[k][b] is the register obtained
+// by feeding 2^k zero bytes into a register holding only bit b
+#define AX25_FCS_ZERO_POWERS 16
+static uint16_t ax25_fcs_zero_matrix[AX25_FCS_ZERO_POWERS][16];
+static pthread_once_t ax25_fcs_zero_once = PTHREAD_ONCE_INIT;
+
+static uint16_t ax25_fcs_matrix_apply(const uint16_t matrix[16], uint16_t reg) {
+    uint16_t result = 0;
+    for (int b = 0; b < 16; b++) {
+        result ^= matrix[b] & (uint16_t)(0u - ((reg >> b) & 1));
+    }
+    return result;
+}
+
+static void ax25_fcs_build_zero_matrices(void) {
+    for (int b = 0; b < 16; b++) {
+        uint16_t reg = (uint16_t)(1u << b);
+        ax25_fcs_zero_matrix[0][b] = (reg >> 8) ^ ax25_fcs_table[reg & 0xFF];
+    }
+    // Squaring: advancing 2^k bytes twice advances 2^(k+1) bytes
+    for (int k = 1; k < AX25_FCS_ZERO_POWERS; k++) {
+        for (int b = 0; b < 16; b++) {
+            ax25_fcs_zero_matrix[k][b] =
+                ax25_fcs_matrix_apply(ax25_fcs_zero_matrix[k - 1], ax25_fcs_zero_matrix[k - 1][b]);
+        }
+    }
+}
 
 // Initialize AX.25 TNC
 int ax25_init(ax25_tnc_t* tnc) {
@@ -31,21 +96,26 @@ int ax25_init(ax25_tnc_t* tnc) {
     tnc->config.full_duplex = false;
     tnc->config.max_frame_length = 255;  // Maximum value for uint8_t
     tnc->config.window_size = 4;
+    tnc->config.window_size_ext = 32;
+    tnc->config.extended = false;
     tnc->config.t1_timeout = 3000;       // 3 seconds
     tnc->config.t2_timeout = 1000;     // 1 second
     tnc->config.t3_timeout = 30000;     // 30 seconds
     tnc->config.max_retries = 3;
     
-    // Initialize connections
-    tnc->num_connections = 0;
-    for (int i = 0; i < 16; i++) {
-        tnc->connections[i].state = AX25_STATE_DISCONNECTED;
-    }
+    // Initialize session table (allocated on first connect) and timers
+    ax25_session_table_init(&tnc->sessions);
+    timer_wheel_init(&tnc->timers, AX25_TIMER_TICK_MS, timer_wheel_clock_ms());
+    tnc->sessions.timers = &tnc->timers;
     
-    // Initialize frames
-    memset(&tnc->rx_frame, 0, sizeof(ax25_frame_t));
+    // Initialize receive queues and frames
+    memset(tnc->rx_queues, 0, sizeof(tnc->rx_queues));
+    tnc->rx_order = 0;
+    tnc->rx_policy = AX25_RX_DROP_NEWEST;
+    memset(&tnc->rx_stats, 0, sizeof(tnc->rx_stats));
     memset(&tnc->tx_frame, 0, sizeof(ax25_frame_t));
-    tnc->frame_ready = false;
+    tnc->tx_handler = NULL;
+    tnc->tx_ctx = NULL;
     
     return 0;
 }
@@ -56,14 +126,15 @@ int ax25_cleanup(ax25_tnc_t* tnc) {
         return -1;
     }
     
-    // Disconnect all connections
-    for (int i = 0; i < tnc->num_connections; i++) {
-        ax25_disconnect(tnc, &tnc->connections[i].remote_addr);
+    // Drop all sessions and forget their timers
+    ax25_session_table_free(&tnc->sessions);
+    timer_wheel_init(&tnc->timers, AX25_TIMER_TICK_MS, timer_wheel_now(&tnc->timers));
+    tnc->sessions.timers = &tnc->timers;
+    // Discard queued frames (no producer may be running)
+    for (int i = 0; i < AX25_RX_QUEUES; i++) {
+        tnc->rx_queues[i].head = tnc->rx_queues[i].tail;
     }
     
-    tnc->num_connections = 0;
-    tnc->frame_ready = false;
-    
     return 0;
 }
 
@@ -155,6 +226,11 @@ int ax25_address_equal(const ax25_address_t* addr1, const ax25_address_t* addr2)
            (((addr1->ssid >> 1) & 0x0F) == ((addr2->ssid >> 1) & 0x0F));
 }
 
+// I frames and UI frames carry a PID; S frames and other U frames do not
+static bool ax25_control_has_pid(uint8_t control) {
+    return (control & 0x01) == 0 || (control & ~0x10) == AX25_CTRL_UI;
+}
+
 // Create AX.25 frame
 int ax25_create_frame(ax25_frame_t* frame, const ax25_address_t* src, const ax25_address_t* dst, 
                      uint8_t control, uint8_t pid, const uint8_t* info, uint16_t info_len) {
@@ -191,83 +267,227 @@ int ax25_create_frame(ax25_frame_t* frame, const ax25_address_t* src, const ax25
 
 // Parse AX.25 frame
 int ax25_parse_frame(const uint8_t* data, uint16_t length, ax25_frame_t* frame) {
-    if (!data || !frame || length < 14) { // Minimum frame size
+    if (!data || !frame) {
         return -1;
     }
-    
-    // Clear frame
-    memset(frame, 0, sizeof(ax25_frame_t));
-    
+
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data, length) != 0) {
+        return -1;
+    }
+
+    return ax25_frame_view_to_frame(&view, frame);
+}
+
+// Index a frame in place: only the address extension bits are read
+int ax25_frame_view_init(ax25_frame_view_t* view, const uint8_t* data, uint16_t length) {
+    return ax25_frame_view_init_ext(view, data, length, false);
+}
+
+int ax25_frame_view_init_ext(ax25_frame_view_t* view, const uint8_t* data, uint16_t length,
+                             bool extended) {
+    if (!view || !data) {
+        return -1;
+    }
+
+    memset(view, 0, sizeof(*view));
+
+    // Walk the address fields until the extension bit marks the last one
     uint16_t pos = 0;
-    
-    // Parse addresses
-    while (pos < length - 2) { // Leave room for control field
-        if (pos + 7 > length) break;
-        
-        // Check if this is the last address (bit 0 of SSID byte is set)
-        // AX.25 SSID byte format (Dire Wolf authoritative):
-        // Bit 7: H bit, Bit 6-5: Reserved (11), Bits 4-1: SSID, Bit 0: Last address flag
-        // Bit 0 (LSB) is the address extension bit: 1 = last address, 0 = more addresses
-        bool last_addr = (data[pos + 6] & 0x01) != 0;
-        
-        // Copy address
-        memcpy(frame->addresses[frame->num_addresses].callsign, &data[pos], 6);
-        // Extract SSID from bits 4-1 of SSID byte
-        frame->addresses[frame->num_addresses].ssid = (data[pos + 6] >> 1) & 0x0F;
-        frame->addresses[frame->num_addresses].command = (data[pos + 6] & 0x80) != 0;  // Bit 7 is H/C/R bit
-        // has_been_repeated indicates if this address was repeated by a digipeater
-        // This is determined by checking if the H bit is set (bit 7)
-        frame->addresses[frame->num_addresses].has_been_repeated = (data[pos + 6] & 0x80) != 0;
-        
-        frame->num_addresses++;
-        pos += 7;
-        
-        if (last_addr) break;
+    bool last_addr = false;
+    while (!last_addr) {
+        if (view->num_addresses >= AX25_MAX_ADDRS || pos + AX25_ADDR_LEN > length) {
+            return -1; // Unterminated address list
+        }
+        // Bit 0 (LSB) of the SSID byte: 1 = last address, 0 = more addresses
+        last_addr = (data[pos + 6] & 0x01) != 0;
+        view->num_addresses++;
+        pos += AX25_ADDR_LEN;
     }
-    
-    if (frame->num_addresses < 2) {
+
+    if (view->num_addresses < 2) {
         return -1; // Need at least source and destination
     }
-    
-    // Parse control field
-    if (pos >= length) {
+
+    // Control field and FCS must follow the addresses
+    if (pos + 1 + 2 > length) {
         return -1;
     }
-    frame->control = data[pos++];
-    
-    // Parse PID field (if present)
-    if ((frame->control & 0x01) == 0) { // I or S frame
-        if (pos >= length) {
+    view->control_offset = pos;
+
+    // Modulo 128 I and S frames have a second control octet
+    uint8_t control = data[view->control_offset];
+    view->control_length = (extended && (control & 0x03) != AX25_FRAME_U) ? 2 : 1;
+    pos += view->control_length;
+    if (pos + 2 > length) {
+        return -1;
+    }
+
+    // I frames and UI frames carry a PID and an information field;
+    // S frames and other U frames have neither
+    if (ax25_control_has_pid(control)) {
+        if (pos + 1 + 2 > length) {
             return -1;
         }
-        frame->pid = data[pos++];
-    } else {
-        frame->pid = AX25_PID_NONE;
+        view->has_pid = true;
+        pos++;
     }
-    
-    // Parse information field
-    if ((frame->control & 0x01) == 0) { // I or UI frame
-        frame->info_length = length - pos - 2; // Subtract FCS
-        if (frame->info_length > AX25_MAX_INFO) {
-            frame->info_length = AX25_MAX_INFO;
+
+    view->info_offset = pos;
+    view->info_length = length - 2 - pos;
+    if (view->info_length > AX25_MAX_INFO) {
+        return -1; // Information field too long
+    }
+
+    view->data = data;
+    view->length = length;
+    return 0;
+}
+
+// Decode one address field
+int ax25_frame_view_get_address(const ax25_frame_view_t* view, uint8_t index, ax25_address_t* addr) {
+    if (!view || !addr || index >= view->num_addresses) {
+        return -1;
+    }
+
+    const uint8_t* field = &view->data[index * AX25_ADDR_LEN];
+    memcpy(addr->callsign, field, 6);
+    addr->ssid = field[6];
+    addr->command = (field[6] & 0x80) != 0;            // Bit 7 is H/C/R bit
+    addr->has_been_repeated = index >= 2 && (field[6] & 0x80) != 0;
+    return 0;
+}
+
+// Decode one address field to ASCII callsign and SSID value
+int ax25_frame_view_get_callsign(const ax25_frame_view_t* view, uint8_t index,
+                                 char* callsign, uint8_t* ssid) {
+    if (!view || !callsign || index >= view->num_addresses) {
+        return -1;
+    }
+
+    const uint8_t* field = &view->data[index * AX25_ADDR_LEN];
+    int len = 0;
+    for (int i = 0; i < 6; i++) {
+        char c = (field[i] >> 1) & 0x7F;
+        if (c == ' ' || c == '\0') {
+            break;
         }
-        if (frame->info_length > 0) {
-            memcpy(frame->info, &data[pos], frame->info_length);
+        callsign[len++] = c;
+    }
+    callsign[len] = '\0';
+
+    if (ssid) {
+        *ssid = (field[6] >> 1) & 0x0F;  // SSID is in bits 4-1
+    }
+    return 0;
+}
+
+// Compare one address field against an address without decoding it
+bool ax25_frame_view_address_equal(const ax25_frame_view_t* view, uint8_t index,
+                                   const ax25_address_t* addr) {
+    if (!view || !addr || index >= view->num_addresses) {
+        return false;
+    }
+
+    const uint8_t* field = &view->data[index * AX25_ADDR_LEN];
+    for (int i = 0; i < 6; i++) {
+        // ax25_set_address pads with NUL, frames on air pad with spaces
+        uint8_t a = field[i] ? field[i] : (' ' << 1);
+        uint8_t b = addr->callsign[i] ? addr->callsign[i] : (' ' << 1);
+        if (a != b) {
+            return false;
         }
-        pos += frame->info_length;
     }
-    
-    // Parse FCS
-    if (pos + 2 > length) {
+    return ((field[6] >> 1) & 0x0F) == ((addr->ssid >> 1) & 0x0F);
+}
+
+// Control field
+uint8_t ax25_frame_view_control(const ax25_frame_view_t* view) {
+    if (!view || !view->data) {
+        return 0;
+    }
+    return view->data[view->control_offset];
+}
+
+// Control field with the second octet of modulo 128 I and S frames in
+// bits 8-15 (zero for single-octet control fields)
+uint16_t ax25_frame_view_control_ext(const ax25_frame_view_t* view) {
+    if (!view || !view->data) {
+        return 0;
+    }
+    uint16_t control = view->data[view->control_offset];
+    if (view->control_length == 2) {
+        control |= (uint16_t)view->data[view->control_offset + 1] << 8;
+    }
+    return control;
+}
+
+// PID field, AX25_PID_NONE when the frame carries none
+uint8_t ax25_frame_view_pid(const ax25_frame_view_t* view) {
+    if (!view || !view->data || !view->has_pid) {
+        return AX25_PID_NONE;
+    }
+    return view->data[view->control_offset + view->control_length];
+}
+
+// Information field, pointing into the caller's buffer
+const uint8_t* ax25_frame_view_info(const ax25_frame_view_t* view, uint16_t* length) {
+    if (!view || !view->data) {
+        if (length) {
+            *length = 0;
+        }
+        return NULL;
+    }
+
+    if (length) {
+        *length = view->info_length;
+    }
+    return &view->data[view->info_offset];
+}
+
+// FCS as transmitted (low byte first)
+uint16_t ax25_frame_view_fcs(const ax25_frame_view_t* view) {
+    if (!view || !view->data) {
+        return 0;
+    }
+    return view->data[view->length - 2] | (view->data[view->length - 1] << 8);
+}
+
+// Verify the FCS over the frame
+bool ax25_frame_view_check_fcs(const ax25_frame_view_t* view) {
+    if (!view || !view->data) {
+        return false;
+    }
+    return ax25_check_fcs(view->data, view->length - 2, ax25_frame_view_fcs(view));
+}
+
+// Copy every field of a view into a frame structure
+int ax25_frame_view_to_frame(const ax25_frame_view_t* view, ax25_frame_t* frame) {
+    if (!view || !view->data || !frame) {
         return -1;
     }
-    frame->fcs = (data[pos + 1] << 8) | data[pos];
-    
+
+    memset(frame, 0, sizeof(ax25_frame_t));
+
+    for (uint8_t i = 0; i < view->num_addresses; i++) {
+        ax25_frame_view_get_address(view, i, &frame->addresses[i]);
+    }
+    frame->num_addresses = view->num_addresses;
+    frame->control = ax25_frame_view_control(view);
+    frame->pid = ax25_frame_view_pid(view);
+
+    if (view->info_length > 0) {
+        memcpy(frame->info, &view->data[view->info_offset], view->info_length);
+    }
+    frame->info_length = view->info_length;
+    frame->fcs = ax25_frame_view_fcs(view);
+
     // Validate frame
     if (ax25_validate_frame(frame) != 0) {
         return -1;
     }
-    
+
+    frame->valid = true;
     return 0;
 }
 
@@ -277,58 +497,134 @@ int ax25_encode_frame(const ax25_frame_t* frame, uint8_t* data, uint16_t* length
         return -1;
     }
     
+    ax25_header_template_t tmpl;
+    if (ax25_header_template_init(&tmpl, frame->addresses, frame->num_addresses,
+                                  frame->control, frame->pid) != 0) {
+        return -1;
+    }
+    
+    uint16_t pos = tmpl.length + frame->info_length;
+    if (pos + 2 > *length) {
+        return -1;
+    }
+    
+    memcpy(data, tmpl.bytes, tmpl.length);
+    if (frame->info_length > 0) {
+        memcpy(&data[tmpl.length], frame->info, frame->info_length);
+    }
+    
+    // Calculate and add FCS
+    uint16_t fcs = ax25_fcs_update(tmpl.fcs_state, frame->info, frame->info_length) ^ 0xFFFF;
+    data[pos++] = fcs & 0xFF;
+    data[pos++] = (fcs >> 8) & 0xFF;
+    
+    *length = pos;
+    return 0;
+}
+
+// Encode the address, control and PID fields once for reuse
+static int ax25_header_template_build(ax25_header_template_t* tmpl, const ax25_address_t* addresses,
+                                      uint8_t num_addresses, uint16_t control, uint8_t pid,
+                                      bool extended) {
+    if (!tmpl || !addresses || num_addresses < 2 || num_addresses > AX25_MAX_ADDRS) {
+        return -1;
+    }
+    
     uint16_t pos = 0;
-    uint16_t max_len = *length;
     
     // Add addresses
-    for (int i = 0; i < frame->num_addresses; i++) {
-        if (pos + 7 > max_len) {
-            return -1;
-        }
-        
-        memcpy(&data[pos], frame->addresses[i].callsign, 6);
-        data[pos + 6] = frame->addresses[i].ssid;
+    for (int i = 0; i < num_addresses; i++) {
+        memcpy(&tmpl->bytes[pos], addresses[i].callsign, 6);
+        tmpl->bytes[pos + 6] = addresses[i].ssid & ~0x01;
         
         // Set last address bit (bit 0 of SSID byte)
-        if (i == frame->num_addresses - 1) {
-            data[pos + 6] |= 0x01;  // Bit 0 (LSB) is the extension bit
+        if (i == num_addresses - 1) {
+            tmpl->bytes[pos + 6] |= 0x01;  // Bit 0 (LSB) is the extension bit
         }
         
-        pos += 7;
+        pos += AX25_ADDR_LEN;
+    }
+    
+    // Add control field, and PID for I and UI frames
+    tmpl->control_offset = pos;
+    tmpl->bytes[pos++] = control & 0xFF;
+    tmpl->control_length = 1;
+    if (extended && (control & 0x03) != AX25_FRAME_U) {
+        tmpl->bytes[pos++] = control >> 8;
+        tmpl->control_length = 2;
+    }
+    if (ax25_control_has_pid(control & 0xFF)) {
+        tmpl->bytes[pos++] = pid;
     }
     
-    // Add control field
-    if (pos >= max_len) {
+    tmpl->length = pos;
+    tmpl->fcs_state = ax25_fcs_update(0xFFFF, tmpl->bytes, pos);
+    return 0;
+}
+
+int ax25_header_template_init(ax25_header_template_t* tmpl, const ax25_address_t* addresses,
+                              uint8_t num_addresses, uint8_t control, uint8_t pid) {
+    return ax25_header_template_build(tmpl, addresses, num_addresses, control, pid, false);
+}
+
+int ax25_header_template_init_ext(ax25_header_template_t* tmpl, const ax25_address_t* addresses,
+                                  uint8_t num_addresses, uint16_t control, uint8_t pid) {
+    return ax25_header_template_build(tmpl, addresses, num_addresses, control, pid, true);
+}
+
+// Replace the control field (e.g. new sequence numbers); the PID layout
+// must not change
+int ax25_header_template_set_control(ax25_header_template_t* tmpl, uint8_t control) {
+    if (!tmpl || tmpl->length < 2 * AX25_ADDR_LEN + 1 || tmpl->control_length != 1) {
         return -1;
     }
-    data[pos++] = frame->control;
     
-    // Add PID field (if needed)
-    if ((frame->control & 0x01) == 0) { // I or S frame
-        if (pos >= max_len) {
-            return -1;
-        }
-        data[pos++] = frame->pid;
+    uint16_t control_offset = tmpl->control_offset;
+    if (ax25_control_has_pid(control) != ax25_control_has_pid(tmpl->bytes[control_offset])) {
+        return -1;
     }
     
-    // Add information field
-    if (frame->info_length > 0) {
-        if (pos + frame->info_length > max_len) {
-            return -1;
-        }
-        memcpy(&data[pos], frame->info, frame->info_length);
-        pos += frame->info_length;
+    tmpl->bytes[control_offset] = control;
+    tmpl->fcs_state = ax25_fcs_update(0xFFFF, tmpl->bytes, tmpl->length);
+    return 0;
+}
+
+// Describe a frame as header, information field (in place) and FCS segments
+int ax25_encode_iov(const ax25_header_template_t* tmpl, const uint8_t* info, uint16_t info_len,
+                    uint8_t fcs[2], struct iovec* iov) {
+    if (!tmpl || !fcs || !iov || (info_len > 0 && !info) || info_len > AX25_MAX_INFO) {
+        return -1;
     }
     
-    // Calculate and add FCS
-    uint16_t fcs = ax25_calculate_fcs(data, pos);
-    if (pos + 2 > max_len) {
+    int count = 0;
+    iov[count].iov_base = (void*)tmpl->bytes;
+    iov[count].iov_len = tmpl->length;
+    count++;
+    
+    if (info_len > 0) {
+        iov[count].iov_base = (void*)info;
+        iov[count].iov_len = info_len;
+        count++;
+    }
+    
+    uint16_t crc = ax25_fcs_update(tmpl->fcs_state, info, info_len) ^ 0xFFFF;
+    fcs[0] = crc & 0xFF;
+    fcs[1] = (crc >> 8) & 0xFF;
+    iov[count].iov_base = fcs;
+    iov[count].iov_len = 2;
+    count++;
+    
+    return count;
+}
+
+// Set the sink for encoded frames
+int ax25_set_tx_handler(ax25_tnc_t* tnc, ax25_tx_handler_t handler, void* ctx) {
+    if (!tnc) {
         return -1;
     }
-    data[pos++] = fcs & 0xFF;
-    data[pos++] = (fcs >> 8) & 0xFF;
     
-    *length = pos;
+    tnc->tx_handler = handler;
+    tnc->tx_ctx = ctx;
     return 0;
 }
 
@@ -353,102 +649,225 @@ int ax25_validate_frame(const ax25_frame_t* frame) {
     return 0;
 }
 
-// Connect to remote station
-int ax25_connect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr) {
-    if (!tnc || !remote_addr) {
-        return -1;
+// Receive Queues
+// A queue's tail is written only by the producer. Its head is advanced by
+// the consumer and, under AX25_RX_DROP_OLDEST, by the producer evicting
+// the oldest frame; both do so with compare-and-swap. The consumer copies
+// a frame out before claiming it, and discards the copy if the claim
+// fails because the slot was evicted meanwhile.
+//
+// An evicted slot is rewritten by the producer while the consumer may still
+// be copying it, so each slot carries a sequence count (a seqlock): odd
+// while the producer writes, bumped again when it is done. The consumer
+// only keeps a copy taken with the same even count before and after.
+
+// Queue a frame belongs in, by its control field; NULL for S and U frames
+// other than UI, which are link control and are not queued
+static ax25_rx_queue_t* ax25_rx_queue_for(ax25_tnc_t* tnc, uint8_t control) {
+    if ((control & 0x01) == 0) {
+        return &tnc->rx_queues[AX25_RX_QUEUE_DATA];
     }
-    
-    // Find available connection slot
-    int slot = -1;
-    for (int i = 0; i < 16; i++) {
-        if (tnc->connections[i].state == AX25_STATE_DISCONNECTED) {
-            slot = i;
+    if ((control & AX25_CTRL_U_MASK) == AX25_CTRL_UI) {
+        return &tnc->rx_queues[AX25_RX_QUEUE_UI];
+    }
+    return NULL;
+}
+
+static bool ax25_rx_full(const ax25_rx_queue_t* queue) {
+    return queue->tail - __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) >= AX25_RX_QUEUE_LEN;
+}
+
+// Mark the producer's next slot as being written
+static ax25_frame_t* ax25_rx_write_begin(ax25_rx_queue_t* queue) {
+    uint32_t index = queue->tail & (AX25_RX_QUEUE_LEN - 1);
+    __atomic_store_n(&queue->seq[index], queue->seq[index] + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return &queue->frames[index];
+}
+
+// Claim the slot for the next frame, evicting the oldest if the policy allows
+static ax25_frame_t* ax25_rx_reserve(ax25_tnc_t* tnc, ax25_rx_queue_t* queue) {
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    while (queue->tail - head >= AX25_RX_QUEUE_LEN) {
+        if (tnc->rx_policy == AX25_RX_DROP_NEWEST) {
+            __atomic_store_n(&tnc->rx_stats.dropped, tnc->rx_stats.dropped + 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+        // On failure the consumer freed a slot; head is reloaded by the CAS
+        if (__atomic_compare_exchange_n(&queue->head, &head, head + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&tnc->rx_stats.dropped, tnc->rx_stats.dropped + 1, __ATOMIC_RELAXED);
             break;
         }
     }
-    
-    if (slot == -1) {
-        return -1; // No available connections
+    return ax25_rx_write_begin(queue);
+}
+
+// Finish writing the slot, whether or not it is published
+static void ax25_rx_write_end(ax25_rx_queue_t* queue) {
+    uint32_t index = queue->tail & (AX25_RX_QUEUE_LEN - 1);
+    __atomic_store_n(&queue->seq[index], queue->seq[index] + 1, __ATOMIC_RELEASE);
+}
+
+// Make the reserved slot visible to the consumer
+static void ax25_rx_publish(ax25_tnc_t* tnc, ax25_rx_queue_t* queue) {
+    __atomic_store_n(&queue->order[queue->tail & (AX25_RX_QUEUE_LEN - 1)], tnc->rx_order++,
+                     __ATOMIC_RELAXED);
+    ax25_rx_write_end(queue);
+    __atomic_store_n(&queue->tail, queue->tail + 1, __ATOMIC_RELEASE);
+
+    uint32_t depth = ax25_rx_pending(tnc);
+    __atomic_store_n(&tnc->rx_stats.frames_in, tnc->rx_stats.frames_in + 1, __ATOMIC_RELAXED);
+    if (depth > tnc->rx_stats.high_water) {
+        __atomic_store_n(&tnc->rx_stats.high_water, depth, __ATOMIC_RELAXED);
     }
-    
-    // Initialize connection
-    tnc->connections[slot].local_addr = tnc->config.my_address;
-    tnc->connections[slot].remote_addr = *remote_addr;
-    tnc->connections[slot].state = AX25_STATE_CONNECTING;
-    tnc->connections[slot].send_seq = 0;
-    tnc->connections[slot].recv_seq = 0;
-    tnc->connections[slot].window_size = tnc->config.window_size;
-    tnc->connections[slot].timeout = tnc->config.t1_timeout;
-    tnc->connections[slot].retry_count = 0;
-    
-    if (slot >= tnc->num_connections) {
-        tnc->num_connections = slot + 1;
+}
+
+// Copy the oldest frame out; returns false if the queue is empty. A copy
+// torn by the producer rewriting the slot is retried; the producer moves
+// the head past a slot before rewriting it, so the retry makes progress.
+static bool ax25_rx_peek(ax25_rx_queue_t* queue, ax25_frame_t* frame, uint32_t* head) {
+    for (;;) {
+        *head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if (*head == __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        uint32_t index = *head & (AX25_RX_QUEUE_LEN - 1);
+        uint32_t seq = __atomic_load_n(&queue->seq[index], __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue; // Evicted and being rewritten
+        }
+        memcpy(frame, &queue->frames[index], sizeof(ax25_frame_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&queue->seq[index], __ATOMIC_RELAXED) == seq) {
+            return true;
+        }
     }
-    
-    return slot;
 }
 
-// Disconnect from remote station
-int ax25_disconnect(ax25_tnc_t* tnc, const ax25_address_t* remote_addr) {
-    if (!tnc || !remote_addr) {
+// Release the frame read by ax25_rx_peek; false if it was evicted first
+static bool ax25_rx_commit(ax25_rx_queue_t* queue, uint32_t head) {
+    return __atomic_compare_exchange_n(&queue->head, &head, head + 1, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+// Enqueue a parsed frame
+int ax25_rx_enqueue(ax25_tnc_t* tnc, const ax25_frame_t* frame) {
+    if (!tnc || !frame) {
         return -1;
     }
-    
-    // Find connection
-    for (int i = 0; i < tnc->num_connections; i++) {
-        if (ax25_address_equal(&tnc->connections[i].remote_addr, remote_addr)) {
-            tnc->connections[i].state = AX25_STATE_DISCONNECTED;
-            return 0;
+
+    ax25_rx_queue_t* queue = ax25_rx_queue_for(tnc, frame->control);
+    if (!queue) {
+        return -1;
+    }
+    ax25_frame_t* slot = ax25_rx_reserve(tnc, queue);
+    if (!slot) {
+        return -1;
+    }
+
+    *slot = *frame;
+    ax25_rx_publish(tnc, queue);
+    return 0;
+}
+
+// Decode an indexed frame into the queue: straight into a free slot, or
+// first aside when the queue is full, so a frame that fails to decode
+// does not evict a good one
+int ax25_rx_enqueue_view(ax25_tnc_t* tnc, const ax25_frame_view_t* view) {
+    if (!tnc || !view || !view->data) {
+        return -1;
+    }
+
+    ax25_rx_queue_t* queue = ax25_rx_queue_for(tnc, ax25_frame_view_control(view));
+    if (!queue) {
+        return -1;
+    }
+    if (ax25_rx_full(queue)) {
+        ax25_frame_t frame;
+        if (ax25_frame_view_to_frame(view, &frame) != 0) {
+            return -1;
         }
+        return ax25_rx_enqueue(tnc, &frame);
     }
-    
-    return -1; // Connection not found
+
+    // Only the producer fills slots, so this one stays free. A consumer
+    // still copying it after an eviction sees the write in progress.
+    ax25_frame_t* slot = ax25_rx_write_begin(queue);
+    if (ax25_frame_view_to_frame(view, slot) != 0) {
+        ax25_rx_write_end(queue);
+        return -1;
+    }
+
+    ax25_rx_publish(tnc, queue);
+    return 0;
 }
 
-// Send data to remote station
-int ax25_send_data(ax25_tnc_t* tnc, const ax25_address_t* remote_addr, 
-                   const uint8_t* data, uint16_t length) {
-    if (!tnc || !remote_addr || !data || length == 0) {
+// Dequeue the oldest frame of either queue
+int ax25_rx_dequeue(ax25_tnc_t* tnc, ax25_frame_t* frame) {
+    if (!tnc || !frame) {
         return -1;
     }
-    
-    // Find connection
-    int conn = -1;
-    for (int i = 0; i < tnc->num_connections; i++) {
-        if (ax25_address_equal(&tnc->connections[i].remote_addr, remote_addr)) {
-            conn = i;
-            break;
+
+    for (;;) {
+        // Heads may be evicted meanwhile; a stale choice only fails the claim
+        ax25_rx_queue_t* oldest = NULL;
+        uint32_t oldest_order = 0;
+        for (int i = 0; i < AX25_RX_QUEUES; i++) {
+            ax25_rx_queue_t* queue = &tnc->rx_queues[i];
+            uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+            if (head == __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            uint32_t order =
+                __atomic_load_n(&queue->order[head & (AX25_RX_QUEUE_LEN - 1)], __ATOMIC_RELAXED);
+            if (!oldest || (int32_t)(order - oldest_order) < 0) {
+                oldest = queue;
+                oldest_order = order;
+            }
+        }
+        if (!oldest) {
+            return 0;
+        }
+
+        uint32_t head;
+        if (ax25_rx_peek(oldest, frame, &head) && ax25_rx_commit(oldest, head)) {
+            return 1;
         }
     }
-    
-    if (conn == -1 || tnc->connections[conn].state != AX25_STATE_CONNECTED) {
-        return -1; // No active connection
+}
+
+uint32_t ax25_rx_pending(const ax25_tnc_t* tnc) {
+    if (!tnc) {
+        return 0;
     }
-    
-    // Create I frame
-    ax25_frame_t frame;
-    if (ax25_create_frame(&frame, &tnc->connections[conn].local_addr, 
-                         &tnc->connections[conn].remote_addr,
-                         AX25_CTRL_I | (tnc->connections[conn].send_seq << 1),
-                         AX25_PID_IP, data, length) != 0) {
+
+    uint32_t pending = 0;
+    for (int i = 0; i < AX25_RX_QUEUES; i++) {
+        pending += __atomic_load_n(&tnc->rx_queues[i].tail, __ATOMIC_ACQUIRE) -
+                   __atomic_load_n(&tnc->rx_queues[i].head, __ATOMIC_ACQUIRE);
+    }
+    return pending;
+}
+
+int ax25_rx_set_policy(ax25_tnc_t* tnc, ax25_rx_policy_t policy) {
+    if (!tnc || (policy != AX25_RX_DROP_NEWEST && policy != AX25_RX_DROP_OLDEST)) {
         return -1;
     }
-    
-    // Encode and send frame
-    uint8_t encoded[512];
-    uint16_t encoded_len = sizeof(encoded);
-    if (ax25_encode_frame(&frame, encoded, &encoded_len) != 0) {
+
+    tnc->rx_policy = policy;
+    return 0;
+}
+
+// Get receive queue statistics
+int ax25_rx_get_stats(const ax25_tnc_t* tnc, ax25_rx_stats_t* stats) {
+    if (!tnc || !stats) {
         return -1;
     }
-    
-    // Send via KISS interface
-    // Note: This requires the TNC to have a KISS interface
-    // KISS frame transmission is handled by the KISS protocol layer
-    // Frame encoding complete; transmission via kiss_send_frame()
-    
-    tnc->connections[conn].send_seq = (tnc->connections[conn].send_seq + 1) % 8;
-    
+
+    stats->frames_in = __atomic_load_n(&tnc->rx_stats.frames_in, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&tnc->rx_stats.dropped, __ATOMIC_RELAXED);
+    stats->high_water = __atomic_load_n(&tnc->rx_stats.high_water, __ATOMIC_RELAXED);
     return 0;
 }
 
@@ -459,30 +878,30 @@ int ax25_receive_data(ax25_tnc_t* tnc, ax25_address_t* remote_addr,
         return -1;
     }
     
-    if (!tnc->frame_ready) {
-        return 0; // No frame ready
-    }
-    
-    // Check if this is an I frame
-    if ((tnc->rx_frame.control & 0x01) != 0) {
-        return 0; // Not an I frame
-    }
+    ax25_rx_queue_t* queue = &tnc->rx_queues[AX25_RX_QUEUE_DATA];
+    ax25_frame_t frame;
+    uint32_t head;
+    do {
+        if (!ax25_rx_peek(queue, &frame, &head)) {
+            return 0; // No frame ready
+        }
+        
+        // Buffer too small: leave the frame queued
+        if (frame.info_length > *length) {
+            return -1;
+        }
+    } while (!ax25_rx_commit(queue, head));
     
     // Copy data
-    if (tnc->rx_frame.info_length > *length) {
-        return -1; // Buffer too small
-    }
-    
-    memcpy(data, tnc->rx_frame.info, tnc->rx_frame.info_length);
-    *length = tnc->rx_frame.info_length;
+    memcpy(data, frame.info, frame.info_length);
+    *length = frame.info_length;
     
     // Set remote address
-    if (tnc->rx_frame.num_addresses >= 2) {
-        *remote_addr = tnc->rx_frame.addresses[1]; // Source address
+    if (frame.num_addresses >= 2) {
+        *remote_addr = frame.addresses[1]; // Source address
     }
     
-    tnc->frame_ready = false;
-    return tnc->rx_frame.info_length;
+    return frame.info_length;
 }
 
 // Send UI frame (for APRS)
@@ -493,49 +912,44 @@ int ax25_send_ui_frame(ax25_tnc_t* tnc, const ax25_address_t* src, const ax25_ad
         return -1;
     }
     
-    // Create UI frame
-    ax25_frame_t frame;
-    memset(&frame, 0, sizeof(ax25_frame_t));
-    
     // Set addresses
-    frame.addresses[0] = *dst;
-    frame.addresses[0].command = true;
-    frame.addresses[1] = *src;
-    frame.addresses[1].command = false;
+    ax25_address_t addresses[AX25_MAX_ADDRS];
+    addresses[0] = *dst;
+    addresses[0].command = true;
+    addresses[1] = *src;
+    addresses[1].command = false;
     
     // Add digipeaters
+    uint8_t num_addresses = 2;
     for (int i = 0; i < num_digipeaters && i < AX25_MAX_ADDRS - 2; i++) {
-        frame.addresses[2 + i] = digipeaters[i];
-        frame.addresses[2 + i].command = false;
-        frame.addresses[2 + i].has_been_repeated = true;
+        addresses[num_addresses] = digipeaters[i];
+        addresses[num_addresses].command = false;
+        addresses[num_addresses].has_been_repeated = true;
+        num_addresses++;
     }
     
-    frame.num_addresses = 2 + num_digipeaters;
-    
-    // Set control and PID
-    frame.control = AX25_CTRL_UI;
-    frame.pid = pid;
+    // Encode the UI header
+    ax25_header_template_t tmpl;
+    if (ax25_header_template_init(&tmpl, addresses, num_addresses, AX25_CTRL_UI, pid) != 0) {
+        return -1;
+    }
     
-    // Set information field
+    // Set information field (referenced in place)
     if (info_len > AX25_MAX_INFO) {
         info_len = AX25_MAX_INFO;
     }
-    memcpy(frame.info, info, info_len);
-    frame.info_length = info_len;
-    
-    frame.valid = true;
     
-    // Encode and send frame
-    uint8_t encoded[512];
-    uint16_t encoded_len = sizeof(encoded);
-    if (ax25_encode_frame(&frame, encoded, &encoded_len) != 0) {
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, info, info_len, fcs, iov);
+    if (iovcnt < 0) {
         return -1;
     }
     
-    // Send via KISS interface
-    // Note: This requires the TNC to have a KISS interface
-    // KISS frame transmission is handled by the KISS protocol layer
-    // Frame encoding complete; transmission via kiss_send_frame()
+    // Send via the transmit hook (normally the KISS interface)
+    if (tnc->tx_handler && tnc->tx_handler(tnc->tx_ctx, iov, iovcnt) < 0) {
+        return -1;
+    }
     
     return 0;
 }
@@ -548,65 +962,90 @@ int ax25_receive_ui_frame(ax25_tnc_t* tnc, ax25_address_t* src, ax25_address_t*
         return -1;
     }
     
-    if (!tnc->frame_ready) {
-        return 0; // No frame ready
-    }
-    
-    // Check if this is a UI frame
-    if (tnc->rx_frame.control != AX25_CTRL_UI) {
-        return 0; // Not a UI frame
-    }
+    ax25_rx_queue_t* queue = &tnc->rx_queues[AX25_RX_QUEUE_UI];
+    ax25_frame_t frame;
+    uint32_t head;
+    do {
+        if (!ax25_rx_peek(queue, &frame, &head)) {
+            return 0; // No frame ready
+        }
+        
+        // Buffer too small: leave the frame queued
+        if (frame.info_length > *info_len) {
+            return -1;
+        }
+    } while (!ax25_rx_commit(queue, head));
     
     // Set addresses
-    if (tnc->rx_frame.num_addresses >= 2) {
-        *dst = tnc->rx_frame.addresses[0]; // Destination
-        *src = tnc->rx_frame.addresses[1]; // Source
+    if (frame.num_addresses >= 2) {
+        *dst = frame.addresses[0]; // Destination
+        *src = frame.addresses[1]; // Source
     }
     
-    // Set digipeaters
-    *num_digipeaters = 0;
-    if (tnc->rx_frame.num_addresses > 2) {
-        uint8_t max_digipeaters = tnc->rx_frame.num_addresses - 2;
+    // Set digipeaters (*num_digipeaters is the array capacity on entry;
+    // digipeaters may be NULL when the path is not wanted)
+    uint8_t max_digipeaters = 0;
+    if (frame.num_addresses > 2 && digipeaters) {
+        max_digipeaters = frame.num_addresses - 2;
         if (max_digipeaters > *num_digipeaters) {
             max_digipeaters = *num_digipeaters;
         }
         
         for (int i = 0; i < max_digipeaters; i++) {
-            digipeaters[i] = tnc->rx_frame.addresses[2 + i];
+            digipeaters[i] = frame.addresses[2 + i];
         }
-        *num_digipeaters = max_digipeaters;
     }
+    *num_digipeaters = max_digipeaters;
     
     // Set PID and information
-    *pid = tnc->rx_frame.pid;
+    *pid = frame.pid;
+    memcpy(info, frame.info, frame.info_length);
+    *info_len = frame.info_length;
     
-    if (tnc->rx_frame.info_length > *info_len) {
-        return -1; // Buffer too small
+    return frame.info_length;
+}
+
+// Advance a raw FCS register (no initial value or final inversion applied)
+uint16_t ax25_fcs_update(uint16_t reg, const uint8_t* data, uint16_t length) {
+    if (!data) {
+        return reg;
     }
-    
-    memcpy(info, tnc->rx_frame.info, tnc->rx_frame.info_length);
-    *info_len = tnc->rx_frame.info_length;
-    
-    tnc->frame_ready = false;
-    return tnc->rx_frame.info_length;
+
+    for (uint16_t i = 0; i < length; i++) {
+        reg = (reg >> 8) ^ ax25_fcs_table[(reg ^ data[i]) & 0xFF];
+    }
+
+    return reg;
 }
 
 // Calculate FCS (Frame Check Sequence)
 uint16_t ax25_calculate_fcs(const uint8_t* data, uint16_t length) {
-    uint16_t fcs = 0xFFFF;
-    
-    for (uint16_t i = 0; i < length; i++) {
-        fcs ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (fcs & 0x0001) {
-                fcs = (fcs >> 1) ^ 0x8408;
-            } else {
-                fcs = fcs >> 1;
-            }
+    return ax25_fcs_update(0xFFFF, data, length) ^ 0xFFFF;
+}
+
+// Patch an FCS after bytes [offset, offset + count) of the covered data changed.
+// The CRC is linear, so the new FCS is the old one XOR the zero-initialised
+// CRC of the difference, advanced over the unchanged bytes that follow it.
+uint16_t ax25_fcs_patch(uint16_t fcs, uint16_t length, uint16_t offset,
+                        const uint8_t* old_bytes, const uint8_t* new_bytes, uint16_t count) {
+    if (!old_bytes || !new_bytes || (uint32_t)offset + count > length) {
+        return fcs;
+    }
+
+    uint16_t reg = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        reg = (reg >> 8) ^ ax25_fcs_table[(reg ^ old_bytes[i] ^ new_bytes[i]) & 0xFF];
+    }
+
+    pthread_once(&ax25_fcs_zero_once, ax25_fcs_build_zero_matrices);
+    uint16_t zeros = length - offset - count;
+    for (int k = 0; zeros != 0 && reg != 0; k++, zeros >>= 1) {
+        if (zeros & 1) {
+            reg = ax25_fcs_matrix_apply(ax25_fcs_zero_matrix[k], reg);
         }
     }
-    
-    return fcs ^ 0xFFFF;
+
+    return fcs ^ reg;
 }
 
 // Check FCS
@@ -0,0 +1,281 @@
+//--------------------------------------------------------------------
+// AX.25 Session Table
+//
+// Hash-indexed connected-mode sessions with slab-allocated state
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "ax25_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Slab entry; the free-list link is only used while the session is released
+struct ax25_session_node {
+    ax25_connection_t session;
+    struct ax25_session_node* next_free;
+};
+
+// Pack the shifted callsign bytes and the SSID; C/R, H and the extension
+// bit are not part of a station's identity
+uint64_t ax25_address_key(const ax25_address_t* addr) {
+    if (!addr) {
+        return 0;
+    }
+
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) {
+        key = (key << 8) | addr->callsign[i];
+    }
+    return (key << 4) | ((addr->ssid >> 1) & 0x0F);
+}
+
+// 64-bit finalizer mix of the key pair
+static uint32_t ax25_session_hash(uint64_t local_key, uint64_t remote_key) {
+    uint64_t h = local_key * 0x9E3779B97F4A7C15ULL ^ remote_key;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+int ax25_session_table_init(ax25_session_table_t* table) {
+    if (!table) {
+        return -1;
+    }
+
+    memset(table, 0, sizeof(*table));
+    return 0;
+}
+
+// Free the window buffers a connected session owns
+static void ax25_session_free_windows(ax25_connection_t* session) {
+    free(session->tx_window);
+    free(session->rx_window);
+    session->tx_window = NULL;
+    session->rx_window = NULL;
+}
+
+// Release the index and every slab; outstanding session pointers become invalid
+void ax25_session_table_free(ax25_session_table_t* table) {
+    if (!table) {
+        return;
+    }
+
+    for (uint32_t i = 0; table->buckets && i <= table->mask; i++) {
+        if (table->buckets[i].session) {
+            ax25_session_free_windows(table->buckets[i].session);
+        }
+    }
+    for (uint32_t i = 0; i < table->num_slabs; i++) {
+        free(table->slabs[i]);
+    }
+    free(table->slabs);
+    free(table->buckets);
+    memset(table, 0, sizeof(*table));
+}
+
+// Place an entry known to be absent
+static void ax25_session_place(ax25_session_bucket_t* buckets, uint32_t mask,
+                               const ax25_session_bucket_t* entry) {
+    uint32_t i = entry->hash & mask;
+    while (buckets[i].session) {
+        i = (i + 1) & mask;
+    }
+    buckets[i] = *entry;
+}
+
+// Rebuild the index at twice the size (or the initial size)
+static int ax25_session_grow(ax25_session_table_t* table) {
+    uint32_t old_size = table->buckets ? table->mask + 1 : 0;
+    uint32_t size = old_size ? old_size * 2 : AX25_SESSION_MIN_BUCKETS;
+    if (size < old_size) {
+        return -1; // Index size overflow
+    }
+
+    ax25_session_bucket_t* buckets = calloc(size, sizeof(ax25_session_bucket_t));
+    if (!buckets) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < old_size; i++) {
+        if (table->buckets[i].session) {
+            ax25_session_place(buckets, size - 1, &table->buckets[i]);
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = buckets;
+    table->mask = size - 1;
+    return 0;
+}
+
+// Take a session from the free list, adding a slab if it is empty
+static ax25_connection_t* ax25_session_alloc(ax25_session_table_t* table) {
+    if (!table->free_list) {
+        struct ax25_session_node** slabs =
+            realloc(table->slabs, (table->num_slabs + 1) * sizeof(*slabs));
+        if (!slabs) {
+            return NULL;
+        }
+        table->slabs = slabs;
+
+        struct ax25_session_node* slab = malloc(AX25_SESSION_SLAB_SIZE * sizeof(*slab));
+        if (!slab) {
+            return NULL;
+        }
+        slabs[table->num_slabs++] = slab;
+
+        for (int i = AX25_SESSION_SLAB_SIZE - 1; i >= 0; i--) {
+            slab[i].next_free = table->free_list;
+            table->free_list = &slab[i];
+        }
+    }
+
+    struct ax25_session_node* node = table->free_list;
+    table->free_list = node->next_free;
+    return &node->session;
+}
+
+static void ax25_session_release(ax25_session_table_t* table, ax25_connection_t* session) {
+    // An armed timer would otherwise fire on a recycled node
+    timer_wheel_cancel(table->timers, &session->t1);
+    timer_wheel_cancel(table->timers, &session->t2);
+    timer_wheel_cancel(table->timers, &session->t3);
+    ax25_session_free_windows(session);
+
+    // The session is the node's first member
+    struct ax25_session_node* node = (struct ax25_session_node*)session;
+    node->next_free = table->free_list;
+    table->free_list = node;
+}
+
+// Bucket holding the pair, or -1
+static int64_t ax25_session_lookup(const ax25_session_table_t* table, uint64_t local_key,
+                                   uint64_t remote_key, uint32_t hash) {
+    if (!table->buckets) {
+        return -1;
+    }
+
+    uint32_t i = hash & table->mask;
+    while (table->buckets[i].session) {
+        const ax25_session_bucket_t* bucket = &table->buckets[i];
+        if (bucket->hash == hash && bucket->local_key == local_key &&
+            bucket->remote_key == remote_key) {
+            return i;
+        }
+        i = (i + 1) & table->mask;
+    }
+    return -1;
+}
+
+// Find the session for a (local, remote) pair
+ax25_connection_t* ax25_session_find(const ax25_session_table_t* table,
+                                     const ax25_address_t* local, const ax25_address_t* remote) {
+    if (!table || !local || !remote) {
+        return NULL;
+    }
+
+    uint64_t local_key = ax25_address_key(local);
+    uint64_t remote_key = ax25_address_key(remote);
+    int64_t i = ax25_session_lookup(table, local_key, remote_key,
+                                    ax25_session_hash(local_key, remote_key));
+    return (i < 0) ? NULL : table->buckets[i].session;
+}
+
+// Find or create the session for a (local, remote) pair
+ax25_connection_t* ax25_session_insert(ax25_session_table_t* table, const ax25_address_t* local,
+                                       const ax25_address_t* remote) {
+    if (!table || !local || !remote) {
+        return NULL;
+    }
+
+    uint64_t local_key = ax25_address_key(local);
+    uint64_t remote_key = ax25_address_key(remote);
+    uint32_t hash = ax25_session_hash(local_key, remote_key);
+    int64_t i = ax25_session_lookup(table, local_key, remote_key, hash);
+    if (i >= 0) {
+        return table->buckets[i].session;
+    }
+
+    // Keep the load factor below 3/4 so probe sequences stay short
+    if (!table->buckets || (uint64_t)(table->count + 1) * 4 > (uint64_t)(table->mask + 1) * 3) {
+        if (ax25_session_grow(table) != 0) {
+            return NULL;
+        }
+    }
+
+    ax25_connection_t* session = ax25_session_alloc(table);
+    if (!session) {
+        return NULL;
+    }
+    memset(session, 0, sizeof(*session));
+    session->local_addr = *local;
+    session->remote_addr = *remote;
+    session->state = AX25_STATE_DISCONNECTED;
+
+    ax25_session_bucket_t entry = { local_key, remote_key, hash, session };
+    ax25_session_place(table->buckets, table->mask, &entry);
+    table->count++;
+    return session;
+}
+
+// Remove a session. Later entries of the probe run are shifted back into
+// the hole instead of leaving a tombstone, so lookups never slow down as
+// sessions come and go.
+int ax25_session_remove(ax25_session_table_t* table, const ax25_address_t* local,
+                        const ax25_address_t* remote) {
+    if (!table || !local || !remote) {
+        return -1;
+    }
+
+    uint64_t local_key = ax25_address_key(local);
+    uint64_t remote_key = ax25_address_key(remote);
+    int64_t found = ax25_session_lookup(table, local_key, remote_key,
+                                        ax25_session_hash(local_key, remote_key));
+    if (found < 0) {
+        return -1;
+    }
+
+    ax25_session_release(table, table->buckets[found].session);
+
+    uint32_t hole = (uint32_t)found;
+    uint32_t j = hole;
+    for (;;) {
+        j = (j + 1) & table->mask;
+        if (!table->buckets[j].session) {
+            break;
+        }
+        // Move the entry if the hole lies between its home bucket and j
+        uint32_t home = table->buckets[j].hash & table->mask;
+        if (((j - home) & table->mask) >= ((j - hole) & table->mask)) {
+            table->buckets[hole] = table->buckets[j];
+            hole = j;
+        }
+    }
+    table->buckets[hole].session = NULL;
+    table->count--;
+    return 0;
+}
+
+uint32_t ax25_session_count(const ax25_session_table_t* table) {
+    return table ? table->count : 0;
+}
+
+// Visit every live session in index order
+int ax25_session_foreach(ax25_session_table_t* table, ax25_session_visit_t visit, void* ctx) {
+    if (!table || !visit) {
+        return -1;
+    }
+
+    if (!table->buckets) {
+        return 0;
+    }
+    for (uint32_t i = 0; i <= table->mask; i++) {
+        if (table->buckets[i].session) {
+            visit(ctx, table->buckets[i].session);
+        }
+    }
+    return 0;
+}
@@ -14,11 +14,14 @@
 
 #include "ax25_to_m17_impl.h"
 
+#include <chrono>
 #include <cstring>
+#include <stdexcept>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <iostream>
 #include <m17_ax25_bridge.h>
+#include <timer_wheel.h>
 #include <volk/volk.h>
 
 namespace gr {
@@ -29,49 +32,112 @@ namespace m17_bridge {
  * \param callsign Source callsign for M17 frames
  * \param destination Destination callsign for M17 frames
  * \param enable_fec Enable FX.25 Forward Error Correction
+ * \param batch_window_ms Batching window in milliseconds (0 = off)
+ * \param batch_max_bytes Largest aggregated packet in bytes
  * \return Shared pointer to the converter block
  */
 ax25_to_m17::sptr ax25_to_m17::make(const std::string& callsign, const std::string& destination,
-                                    bool enable_fec) {
-    return gnuradio::make_block_sptr<ax25_to_m17_impl>(callsign, destination, enable_fec);
+                                    bool enable_fec, int batch_window_ms, int batch_max_bytes) {
+    return gnuradio::make_block_sptr<ax25_to_m17_impl>(callsign, destination, enable_fec,
+                                                       batch_window_ms, batch_max_bytes);
 }
 
 ax25_to_m17_impl::ax25_to_m17_impl(const std::string& callsign, const std::string& destination,
-                                   bool enable_fec)
-    : gr::sync_block("ax25_to_m17", gr::io_signature::make(1, 1, sizeof(uint8_t)),
-                     gr::io_signature::make(1, 1, sizeof(uint8_t))),
+                                   bool enable_fec, int batch_window_ms, int batch_max_bytes)
+    : gr::block("ax25_to_m17", gr::io_signature::make(1, 1, sizeof(uint8_t)),
+                gr::io_signature::make(1, 1, sizeof(uint8_t))),
       d_callsign(callsign), d_destination(destination), d_enable_fec(enable_fec), d_frame_buffer(),
-      d_frame_length(0), d_state(STATE_IDLE), d_frame_counter(0), d_bit_stuffer(0), d_bit_count(0) {
+      d_frame_length(0), d_state(STATE_IDLE), d_frame_counter(0), d_bit_stuffer(0), d_bit_count(0),
+      d_batch_window_ms(batch_window_ms < 0 ? 0 : batch_window_ms), d_stopping(false) {
+    if (batch_max_bytes < 0 || m17_packet_batch_init(&d_batch, batch_max_bytes) != 0) {
+        throw std::invalid_argument("ax25_to_m17: batch_max_bytes must be 3.." +
+                                    std::to_string(M17_PACKET_MAX_DATA));
+    }
+
     // Initialize M17 frame structure
     initialize_m17_frame();
 
-    // Set up message ports for control
+    // Set up message ports for control and batch flushing
     message_port_register_in(pmt::mp("control"));
     set_msg_handler(pmt::mp("control"), [this](pmt::pmt_t msg) { handle_control_message(msg); });
+    message_port_register_in(pmt::mp("flush"));
+    set_msg_handler(pmt::mp("flush"), [this](pmt::pmt_t) {
+        std::lock_guard<std::mutex> lock(d_batch_mutex);
+        flush_batch();
+    });
+}
+
+ax25_to_m17_impl::~ax25_to_m17_impl() { stop(); }
+
+bool ax25_to_m17_impl::start() {
+    d_stopping = false;
+    d_flush_thread = std::thread([this] { run_flush_timer(); });
+    return true;
 }
 
-ax25_to_m17_impl::~ax25_to_m17_impl() {}
+bool ax25_to_m17_impl::stop() {
+    {
+        std::lock_guard<std::mutex> lock(d_batch_mutex);
+        d_stopping = true;
+    }
+    d_batch_cond.notify_all();
+    if (d_flush_thread.joinable()) {
+        d_flush_thread.join();
+    }
+    return true;
+}
+
+void ax25_to_m17_impl::run_flush_timer() {
+    std::unique_lock<std::mutex> lock(d_batch_mutex);
+    while (!d_stopping) {
+        if (d_batch_window_ms == 0 || d_batch.count == 0) {
+            d_batch_cond.wait(lock); // Until a batch opens
+            continue;
+        }
+
+        uint64_t due_ms = d_batch.opened_ms + d_batch_window_ms;
+        uint64_t now_ms = timer_wheel_clock_ms();
+        if (now_ms < due_ms) {
+            d_batch_cond.wait_for(lock, std::chrono::milliseconds(due_ms - now_ms));
+            continue;
+        }
+
+        // Message handlers run on the block thread, which then sends the
+        // batch out through general_work even without new input
+        uint64_t opened_ms = d_batch.opened_ms;
+        lock.unlock();
+        post(pmt::mp("flush"), pmt::PMT_T);
+        lock.lock();
+        d_batch_cond.wait(lock, [&] {
+            return d_stopping || d_batch.count == 0 || d_batch.opened_ms != opened_ms;
+        });
+    }
+}
 
 void ax25_to_m17_impl::initialize_m17_frame() {
-    // M17 frame structure: sync word + payload + CRC
+    // Bridge frame marker (0x5D 0x5F) and frame type, ahead of each
+    // packet chunk and its metadata byte
     d_m17_frame.clear();
-
-    // M17 sync word (0x5D)
     d_m17_frame.push_back(0x5D);
+    d_m17_frame.push_back(0x5F);
+    d_m17_frame.push_back(M17_FRAME_TYPE_PACKET);
+}
 
-    // Frame type (data frame)
-    d_m17_frame.push_back(0x00);
+void ax25_to_m17_impl::forecast(int /*noutput_items*/, gr_vector_int& ninput_items_required) {
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
+    ninput_items_required[0] = d_output_buffer.empty() ? 1 : 0;
 }
 
-int ax25_to_m17_impl::work(int noutput_items, gr_vector_const_void_star& input_items,
-                           gr_vector_void_star& output_items) {
+int ax25_to_m17_impl::general_work(int noutput_items, gr_vector_int& ninput_items,
+                                   gr_vector_const_void_star& input_items,
+                                   gr_vector_void_star& output_items) {
     const uint8_t* in = (const uint8_t*)input_items[0];
     uint8_t* out = (uint8_t*)output_items[0];
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
 
-    int consumed = 0;
     int produced = 0;
 
-    for (int i = 0; i < noutput_items; i++) {
+    for (int i = 0; i < ninput_items[0]; i++) {
         switch (d_state) {
         case STATE_IDLE:
             // Look for AX.25 frame start (flag 0x7E)
@@ -82,7 +148,6 @@ int ax25_to_m17_impl::work(int noutput_items, gr_vector_const_void_star& input_i
                 d_bit_stuffer = 0;
                 d_bit_count = 0;
             }
-            consumed++;
             break;
 
         case STATE_FRAME_START:
@@ -94,10 +159,15 @@ int ax25_to_m17_impl::work(int noutput_items, gr_vector_const_void_star& input_i
                 d_frame_buffer.push_back(in[i]);
                 d_frame_length++;
             }
-            consumed++;
             break;
         }
     }
+    consume_each(ninput_items[0]);
+
+    // Send the batch once its oldest frame has waited the window out
+    if (m17_packet_batch_due(&d_batch, d_batch_window_ms, timer_wheel_clock_ms())) {
+        flush_batch();
+    }
 
     // Output any converted M17 frames
     if (!d_output_buffer.empty()) {
@@ -111,71 +181,67 @@ int ax25_to_m17_impl::work(int noutput_items, gr_vector_const_void_star& input_i
 }
 
 void ax25_to_m17_impl::process_ax25_frame() {
-    if (d_frame_buffer.size() < 10) { // Minimum AX.25 frame size
-        return;                       // Incomplete frame
+    // Two addresses, control field and FCS at least
+    if (d_frame_buffer.size() < 2 * AX25_ADDR_LEN + 1 + 2) {
+        return; // Incomplete frame
     }
 
-    // Extract AX.25 frame components
-    std::vector<uint8_t> ax25_payload;
+    // The whole frame goes across; the far side recomputes the FCS
+    std::vector<uint8_t> ax25_frame(d_frame_buffer.begin(), d_frame_buffer.end() - 2);
+    convert_ax25_to_m17(ax25_frame);
+}
 
-    // Skip AX.25 header (destination, source, control, PID)
-    size_t header_size = 14; // 6 + 1 + 6 + 1 for dest/src addresses and control
-    if (d_frame_buffer.size() > header_size + 2) { // +2 for FCS
-        ax25_payload.assign(d_frame_buffer.begin() + header_size,
-                            d_frame_buffer.end() - 2); // Skip FCS
+void ax25_to_m17_impl::convert_ax25_to_m17(const std::vector<uint8_t>& ax25_frame) {
+    if (d_batch_window_ms > 0) {
+        uint64_t now_ms = timer_wheel_clock_ms();
+        if (m17_packet_batch_add(&d_batch, ax25_frame.data(), ax25_frame.size(), now_ms) == 0) {
+            if (d_batch.count == 1) {
+                d_batch_cond.notify_one(); // A new window starts
+            }
+            return;
+        }
+        // Full: send what is waiting and start over with this frame
+        flush_batch();
+        if (m17_packet_batch_add(&d_batch, ax25_frame.data(), ax25_frame.size(), now_ms) == 0) {
+            d_batch_cond.notify_one();
+            return;
+        }
+        // Too long for any container; it goes on its own
     }
 
-    // Convert AX.25 payload to M17 frame
-    convert_ax25_to_m17(ax25_payload);
+    uint8_t frames[M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN];
+    int count = m17_packet_encode(M17_PACKET_PROTO_AX25, ax25_frame.data(), ax25_frame.size(),
+                                  frames, sizeof(frames));
+    if (count < 0) {
+        return; // Longer than one M17 packet
+    }
+    emit_packet_frames(frames, count);
 }
 
-void ax25_to_m17_impl::convert_ax25_to_m17(const std::vector<uint8_t>& ax25_payload) {
-    // Create M17 frame
-    std::vector<uint8_t> m17_frame = d_m17_frame;
-
-    // Add M17 payload (AX.25 information field)
-    m17_frame.insert(m17_frame.end(), ax25_payload.begin(), ax25_payload.end());
-
-    // Pad to M17 frame size if necessary
-    while (m17_frame.size() < 48) {
-        m17_frame.push_back(0x00);
+void ax25_to_m17_impl::flush_batch() {
+    uint8_t frames[M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN];
+    int count = m17_packet_batch_flush(&d_batch, frames, sizeof(frames));
+    if (count > 0) {
+        emit_packet_frames(frames, count);
+        d_batch_cond.notify_one();
     }
-
-    // Calculate and add M17 CRC
-    uint16_t crc = calculate_m17_crc(m17_frame);
-    m17_frame.push_back(crc & 0xFF);
-    m17_frame.push_back((crc >> 8) & 0xFF);
-
-    // Store for output
-    d_output_buffer.insert(d_output_buffer.end(), m17_frame.begin(), m17_frame.end());
-
-    d_frame_counter++;
 }
 
-uint16_t ax25_to_m17_impl::calculate_m17_crc(const std::vector<uint8_t>& frame) {
-    // M17 uses CRC-16-CCITT
-    uint16_t crc = 0xFFFF;
-
-    for (uint8_t byte : frame) {
-        crc ^= (byte << 8);
-        for (int i = 0; i < 8; i++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
-            }
-        }
+void ax25_to_m17_impl::emit_packet_frames(const uint8_t* frames, int count) {
+    for (int i = 0; i < count; i++) {
+        const uint8_t* frame = &frames[i * M17_PACKET_FRAME_LEN];
+        d_output_buffer.insert(d_output_buffer.end(), d_m17_frame.begin(), d_m17_frame.end());
+        d_output_buffer.insert(d_output_buffer.end(), frame, frame + M17_PACKET_FRAME_LEN);
     }
-
-    return crc;
+    d_frame_counter += count;
 }
 
 void ax25_to_m17_impl::handle_control_message(pmt::pmt_t msg) {
     if (pmt::is_dict(msg)) {
         // Handle configuration changes
         if (pmt::dict_has_key(msg, pmt::mp("destination"))) {
-            d_destination =
-                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("destination"), pmt::mp("")));
+            set_destination(
+                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("destination"), pmt::mp(""))));
         }
 
         if (pmt::dict_has_key(msg, pmt::mp("callsign"))) {
@@ -186,6 +252,9 @@ void ax25_to_m17_impl::handle_control_message(pmt::pmt_t msg) {
 }
 
 void ax25_to_m17_impl::set_destination(const std::string& destination) {
+    // Frames already batched belong to the old destination
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
+    flush_batch();
     d_destination = destination;
 }
 
@@ -197,5 +266,32 @@ void ax25_to_m17_impl::set_fec_enabled(bool enabled) {
     d_enable_fec = enabled;
 }
 
+void ax25_to_m17_impl::set_batch_window(int window_ms) {
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
+    d_batch_window_ms = window_ms < 0 ? 0 : window_ms;
+    if (d_batch_window_ms == 0) {
+        flush_batch();
+    }
+    d_batch_cond.notify_one(); // The open batch may now be due
+}
+
+void ax25_to_m17_impl::set_batch_max_bytes(int max_bytes) {
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
+    if (max_bytes < 3 || max_bytes > M17_PACKET_MAX_DATA) {
+        return; // Out of range; keep the current limit
+    }
+    if (max_bytes < d_batch.length) {
+        flush_batch();
+    }
+    m17_packet_batch_set_max_length(&d_batch, max_bytes);
+}
+
+uint64_t ax25_to_m17_impl::airtime_saved_ms() const {
+    std::lock_guard<std::mutex> lock(d_batch_mutex);
+    m17_packet_batch_stats_t stats;
+    m17_packet_batch_get_stats(&d_batch, &stats);
+    return stats.airtime_saved_ms;
+}
+
 } // namespace m17_bridge
 } // namespace gr
@@ -0,0 +1,152 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_AX25_TO_M17_IMPL_H
+#define INCLUDED_M17_BRIDGE_AX25_TO_M17_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/block.h>
+#include <ax25_to_m17.h>
+#include <m17_packet.h>
+#include <pmt/pmt.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of AX.25 to M17 protocol converter
+ * \ingroup m17_bridge
+ *
+ * Each AX.25 frame (addresses through information field, FCS removed)
+ * is sent as an M17 packet with the AX.25 protocol identifier, cut into
+ * as many 25-byte packet frames as it needs. With batching on, frames
+ * collect in an aggregation container until the window closes or the
+ * container is full.
+ *
+ * Output does not follow input one for one, so this is a general block.
+ * A timer thread waits for the open batch's window to close and posts a
+ * "flush" message; the block thread sends the batch, and forecast asks
+ * for no input while output is waiting, so it goes out on an idle
+ * channel too.
+ */
+class ax25_to_m17_impl : public ax25_to_m17 {
+  private:
+    std::string d_callsign;                         //!< Source callsign for M17 frames
+    std::string d_destination;                      //!< Destination callsign for M17 frames
+    bool d_enable_fec;                              //!< Enable Forward Error Correction
+    std::vector<uint8_t> d_frame_buffer;            //!< AX.25 frame being received
+    int d_frame_length;                             //!< Current frame length
+    enum { STATE_IDLE, STATE_FRAME_START } d_state; //!< Processing state
+    int d_frame_counter;                            //!< M17 packet frames produced
+    uint8_t d_bit_stuffer;                          //!< Bit stuffing shift register
+    int d_bit_count;                                //!< Consecutive one bits seen
+    std::vector<uint8_t> d_m17_frame;               //!< Marker and frame type of each packet frame
+    std::vector<uint8_t> d_output_buffer;           //!< Converted frames waiting for output
+    int d_batch_window_ms;                          //!< Batching window (0 = off)
+    m17_packet_batch_t d_batch;                     //!< Frames waiting to share a packet
+    mutable std::mutex d_batch_mutex;               //!< Guards the batch and output buffer
+    std::condition_variable d_batch_cond;           //!< Wakes the flush timer
+    std::thread d_flush_thread;                     //!< Flush timer while running
+    bool d_stopping;                                //!< Tells the flush timer to exit
+
+  public:
+    /*!
+     * \brief Constructor for AX.25 to M17 converter
+     * \param callsign Source callsign for M17 frames
+     * \param destination Destination callsign for M17 frames
+     * \param enable_fec Enable Forward Error Correction
+     * \param batch_window_ms Batching window in milliseconds (0 = off)
+     * \param batch_max_bytes Largest aggregated packet in bytes
+     */
+    ax25_to_m17_impl(const std::string& callsign, const std::string& destination, bool enable_fec,
+                     int batch_window_ms, int batch_max_bytes);
+
+    /*!
+     * \brief Destructor
+     */
+    ~ax25_to_m17_impl();
+
+    /*!
+     * \brief Input needed: none while converted frames wait for output
+     */
+    void forecast(int noutput_items, gr_vector_int& ninput_items_required);
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param ninput_items Number of input items available
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int general_work(int noutput_items, gr_vector_int& ninput_items,
+                     gr_vector_const_void_star& input_items, gr_vector_void_star& output_items);
+
+    bool start();
+    bool stop();
+
+    void set_destination(const std::string& destination);
+    void set_callsign(const std::string& callsign);
+    void set_fec_enabled(bool enabled);
+    void set_batch_window(int window_ms);
+    void set_batch_max_bytes(int max_bytes);
+    uint64_t airtime_saved_ms() const;
+
+  private:
+    /*!
+     * \brief Prepare the bytes that open every M17 packet frame
+     */
+    void initialize_m17_frame();
+
+    /*!
+     * \brief Strip the FCS of a received frame and convert it
+     */
+    void process_ax25_frame();
+
+    /*!
+     * \brief Segment an AX.25 frame into M17 packet frames
+     * \param ax25_frame Addresses through information field, no FCS
+     */
+    void convert_ax25_to_m17(const std::vector<uint8_t>& ax25_frame);
+
+    /*!
+     * \brief Send the waiting batch as one M17 packet
+     */
+    void flush_batch();
+
+    /*!
+     * \brief Flush timer: posts "flush" when the open batch's window closes
+     */
+    void run_flush_timer();
+
+    /*!
+     * \brief Queue M17 packet frames for output
+     * \param frames Frames from m17_packet_encode, back to back
+     * \param count Number of frames
+     */
+    void emit_packet_frames(const uint8_t* frames, int count);
+
+    /*!
+     * \brief Handle control messages
+     * \param msg Control message
+     */
+    void handle_control_message(pmt::pmt_t msg);
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_AX25_TO_M17_IMPL_H */
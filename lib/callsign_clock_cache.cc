@@ -0,0 +1,213 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "callsign_clock_cache.h"
+
+#include <m17_callsign.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace gr {
+namespace m17_bridge {
+
+callsign_clock_cache::table::table(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 1)),
+      buckets((this->capacity + BUCKET_WAYS - 1) / BUCKET_WAYS),
+      slots(new std::atomic<uint64_t>[this->capacity]),
+      hands(new std::atomic<unsigned>[buckets]) {
+    for (size_t i = 0; i < this->capacity; i++) {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < buckets; i++) {
+        hands[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t callsign_clock_cache::table::bucket_of(uint64_t key) const {
+    return ((key * 0x9E3779B97F4A7C15ULL) >> 32) % buckets;
+}
+
+callsign_clock_cache::callsign_clock_cache(size_t capacity)
+    : d_table(new table(capacity)), d_epoch(0), d_readers{{0}, {0}}, d_hits(0),
+      d_misses(0), d_evictions(0) {}
+
+callsign_clock_cache::~callsign_clock_cache() { delete d_table.load(); }
+
+callsign_clock_cache::table* callsign_clock_cache::read_lock(unsigned& slot) const {
+    // As in callsign_mapper_impl::read_lock(): the registration only counts
+    // once the epoch is seen unchanged, so set_capacity() waits for it
+    for (;;) {
+        slot = d_epoch.load() & 1;
+        d_readers[slot].fetch_add(1);
+        if ((d_epoch.load() & 1) == slot) {
+            return d_table.load();
+        }
+        d_readers[slot].fetch_sub(1);
+    }
+}
+
+void callsign_clock_cache::read_unlock(unsigned slot) const {
+    d_readers[slot].fetch_sub(1);
+}
+
+bool callsign_clock_cache::encode(const std::string& callsign, uint64_t& key) {
+    return m17_callsign_to_value(callsign.c_str(), &key) == 0;
+}
+
+bool callsign_clock_cache::lookup(const std::string& callsign) {
+    uint64_t key;
+    bool hit = false;
+    if (encode(callsign, key)) {
+        unsigned slot;
+        const table& t = *read_lock(slot);
+        size_t bucket = t.bucket_of(key);
+        for (size_t i = t.bucket_begin(bucket); i < t.bucket_begin(bucket + 1); i++) {
+            uint64_t word = t.slots[i].load(std::memory_order_relaxed);
+            if ((word & KEY_MASK) == key) {
+                // Only write when the bit changes, so hot entries stay shared
+                if (!(word & REFERENCED)) {
+                    t.slots[i].fetch_or(REFERENCED, std::memory_order_relaxed);
+                }
+                hit = true;
+                break;
+            }
+        }
+        read_unlock(slot);
+    }
+
+    (hit ? d_hits : d_misses).fetch_add(1, std::memory_order_relaxed);
+    return hit;
+}
+
+bool callsign_clock_cache::insert_key(table& t, uint64_t key) {
+    size_t bucket = t.bucket_of(key);
+    size_t begin = t.bucket_begin(bucket);
+    size_t ways = t.bucket_begin(bucket + 1) - begin;
+
+    // Already present (another thread got there first), or a free slot
+    for (size_t i = begin; i < begin + ways; i++) {
+        uint64_t word = t.slots[i].load(std::memory_order_relaxed);
+        if ((word & KEY_MASK) == key) {
+            return true;
+        }
+    }
+    for (size_t i = begin; i < begin + ways; i++) {
+        uint64_t empty = 0;
+        if (t.slots[i].compare_exchange_strong(empty, key, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    // Sweep the clock hand: referenced entries get a second chance. Two
+    // full turns always find a victim unless other threads keep setting
+    // bits, in which case the callsign is simply not cached.
+    for (size_t turn = 0; turn < 2 * ways; turn++) {
+        size_t i = begin + t.hands[bucket].fetch_add(1, std::memory_order_relaxed) % ways;
+        uint64_t word = t.slots[i].load(std::memory_order_relaxed);
+        if (word & REFERENCED) {
+            t.slots[i].compare_exchange_strong(word, word & ~REFERENCED,
+                                               std::memory_order_relaxed);
+        } else if (t.slots[i].compare_exchange_strong(word, key, std::memory_order_relaxed)) {
+            if (word) {
+                d_evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void callsign_clock_cache::insert(const std::string& callsign) {
+    uint64_t key;
+    if (encode(callsign, key)) {
+        unsigned slot;
+        insert_key(*read_lock(slot), key);
+        read_unlock(slot);
+    }
+}
+
+void callsign_clock_cache::erase(const std::string& callsign) {
+    uint64_t key;
+    if (!encode(callsign, key)) {
+        return;
+    }
+
+    unsigned slot;
+    table& t = *read_lock(slot);
+    size_t bucket = t.bucket_of(key);
+    for (size_t i = t.bucket_begin(bucket); i < t.bucket_begin(bucket + 1); i++) {
+        uint64_t word = t.slots[i].load(std::memory_order_relaxed);
+        if ((word & KEY_MASK) == key) {
+            t.slots[i].compare_exchange_strong(word, 0, std::memory_order_relaxed);
+        }
+    }
+    read_unlock(slot);
+}
+
+void callsign_clock_cache::clear() {
+    unsigned slot;
+    table& t = *read_lock(slot);
+    for (size_t i = 0; i < t.capacity; i++) {
+        t.slots[i].store(0, std::memory_order_relaxed);
+    }
+    read_unlock(slot);
+}
+
+void callsign_clock_cache::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(d_resize_mutex);
+
+    // Referenced entries move last so a smaller table keeps them. Entries
+    // inserted into the old table while it is copied may be lost; they are
+    // only cache entries and come back on their next lookup.
+    table* old_table = d_table.load();
+    const table& old = *old_table;
+    std::unique_ptr<table> resized(new table(capacity));
+    for (uint64_t pass : { uint64_t(0), REFERENCED }) {
+        for (size_t i = 0; i < old.capacity; i++) {
+            uint64_t word = old.slots[i].load(std::memory_order_relaxed);
+            if (word && (word & REFERENCED) == pass && !insert_key(*resized, word & KEY_MASK)) {
+                d_evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    d_table.store(resized.release());
+
+    // Flip the epoch so new operations register in the other slot; those
+    // still counted in the old slot may hold old_table
+    unsigned old_slot = d_epoch.fetch_add(1) & 1;
+    while (d_readers[old_slot].load() != 0) {
+        std::this_thread::yield();
+    }
+
+    delete old_table;
+}
+
+callsign_clock_cache::stats callsign_clock_cache::get_stats() const {
+    unsigned slot;
+    const table& t = *read_lock(slot);
+    size_t size = 0;
+    for (size_t i = 0; i < t.capacity; i++) {
+        size += t.slots[i].load(std::memory_order_relaxed) != 0;
+    }
+    size_t capacity = t.capacity;
+    read_unlock(slot);
+    return stats{ d_hits.load(std::memory_order_relaxed),
+                  d_misses.load(std::memory_order_relaxed),
+                  d_evictions.load(std::memory_order_relaxed), size, capacity };
+}
+
+} // namespace m17_bridge
+} // namespace gr
@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_CALLSIGN_CLOCK_CACHE_H
+#define INCLUDED_M17_BRIDGE_CALLSIGN_CLOCK_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Capacity-bounded CLOCK cache of auto-mapped callsigns
+ * \ingroup m17_bridge
+ *
+ * Remembers the callsigns that were mapped on the fly because they have no
+ * pinned (manual) entry. Auto mappings are identities, so only the callsign
+ * is kept, packed into its 48-bit M17 base-40 value. Callsigns that do not
+ * encode (too long, or characters outside base-40) are never cached.
+ *
+ * Slots are grouped into buckets of up to eight by hash; each slot is one
+ * atomic word holding the callsign and a reference bit. Once a bucket is
+ * full, its clock hand evicts the first entry not referenced since the hand
+ * last passed, approximating LRU. lookup(), insert() and erase() are
+ * lock-free. set_capacity() swaps in a new table and frees the old one once
+ * the operations that may still be using it have drained, using the same
+ * two-slot epoch scheme as the mapper's snapshots.
+ */
+class callsign_clock_cache {
+  public:
+    /*!
+     * \brief Cache counters
+     */
+    struct stats {
+        uint64_t hits;      //!< Lookups served from the cache
+        uint64_t misses;    //!< Lookups not found in the cache
+        uint64_t evictions; //!< Entries dropped to respect the capacity
+        size_t size;        //!< Current number of entries
+        size_t capacity;    //!< Maximum number of entries
+    };
+
+    /*!
+     * \brief Constructor
+     * \param capacity Maximum number of entries (at least one is kept)
+     */
+    explicit callsign_clock_cache(size_t capacity);
+    ~callsign_clock_cache();
+
+    callsign_clock_cache(const callsign_clock_cache&) = delete;
+    callsign_clock_cache& operator=(const callsign_clock_cache&) = delete;
+
+    /*!
+     * \brief Look up a callsign and mark it referenced
+     * \param callsign Callsign to look up
+     * \return True on a hit
+     */
+    bool lookup(const std::string& callsign);
+
+    /*!
+     * \brief Add a callsign, evicting from its bucket if full
+     * \param callsign Callsign
+     */
+    void insert(const std::string& callsign);
+
+    /*!
+     * \brief Remove a callsign if present
+     * \param callsign Callsign
+     */
+    void erase(const std::string& callsign);
+
+    /*!
+     * \brief Remove all entries; counters are kept
+     */
+    void clear();
+
+    /*!
+     * \brief Change the capacity, moving over as many entries as fit
+     * \param capacity New maximum number of entries
+     */
+    void set_capacity(size_t capacity);
+
+    /*!
+     * \brief Snapshot of the cache counters
+     */
+    stats get_stats() const;
+
+  private:
+    static constexpr size_t BUCKET_WAYS = 8;
+    static constexpr uint64_t REFERENCED = 1ULL << 63;
+    static constexpr uint64_t KEY_MASK = (1ULL << 48) - 1;
+
+    /*!
+     * \brief Slot array; bucket b covers [bucket_begin(b), bucket_begin(b + 1))
+     */
+    struct table {
+        explicit table(size_t capacity);
+
+        size_t bucket_of(uint64_t key) const;
+        size_t bucket_begin(size_t bucket) const { return bucket * capacity / buckets; }
+
+        size_t capacity;                                //!< Total slots
+        size_t buckets;                                 //!< Number of buckets
+        std::unique_ptr<std::atomic<uint64_t>[]> slots; //!< Key | REFERENCED, 0 = empty
+        std::unique_ptr<std::atomic<unsigned>[]> hands; //!< Clock hand per bucket
+    };
+
+    static bool encode(const std::string& callsign, uint64_t& key);
+    bool insert_key(table& t, uint64_t key);
+
+    // Pin the current table for one operation
+    table* read_lock(unsigned& slot) const;
+    void read_unlock(unsigned slot) const;
+
+    std::atomic<table*> d_table;                  //!< Current table (owned)
+    std::atomic<unsigned> d_epoch;                //!< Selects the reader slot
+    mutable std::atomic<unsigned> d_readers[2];   //!< Active operations per epoch slot
+    std::mutex d_resize_mutex;                    //!< Serialises set_capacity
+    std::atomic<uint64_t> d_hits;                 //!< Hit counter
+    std::atomic<uint64_t> d_misses;               //!< Miss counter
+    std::atomic<uint64_t> d_evictions;            //!< Eviction counter
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_CALLSIGN_CLOCK_CACHE_H */
@@ -14,43 +14,242 @@
 
 #include "callsign_mapper_impl.h"
 
+#include <ax25_protocol.h>
+
 #include <algorithm>
+#include <cctype>
 #include <cstring>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <iostream>
 #include <map>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 #include <volk/volk.h>
 
 namespace gr {
 namespace m17_bridge {
 
-callsign_mapper::sptr callsign_mapper::make() {
-    return gnuradio::make_block_sptr<callsign_mapper_impl>();
+namespace {
+
+// Shortest frame body between flags: destination, source, control and FCS
+const int MAPPER_MIN_FRAME = 2 * AX25_ADDR_LEN + 1 + 2;
+
+// Longest frame held back waiting for its closing flag
+const int MAPPER_MAX_HELD_FRAME = 1 + AX25_MAX_ADDRS * AX25_ADDR_LEN + 2 + AX25_MAX_INFO + 2;
+
+// Padding in a callsign field: spaces per the specification, NULs as
+// written by ax25_set_address()
+bool ax25_is_padding(uint8_t c) {
+    return c == (' ' << 1) || c == 0x00;
+}
+
+// Decode a 7-byte address field into "CALL" or "CALL-SSID"
+bool ax25_field_to_callsign(const uint8_t* field, std::string& callsign) {
+    callsign.clear();
+    for (int i = 0; i < 6; i++) {
+        if (ax25_is_padding(field[i])) {
+            break;
+        }
+        char c = (char)(field[i] >> 1);
+        if ((field[i] & 0x01) || !(isupper((unsigned char)c) || isdigit((unsigned char)c))) {
+            return false;
+        }
+        callsign.push_back(c);
+    }
+
+    for (size_t i = callsign.size(); i < 6; i++) {
+        if (!ax25_is_padding(field[i])) {
+            return false; // Characters after padding
+        }
+    }
+
+    if (callsign.empty()) {
+        return false;
+    }
+
+    int ssid = (field[6] >> 1) & 0x0F;
+    if (ssid) {
+        callsign += "-" + std::to_string(ssid);
+    }
+    return true;
+}
+
+// Encode "CALL" or "CALL-SSID" into a 7-byte address field, keeping the
+// flag bits of the original SSID byte and its padding style
+bool callsign_to_ax25_field(const std::string& callsign, const uint8_t* old_field,
+                            uint8_t* new_field) {
+    size_t dash = callsign.find('-');
+    std::string base = callsign.substr(0, dash);
+    int ssid = 0;
+    if (dash != std::string::npos) {
+        std::string digits = callsign.substr(dash + 1);
+        if (digits.empty() || digits.size() > 2 ||
+            !std::all_of(digits.begin(), digits.end(), ::isdigit)) {
+            return false;
+        }
+        ssid = std::stoi(digits);
+    }
+
+    if (base.empty() || base.size() > 6 || ssid > 15) {
+        return false;
+    }
+
+    uint8_t pad = (' ' << 1);
+    for (int i = 0; i < 6; i++) {
+        if (old_field[i] == 0x00) {
+            pad = 0x00;
+        }
+    }
+
+    for (int i = 0; i < 6; i++) {
+        if (i < (int)base.size()) {
+            char c = (char)toupper((unsigned char)base[i]);
+            if (!(isupper((unsigned char)c) || isdigit((unsigned char)c))) {
+                return false;
+            }
+            new_field[i] = (uint8_t)(c << 1);
+        } else {
+            new_field[i] = pad;
+        }
+    }
+    new_field[6] = (old_field[6] & ~0x1E) | (uint8_t)(ssid << 1);
+    return true;
 }
 
-callsign_mapper_impl::callsign_mapper_impl()
+} // namespace
+
+callsign_mapper::sptr callsign_mapper::make(int auto_mapping_capacity) {
+    return gnuradio::make_block_sptr<callsign_mapper_impl>(auto_mapping_capacity);
+}
+
+callsign_mapper_impl::callsign_mapper_impl(int auto_mapping_capacity)
     : gr::sync_block("callsign_mapper", gr::io_signature::make(1, 1, sizeof(uint8_t)),
                      gr::io_signature::make(1, 1, sizeof(uint8_t))),
-      d_mapping_table(), d_reverse_mapping_table(), d_auto_mapping_enabled(true),
+      d_snapshot(new mapping_snapshot()), d_epoch(0), d_readers{{0}, {0}},
+      d_auto_mapping_enabled(true), d_auto_cache(std::max(auto_mapping_capacity, 1)),
       d_mapping_counter(0) {
-    // Set up message ports for control
+    // Set up message ports for control and statistics
     message_port_register_in(pmt::mp("control"));
     set_msg_handler(pmt::mp("control"), [this](pmt::pmt_t msg) { handle_control_message(msg); });
+    message_port_register_out(pmt::mp("stats"));
 
     // Initialize default mappings
     initialize_default_mappings();
 }
 
-callsign_mapper_impl::~callsign_mapper_impl() {}
+callsign_mapper_impl::~callsign_mapper_impl() {
+    delete d_snapshot.load();
+}
+
+bool callsign_mapper_impl::mapping_snapshot::find_forward(const std::string& m17_callsign,
+                                                         std::string& ax25_callsign) const {
+    auto it = forward.find(m17_callsign);
+    if (it != forward.end()) {
+        ax25_callsign = it->second;
+        return true;
+    }
+    if (!file || removed_forward.count(m17_callsign)) {
+        return false;
+    }
+    const char* value = callsign_snapshot_lookup_forward(file.get(), m17_callsign.c_str());
+    if (!value) {
+        return false;
+    }
+    ax25_callsign = value;
+    return true;
+}
+
+bool callsign_mapper_impl::mapping_snapshot::find_reverse(const std::string& ax25_callsign,
+                                                         std::string& m17_callsign) const {
+    auto it = reverse.find(ax25_callsign);
+    if (it != reverse.end()) {
+        m17_callsign = it->second;
+        return true;
+    }
+    if (!file || removed_reverse.count(ax25_callsign)) {
+        return false;
+    }
+    const char* value = callsign_snapshot_lookup_reverse(file.get(), ax25_callsign.c_str());
+    if (!value) {
+        return false;
+    }
+    m17_callsign = value;
+    return true;
+}
+
+const callsign_mapper_impl::mapping_snapshot*
+callsign_mapper_impl::read_lock(unsigned& slot) const {
+    // Register in the current epoch slot before loading the pointer. A writer
+    // that retires this snapshot flips the epoch first and then waits for the
+    // old slot to drain, so the pointer stays valid until read_unlock().
+    //
+    // The epoch may flip between reading it and registering; the registration
+    // then lands in a slot the next writer will not wait on. Registering only
+    // counts once the epoch is seen unchanged afterwards: any writer that
+    // retires the snapshot loaded below flips away from this slot and waits
+    // for it.
+    for (;;) {
+        slot = d_epoch.load() & 1;
+        d_readers[slot].fetch_add(1);
+        if ((d_epoch.load() & 1) == slot) {
+            return d_snapshot.load();
+        }
+        d_readers[slot].fetch_sub(1);
+    }
+}
+
+void callsign_mapper_impl::read_unlock(unsigned slot) const {
+    d_readers[slot].fetch_sub(1);
+}
+
+void callsign_mapper_impl::update_snapshot(
+    const std::function<bool(mapping_snapshot&)>& edit) {
+    std::lock_guard<std::mutex> lock(d_writer_mutex);
+
+    // Writers are serialised, so the published snapshot cannot be retired
+    // underneath us while it is copied
+    const mapping_snapshot* old_snap = d_snapshot.load();
+    mapping_snapshot* new_snap = new mapping_snapshot(*old_snap);
+    if (!edit(*new_snap)) {
+        delete new_snap;
+        return;
+    }
+
+    d_snapshot.store(new_snap);
+
+    // Grace period: new readers go to the other slot and see new_snap;
+    // readers still counted in the old slot may hold old_snap
+    unsigned old_slot = d_epoch.fetch_add(1) & 1;
+    while (d_readers[old_slot].load() != 0) {
+        std::this_thread::yield();
+    }
+
+    delete old_snap;
+}
+
+void callsign_mapper_impl::insert_mapping(mapping_snapshot& snap,
+                                          const std::string& m17_callsign,
+                                          const std::string& ax25_callsign) {
+    snap.forward[m17_callsign] = ax25_callsign;
+    snap.reverse[ax25_callsign] = m17_callsign;
+    snap.removed_forward.erase(m17_callsign);
+    snap.removed_reverse.erase(ax25_callsign);
+}
 
 void callsign_mapper_impl::initialize_default_mappings() {
-    // Add some common amateur radio callsign mappings
-    add_mapping("N0CALL", "N0CALL");
-    add_mapping("W1AW", "W1AW");
-    add_mapping("VE3KCL", "VE3KCL");
-    add_mapping("G0ABC", "G0ABC");
-    add_mapping("JA1ABC", "JA1ABC");
+    // Add some common amateur radio callsign mappings in a single update
+    update_snapshot([](mapping_snapshot& snap) {
+        insert_mapping(snap, "N0CALL", "N0CALL");
+        insert_mapping(snap, "W1AW", "W1AW");
+        insert_mapping(snap, "VE3KCL", "VE3KCL");
+        insert_mapping(snap, "G0ABC", "G0ABC");
+        insert_mapping(snap, "JA1ABC", "JA1ABC");
+        return true;
+    });
 }
 
 int callsign_mapper_impl::work(int noutput_items, gr_vector_const_void_star& input_items,
@@ -58,81 +257,157 @@ int callsign_mapper_impl::work(int noutput_items, gr_vector_const_void_star& inp
     const uint8_t* in = (const uint8_t*)input_items[0];
     uint8_t* out = (uint8_t*)output_items[0];
 
-    // Process input data and apply callsign mapping
-    for (int i = 0; i < noutput_items; i++) {
-        out[i] = in[i]; // Default: pass through unchanged
+    // Frames are delimited by AX.25 flags. The last flag and anything after
+    // it may open a frame whose closing flag has not arrived yet; hold them
+    // back (up to the longest possible frame) so the frame is rewritten whole
+    // and the next call starts at its opening flag.
+    int produced = noutput_items;
+    int scanned = noutput_items;
+    const uint8_t* last_flag = (const uint8_t*)memrchr(in, AX25_FLAG, noutput_items);
+    if (last_flag) {
+        int tail = noutput_items - (int)(last_flag - in);
+        if (tail <= MAPPER_MAX_HELD_FRAME) {
+            produced = (int)(last_flag - in);
+            if (produced == 0) {
+                return 0; // Wait for the rest of the frame
+            }
+            // The held flag still closes the frame before it
+            scanned = produced + 1;
+        }
+    }
 
-        // Apply callsign mapping if needed
-        if (d_auto_mapping_enabled) {
-            // Callsign mapping applied during frame processing
-            // Frame parsing and callsign replacement handled by protocol layers
-            apply_callsign_mapping(&out[i], 1);
+    // Unchanged data passes through with a single copy; mapped frames are
+    // then patched in place
+    memcpy(out, in, scanned);
+
+    unsigned slot;
+    const mapping_snapshot* snap = read_lock(slot);
+    if (!snap->forward.empty() || snap->file) {
+        uint8_t* end = out + scanned;
+        uint8_t* open_flag = (uint8_t*)memchr(out, AX25_FLAG, produced);
+        while (open_flag) {
+            uint8_t* close_flag =
+                (uint8_t*)memchr(open_flag + 1, AX25_FLAG, end - (open_flag + 1));
+            if (!close_flag) {
+                break;
+            }
+            apply_callsign_mapping(*snap, open_flag + 1, (int)(close_flag - open_flag - 1));
+            open_flag = close_flag;
         }
     }
+    read_unlock(slot);
 
-    return noutput_items;
+    return produced;
 }
 
 void callsign_mapper_impl::add_mapping(const std::string& m17_callsign,
                                        const std::string& ax25_callsign) {
-    d_mapping_table[m17_callsign] = ax25_callsign;
-    d_reverse_mapping_table[ax25_callsign] = m17_callsign;
+    update_snapshot([&](mapping_snapshot& snap) {
+        insert_mapping(snap, m17_callsign, ax25_callsign);
+        return true;
+    });
 }
 
 void callsign_mapper_impl::remove_mapping(const std::string& m17_callsign) {
-    auto it = d_mapping_table.find(m17_callsign);
-    if (it != d_mapping_table.end()) {
-        std::string ax25_callsign = it->second;
-        d_mapping_table.erase(it);
-        d_reverse_mapping_table.erase(ax25_callsign);
-    }
+    update_snapshot([&](mapping_snapshot& snap) {
+        std::string ax25_callsign;
+        if (!snap.find_forward(m17_callsign, ax25_callsign)) {
+            return false;
+        }
+        snap.forward.erase(m17_callsign);
+        snap.reverse.erase(ax25_callsign);
+        if (snap.file) {
+            // Hide the entry in the mapped table as well
+            snap.removed_forward.insert(m17_callsign);
+            snap.removed_reverse.insert(ax25_callsign);
+        }
+        return true;
+    });
+    d_auto_cache.erase(m17_callsign);
 }
 
-std::string callsign_mapper_impl::get_ax25_callsign(const std::string& m17_callsign) {
-    auto it = d_mapping_table.find(m17_callsign);
-    if (it != d_mapping_table.end()) {
-        return it->second;
+std::string callsign_mapper_impl::lookup_auto_mapping(const std::string& callsign) {
+    if (!d_auto_mapping_enabled) {
+        return callsign; // Return original if no mapping found
+    }
+
+    // Auto-mapping: remember the callsign in the bounded cache. The mapping
+    // is the identity in both directions, so only recency is tracked.
+    if (!d_auto_cache.lookup(callsign)) {
+        d_auto_cache.insert(callsign); // Default: same callsign
     }
+    return callsign;
+}
 
-    // Auto-mapping: create a new mapping if auto-mapping is enabled
-    if (d_auto_mapping_enabled) {
-        std::string ax25_callsign = m17_callsign; // Default: same callsign
-        add_mapping(m17_callsign, ax25_callsign);
+std::string callsign_mapper_impl::get_ax25_callsign(const std::string& m17_callsign) {
+    unsigned slot;
+    const mapping_snapshot* snap = read_lock(slot);
+    std::string ax25_callsign;
+    bool found = snap->find_forward(m17_callsign, ax25_callsign);
+    read_unlock(slot);
+    if (found) {
         return ax25_callsign;
     }
 
-    return m17_callsign; // Return original if no mapping found
+    return lookup_auto_mapping(m17_callsign);
 }
 
 std::string callsign_mapper_impl::get_m17_callsign(const std::string& ax25_callsign) {
-    auto it = d_reverse_mapping_table.find(ax25_callsign);
-    if (it != d_reverse_mapping_table.end()) {
-        return it->second;
-    }
-
-    // Auto-mapping: create a new mapping if auto-mapping is enabled
-    if (d_auto_mapping_enabled) {
-        std::string m17_callsign = ax25_callsign; // Default: same callsign
-        add_mapping(m17_callsign, ax25_callsign);
+    unsigned slot;
+    const mapping_snapshot* snap = read_lock(slot);
+    std::string m17_callsign;
+    bool found = snap->find_reverse(ax25_callsign, m17_callsign);
+    read_unlock(slot);
+    if (found) {
         return m17_callsign;
     }
 
-    return ax25_callsign; // Return original if no mapping found
+    return lookup_auto_mapping(ax25_callsign);
 }
 
-void callsign_mapper_impl::apply_callsign_mapping(uint8_t* data, int length) {
-    // Apply callsign mapping to frame data
-    // Frame parsing and callsign replacement is protocol-specific:
-    // 1. Parse frame structure to identify callsign fields
-    // 2. Look up callsign in mapping table
-    // 3. Replace callsign with mapped value
-    // 4. Update frame checksums/CRCs if modified
-    
-    // Current implementation: frame-level mapping handled by protocol converters
-    // Byte-level pass-through maintains frame integrity
-    (void)data;   // Frame processing handled at protocol layer
-    (void)length; // Frame length managed by protocol layer
-    // frame format being processed
+bool callsign_mapper_impl::apply_callsign_mapping(const mapping_snapshot& snap, uint8_t* frame,
+                                                  int length) {
+    // Destination and source addresses are rewritten; digipeater fields carry
+    // path aliases and are left alone. The FCS is not verified: patching is
+    // linear, so a corrupted frame stays exactly as corrupted as it arrived.
+    if (length < MAPPER_MIN_FRAME || (frame[AX25_ADDR_LEN - 1] & 0x01)) {
+        return false; // Too short, or destination marked as last address
+    }
+
+    std::string callsigns[2];
+    for (int a = 0; a < 2; a++) {
+        if (!ax25_field_to_callsign(&frame[a * AX25_ADDR_LEN], callsigns[a])) {
+            return false; // Not an AX.25 frame
+        }
+    }
+
+    uint16_t fcs_len = (uint16_t)(length - 2);
+    uint16_t fcs = frame[fcs_len] | (frame[fcs_len + 1] << 8);
+    bool changed = false;
+
+    for (int a = 0; a < 2; a++) {
+        std::string mapped;
+        if (!snap.find_forward(callsigns[a], mapped) || mapped == callsigns[a]) {
+            continue;
+        }
+
+        uint8_t* field = &frame[a * AX25_ADDR_LEN];
+        uint8_t patched[AX25_ADDR_LEN];
+        if (!callsign_to_ax25_field(mapped, field, patched)) {
+            continue; // Mapped callsign cannot be expressed in AX.25
+        }
+
+        fcs = ax25_fcs_patch(fcs, fcs_len, (uint16_t)(a * AX25_ADDR_LEN), field, patched,
+                             AX25_ADDR_LEN);
+        memcpy(field, patched, AX25_ADDR_LEN);
+        changed = true;
+    }
+
+    if (changed) {
+        frame[fcs_len] = fcs & 0xFF;
+        frame[fcs_len + 1] = (fcs >> 8) & 0xFF;
+    }
+    return changed;
 }
 
 void callsign_mapper_impl::handle_control_message(pmt::pmt_t msg) {
@@ -148,6 +423,29 @@ void callsign_mapper_impl::handle_control_message(pmt::pmt_t msg) {
             }
         }
 
+        if (pmt::dict_has_key(msg, pmt::mp("add_mappings"))) {
+            // Bulk update: a vector of {m17, ax25} dicts applied as one snapshot swap
+            pmt::pmt_t mappings = pmt::dict_ref(msg, pmt::mp("add_mappings"), pmt::PMT_NIL);
+            if (pmt::is_vector(mappings)) {
+                update_snapshot([&](mapping_snapshot& snap) {
+                    bool changed = false;
+                    for (size_t i = 0; i < pmt::length(mappings); i++) {
+                        pmt::pmt_t mapping = pmt::vector_ref(mappings, i);
+                        if (!pmt::is_dict(mapping)) {
+                            continue;
+                        }
+                        std::string m17_callsign = pmt::symbol_to_string(
+                            pmt::dict_ref(mapping, pmt::mp("m17"), pmt::mp("")));
+                        std::string ax25_callsign = pmt::symbol_to_string(
+                            pmt::dict_ref(mapping, pmt::mp("ax25"), pmt::mp("")));
+                        insert_mapping(snap, m17_callsign, ax25_callsign);
+                        changed = true;
+                    }
+                    return changed;
+                });
+            }
+        }
+
         if (pmt::dict_has_key(msg, pmt::mp("remove_mapping"))) {
             std::string m17_callsign =
                 pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("remove_mapping"), pmt::mp("")));
@@ -158,9 +456,30 @@ void callsign_mapper_impl::handle_control_message(pmt::pmt_t msg) {
             d_auto_mapping_enabled =
                 pmt::to_bool(pmt::dict_ref(msg, pmt::mp("auto_mapping"), pmt::PMT_F));
         }
+
+        if (pmt::dict_has_key(msg, pmt::mp("auto_mapping_capacity"))) {
+            set_auto_mapping_capacity(
+                pmt::to_long(pmt::dict_ref(msg, pmt::mp("auto_mapping_capacity"), pmt::mp(1L))));
+        }
+
+        if (pmt::dict_has_key(msg, pmt::mp("get_stats"))) {
+            publish_stats();
+        }
     }
 }
 
+void callsign_mapper_impl::publish_stats() {
+    callsign_clock_cache::stats stats = d_auto_cache.get_stats();
+
+    pmt::pmt_t dict = pmt::make_dict();
+    dict = pmt::dict_add(dict, pmt::mp("hits"), pmt::from_uint64(stats.hits));
+    dict = pmt::dict_add(dict, pmt::mp("misses"), pmt::from_uint64(stats.misses));
+    dict = pmt::dict_add(dict, pmt::mp("evictions"), pmt::from_uint64(stats.evictions));
+    dict = pmt::dict_add(dict, pmt::mp("size"), pmt::from_uint64(stats.size));
+    dict = pmt::dict_add(dict, pmt::mp("capacity"), pmt::from_uint64(stats.capacity));
+    message_port_pub(pmt::mp("stats"), dict);
+}
+
 void callsign_mapper_impl::set_auto_mapping_enabled(bool enabled) {
     d_auto_mapping_enabled = enabled;
 }
@@ -169,27 +488,112 @@ bool callsign_mapper_impl::is_auto_mapping_enabled() const {
     return d_auto_mapping_enabled;
 }
 
+void callsign_mapper_impl::set_auto_mapping_capacity(int capacity) {
+    d_auto_cache.set_capacity(std::max(capacity, 1));
+}
+
+int callsign_mapper_impl::auto_mapping_capacity() const {
+    return (int)d_auto_cache.get_stats().capacity;
+}
+
 std::map<std::string, std::string> callsign_mapper_impl::get_mapping_table() const {
-    return d_mapping_table;
+    unsigned slot;
+    const mapping_snapshot* snap = read_lock(slot);
+    std::map<std::string, std::string> table(snap->forward.begin(), snap->forward.end());
+    if (snap->file) {
+        // Overlay entries take precedence over the mapped table
+        for (uint32_t i = 0; i < snap->file->forward_count; i++) {
+            const callsign_snapshot_record_t& record = snap->file->forward[i];
+            if (!snap->removed_forward.count(record.key)) {
+                table.emplace(record.key, record.value);
+            }
+        }
+    }
+    read_unlock(slot);
+    return table;
 }
 
 void callsign_mapper_impl::clear_mappings() {
-    d_mapping_table.clear();
-    d_reverse_mapping_table.clear();
+    update_snapshot([](mapping_snapshot& snap) {
+        snap = mapping_snapshot();
+        return true;
+    });
+    d_auto_cache.clear();
 }
 
 void callsign_mapper_impl::load_mappings_from_file(const std::string& filename) {
-    // File-based configuration loading
-    // Mappings are currently managed in-memory via API calls
-    // File I/O support can be added when persistent storage is required
-    (void)filename;  // Parameter reserved for future file-based configuration
+    // Replaces the pinned mappings. Binary snapshots are detected by their
+    // magic and memory-mapped; anything else is parsed as text.
+    if (access(filename.c_str(), R_OK) != 0) {
+        d_logger->warn("Callsign mapping file {} not found, keeping current mappings",
+                       filename);
+        return;
+    }
+
+    if (callsign_snapshot_probe(filename.c_str())) {
+        callsign_snapshot_t* file = new callsign_snapshot_t();
+        if (callsign_snapshot_open(file, filename.c_str()) != 0) {
+            delete file;
+            throw std::runtime_error("Invalid callsign snapshot: " + filename);
+        }
+        std::shared_ptr<const callsign_snapshot_t> shared(
+            file, [](const callsign_snapshot_t* snap) {
+                callsign_snapshot_close(const_cast<callsign_snapshot_t*>(snap));
+                delete snap;
+            });
+
+        update_snapshot([&](mapping_snapshot& snap) {
+            snap = mapping_snapshot();
+            snap.file = shared;
+            return true;
+        });
+        return;
+    }
+
+    std::vector<std::pair<std::string, std::string>> mappings;
+    int count = callsign_snapshot_parse_text(
+        filename.c_str(),
+        [](void* ctx, const char* m17_callsign, const char* ax25_callsign) {
+            static_cast<std::vector<std::pair<std::string, std::string>>*>(ctx)->emplace_back(
+                m17_callsign, ax25_callsign);
+            return 0;
+        },
+        &mappings);
+    if (count < 0) {
+        throw std::runtime_error("Invalid callsign mapping file: " + filename);
+    }
+
+    update_snapshot([&](mapping_snapshot& snap) {
+        snap = mapping_snapshot();
+        for (const auto& mapping : mappings) {
+            insert_mapping(snap, mapping.first, mapping.second);
+        }
+        return true;
+    });
 }
 
 void callsign_mapper_impl::save_mappings_to_file(const std::string& filename) {
-    // File-based configuration saving
-    // Mappings are currently managed in-memory via API calls
-    // File I/O support can be added when persistent storage is required
-    (void)filename;  // Parameter reserved for future file-based configuration
+    // Pinned mappings are written as text; use m17_callsign_snapshot to
+    // convert the file into a binary snapshot
+    std::map<std::string, std::string> table = get_mapping_table();
+
+    std::vector<callsign_snapshot_record_t> records;
+    records.reserve(table.size());
+    for (const auto& mapping : table) {
+        callsign_snapshot_record_t record;
+        if (callsign_snapshot_record_set(&record, mapping.first.c_str(),
+                                         mapping.second.c_str()) != 0) {
+            d_logger->warn("Skipping callsign mapping {} -> {}: callsign too long",
+                           mapping.first, mapping.second);
+            continue;
+        }
+        records.push_back(record);
+    }
+
+    if (callsign_snapshot_write_text(filename.c_str(), records.data(),
+                                     (uint32_t)records.size()) != 0) {
+        throw std::runtime_error("Failed to write callsign mapping file: " + filename);
+    }
 }
 
 } // namespace m17_bridge
@@ -0,0 +1,172 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_CALLSIGN_MAPPER_IMPL_H
+#define INCLUDED_M17_BRIDGE_CALLSIGN_MAPPER_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <callsign_clock_cache.h>
+#include <callsign_mapper.h>
+#include <callsign_snapshot.h>
+#include <pmt/pmt.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of the M17/AX.25 callsign mapper
+ * \ingroup m17_bridge
+ *
+ * The mapping tables are held in an immutable snapshot published through an
+ * atomic pointer. Lookups never take a lock; updates copy the current
+ * snapshot, modify the copy and swap it in. A retired snapshot is freed once
+ * every reader that may still hold it has left (two-slot epoch counters).
+ *
+ * Snapshots hold pinned (manual) mappings only. Auto-generated mappings are
+ * identities, so a single bounded CLOCK cache serves both lookup directions;
+ * it is lock-free, so the lookup path never takes a lock.
+ *
+ * A binary table loaded from file stays memory-mapped and is searched in
+ * place; mappings added or removed afterwards are kept as an overlay.
+ *
+ * The stream is treated as flag-delimited AX.25 frames. Pinned mappings are
+ * applied to the destination and source address fields in place and the
+ * FCS is patched incrementally; all other bytes pass through unchanged.
+ */
+class callsign_mapper_impl : public callsign_mapper {
+  private:
+    /*!
+     * \brief Immutable mapping tables; never modified after publication
+     */
+    struct mapping_snapshot {
+        std::unordered_map<std::string, std::string> forward; //!< M17 -> AX.25
+        std::unordered_map<std::string, std::string> reverse; //!< AX.25 -> M17
+        std::shared_ptr<const callsign_snapshot_t> file;      //!< Mapped base table, or null
+        std::unordered_set<std::string> removed_forward;      //!< File keys removed since load
+        std::unordered_set<std::string> removed_reverse;      //!< File keys removed since load
+
+        bool find_forward(const std::string& m17_callsign, std::string& ax25_callsign) const;
+        bool find_reverse(const std::string& ax25_callsign, std::string& m17_callsign) const;
+    };
+
+    std::atomic<const mapping_snapshot*> d_snapshot; //!< Currently published tables
+    std::atomic<unsigned> d_epoch;                   //!< Selects the reader slot
+    mutable std::atomic<unsigned> d_readers[2];      //!< Active readers per epoch slot
+    std::mutex d_writer_mutex;                       //!< Serialises snapshot updates
+    std::atomic<bool> d_auto_mapping_enabled;        //!< Enable automatic mapping
+    callsign_clock_cache d_auto_cache;               //!< Bounded auto-generated mappings
+    int d_mapping_counter;                           //!< Counter for auto-generated mappings
+
+  public:
+    /*!
+     * \brief Constructor for callsign mapper
+     * \param auto_mapping_capacity Maximum number of auto-generated mappings kept
+     */
+    callsign_mapper_impl(int auto_mapping_capacity);
+
+    /*!
+     * \brief Destructor
+     */
+    ~callsign_mapper_impl();
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int work(int noutput_items, gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+    void add_mapping(const std::string& m17_callsign, const std::string& ax25_callsign);
+    void remove_mapping(const std::string& m17_callsign);
+    std::string get_ax25_callsign(const std::string& m17_callsign);
+    std::string get_m17_callsign(const std::string& ax25_callsign);
+    void set_auto_mapping_enabled(bool enabled);
+    bool is_auto_mapping_enabled() const;
+    void set_auto_mapping_capacity(int capacity);
+    int auto_mapping_capacity() const;
+    std::map<std::string, std::string> get_mapping_table() const;
+    void clear_mappings();
+    void load_mappings_from_file(const std::string& filename);
+    void save_mappings_to_file(const std::string& filename);
+
+  private:
+    /*!
+     * \brief Pin the current snapshot for reading
+     * \param slot Receives the reader slot to pass to read_unlock()
+     * \return Snapshot valid until read_unlock()
+     */
+    const mapping_snapshot* read_lock(unsigned& slot) const;
+
+    /*!
+     * \brief Release a snapshot pinned by read_lock()
+     * \param slot Reader slot returned by read_lock()
+     */
+    void read_unlock(unsigned slot) const;
+
+    /*!
+     * \brief Copy the current snapshot, apply an edit and publish the result
+     * \param edit Modifies the private copy; return false to discard it
+     */
+    void update_snapshot(const std::function<bool(mapping_snapshot&)>& edit);
+
+    /*!
+     * \brief Insert a mapping into both directions of a snapshot
+     */
+    static void insert_mapping(mapping_snapshot& snap, const std::string& m17_callsign,
+                               const std::string& ax25_callsign);
+
+    /*!
+     * \brief Resolve a callsign without a pinned mapping
+     * \param callsign Callsign in either protocol
+     * \return The auto-generated (identity) mapping, or the callsign itself
+     */
+    std::string lookup_auto_mapping(const std::string& callsign);
+
+    /*!
+     * \brief Publish the auto-mapping cache counters on the "stats" port
+     */
+    void publish_stats();
+
+    /*!
+     * \brief Initialize default callsign mappings
+     */
+    void initialize_default_mappings();
+
+    /*!
+     * \brief Rewrite mapped callsigns in one AX.25 frame, patching its FCS
+     * \param snap Mapping tables to apply
+     * \param frame Frame bytes between flags, including the FCS
+     * \param length Frame length
+     * \return True if the frame was modified
+     */
+    bool apply_callsign_mapping(const mapping_snapshot& snap, uint8_t* frame, int length);
+
+    /*!
+     * \brief Handle control messages
+     * \param msg Control message
+     */
+    void handle_control_message(pmt::pmt_t msg);
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_CALLSIGN_MAPPER_IMPL_H */
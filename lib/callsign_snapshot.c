@@ -0,0 +1,459 @@
+//--------------------------------------------------------------------
+// Callsign Mapping Snapshot
+//
+// Versioned, checksummed binary format for callsign mapping tables.
+// Records are fixed width and sorted, so a memory-mapped file is
+// searched in place without parsing.
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "callsign_snapshot.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Header field offsets; the header is serialised byte-wise so the file
+// format does not depend on host endianness or struct padding
+#define SNAP_OFF_VERSION        8
+#define SNAP_OFF_RECORD_LEN     10
+#define SNAP_OFF_FORWARD_COUNT  12
+#define SNAP_OFF_REVERSE_COUNT  16
+#define SNAP_OFF_CRC32          20
+
+// CRC-32C (Castagnoli, reflected). Chosen over the IEEE polynomial because
+// x86 computes it in hardware (SSE4.2), which keeps open() of a large
+// snapshot within a few milliseconds. Slice-by-4 tables are the fallback.
+#define SNAPSHOT_CRC_POLY       0x82F63B78u
+
+static uint32_t snapshot_crc_table[4][256];
+static pthread_once_t snapshot_crc_once = PTHREAD_ONCE_INIT;
+static uint32_t (*snapshot_crc_update)(uint32_t crc, const uint8_t* data, size_t length);
+
+static uint32_t snapshot_crc_update_table(uint32_t crc, const uint8_t* data, size_t length);
+#if defined(__x86_64__) && defined(__GNUC__)
+static uint32_t snapshot_crc_update_sse42(uint32_t crc, const uint8_t* data, size_t length);
+#endif
+
+static void snapshot_build_crc_table(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (SNAPSHOT_CRC_POLY & (0u - (crc & 1)));
+        }
+        snapshot_crc_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = snapshot_crc_table[0][i];
+        for (int t = 1; t < 4; t++) {
+            crc = (crc >> 8) ^ snapshot_crc_table[0][crc & 0xFF];
+            snapshot_crc_table[t][i] = crc;
+        }
+    }
+
+    snapshot_crc_update = snapshot_crc_update_table;
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        snapshot_crc_update = snapshot_crc_update_sse42;
+    }
+#endif
+}
+
+static void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (v >> (8 * i)) & 0xFF;
+    }
+}
+
+static uint16_t get_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static int record_compare(const void* a, const void* b) {
+    // Fields are NUL padded, so memcmp orders them like strcmp
+    return memcmp(((const callsign_snapshot_record_t*)a)->key,
+                  ((const callsign_snapshot_record_t*)b)->key, CALLSIGN_SNAPSHOT_FIELD_LEN);
+}
+
+// Records must be NUL terminated and strictly ascending by key
+static int validate_records(const callsign_snapshot_record_t* records, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (records[i].key[CALLSIGN_SNAPSHOT_FIELD_LEN - 1] != '\0' ||
+            records[i].value[CALLSIGN_SNAPSHOT_FIELD_LEN - 1] != '\0') {
+            return -1;
+        }
+        if (i > 0 && record_compare(&records[i - 1], &records[i]) >= 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static const char* lookup(const callsign_snapshot_record_t* records, uint32_t count,
+                          const char* key) {
+    if (!records || !key) {
+        return NULL;
+    }
+
+    size_t len = strlen(key);
+    if (len > CALLSIGN_SNAPSHOT_MAX_CALLSIGN) {
+        return NULL;
+    }
+
+    char padded[CALLSIGN_SNAPSHOT_FIELD_LEN] = { 0 };
+    memcpy(padded, key, len);
+
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = memcmp(records[mid].key, padded, CALLSIGN_SNAPSHOT_FIELD_LEN);
+        if (cmp == 0) {
+            return records[mid].value;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return NULL;
+}
+
+// Advance the raw CRC register; caller has built the tables
+static uint32_t snapshot_crc_update_table(uint32_t crc, const uint8_t* data, size_t length) {
+    size_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        crc ^= get_le32(&data[i]);
+        crc = snapshot_crc_table[3][crc & 0xFF] ^ snapshot_crc_table[2][(crc >> 8) & 0xFF] ^
+              snapshot_crc_table[1][(crc >> 16) & 0xFF] ^ snapshot_crc_table[0][crc >> 24];
+    }
+    for (; i < length; i++) {
+        crc = (crc >> 8) ^ snapshot_crc_table[0][(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("sse4.2")))
+static uint32_t snapshot_crc_update_sse42(uint32_t crc, const uint8_t* data, size_t length) {
+    uint64_t crc64 = crc;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, &data[i], sizeof(word));
+        crc64 = __builtin_ia32_crc32di(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+    for (; i < length; i++) {
+        crc = __builtin_ia32_crc32qi(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+// Calculate CRC-32C over a buffer
+uint32_t callsign_snapshot_crc32c(const uint8_t* data, size_t length) {
+    if (!data && length) {
+        return 0;
+    }
+
+    pthread_once(&snapshot_crc_once, snapshot_build_crc_table);
+    return snapshot_crc_update(0xFFFFFFFFu, data, length) ^ 0xFFFFFFFFu;
+}
+
+// Fill a record from two callsign strings
+int callsign_snapshot_record_set(callsign_snapshot_record_t* record, const char* key,
+                                 const char* value) {
+    if (!record || !key || !value) {
+        return -1;
+    }
+
+    size_t key_len = strlen(key);
+    size_t value_len = strlen(value);
+    if (key_len == 0 || key_len > CALLSIGN_SNAPSHOT_MAX_CALLSIGN ||
+        value_len > CALLSIGN_SNAPSHOT_MAX_CALLSIGN) {
+        return -1; // Does not fit a fixed-width field
+    }
+
+    memset(record, 0, sizeof(*record));
+    memcpy(record->key, key, key_len);
+    memcpy(record->value, value, value_len);
+    return 0;
+}
+
+// Check whether a file starts with the snapshot magic
+bool callsign_snapshot_probe(const char* filename) {
+    if (!filename) {
+        return false;
+    }
+
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    char magic[CALLSIGN_SNAPSHOT_MAGIC_LEN];
+    bool match = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) &&
+                 memcmp(magic, CALLSIGN_SNAPSHOT_MAGIC, CALLSIGN_SNAPSHOT_MAGIC_LEN) == 0;
+    fclose(fp);
+    return match;
+}
+
+// Map and validate a snapshot file
+int callsign_snapshot_open(callsign_snapshot_t* snap, const char* filename) {
+    if (!snap || !filename) {
+        return -1;
+    }
+
+    memset(snap, 0, sizeof(*snap));
+
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < CALLSIGN_SNAPSHOT_HEADER_LEN) {
+        close(fd);
+        return -1;
+    }
+
+    size_t map_len = (size_t)st.st_size;
+    void* base = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+
+    const uint8_t* hdr = (const uint8_t*)base;
+    uint32_t forward_count = get_le32(&hdr[SNAP_OFF_FORWARD_COUNT]);
+    uint32_t reverse_count = get_le32(&hdr[SNAP_OFF_REVERSE_COUNT]);
+    uint64_t expected_len = CALLSIGN_SNAPSHOT_HEADER_LEN +
+                            ((uint64_t)forward_count + reverse_count) *
+                                sizeof(callsign_snapshot_record_t);
+
+    if (memcmp(hdr, CALLSIGN_SNAPSHOT_MAGIC, CALLSIGN_SNAPSHOT_MAGIC_LEN) != 0 ||
+        get_le16(&hdr[SNAP_OFF_VERSION]) != CALLSIGN_SNAPSHOT_VERSION ||
+        get_le16(&hdr[SNAP_OFF_RECORD_LEN]) != sizeof(callsign_snapshot_record_t) ||
+        expected_len != map_len) {
+        munmap(base, map_len);
+        return -1; // Not a snapshot, unsupported version or truncated
+    }
+
+    if (callsign_snapshot_crc32c(hdr + CALLSIGN_SNAPSHOT_HEADER_LEN,
+                                map_len - CALLSIGN_SNAPSHOT_HEADER_LEN) !=
+        get_le32(&hdr[SNAP_OFF_CRC32])) {
+        munmap(base, map_len);
+        return -1; // Corrupted
+    }
+
+    const callsign_snapshot_record_t* records =
+        (const callsign_snapshot_record_t*)(hdr + CALLSIGN_SNAPSHOT_HEADER_LEN);
+    if (validate_records(records, forward_count) != 0 ||
+        validate_records(records + forward_count, reverse_count) != 0) {
+        munmap(base, map_len);
+        return -1;
+    }
+
+    snap->map_base = base;
+    snap->map_len = map_len;
+    snap->forward = records;
+    snap->forward_count = forward_count;
+    snap->reverse = records + forward_count;
+    snap->reverse_count = reverse_count;
+    return 0;
+}
+
+// Unmap a snapshot
+void callsign_snapshot_close(callsign_snapshot_t* snap) {
+    if (!snap) {
+        return;
+    }
+
+    if (snap->map_base) {
+        munmap(snap->map_base, snap->map_len);
+    }
+    memset(snap, 0, sizeof(*snap));
+}
+
+// Sort the records in place and write them atomically (temp file + rename)
+int callsign_snapshot_write(const char* filename,
+                            callsign_snapshot_record_t* forward, uint32_t forward_count,
+                            callsign_snapshot_record_t* reverse, uint32_t reverse_count) {
+    if (!filename || (forward_count && !forward) || (reverse_count && !reverse)) {
+        return -1;
+    }
+
+    if (forward_count) {
+        qsort(forward, forward_count, sizeof(*forward), record_compare);
+    }
+    if (reverse_count) {
+        qsort(reverse, reverse_count, sizeof(*reverse), record_compare);
+    }
+    if (validate_records(forward, forward_count) != 0 ||
+        validate_records(reverse, reverse_count) != 0) {
+        return -1; // Duplicate keys
+    }
+
+    // The CRC covers both sections back to back
+    size_t forward_len = (size_t)forward_count * sizeof(*forward);
+    size_t reverse_len = (size_t)reverse_count * sizeof(*reverse);
+    pthread_once(&snapshot_crc_once, snapshot_build_crc_table);
+    uint32_t crc = 0xFFFFFFFFu;
+    if (forward_len) {
+        crc = snapshot_crc_update(crc, (const uint8_t*)forward, forward_len);
+    }
+    if (reverse_len) {
+        crc = snapshot_crc_update(crc, (const uint8_t*)reverse, reverse_len);
+    }
+    crc ^= 0xFFFFFFFFu;
+
+    uint8_t hdr[CALLSIGN_SNAPSHOT_HEADER_LEN] = { 0 };
+    memcpy(hdr, CALLSIGN_SNAPSHOT_MAGIC, CALLSIGN_SNAPSHOT_MAGIC_LEN);
+    put_le16(&hdr[SNAP_OFF_VERSION], CALLSIGN_SNAPSHOT_VERSION);
+    put_le16(&hdr[SNAP_OFF_RECORD_LEN], sizeof(callsign_snapshot_record_t));
+    put_le32(&hdr[SNAP_OFF_FORWARD_COUNT], forward_count);
+    put_le32(&hdr[SNAP_OFF_REVERSE_COUNT], reverse_count);
+    put_le32(&hdr[SNAP_OFF_CRC32], crc);
+
+    size_t name_len = strlen(filename);
+    char* tmp_name = malloc(name_len + 5);
+    if (!tmp_name) {
+        return -1;
+    }
+    memcpy(tmp_name, filename, name_len);
+    memcpy(tmp_name + name_len, ".tmp", 5);
+
+    FILE* fp = fopen(tmp_name, "wb");
+    if (!fp) {
+        free(tmp_name);
+        return -1;
+    }
+
+    int ok = fwrite(hdr, 1, sizeof(hdr), fp) == sizeof(hdr) &&
+             (!forward_len || fwrite(forward, 1, forward_len, fp) == forward_len) &&
+             (!reverse_len || fwrite(reverse, 1, reverse_len, fp) == reverse_len);
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok || rename(tmp_name, filename) != 0) {
+        unlink(tmp_name);
+        free(tmp_name);
+        return -1;
+    }
+
+    free(tmp_name);
+    return 0;
+}
+
+// Parse a text mapping file: one "M17CALL AX25CALL" pair per line,
+// '#' starts a comment. Returns the number of mappings or -1.
+int callsign_snapshot_parse_text(const char* filename, callsign_snapshot_text_cb callback,
+                                 void* ctx) {
+    if (!filename || !callback) {
+        return -1;
+    }
+
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char* hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+
+        char* fields[3] = { NULL, NULL, NULL };
+        int nfields = 0;
+        char* p = line;
+        while (nfields < 3) {
+            while (*p && isspace((unsigned char)*p)) {
+                p++;
+            }
+            if (!*p) {
+                break;
+            }
+            fields[nfields++] = p;
+            while (*p && !isspace((unsigned char)*p)) {
+                p++;
+            }
+            if (*p) {
+                *p++ = '\0';
+            }
+        }
+
+        if (nfields == 0) {
+            continue; // Blank or comment line
+        }
+        if (nfields != 2 || strlen(fields[0]) > CALLSIGN_SNAPSHOT_MAX_CALLSIGN ||
+            strlen(fields[1]) > CALLSIGN_SNAPSHOT_MAX_CALLSIGN) {
+            fclose(fp);
+            return -1; // Malformed line
+        }
+
+        if (callback(ctx, fields[0], fields[1]) != 0) {
+            fclose(fp);
+            return -1;
+        }
+        count++;
+    }
+
+    fclose(fp);
+    return count;
+}
+
+// Write mappings as text, one pair per line
+int callsign_snapshot_write_text(const char* filename,
+                                 const callsign_snapshot_record_t* records, uint32_t count) {
+    if (!filename || (count && !records)) {
+        return -1;
+    }
+
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        return -1;
+    }
+
+    int ok = fprintf(fp, "# M17 callsign  AX.25 callsign\n") > 0;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        ok = fprintf(fp, "%s %s\n", records[i].key, records[i].value) > 0;
+    }
+    ok = (fclose(fp) == 0) && ok;
+    return ok ? 0 : -1;
+}
+
+// Look up an M17 callsign
+const char* callsign_snapshot_lookup_forward(const callsign_snapshot_t* snap, const char* key) {
+    if (!snap) {
+        return NULL;
+    }
+    return lookup(snap->forward, snap->forward_count, key);
+}
+
+// Look up an AX.25 callsign
+const char* callsign_snapshot_lookup_reverse(const callsign_snapshot_t* snap, const char* key) {
+    if (!snap) {
+        return NULL;
+    }
+    return lookup(snap->reverse, snap->reverse_count, key);
+}
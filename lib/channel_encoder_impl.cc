@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "channel_encoder_impl.h"
+
+#include <gnuradio/io_signature.h>
+#include <m17_viterbi.h>
+#include <stdexcept>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Create M17 channel encoder block
+ * \param frame_type LSF, stream or packet frames
+ * \return Shared pointer to the encoder block
+ */
+channel_encoder::sptr channel_encoder::make(int frame_type) {
+    return gnuradio::make_block_sptr<channel_encoder_impl>(frame_type);
+}
+
+int channel_encoder_impl::frame_payload_bytes(int frame_type) {
+    switch (frame_type) {
+    case FRAME_LSF:
+        return M17_LSF_PAYLOAD_BITS / 8;
+    case FRAME_STREAM:
+        return M17_LICH_CODED_BYTES + M17_STREAM_PAYLOAD_BITS / 8;
+    case FRAME_PACKET:
+        return (M17_PACKET_PAYLOAD_BITS + 7) / 8;
+    }
+    return 0;
+}
+
+static int channel_encoder_input_size(int frame_type) {
+    int payload_bytes = channel_encoder_impl::frame_payload_bytes(frame_type);
+    if (payload_bytes == 0) {
+        throw std::invalid_argument("channel_encoder: unknown frame type " +
+                                    std::to_string(frame_type));
+    }
+    return payload_bytes;
+}
+
+channel_encoder_impl::channel_encoder_impl(int frame_type)
+    : gr::sync_block("channel_encoder",
+                     gr::io_signature::make(1, 1, channel_encoder_input_size(frame_type)),
+                     gr::io_signature::make(1, 1, M17_FRAME_SYMBOLS)),
+      d_frame_type(frame_type), d_payload_bytes(frame_payload_bytes(frame_type)) {}
+
+channel_encoder_impl::~channel_encoder_impl() {}
+
+int channel_encoder_impl::work(int noutput_items, gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items) {
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    uint8_t* out = (uint8_t*)output_items[0];
+
+    for (int i = 0; i < noutput_items; i++) {
+        const uint8_t* payload = &in[i * d_payload_bytes];
+        uint8_t* dibits = &out[i * M17_FRAME_SYMBOLS];
+        switch (d_frame_type) {
+        case FRAME_LSF:
+            m17_encode_lsf(payload, dibits);
+            break;
+        case FRAME_STREAM:
+            m17_encode_stream(payload, payload + M17_LICH_CODED_BYTES, dibits);
+            break;
+        default:
+            m17_encode_packet(payload, dibits);
+            break;
+        }
+    }
+
+    return noutput_items;
+}
+
+int channel_encoder_impl::payload_bytes() const {
+    return d_payload_bytes;
+}
+
+int channel_encoder_impl::frame_symbols() const {
+    return M17_FRAME_SYMBOLS;
+}
+
+} // namespace m17_bridge
+} // namespace gr
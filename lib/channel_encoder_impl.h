@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_IMPL_H
+#define INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_IMPL_H
+
+#include <channel_encoder.h>
+#include <gnuradio/io_signature.h>
+#include <m17_encoder.h>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of the M17 channel encoder
+ * \ingroup m17_bridge
+ *
+ * One input vector of payload bytes becomes one output vector of
+ * dibits; the coding itself is m17_encode_lsf, m17_encode_stream or
+ * m17_encode_packet.
+ */
+class channel_encoder_impl : public channel_encoder {
+  private:
+    int d_frame_type;    //!< LSF, stream or packet frames
+    int d_payload_bytes; //!< Input bytes per frame
+
+  public:
+    /*!
+     * \brief Constructor for the channel encoder
+     * \param frame_type LSF, stream or packet frames
+     */
+    channel_encoder_impl(int frame_type);
+
+    /*!
+     * \brief Destructor
+     */
+    ~channel_encoder_impl();
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int work(int noutput_items, gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+    int payload_bytes() const;
+    int frame_symbols() const;
+
+    /*!
+     * \brief Input bytes per frame of a frame type
+     * \return 0 for an unknown frame type
+     */
+    static int frame_payload_bytes(int frame_type);
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_CHANNEL_ENCODER_IMPL_H */
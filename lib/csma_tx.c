@@ -0,0 +1,458 @@
+//--------------------------------------------------------------------
+// CSMA Transmit Scheduler
+//
+// p-persistent channel access with priority queues and multi-frame
+// key-ups; frames of one AX.25 link keep their order
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "csma_tx.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CSMA_TX_UNIT_MS      10          // KISS timing parameters are in 10ms units
+#define CSMA_TX_DEFAULT_SEED 0x2545F491u
+
+typedef struct {
+    uint8_t data[CSMA_TX_MAX_FRAME_LEN];
+    uint16_t length;
+    uint64_t link;              // Address pair hash (0 = not link traffic)
+} csma_tx_slot_t;
+
+// Bounded frame queue; slots are reused in place
+typedef struct {
+    csma_tx_slot_t* slots;
+    uint16_t head;              // Oldest frame
+    uint16_t count;
+} csma_tx_queue_t;
+
+struct csma_tx {
+    csma_tx_config_t config;
+    csma_tx_queue_t queues[CSMA_TX_PRIORITIES];
+    uint16_t depth;             // Slots per queue
+    csma_tx_state_t state;
+    uint64_t now_ms;            // Latest poll time
+    uint64_t next_ms;           // Time of the next state transition
+    uint64_t keyed_at;          // PTT assertion time of the current key-up
+    uint32_t burst_frames;      // Frames sent in the current key-up
+    bool carrier;               // Carrier detect from the receiver
+    uint32_t rng;               // Persistence draw state
+    csma_tx_handler_t handler;
+    csma_tx_ptt_handler_t ptt;
+    void* ctx;                  // Passed to both handlers
+    csma_tx_stats_t stats;
+};
+
+static bool csma_tx_config_valid(const csma_tx_config_t* config) {
+    return config && config->bit_rate > 0 && config->max_burst_frames > 0;
+}
+
+// Persistence draw, uniform over 0..255
+static uint8_t csma_tx_random(csma_tx_t* tx) {
+    uint32_t x = tx->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    tx->rng = x;
+    return (uint8_t)(x >> 24);
+}
+
+// A zero slot time still waits one unit, so a deferring station cannot spin
+static uint64_t csma_tx_slot_ms(const csma_tx_t* tx) {
+    return tx->config.slot_time ? (uint64_t)tx->config.slot_time * CSMA_TX_UNIT_MS
+                                : CSMA_TX_UNIT_MS;
+}
+
+static bool csma_tx_queued(const csma_tx_t* tx) {
+    for (int i = 0; i < CSMA_TX_PRIORITIES; i++) {
+        if (tx->queues[i].count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void csma_tx_config_init(csma_tx_config_t* config) {
+    if (!config) {
+        return;
+    }
+
+    config->tx_delay = 50;          // 500ms
+    config->persistence = 63;       // 63/256
+    config->slot_time = 10;         // 100ms
+    config->tx_tail = 5;            // 50ms
+    config->full_duplex = false;
+    config->bit_rate = 1200;
+    config->max_burst_frames = CSMA_TX_DEFAULT_BURST;
+    config->max_burst_bytes = 0;
+    config->seed = 0;
+}
+
+void csma_tx_config_from_kiss(csma_tx_config_t* config, const kiss_config_t* kiss) {
+    if (!config || !kiss) {
+        return;
+    }
+
+    config->tx_delay = kiss->tx_delay;
+    config->persistence = kiss->persistence;
+    config->slot_time = kiss->slot_time;
+    config->tx_tail = kiss->tx_tail;
+    config->full_duplex = kiss->full_duplex;
+}
+
+// A key-up never needs to carry more than one window of I frames
+void csma_tx_config_from_ax25(csma_tx_config_t* config, const ax25_config_t* ax25) {
+    if (!config || !ax25) {
+        return;
+    }
+
+    config->tx_delay = ax25->tx_delay;
+    config->persistence = ax25->persistence;
+    config->slot_time = ax25->slot_time;
+    config->tx_tail = ax25->tx_tail;
+    config->full_duplex = ax25->full_duplex;
+    uint8_t window = ax25->extended ? ax25->window_size_ext : ax25->window_size;
+    if (window > 0) {
+        config->max_burst_frames = window;
+    }
+}
+
+// Allocate a scheduler with depth frames of queue per priority
+csma_tx_t* csma_tx_create(const csma_tx_config_t* config, uint16_t depth) {
+    if (!csma_tx_config_valid(config) || depth == 0) {
+        return NULL;
+    }
+
+    csma_tx_t* tx = calloc(1, sizeof(csma_tx_t));
+    if (!tx) {
+        return NULL;
+    }
+
+    for (int i = 0; i < CSMA_TX_PRIORITIES; i++) {
+        tx->queues[i].slots = malloc(depth * sizeof(csma_tx_slot_t));
+        if (!tx->queues[i].slots) {
+            csma_tx_destroy(tx);
+            return NULL;
+        }
+    }
+
+    tx->config = *config;
+    tx->depth = depth;
+    tx->state = CSMA_TX_IDLE;
+    tx->rng = config->seed ? config->seed : CSMA_TX_DEFAULT_SEED;
+    return tx;
+}
+
+// Free the scheduler and discard queued frames; PTT is released if keyed
+void csma_tx_destroy(csma_tx_t* tx) {
+    if (!tx) {
+        return;
+    }
+
+    if (tx->ptt && tx->state >= CSMA_TX_KEYUP) {
+        tx->ptt(tx->ctx, false);
+    }
+    for (int i = 0; i < CSMA_TX_PRIORITIES; i++) {
+        free(tx->queues[i].slots);
+    }
+    free(tx);
+}
+
+int csma_tx_set_config(csma_tx_t* tx, const csma_tx_config_t* config) {
+    if (!tx || !csma_tx_config_valid(config)) {
+        return -1;
+    }
+
+    if (config->seed != tx->config.seed) {
+        tx->rng = config->seed ? config->seed : CSMA_TX_DEFAULT_SEED;
+    }
+    tx->config = *config;
+    return 0;
+}
+
+int csma_tx_set_handlers(csma_tx_t* tx, csma_tx_handler_t handler,
+                         csma_tx_ptt_handler_t ptt, void* ctx) {
+    if (!tx) {
+        return -1;
+    }
+
+    tx->handler = handler;
+    tx->ptt = ptt;
+    tx->ctx = ctx;
+    return 0;
+}
+
+// Lowest priority (highest value) below priority holding a frame of the
+// link, or priority if none does
+static uint8_t csma_tx_link_priority(const csma_tx_t* tx, uint8_t priority, uint64_t link) {
+    for (uint8_t i = CSMA_TX_PRIORITIES - 1; link != 0 && i > priority; i--) {
+        const csma_tx_queue_t* queue = &tx->queues[i];
+        for (uint16_t n = 0; n < queue->count; n++) {
+            if (queue->slots[(queue->head + n) % tx->depth].link == link) {
+                return i;
+            }
+        }
+    }
+    return priority;
+}
+
+// Queue a frame given as segments; starts contention if the scheduler was idle.
+// A frame of a link that still has frames waiting in a lower priority queue
+// joins that queue, so priority reorders links but never one link's frames.
+static int csma_tx_enqueue_link(csma_tx_t* tx, uint8_t priority, uint64_t link,
+                                const struct iovec* iov, int iovcnt) {
+    if (!tx || priority >= CSMA_TX_PRIORITIES || !iov || iovcnt <= 0) {
+        return -1;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    if (total == 0 || total > CSMA_TX_MAX_FRAME_LEN) {
+        return -1;
+    }
+
+    csma_tx_queue_t* queue = &tx->queues[csma_tx_link_priority(tx, priority, link)];
+    if (queue->count == tx->depth) {
+        tx->stats.dropped++;
+        return -1;
+    }
+
+    csma_tx_slot_t* slot = &queue->slots[(queue->head + queue->count) % tx->depth];
+    size_t pos = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(&slot->data[pos], iov[i].iov_base, iov[i].iov_len);
+        pos += iov[i].iov_len;
+    }
+    slot->length = (uint16_t)total;
+    slot->link = link;
+    queue->count++;
+
+    if (tx->state == CSMA_TX_IDLE) {
+        tx->state = CSMA_TX_DEFER;
+        tx->next_ms = tx->now_ms;
+    }
+    return 0;
+}
+
+int csma_tx_enqueue_iov(csma_tx_t* tx, uint8_t priority, const struct iovec* iov, int iovcnt) {
+    return csma_tx_enqueue_link(tx, priority, 0, iov, iovcnt);
+}
+
+int csma_tx_enqueue(csma_tx_t* tx, uint8_t priority, const uint8_t* data, uint16_t length) {
+    if (!data) {
+        return -1;
+    }
+
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = length;
+    return csma_tx_enqueue_iov(tx, priority, &iov, 1);
+}
+
+// Byte at offset of a segmented frame, or -1 past its end
+static int csma_tx_iov_byte(const struct iovec* iov, int iovcnt, size_t offset) {
+    for (int i = 0; i < iovcnt; i++) {
+        if (offset < iov[i].iov_len) {
+            return ((const uint8_t*)iov[i].iov_base)[offset];
+        }
+        offset -= iov[i].iov_len;
+    }
+    return -1;
+}
+
+// Link control frames go ahead of other links' data so acknowledgements
+// are not stuck behind a full window; UI traffic goes last. Frames are
+// keyed by destination and source, so a DISC still follows its own link's
+// I frames.
+int csma_tx_ax25_output(void* ctx, const struct iovec* iov, int iovcnt) {
+    csma_tx_t* tx = (csma_tx_t*)ctx;
+    if (!tx || !iov) {
+        return -1;
+    }
+
+    // FNV-1a over both callsigns and SSIDs; C, H and extension bits are
+    // masked. A collision only costs a frame its priority, never its order.
+    uint64_t link = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < 2 * AX25_ADDR_LEN; i++) {
+        int byte = csma_tx_iov_byte(iov, iovcnt, i);
+        if (byte < 0) {
+            return -1;
+        }
+        if (i % AX25_ADDR_LEN == AX25_ADDR_LEN - 1) {
+            byte &= 0x1E;
+        }
+        link = (link ^ (uint8_t)byte) * 0x100000001B3ULL;
+    }
+    link |= 1; // Never 0
+
+    // The address field ends at the first octet with the extension bit set
+    size_t offset = AX25_ADDR_LEN - 1;
+    int byte;
+    while ((byte = csma_tx_iov_byte(iov, iovcnt, offset)) >= 0 && !(byte & 0x01)) {
+        offset += AX25_ADDR_LEN;
+    }
+    int control = csma_tx_iov_byte(iov, iovcnt, offset + 1);
+    if (control < 0) {
+        return -1;
+    }
+
+    uint8_t priority;
+    if ((control & 0x01) == AX25_FRAME_I) {
+        priority = CSMA_TX_PRIO_DATA;
+    } else if ((control & AX25_CTRL_U_MASK) == AX25_CTRL_UI) {
+        priority = CSMA_TX_PRIO_UNPROTO;
+    } else {
+        priority = CSMA_TX_PRIO_CONTROL;
+    }
+    return csma_tx_enqueue_link(tx, priority, link, iov, iovcnt);
+}
+
+size_t csma_tx_pending(const csma_tx_t* tx, uint8_t priority) {
+    if (!tx || priority >= CSMA_TX_PRIORITIES) {
+        return 0;
+    }
+    return tx->queues[priority].count;
+}
+
+void csma_tx_set_carrier(csma_tx_t* tx, bool busy) {
+    if (tx) {
+        tx->carrier = busy;
+    }
+}
+
+// Hand the burst to the handler, highest priority first, and return its
+// airtime: the frames back to back with a flag before each and one after
+static uint64_t csma_tx_send_burst(csma_tx_t* tx) {
+    uint32_t frames = 0;
+    uint64_t bytes = 0;
+    bool open = true;
+
+    for (int i = 0; i < CSMA_TX_PRIORITIES && open; i++) {
+        csma_tx_queue_t* queue = &tx->queues[i];
+        while (queue->count > 0 && frames < tx->config.max_burst_frames) {
+            csma_tx_slot_t* slot = &queue->slots[queue->head];
+            if (frames > 0 && tx->config.max_burst_bytes != 0 &&
+                bytes + slot->length > tx->config.max_burst_bytes) {
+                open = false;
+                break;
+            }
+            if (tx->handler && tx->handler(tx->ctx, slot->data, slot->length) != 0) {
+                open = false;
+                break;
+            }
+
+            frames++;
+            bytes += slot->length;
+            queue->head = (queue->head + 1) % tx->depth;
+            queue->count--;
+        }
+    }
+
+    tx->burst_frames = frames;
+    tx->stats.frames += frames;
+    tx->stats.bytes += bytes;
+    if (frames == 0) {
+        return 0;
+    }
+    uint64_t bits = (bytes + frames + 1) * 8;
+    return (bits * 1000 + tx->config.bit_rate - 1) / tx->config.bit_rate;
+}
+
+// Each transition happens at the time it was scheduled for, except the
+// contention slot, which samples carrier detect as reported at this poll
+int csma_tx_poll(csma_tx_t* tx, uint64_t now_ms) {
+    if (!tx) {
+        return -1;
+    }
+
+    if (now_ms > tx->now_ms) {
+        tx->now_ms = now_ms;
+    }
+
+    int sent = 0;
+    while (tx->state != CSMA_TX_IDLE && tx->next_ms <= tx->now_ms) {
+        uint64_t t = tx->next_ms;
+
+        switch (tx->state) {
+        case CSMA_TX_DEFER:
+            t = tx->now_ms;
+            if (!tx->config.full_duplex) {
+                if (tx->carrier) {
+                    tx->stats.busy_slots++;
+                    tx->next_ms = t + csma_tx_slot_ms(tx);
+                    break;
+                }
+                if (csma_tx_random(tx) > tx->config.persistence) {
+                    tx->stats.persist_slots++;
+                    tx->next_ms = t + csma_tx_slot_ms(tx);
+                    break;
+                }
+            }
+            if (tx->ptt) {
+                tx->ptt(tx->ctx, true);
+            }
+            tx->stats.keyups++;
+            tx->keyed_at = t;
+            tx->state = CSMA_TX_KEYUP;
+            tx->next_ms = t + (uint64_t)tx->config.tx_delay * CSMA_TX_UNIT_MS;
+            break;
+
+        case CSMA_TX_KEYUP:
+            // Frames queued during TXDELAY still make this burst
+            tx->state = CSMA_TX_SENDING;
+            tx->next_ms = t + csma_tx_send_burst(tx);
+            sent += tx->burst_frames;
+            break;
+
+        case CSMA_TX_SENDING:
+            tx->state = CSMA_TX_TAIL;
+            tx->next_ms = t + (uint64_t)tx->config.tx_tail * CSMA_TX_UNIT_MS;
+            break;
+
+        case CSMA_TX_TAIL:
+            if (tx->ptt) {
+                tx->ptt(tx->ctx, false);
+            }
+            tx->stats.keyed_ms += t - tx->keyed_at;
+            tx->stats.overhead_ms += (uint64_t)(tx->config.tx_delay + tx->config.tx_tail) *
+                                     CSMA_TX_UNIT_MS;
+            if (!csma_tx_queued(tx)) {
+                tx->state = CSMA_TX_IDLE;
+            } else {
+                // Contend again for the rest; back off a slot if the
+                // handler took nothing, so a refusing link cannot spin
+                tx->state = CSMA_TX_DEFER;
+                tx->next_ms = tx->burst_frames ? t : t + csma_tx_slot_ms(tx);
+            }
+            break;
+
+        case CSMA_TX_IDLE:
+            break;
+        }
+    }
+
+    return sent;
+}
+
+uint64_t csma_tx_next_event(const csma_tx_t* tx) {
+    if (!tx || tx->state == CSMA_TX_IDLE) {
+        return CSMA_TX_IDLE_EVENT;
+    }
+    return tx->next_ms;
+}
+
+csma_tx_state_t csma_tx_get_state(const csma_tx_t* tx) {
+    return tx ? tx->state : CSMA_TX_IDLE;
+}
+
+// Get statistics
+int csma_tx_get_stats(const csma_tx_t* tx, csma_tx_stats_t* stats) {
+    if (!tx || !stats) {
+        return -1;
+    }
+
+    *stats = tx->stats;
+    return 0;
+}
@@ -0,0 +1,916 @@
+//--------------------------------------------------------------------
+// KISS Link I/O Engine
+//
+// Multi-link KISS transport with an io_uring backend and a poll()
+// fallback behind one API
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "kiss_io.h"
+#include "kiss_protocol.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+// io_uring support needs multishot receive and provided buffer rings
+// (Linux 6.0 headers); HAVE_IO_URING is set by the build when found
+#if defined(__linux__) && defined(HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(IORING_RECV_MULTISHOT)
+#define KISS_IO_HAVE_URING 1
+#endif
+#endif
+
+#define KISS_IO_READ_SIZE       4096    // Bytes per read / receive buffer
+
+typedef struct {
+    int fd;                     // -1 = free slot
+    int fd_flags;               // File status flags to restore on release
+    bool is_socket;             // Sockets use send/recv, ttys read/write
+    bool closing;               // Removed; waiting for in-flight requests
+    kiss_tnc_t decoder;         // Receive state and frame queue
+    uint8_t* tx_ring;           // This link's slice of the transmit region
+    size_t tx_head;             // Next byte to write
+    size_t tx_tail;             // Next free byte
+    int tx_inflight;            // io_uring: send requests in flight
+    bool rx_armed;              // io_uring: receive request in flight
+    bool cancel_inflight;       // io_uring: cancel request in flight
+} kiss_io_link_t;
+
+#ifdef KISS_IO_HAVE_URING
+#define KISS_IO_RX_BUFFERS      128     // Provided receive buffers (power of two)
+#define KISS_IO_BUFFER_GROUP    0
+
+// user_data carries the link id and the request type
+#define KISS_IO_OP_RECV         1
+#define KISS_IO_OP_SEND         2
+#define KISS_IO_OP_CANCEL       3
+#define KISS_IO_USER_DATA(link_id, op)  (((uint64_t)(link_id) << 8) | (op))
+
+typedef struct {
+    int ring_fd;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned* sq_flags;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sqe_tail;                  // Local tail, published on enter
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    void* ring_map;
+    size_t ring_map_len;
+    void* sqe_map;
+    size_t sqe_map_len;
+    struct io_uring_buf_ring* buf_ring; // Provided receive buffers
+    size_t buf_ring_len;
+    uint16_t buf_tail;
+    uint8_t* rx_buffers;
+    bool tx_fixed;                      // Transmit region registered
+    bool recv_single_shot;              // Kernel without multishot receive
+} kiss_io_uring_t;
+#endif
+
+struct kiss_io {
+    kiss_io_config_t config;
+    kiss_io_backend_t backend;
+    kiss_io_link_t* links;
+    uint8_t* tx_region;                 // max_links transmit rings
+    size_t tx_region_len;
+    size_t tx_mask;                     // Per-link ring size - 1
+    struct pollfd* pollfds;             // POSIX backend
+    int* poll_links;
+    int delivered;                      // Frames delivered by the current poll
+    kiss_io_stats_t stats;
+#ifdef KISS_IO_HAVE_URING
+    kiss_io_uring_t uring;
+#endif
+};
+
+// Context for draining one link's receive queue
+typedef struct {
+    kiss_io_t* io;
+    int link_id;
+} kiss_io_rx_ctx_t;
+
+static void kiss_io_close_link(kiss_io_t* io, int link_id);
+static void kiss_io_fail_link(kiss_io_t* io, int link_id);
+
+// Default configuration
+void kiss_io_default_config(kiss_io_config_t* config) {
+    if (!config) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    config->max_links = KISS_IO_DEFAULT_MAX_LINKS;
+    config->tx_buffer_size = KISS_IO_DEFAULT_TX_BUFFER;
+}
+
+//--------------------------------------------------------------------
+// Shared link handling
+//--------------------------------------------------------------------
+
+static void kiss_io_on_frame(void* ctx, const kiss_rx_slot_t* frame) {
+    kiss_io_rx_ctx_t* rx = (kiss_io_rx_ctx_t*)ctx;
+    kiss_io_t* io = rx->io;
+    kiss_io_link_t* link = &io->links[rx->link_id];
+    if (link->fd < 0 || link->closing) {
+        return; // Removed by an earlier frame's handler
+    }
+
+    io->stats.frames_in++;
+    io->delivered++;
+    if (io->config.on_frame) {
+        io->config.on_frame(io->config.ctx, rx->link_id, frame->data, frame->length,
+                            frame->port, frame->command);
+    }
+}
+
+// Feed received bytes to a link's decoder and deliver completed frames
+static void kiss_io_decode(kiss_io_t* io, int link_id, const uint8_t* data, size_t length) {
+    kiss_io_link_t* link = &io->links[link_id];
+    kiss_io_rx_ctx_t rx = { io, link_id };
+
+    io->stats.bytes_in += length;
+    kiss_decode_frames(&link->decoder, data, length, kiss_io_on_frame, &rx);
+}
+
+// Restart an empty ring at its base so frames are encoded in place again
+static void kiss_io_tx_rewind(kiss_io_link_t* link) {
+    if (link->tx_head == link->tx_tail && link->tx_inflight == 0) {
+        link->tx_head = 0;
+        link->tx_tail = 0;
+    }
+}
+
+// Release a closed link's resources and free its slot
+static void kiss_io_release_link(kiss_io_link_t* link) {
+    fcntl(link->fd, F_SETFL, link->fd_flags);
+    close(link->fd);
+    kiss_cleanup(&link->decoder);
+    link->fd = -1;
+    link->closing = false;
+    link->rx_armed = false;
+    link->cancel_inflight = false;
+    link->tx_inflight = 0;
+    link->tx_head = 0;
+    link->tx_tail = 0;
+}
+
+//--------------------------------------------------------------------
+// io_uring backend
+//--------------------------------------------------------------------
+#ifdef KISS_IO_HAVE_URING
+
+static int kiss_io_uring_enter(kiss_io_t* io, unsigned wait_nr, int timeout_ms) {
+    kiss_io_uring_t* u = &io->uring;
+
+    __atomic_store_n(u->sq_tail, u->sqe_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = u->sqe_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE);
+    bool taskrun = __atomic_load_n(u->sq_flags, __ATOMIC_RELAXED) & IORING_SQ_TASKRUN;
+    if (to_submit == 0 && wait_nr == 0 && !taskrun) {
+        return 0;
+    }
+
+    unsigned flags = taskrun ? IORING_ENTER_GETEVENTS : 0;
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+    void* argp = NULL;
+    size_t argsz = 0;
+    if (wait_nr > 0) {
+        flags |= IORING_ENTER_GETEVENTS;
+        if (timeout_ms >= 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+            memset(&arg, 0, sizeof(arg));
+            arg.ts = (uint64_t)(uintptr_t)&ts;
+            flags |= IORING_ENTER_EXT_ARG;
+            argp = &arg;
+            argsz = sizeof(arg);
+        }
+    }
+
+    io->stats.syscalls++;
+    long ret = syscall(__NR_io_uring_enter, u->ring_fd, to_submit, wait_nr, flags, argp, argsz);
+    if (ret < 0) {
+        if (errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+            return 0;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+// Make room for count submission entries, submitting if the queue is full
+static int kiss_io_uring_reserve(kiss_io_t* io, unsigned count) {
+    kiss_io_uring_t* u = &io->uring;
+
+    if (u->sqe_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) + count <= u->sq_entries) {
+        return 0;
+    }
+    if (kiss_io_uring_enter(io, 0, 0) != 0) {
+        return -1;
+    }
+    return (u->sqe_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) + count <= u->sq_entries)
+               ? 0
+               : -1;
+}
+
+// Next submission entry; kiss_io_uring_reserve must have made room
+static struct io_uring_sqe* kiss_io_uring_sqe(kiss_io_t* io, uint64_t user_data) {
+    kiss_io_uring_t* u = &io->uring;
+
+    unsigned index = u->sqe_tail & u->sq_mask;
+    struct io_uring_sqe* sqe = &u->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = user_data;
+    u->sq_array[index] = index;
+    u->sqe_tail++;
+    return sqe;
+}
+
+// Hand a receive buffer back to the kernel
+static void kiss_io_uring_recycle(kiss_io_uring_t* u, uint16_t bid) {
+    struct io_uring_buf* buf = &u->buf_ring->bufs[u->buf_tail & (KISS_IO_RX_BUFFERS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)&u->rx_buffers[(size_t)bid * KISS_IO_READ_SIZE];
+    buf->len = KISS_IO_READ_SIZE;
+    buf->bid = bid;
+    u->buf_tail++;
+    __atomic_store_n(&u->buf_ring->tail, u->buf_tail, __ATOMIC_RELEASE);
+}
+
+// Arm a receive: multishot on sockets, re-armed reads on ttys
+static int kiss_io_uring_arm_recv(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+    if (kiss_io_uring_reserve(io, 1) != 0) {
+        return -1;
+    }
+
+    struct io_uring_sqe* sqe = kiss_io_uring_sqe(io, KISS_IO_USER_DATA(link_id, KISS_IO_OP_RECV));
+    if (link->is_socket) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = io->uring.recv_single_shot ? 0 : IORING_RECV_MULTISHOT;
+    } else {
+        sqe->opcode = IORING_OP_READ;
+        sqe->off = (uint64_t)-1; // Current position; ttys are streams
+        sqe->len = KISS_IO_READ_SIZE;
+    }
+    sqe->fd = link->fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = KISS_IO_BUFFER_GROUP;
+    link->rx_armed = true;
+    return 0;
+}
+
+// Submit the contiguous run of queued bytes up to the end of the ring.
+// Only one send is in flight per link: a short send is not an error and
+// would not break a linked chain, so a second segment could follow a
+// partial first one. The rest goes out from the next poll.
+static int kiss_io_uring_send(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+    size_t pending = link->tx_tail - link->tx_head;
+    if (pending == 0 || link->tx_inflight > 0) {
+        return 0;
+    }
+    if (kiss_io_uring_reserve(io, 1) != 0) {
+        return -1;
+    }
+
+    size_t size = io->tx_mask + 1;
+    size_t offset = link->tx_head & io->tx_mask;
+    size_t len = (pending < size - offset) ? pending : size - offset;
+
+    struct io_uring_sqe* sqe = kiss_io_uring_sqe(io, KISS_IO_USER_DATA(link_id, KISS_IO_OP_SEND));
+    if (link->is_socket) {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->msg_flags = MSG_NOSIGNAL;
+    } else {
+        sqe->opcode = io->uring.tx_fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->off = (uint64_t)-1;
+        sqe->buf_index = 0;
+    }
+    sqe->fd = link->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&link->tx_ring[offset];
+    sqe->len = len;
+
+    link->tx_inflight = 1;
+    return 0;
+}
+
+// Cancel every request on a link; it is released when the last one,
+// including the cancel itself, completes, so the descriptor cannot be
+// closed (and its number reused) while the kernel may still look it up
+static void kiss_io_uring_cancel(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+    if (kiss_io_uring_reserve(io, 1) != 0) {
+        return;
+    }
+    link->cancel_inflight = true;
+
+    struct io_uring_sqe* sqe = kiss_io_uring_sqe(io, KISS_IO_USER_DATA(link_id, KISS_IO_OP_CANCEL));
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = link->fd;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+}
+
+static void kiss_io_uring_complete(kiss_io_t* io, const struct io_uring_cqe* cqe) {
+    int link_id = (int)(cqe->user_data >> 8);
+    int op = (int)(cqe->user_data & 0xFF);
+    kiss_io_link_t* link = &io->links[link_id];
+
+    if (op == KISS_IO_OP_CANCEL) {
+        link->cancel_inflight = false;
+    } else if (op == KISS_IO_OP_RECV) {
+        if (cqe->flags & IORING_CQE_F_BUFFER) {
+            uint16_t bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            if (cqe->res > 0 && !link->closing) {
+                kiss_io_decode(io, link_id, &io->uring.rx_buffers[(size_t)bid * KISS_IO_READ_SIZE],
+                               cqe->res);
+            }
+            kiss_io_uring_recycle(&io->uring, bid);
+        }
+        if (!(cqe->flags & IORING_CQE_F_MORE)) {
+            link->rx_armed = false;
+        }
+
+        if (!link->closing) {
+            if (cqe->res == -EINVAL && link->is_socket && !io->uring.recv_single_shot) {
+                io->uring.recv_single_shot = true; // Kernel without multishot receive
+            } else if (cqe->res == 0 ||
+                       (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -EINTR &&
+                        cqe->res != -EAGAIN)) {
+                kiss_io_fail_link(io, link_id); // Hangup or error
+            }
+        }
+        if (!link->closing && !link->rx_armed) {
+            kiss_io_uring_arm_recv(io, link_id);
+        }
+    } else if (op == KISS_IO_OP_SEND) {
+        link->tx_inflight--;
+        if (cqe->res > 0) {
+            link->tx_head += cqe->res;
+            io->stats.bytes_out += cqe->res;
+        } else if (cqe->res != -ECANCELED && cqe->res != -EAGAIN && cqe->res != -EINTR &&
+                   !link->closing) {
+            kiss_io_fail_link(io, link_id);
+        }
+        // Whatever a short write left is resubmitted on the next poll
+        kiss_io_tx_rewind(link);
+    }
+
+    if (link->closing && !link->rx_armed && link->tx_inflight == 0 && !link->cancel_inflight) {
+        kiss_io_release_link(link);
+    }
+}
+
+static void kiss_io_uring_reap(kiss_io_t* io) {
+    kiss_io_uring_t* u = &io->uring;
+    unsigned head = *u->cq_head;
+
+    while (head != __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe cqe = u->cqes[head & u->cq_mask];
+        head++;
+        __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+        kiss_io_uring_complete(io, &cqe);
+    }
+}
+
+static void kiss_io_uring_teardown(kiss_io_t* io) {
+    kiss_io_uring_t* u = &io->uring;
+
+    if (u->ring_fd >= 0) {
+        close(u->ring_fd);
+    }
+    if (u->ring_map && u->ring_map != MAP_FAILED) {
+        munmap(u->ring_map, u->ring_map_len);
+    }
+    if (u->sqe_map && u->sqe_map != MAP_FAILED) {
+        munmap(u->sqe_map, u->sqe_map_len);
+    }
+    if (u->buf_ring && u->buf_ring != MAP_FAILED) {
+        munmap(u->buf_ring, u->buf_ring_len);
+    }
+    free(u->rx_buffers);
+    memset(u, 0, sizeof(*u));
+    u->ring_fd = -1;
+}
+
+// Set up the ring, the provided buffers and the registered transmit
+// region; any failure leaves the engine on the POSIX backend
+static int kiss_io_uring_setup(kiss_io_t* io) {
+    kiss_io_uring_t* u = &io->uring;
+    u->ring_fd = -1;
+
+    unsigned entries = 64;
+    while (entries < 4u * (unsigned)io->config.max_links && entries < 4096) {
+        entries <<= 1;
+    }
+
+    // Completions are only reaped from the polling thread, so the kernel
+    // need not interrupt it to run completion work (Linux 6.0+); the
+    // TASKRUN flag tells the poll loop when to enter to let that work run.
+    // The ring is not tied to one issuer: the engine is usually created on
+    // one thread and polled (and destroyed) on others.
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+    u->ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (u->ring_fd < 0 && errno == EINVAL) {
+        memset(&params, 0, sizeof(params));
+        u->ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    }
+    if (u->ring_fd < 0) {
+        u->ring_fd = -1;
+        return -1; // ENOSYS, EPERM (seccomp, io_uring_disabled), ...
+    }
+
+    const unsigned required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        kiss_io_uring_teardown(io);
+        return -1;
+    }
+
+    size_t sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    u->ring_map_len = (sq_len > cq_len) ? sq_len : cq_len;
+    u->ring_map = mmap(NULL, u->ring_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       u->ring_fd, IORING_OFF_SQ_RING);
+    u->sqe_map_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqe_map = mmap(NULL, u->sqe_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      u->ring_fd, IORING_OFF_SQES);
+    if (u->ring_map == MAP_FAILED || u->sqe_map == MAP_FAILED) {
+        kiss_io_uring_teardown(io);
+        return -1;
+    }
+
+    uint8_t* ring = (uint8_t*)u->ring_map;
+    u->sq_head = (unsigned*)(ring + params.sq_off.head);
+    u->sq_tail = (unsigned*)(ring + params.sq_off.tail);
+    u->sq_array = (unsigned*)(ring + params.sq_off.array);
+    u->sq_flags = (unsigned*)(ring + params.sq_off.flags);
+    u->sq_mask = *(unsigned*)(ring + params.sq_off.ring_mask);
+    u->sq_entries = params.sq_entries;
+    u->sqe_tail = *u->sq_tail;
+    u->sqes = (struct io_uring_sqe*)u->sqe_map;
+    u->cq_head = (unsigned*)(ring + params.cq_off.head);
+    u->cq_tail = (unsigned*)(ring + params.cq_off.tail);
+    u->cq_mask = *(unsigned*)(ring + params.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*)(ring + params.cq_off.cqes);
+
+    // Provided buffer ring for receives
+    u->buf_ring_len = KISS_IO_RX_BUFFERS * sizeof(struct io_uring_buf);
+    u->buf_ring = mmap(NULL, u->buf_ring_len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    u->rx_buffers = malloc((size_t)KISS_IO_RX_BUFFERS * KISS_IO_READ_SIZE);
+    if (u->buf_ring == MAP_FAILED || !u->rx_buffers) {
+        kiss_io_uring_teardown(io);
+        return -1;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)u->buf_ring;
+    reg.ring_entries = KISS_IO_RX_BUFFERS;
+    reg.bgid = KISS_IO_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, u->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        kiss_io_uring_teardown(io);
+        return -1;
+    }
+    for (uint16_t bid = 0; bid < KISS_IO_RX_BUFFERS; bid++) {
+        kiss_io_uring_recycle(u, bid);
+    }
+
+    // Registered transmit region; plain writes are used if pinning fails
+    struct iovec region = { io->tx_region, io->tx_region_len };
+    u->tx_fixed =
+        syscall(__NR_io_uring_register, u->ring_fd, IORING_REGISTER_BUFFERS, &region, 1) == 0;
+
+    return 0;
+}
+
+// Cancel everything and wait (bounded) for the kernel to let go of the buffers
+static void kiss_io_uring_drain(kiss_io_t* io) {
+    for (int i = 0; i < io->config.max_links; i++) {
+        kiss_io_close_link(io, i);
+    }
+
+    for (int attempt = 0; attempt < 10; attempt++) {
+        bool busy = false;
+        for (int i = 0; i < io->config.max_links; i++) {
+            if (io->links[i].fd >= 0) {
+                busy = true;
+                break;
+            }
+        }
+        if (!busy || kiss_io_uring_enter(io, 1, 100) != 0) {
+            break;
+        }
+        kiss_io_uring_reap(io);
+    }
+}
+
+static int kiss_io_uring_poll(kiss_io_t* io, int timeout_ms) {
+    kiss_io_uring_t* u = &io->uring;
+
+    for (int i = 0; i < io->config.max_links; i++) {
+        kiss_io_link_t* link = &io->links[i];
+        if (link->fd < 0 || link->closing) {
+            continue;
+        }
+        if (!link->rx_armed && kiss_io_uring_arm_recv(io, i) != 0) {
+            return -1;
+        }
+        if (kiss_io_uring_send(io, i) != 0) {
+            return -1;
+        }
+    }
+
+    // Submit and wait in one call; skip the wait if completions are ready
+    bool ready = *u->cq_head != __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+    if (kiss_io_uring_enter(io, (ready || timeout_ms == 0) ? 0 : 1, timeout_ms) != 0) {
+        return -1;
+    }
+    kiss_io_uring_reap(io);
+    return 0;
+}
+
+#endif // KISS_IO_HAVE_URING
+
+//--------------------------------------------------------------------
+// POSIX backend
+//--------------------------------------------------------------------
+
+static int kiss_io_posix_flush(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+
+    while (link->tx_tail != link->tx_head) {
+        size_t size = io->tx_mask + 1;
+        size_t pending = link->tx_tail - link->tx_head;
+        size_t offset = link->tx_head & io->tx_mask;
+        size_t first = (pending < size - offset) ? pending : size - offset;
+
+        struct iovec iov[2];
+        iov[0].iov_base = &link->tx_ring[offset];
+        iov[0].iov_len = first;
+        iov[1].iov_base = link->tx_ring;
+        iov[1].iov_len = pending - first;
+        int iovcnt = (pending > first) ? 2 : 1;
+
+        ssize_t written;
+        io->stats.syscalls++;
+        if (link->is_socket) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iovcnt;
+            written = sendmsg(link->fd, &msg, MSG_NOSIGNAL);
+        } else {
+            written = writev(link->fd, iov, iovcnt);
+        }
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return -1;
+        }
+
+        link->tx_head += written;
+        io->stats.bytes_out += written;
+    }
+
+    kiss_io_tx_rewind(link);
+    return 0;
+}
+
+// Read until the descriptor is drained; -1 on hangup or error
+static int kiss_io_posix_read(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+    uint8_t buffer[KISS_IO_READ_SIZE];
+
+    while (link->fd >= 0 && !link->closing) {
+        io->stats.syscalls++;
+        ssize_t received = read(link->fd, buffer, sizeof(buffer));
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        if (received == 0) {
+            return -1; // Hangup
+        }
+        kiss_io_decode(io, link_id, buffer, received);
+    }
+    return 0;
+}
+
+static int kiss_io_posix_poll(kiss_io_t* io, int timeout_ms) {
+    int count = 0;
+    for (int i = 0; i < io->config.max_links; i++) {
+        kiss_io_link_t* link = &io->links[i];
+        if (link->fd < 0) {
+            continue;
+        }
+        io->pollfds[count].fd = link->fd;
+        io->pollfds[count].events = POLLIN | ((link->tx_tail != link->tx_head) ? POLLOUT : 0);
+        io->pollfds[count].revents = 0;
+        io->poll_links[count] = i;
+        count++;
+    }
+
+    io->stats.syscalls++;
+    int ready = poll(io->pollfds, count, timeout_ms);
+    if (ready <= 0) {
+        return (ready == 0 || errno == EINTR) ? 0 : -1;
+    }
+
+    for (int n = 0; n < count; n++) {
+        int link_id = io->poll_links[n];
+        short revents = io->pollfds[n].revents;
+        if (io->links[link_id].fd != io->pollfds[n].fd) {
+            continue; // Removed by a handler during this poll
+        }
+
+        if ((revents & (POLLIN | POLLHUP | POLLERR)) && kiss_io_posix_read(io, link_id) != 0) {
+            kiss_io_fail_link(io, link_id);
+            continue;
+        }
+        if (io->links[link_id].fd >= 0 && (revents & POLLOUT) &&
+            kiss_io_posix_flush(io, link_id) != 0) {
+            kiss_io_fail_link(io, link_id);
+        }
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------
+// Public API
+//--------------------------------------------------------------------
+
+// Close a link; with io_uring it is released once its requests complete
+static void kiss_io_close_link(kiss_io_t* io, int link_id) {
+    kiss_io_link_t* link = &io->links[link_id];
+    if (link->fd < 0 || link->closing) {
+        return;
+    }
+
+#ifdef KISS_IO_HAVE_URING
+    if (io->backend == KISS_IO_BACKEND_URING && (link->rx_armed || link->tx_inflight > 0)) {
+        link->closing = true;
+        kiss_io_uring_cancel(io, link_id);
+        return;
+    }
+#endif
+    kiss_io_release_link(link);
+}
+
+// Report a hangup or I/O error, then close the link
+static void kiss_io_fail_link(kiss_io_t* io, int link_id) {
+    if (io->links[link_id].fd < 0 || io->links[link_id].closing) {
+        return;
+    }
+    if (io->config.on_close) {
+        io->config.on_close(io->config.ctx, link_id);
+    }
+    kiss_io_close_link(io, link_id);
+}
+
+kiss_io_t* kiss_io_create(const kiss_io_config_t* config) {
+    if (!config || config->max_links <= 0 || config->max_links > (1 << 24) ||
+        config->tx_buffer_size == 0) {
+        return NULL;
+    }
+
+    kiss_io_t* io = calloc(1, sizeof(kiss_io_t));
+    if (!io) {
+        return NULL;
+    }
+    io->config = *config;
+    io->backend = KISS_IO_BACKEND_POSIX;
+#ifdef KISS_IO_HAVE_URING
+    io->uring.ring_fd = -1;
+#endif
+
+    size_t size = 1;
+    while (size < config->tx_buffer_size) {
+        size <<= 1;
+    }
+    io->config.tx_buffer_size = size;
+    io->tx_mask = size - 1;
+
+    // Page-aligned so the whole region can be registered with the kernel
+    io->tx_region_len = size * config->max_links;
+    io->tx_region = mmap(NULL, io->tx_region_len, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    io->links = calloc(config->max_links, sizeof(kiss_io_link_t));
+    io->pollfds = calloc(config->max_links, sizeof(struct pollfd));
+    io->poll_links = calloc(config->max_links, sizeof(int));
+    if (io->tx_region == MAP_FAILED || !io->links || !io->pollfds || !io->poll_links) {
+        if (io->tx_region == MAP_FAILED) {
+            io->tx_region = NULL;
+        }
+        kiss_io_destroy(io);
+        return NULL;
+    }
+
+    for (int i = 0; i < config->max_links; i++) {
+        io->links[i].fd = -1;
+        io->links[i].tx_ring = &io->tx_region[(size_t)i * size];
+    }
+
+#ifdef KISS_IO_HAVE_URING
+    if (!config->force_posix && kiss_io_uring_setup(io) == 0) {
+        io->backend = KISS_IO_BACKEND_URING;
+    }
+#endif
+
+    return io;
+}
+
+void kiss_io_destroy(kiss_io_t* io) {
+    if (!io) {
+        return;
+    }
+
+#ifdef KISS_IO_HAVE_URING
+    if (io->backend == KISS_IO_BACKEND_URING) {
+        kiss_io_uring_drain(io);
+    }
+    kiss_io_uring_teardown(io);
+#endif
+
+    if (io->links) {
+        for (int i = 0; i < io->config.max_links; i++) {
+            if (io->links[i].fd >= 0) {
+                kiss_io_release_link(&io->links[i]);
+            }
+        }
+    }
+
+    if (io->tx_region) {
+        munmap(io->tx_region, io->tx_region_len);
+    }
+    free(io->links);
+    free(io->pollfds);
+    free(io->poll_links);
+    free(io);
+}
+
+kiss_io_backend_t kiss_io_backend(const kiss_io_t* io) {
+    return io ? io->backend : KISS_IO_BACKEND_POSIX;
+}
+
+int kiss_io_add_link(kiss_io_t* io, int fd) {
+    if (!io || fd < 0) {
+        return -1;
+    }
+
+    int link_id = -1;
+    for (int i = 0; i < io->config.max_links; i++) {
+        if (io->links[i].fd < 0) {
+            link_id = i;
+            break;
+        }
+    }
+    if (link_id < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    int flags = fcntl(fd, F_GETFL);
+    if (fstat(fd, &st) != 0 || flags < 0) {
+        return -1;
+    }
+
+    // The POSIX backend needs non-blocking descriptors; io_uring waits
+    // for readiness itself and punts blocking tty I/O to its workers
+    int link_flags =
+        (io->backend == KISS_IO_BACKEND_POSIX) ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(fd, F_SETFL, link_flags) != 0) {
+        return -1;
+    }
+
+    kiss_io_link_t* link = &io->links[link_id];
+    link->fd = fd;
+    link->fd_flags = flags;
+    link->is_socket = S_ISSOCK(st.st_mode);
+    link->closing = false;
+    link->tx_head = 0;
+    link->tx_tail = 0;
+    link->tx_inflight = 0;
+    link->rx_armed = false;
+    link->cancel_inflight = false;
+    kiss_init(&link->decoder);
+
+#ifdef KISS_IO_HAVE_URING
+    if (io->backend == KISS_IO_BACKEND_URING) {
+        kiss_io_uring_arm_recv(io, link_id); // Submitted by the next poll
+    }
+#endif
+
+    return link_id;
+}
+
+int kiss_io_remove_link(kiss_io_t* io, int link_id) {
+    if (!io || link_id < 0 || link_id >= io->config.max_links ||
+        io->links[link_id].fd < 0 || io->links[link_id].closing) {
+        return -1;
+    }
+
+    kiss_io_close_link(io, link_id);
+    return 0;
+}
+
+// Encode a frame into a link's transmit ring
+int kiss_io_send(kiss_io_t* io, int link_id, const uint8_t* data, uint16_t length, uint8_t port) {
+    if (!io || link_id < 0 || link_id >= io->config.max_links || (!data && length > 0) ||
+        length > KISS_MAX_FRAME_LEN) {
+        return -1;
+    }
+
+    kiss_io_link_t* link = &io->links[link_id];
+    if (link->fd < 0 || link->closing) {
+        return -1;
+    }
+
+    size_t size = io->tx_mask + 1;
+    size_t free_bytes = size - (link->tx_tail - link->tx_head);
+    size_t offset = link->tx_tail & io->tx_mask;
+    size_t contiguous = size - offset;
+    if (contiguous > free_bytes) {
+        contiguous = free_bytes;
+    }
+
+    int encoded;
+    if (contiguous >= KISS_ENCODED_MAX(length)) {
+        encoded = kiss_encode_frame(data, length, port, &link->tx_ring[offset]);
+    } else {
+        // Near the wrap point or a nearly full ring: stage, then copy if it fits
+        uint8_t staging[KISS_ENCODED_MAX(KISS_MAX_FRAME_LEN)];
+        encoded = kiss_encode_frame(data, length, port, staging);
+        if (encoded < 0 || (size_t)encoded > free_bytes) {
+            io->stats.frames_dropped++;
+            return -1;
+        }
+        size_t first = (size_t)encoded < size - offset ? (size_t)encoded : size - offset;
+        memcpy(&link->tx_ring[offset], staging, first);
+        memcpy(link->tx_ring, &staging[first], encoded - first);
+    }
+    if (encoded < 0) {
+        return -1;
+    }
+
+    link->tx_tail += encoded;
+    io->stats.frames_out++;
+    return 0;
+}
+
+size_t kiss_io_pending(const kiss_io_t* io, int link_id) {
+    if (!io || link_id < 0 || link_id >= io->config.max_links) {
+        return 0;
+    }
+    return io->links[link_id].tx_tail - io->links[link_id].tx_head;
+}
+
+int kiss_io_poll(kiss_io_t* io, int timeout_ms) {
+    if (!io) {
+        return -1;
+    }
+
+    io->delivered = 0;
+    int result;
+#ifdef KISS_IO_HAVE_URING
+    if (io->backend == KISS_IO_BACKEND_URING) {
+        result = kiss_io_uring_poll(io, timeout_ms);
+    } else
+#endif
+    {
+        result = kiss_io_posix_poll(io, timeout_ms);
+    }
+
+    return (result < 0) ? -1 : io->delivered;
+}
+
+int kiss_io_get_stats(const kiss_io_t* io, kiss_io_stats_t* stats) {
+    if (!io || !stats) {
+        return -1;
+    }
+
+    *stats = io->stats;
+    return 0;
+}
@@ -0,0 +1,375 @@
+//--------------------------------------------------------------------
+// Multi-Port KISS Multiplexer
+//
+// Per-port receive/transmit queues with deficit round-robin output
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "kiss_mux.h"
+#include "kiss_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+// Bounded frame queue; slots are reused in place
+typedef struct {
+    kiss_rx_slot_t* slots;
+    uint16_t depth;
+    uint16_t head;              // Oldest frame
+    uint16_t count;
+} kiss_mux_queue_t;
+
+typedef struct {
+    kiss_mux_t* mux;
+    uint8_t index;              // KISS port number
+    bool open;
+    uint16_t weight;            // DRR quantum in units of KISS_MUX_QUANTUM
+    size_t deficit;             // Unused TX credit in bytes
+    kiss_mux_queue_t rx;
+    kiss_mux_queue_t tx;
+    m17_ax25_bridge_t* bridge;  // Receives the port's frames (may be NULL)
+    kiss_mux_port_stats_t stats;
+} kiss_mux_port_t;
+
+struct kiss_mux {
+    kiss_tnc_t decoder;         // Receive state for the shared link
+    kiss_mux_port_t ports[KISS_MUX_PORTS];
+    uint32_t unrouted;          // Frames for ports that are not open
+    uint8_t rx_next;            // Next port dispatch serves
+    uint8_t tx_next;            // Port the DRR scheduler is visiting
+    bool tx_granted;            // tx_next already received its quantum this visit
+};
+
+static kiss_rx_slot_t* kiss_mux_queue_tail(kiss_mux_queue_t* queue) {
+    if (queue->count == queue->depth) {
+        return NULL;
+    }
+    return &queue->slots[(queue->head + queue->count) % queue->depth];
+}
+
+static void kiss_mux_queue_pop(kiss_mux_queue_t* queue) {
+    queue->head = (queue->head + 1) % queue->depth;
+    queue->count--;
+}
+
+// Create a multiplexer with every port closed
+kiss_mux_t* kiss_mux_create(void) {
+    kiss_mux_t* mux = calloc(1, sizeof(kiss_mux_t));
+    if (!mux) {
+        return NULL;
+    }
+
+    kiss_init(&mux->decoder);
+    for (int i = 0; i < KISS_MUX_PORTS; i++) {
+        mux->ports[i].mux = mux;
+        mux->ports[i].index = (uint8_t)i;
+    }
+    return mux;
+}
+
+// Close every port and free the multiplexer
+void kiss_mux_destroy(kiss_mux_t* mux) {
+    if (!mux) {
+        return;
+    }
+
+    for (int i = 0; i < KISS_MUX_PORTS; i++) {
+        kiss_mux_close_port(mux, (uint8_t)i);
+    }
+    kiss_cleanup(&mux->decoder);
+    free(mux);
+}
+
+// Allocate a port's queues and start routing its frames
+int kiss_mux_open_port(kiss_mux_t* mux, uint8_t port, uint16_t weight, uint16_t depth) {
+    if (!mux || port >= KISS_MUX_PORTS || weight == 0 || depth == 0 || mux->ports[port].open) {
+        return -1;
+    }
+
+    kiss_mux_port_t* p = &mux->ports[port];
+    p->rx.slots = malloc(depth * sizeof(kiss_rx_slot_t));
+    p->tx.slots = malloc(depth * sizeof(kiss_rx_slot_t));
+    if (!p->rx.slots || !p->tx.slots) {
+        free(p->rx.slots);
+        free(p->tx.slots);
+        p->rx.slots = NULL;
+        p->tx.slots = NULL;
+        return -1;
+    }
+
+    p->rx.depth = depth;
+    p->rx.head = 0;
+    p->rx.count = 0;
+    p->tx.depth = depth;
+    p->tx.head = 0;
+    p->tx.count = 0;
+    p->weight = weight;
+    p->deficit = 0;
+    p->bridge = NULL;
+    memset(&p->stats, 0, sizeof(p->stats));
+    p->open = true;
+    return 0;
+}
+
+// Detach the port's bridge and discard its queued frames
+int kiss_mux_close_port(kiss_mux_t* mux, uint8_t port) {
+    if (!mux || port >= KISS_MUX_PORTS || !mux->ports[port].open) {
+        return -1;
+    }
+
+    kiss_mux_port_t* p = &mux->ports[port];
+    kiss_mux_attach_bridge(mux, port, NULL);
+    free(p->rx.slots);
+    free(p->tx.slots);
+    p->rx.slots = NULL;
+    p->tx.slots = NULL;
+    p->open = false;
+    if (mux->tx_next == port) {
+        mux->tx_granted = false;
+    }
+    return 0;
+}
+
+int kiss_mux_set_weight(kiss_mux_t* mux, uint8_t port, uint16_t weight) {
+    if (!mux || port >= KISS_MUX_PORTS || !mux->ports[port].open || weight == 0) {
+        return -1;
+    }
+
+    mux->ports[port].weight = weight;
+    return 0;
+}
+
+// Queue a frame on a port's transmit queue; returns -1 if it is full
+static int kiss_mux_enqueue_tx(kiss_mux_port_t* p, const struct iovec* iov, int iovcnt) {
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    if (total > KISS_MAX_FRAME_LEN) {
+        return -1;
+    }
+
+    kiss_rx_slot_t* slot = kiss_mux_queue_tail(&p->tx);
+    if (!slot) {
+        p->stats.tx_dropped++;
+        return -1;
+    }
+
+    size_t pos = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(&slot->data[pos], iov[i].iov_base, iov[i].iov_len);
+        pos += iov[i].iov_len;
+    }
+    slot->length = (uint16_t)total;
+    slot->command = KISS_CMD_DATA;
+    slot->port = p->index;
+    p->tx.count++;
+    return 0;
+}
+
+// KISS output of an attached bridge; the bridge's own port number is
+// replaced by the port it is attached to
+static int kiss_mux_bridge_tx(void* ctx, const struct iovec* iov, int iovcnt, uint8_t port) {
+    (void)port;
+    return kiss_mux_enqueue_tx((kiss_mux_port_t*)ctx, iov, iovcnt);
+}
+
+// Bind a bridge instance to a port
+int kiss_mux_attach_bridge(kiss_mux_t* mux, uint8_t port, m17_ax25_bridge_t* bridge) {
+    if (!mux || port >= KISS_MUX_PORTS || !mux->ports[port].open) {
+        return -1;
+    }
+
+    kiss_mux_port_t* p = &mux->ports[port];
+    if (p->bridge) {
+        kiss_set_tx_handler(&p->bridge->kiss_tnc, NULL, NULL);
+    }
+    p->bridge = bridge;
+    if (bridge) {
+        kiss_set_tx_handler(&bridge->kiss_tnc, kiss_mux_bridge_tx, p);
+    }
+    return 0;
+}
+
+// Copy one decoded frame into its port's receive queue
+static void kiss_mux_route(void* ctx, const kiss_rx_slot_t* frame) {
+    kiss_mux_t* mux = (kiss_mux_t*)ctx;
+    kiss_mux_port_t* p = &mux->ports[frame->port & 0x0F];
+
+    if (!p->open) {
+        mux->unrouted++;
+        return;
+    }
+
+    // TNC parameter frames are not AX.25 payload
+    if (frame->command != KISS_CMD_DATA) {
+        p->stats.rx_commands++;
+        return;
+    }
+
+    kiss_rx_slot_t* slot = kiss_mux_queue_tail(&p->rx);
+    if (!slot) {
+        p->stats.rx_dropped++;
+        return;
+    }
+
+    memcpy(slot->data, frame->data, frame->length);
+    slot->length = frame->length;
+    slot->command = KISS_CMD_DATA;
+    slot->port = p->index;
+    p->rx.count++;
+    p->stats.rx_frames++;
+    p->stats.rx_bytes += frame->length;
+}
+
+// Decode link bytes and route the completed frames by port
+int kiss_mux_input(kiss_mux_t* mux, const uint8_t* data, size_t length) {
+    if (!mux || (!data && length > 0)) {
+        return -1;
+    }
+
+    return kiss_decode_frames(&mux->decoder, data, length, kiss_mux_route, mux);
+}
+
+// Pop the oldest received frame of a port
+int kiss_mux_receive(kiss_mux_t* mux, uint8_t port, uint8_t* data, uint16_t* length) {
+    if (!mux || port >= KISS_MUX_PORTS || !data || !length || !mux->ports[port].open) {
+        return -1;
+    }
+
+    kiss_mux_port_t* p = &mux->ports[port];
+    if (p->rx.count == 0) {
+        return 0;
+    }
+
+    kiss_rx_slot_t* slot = &p->rx.slots[p->rx.head];
+    if (slot->length > *length) {
+        return -1;
+    }
+
+    memcpy(data, slot->data, slot->length);
+    *length = slot->length;
+    kiss_mux_queue_pop(&p->rx);
+    return 1;
+}
+
+// Feed queued frames to the attached bridges, one frame per port per pass
+int kiss_mux_dispatch(kiss_mux_t* mux, int max_frames) {
+    if (!mux) {
+        return -1;
+    }
+
+    int delivered = 0;
+    int idle = 0;
+    while (delivered < max_frames && idle < KISS_MUX_PORTS) {
+        kiss_mux_port_t* p = &mux->ports[mux->rx_next];
+        mux->rx_next = (mux->rx_next + 1) % KISS_MUX_PORTS;
+
+        if (!p->open || !p->bridge || p->rx.count == 0) {
+            idle++;
+            continue;
+        }
+        idle = 0;
+
+        kiss_rx_slot_t* slot = &p->rx.slots[p->rx.head];
+        if (m17_ax25_bridge_process_rx_data(p->bridge, slot->data, slot->length) != 0) {
+            p->stats.rx_errors++;
+        }
+        kiss_mux_queue_pop(&p->rx);
+        delivered++;
+    }
+
+    return delivered;
+}
+
+// Queue a frame for transmission on a port
+int kiss_mux_send(kiss_mux_t* mux, uint8_t port, const uint8_t* data, uint16_t length) {
+    if (!mux || port >= KISS_MUX_PORTS || !data || length == 0 || !mux->ports[port].open) {
+        return -1;
+    }
+
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = length;
+    return kiss_mux_enqueue_tx(&mux->ports[port], &iov, 1);
+}
+
+size_t kiss_mux_pending(const kiss_mux_t* mux, uint8_t port) {
+    if (!mux || port >= KISS_MUX_PORTS || !mux->ports[port].open) {
+        return 0;
+    }
+    return mux->ports[port].tx.count;
+}
+
+// Deficit round robin over the transmit queues. Each visit to a backlogged
+// port adds weight * KISS_MUX_QUANTUM bytes of credit and sends head frames
+// while they fit in it; an emptied queue forfeits what is left. When the
+// byte budget or the link stops the round, the next call resumes the same
+// visit without granting the quantum again.
+int kiss_mux_transmit(kiss_mux_t* mux, kiss_mux_tx_handler_t handler, void* ctx,
+                      size_t max_bytes) {
+    if (!mux || !handler) {
+        return -1;
+    }
+
+    int frames = 0;
+    size_t bytes = 0;
+    int idle = 0;
+    while (idle < KISS_MUX_PORTS) {
+        kiss_mux_port_t* p = &mux->ports[mux->tx_next];
+
+        if (!p->open || p->tx.count == 0) {
+            p->deficit = 0;
+            idle++;
+        } else {
+            idle = 0;
+            if (!mux->tx_granted) {
+                p->deficit += (size_t)p->weight * KISS_MUX_QUANTUM;
+                mux->tx_granted = true;
+            }
+
+            while (p->tx.count > 0) {
+                kiss_rx_slot_t* slot = &p->tx.slots[p->tx.head];
+                if (slot->length > p->deficit) {
+                    break;
+                }
+                if (max_bytes != 0 && bytes + slot->length > max_bytes) {
+                    return frames;
+                }
+                if (handler(ctx, slot->data, slot->length, p->index) != 0) {
+                    return frames;
+                }
+
+                p->deficit -= slot->length;
+                p->stats.tx_frames++;
+                p->stats.tx_bytes += slot->length;
+                bytes += slot->length;
+                frames++;
+                kiss_mux_queue_pop(&p->tx);
+            }
+
+            if (p->tx.count == 0) {
+                p->deficit = 0;
+            }
+        }
+
+        mux->tx_next = (mux->tx_next + 1) % KISS_MUX_PORTS;
+        mux->tx_granted = false;
+    }
+
+    return frames;
+}
+
+uint32_t kiss_mux_unrouted(const kiss_mux_t* mux) {
+    return mux ? mux->unrouted : 0;
+}
+
+// Get a port's statistics
+int kiss_mux_get_port_stats(const kiss_mux_t* mux, uint8_t port, kiss_mux_port_stats_t* stats) {
+    if (!mux || port >= KISS_MUX_PORTS || !stats || !mux->ports[port].open) {
+        return -1;
+    }
+
+    *stats = mux->ports[port].stats;
+    return 0;
+}
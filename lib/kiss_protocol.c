@@ -8,12 +8,25 @@
 // M17 Foundation, 19 April 2025
 //--------------------------------------------------------------------
 #include "kiss_protocol.h"
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Static escape sequences and terminator referenced by kiss_encode_iov
+static const uint8_t kiss_escaped_fend[2] = { KISS_FESC, KISS_TFEND };
+static const uint8_t kiss_escaped_fesc[2] = { KISS_FESC, KISS_TFESC };
+static const uint8_t kiss_fend = KISS_FEND;
 
 // Initialize KISS TNC
 int kiss_init(kiss_tnc_t* tnc) {
@@ -21,10 +34,17 @@ int kiss_init(kiss_tnc_t* tnc) {
         return -1;
     }
     
-    // Initialize state
+    // Initialize state and receive queue
     tnc->state = KISS_STATE_IDLE;
+    tnc->rx_head = 0;
+    tnc->rx_count = 0;
+    tnc->rx_frame = NULL;
     tnc->buffer_pos = 0;
-    tnc->frame_ready = false;
+    tnc->rx_dropped = 0;
+    tnc->serial_fd = -1;
+    tnc->tcp_socket = -1;
+    tnc->tx_handler = NULL;
+    tnc->tx_ctx = NULL;
     
     // Set default configuration
     tnc->config.tx_delay = 50;      // 500ms
@@ -34,13 +54,6 @@ int kiss_init(kiss_tnc_t* tnc) {
     tnc->config.full_duplex = false;
     tnc->config.hardware_id = 0;
     
-    // Initialize current frame
-    tnc->current_frame.data = NULL;
-    tnc->current_frame.length = 0;
-    tnc->current_frame.command = 0;
-    tnc->current_frame.port = 0;
-    tnc->current_frame.escaped = false;
-    
     return 0;
 }
 
@@ -50,16 +63,12 @@ int kiss_cleanup(kiss_tnc_t* tnc) {
         return -1;
     }
     
-    // Free allocated memory
-    if (tnc->current_frame.data) {
-        free(tnc->current_frame.data);
-        tnc->current_frame.data = NULL;
-    }
-    
-    // Reset state
+    // Reset state and discard queued frames
     tnc->state = KISS_STATE_IDLE;
+    tnc->rx_head = 0;
+    tnc->rx_count = 0;
+    tnc->rx_frame = NULL;
     tnc->buffer_pos = 0;
-    tnc->frame_ready = false;
     
     return 0;
 }
@@ -84,78 +93,276 @@ int kiss_get_config(const kiss_tnc_t* tnc, kiss_config_t* config) {
     return 0;
 }
 
+// Route outgoing frames to a handler instead of the serial/TCP interface
+int kiss_set_tx_handler(kiss_tnc_t* tnc, kiss_tx_handler_t handler, void* ctx) {
+    if (!tnc) {
+        return -1;
+    }
+
+    tnc->tx_handler = handler;
+    tnc->tx_ctx = ctx;
+    return 0;
+}
+
 // Send KISS frame
 int kiss_send_frame(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length, uint8_t port) {
     if (!tnc || !data || length == 0) {
         return -1;
     }
     
-    // Allocate frame buffer
-    uint8_t* frame = malloc(length + 3); // FEND + command + data + FEND
-    if (!frame) {
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = length;
+    
+    return kiss_send_iov(tnc, &iov, 1, port);
+}
+
+// Append one segment to a scatter-gather frame
+static int kiss_iov_append(kiss_iov_t* out, const void* base, size_t len) {
+    if (out->count >= KISS_IOV_MAX) {
+        return -1;
+    }
+    out->iov[out->count].iov_base = (void*)base;
+    out->iov[out->count].iov_len = len;
+    out->count++;
+    return 0;
+}
+
+// Build an escaped KISS frame referencing the payload segments in place
+int kiss_encode_iov(const struct iovec* in, int in_count, uint8_t port, uint8_t command,
+                    kiss_iov_t* out) {
+    if (!in || in_count < 0 || !out) {
         return -1;
     }
     
-    uint16_t pos = 0;
+    out->count = 0;
     
-    // Start frame
-    frame[pos++] = KISS_FEND;
+    // Start frame and command byte (port + command)
+    uint8_t cmd = (port << 4) | (command & 0x0F);
+    uint8_t head_len = 0;
+    out->head[head_len++] = KISS_FEND;
+    if (cmd == KISS_FEND || cmd == KISS_FESC) {
+        out->head[head_len++] = KISS_FESC;
+        out->head[head_len++] = (cmd == KISS_FEND) ? KISS_TFEND : KISS_TFESC;
+    } else {
+        out->head[head_len++] = cmd;
+    }
+    kiss_iov_append(out, out->head, head_len);
     
-    // Command byte (port + command)
-    frame[pos++] = (port << 4) | KISS_CMD_DATA;
+    // Split each segment at the bytes that need escaping
+    for (int i = 0; i < in_count; i++) {
+        const uint8_t* data = (const uint8_t*)in[i].iov_base;
+        size_t len = in[i].iov_len;
+        size_t run_start = 0;
+        
+        for (size_t pos = 0; pos < len; pos++) {
+            if (data[pos] != KISS_FEND && data[pos] != KISS_FESC) {
+                continue;
+            }
+            if (pos > run_start && kiss_iov_append(out, &data[run_start], pos - run_start) != 0) {
+                return -1;
+            }
+            const uint8_t* escape = (data[pos] == KISS_FEND) ? kiss_escaped_fend : kiss_escaped_fesc;
+            if (kiss_iov_append(out, escape, 2) != 0) {
+                return -1;
+            }
+            run_start = pos + 1;
+        }
+        
+        if (len > run_start && kiss_iov_append(out, &data[run_start], len - run_start) != 0) {
+            return -1;
+        }
+    }
     
-    // Escape and add data
-    uint16_t escaped_len;
-    if (kiss_escape_data(data, length, &frame[pos], &escaped_len) != 0) {
-        free(frame);
+    // End frame
+    return kiss_iov_append(out, &kiss_fend, 1);
+}
+
+// Send a frame given as payload segments on the active interface
+int kiss_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt, uint8_t port) {
+    if (!tnc || !iov || iovcnt <= 0) {
         return -1;
     }
-    pos += escaped_len;
     
-    // End frame
-    frame[pos++] = KISS_FEND;
+    // Frames routed elsewhere (e.g. a multi-port mux) are handed over unencoded
+    if (tnc->tx_handler) {
+        return tnc->tx_handler(tnc->tx_ctx, iov, iovcnt, port);
+    }
     
-    // Send frame (implementation depends on interface)
-    int result = kiss_serial_send(tnc, frame, pos);
+    kiss_iov_t frame;
+    if (kiss_encode_iov(iov, iovcnt, port, KISS_CMD_DATA, &frame) != 0) {
+        // Too many escapes to reference in place; fall back to one flat copy
+        size_t total = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            total += iov[i].iov_len;
+        }
+        uint8_t* flat = malloc(2 * total + 4); // FEND + command + escaped data + FEND
+        if (!flat) {
+            return -1;
+        }
+        
+        size_t pos = frame.iov[0].iov_len; // Head is always the first segment
+        memcpy(flat, frame.head, pos);
+        for (int i = 0; i < iovcnt; i++) {
+            const uint8_t* data = (const uint8_t*)iov[i].iov_base;
+            for (size_t j = 0; j < iov[i].iov_len; j++) {
+                if (data[j] == KISS_FEND || data[j] == KISS_FESC) {
+                    flat[pos++] = KISS_FESC;
+                    flat[pos++] = (data[j] == KISS_FEND) ? KISS_TFEND : KISS_TFESC;
+                } else {
+                    flat[pos++] = data[j];
+                }
+            }
+        }
+        flat[pos++] = KISS_FEND;
+        
+        frame.iov[0].iov_base = flat;
+        frame.iov[0].iov_len = pos;
+        int result = (tnc->serial_fd >= 0) ? kiss_serial_send_iov(tnc, frame.iov, 1)
+                                           : kiss_tcp_send_iov(tnc, frame.iov, 1);
+        free(flat);
+        return result;
+    }
     
-    free(frame);
-    return result;
+    // Send frame (serial when configured, otherwise TCP)
+    if (tnc->serial_fd >= 0) {
+        return kiss_serial_send_iov(tnc, frame.iov, frame.count);
+    }
+    return kiss_tcp_send_iov(tnc, frame.iov, frame.count);
 }
 
-// Receive KISS frame
+// Receive KISS frame (oldest queued frame)
 int kiss_receive_frame(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length, uint8_t* port) {
     if (!tnc || !data || !length) {
         return -1;
     }
     
-    if (!tnc->frame_ready) {
+    if (tnc->rx_count == 0) {
         return 0; // No frame ready
     }
     
     // Copy frame data
-    if (tnc->current_frame.length > *length) {
+    kiss_rx_slot_t* slot = &tnc->rx_slots[tnc->rx_head];
+    if (slot->length > *length) {
         return -1; // Buffer too small
     }
     
-    memcpy(data, tnc->current_frame.data, tnc->current_frame.length);
-    *length = tnc->current_frame.length;
+    memcpy(data, slot->data, slot->length);
+    *length = slot->length;
     
     if (port) {
-        *port = tnc->current_frame.port;
+        *port = slot->port;
     }
     
-    // Reset frame ready flag
-    tnc->frame_ready = false;
+    // Release the slot
+    tnc->rx_head = (tnc->rx_head + 1) % KISS_RX_SLOTS;
+    tnc->rx_count--;
     
-    return tnc->current_frame.length;
+    return *length;
 }
 
-// Process incoming byte
-int kiss_process_byte(kiss_tnc_t* tnc, uint8_t byte) {
-    if (!tnc) {
+// Drain up to max_frames queued frames without copying them out
+int kiss_receive_frames(kiss_tnc_t* tnc, kiss_frame_handler_t handler, void* ctx, int max_frames) {
+    if (!tnc || !handler) {
         return -1;
     }
     
+    int drained = 0;
+    while (tnc->rx_count > 0 && drained < max_frames) {
+        kiss_rx_slot_t* slot = &tnc->rx_slots[tnc->rx_head];
+        handler(ctx, slot->data, slot->length, slot->port);
+        
+        tnc->rx_head = (tnc->rx_head + 1) % KISS_RX_SLOTS;
+        tnc->rx_count--;
+        drained++;
+    }
+    
+    return drained;
+}
+
+// Find the first FEND or FESC in a span; returns length if there is none.
+// Compares 16 bytes per step and only inspects the matching lanes.
+static size_t kiss_find_special(const uint8_t* data, size_t length, uint8_t a, uint8_t b) {
+    size_t pos = 0;
+    
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi8((char)a);
+    const __m128i vb = _mm_set1_epi8((char)b);
+    for (; pos + 16 <= length; pos += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)&data[pos]);
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (mask) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t va = vdupq_n_u8(a);
+    const uint8x16_t vb = vdupq_n_u8(b);
+    for (; pos + 16 <= length; pos += 16) {
+        uint8x16_t chunk = vld1q_u8(&data[pos]);
+        uint8x16_t hit = vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb));
+        // Narrow to one nibble per lane
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask) {
+            return pos + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+#endif
+    
+    for (; pos < length; pos++) {
+        if (data[pos] == a || data[pos] == b) {
+            break;
+        }
+    }
+    return pos;
+}
+
+// Append received bytes to the frame being assembled. Bytes beyond the
+// slot capacity are discarded; with the queue full nothing is stored.
+static inline void kiss_rx_append(kiss_tnc_t* tnc, const uint8_t* data, size_t length) {
+    size_t space = KISS_MAX_FRAME_LEN - tnc->buffer_pos;
+    size_t copy = length < space ? length : space;
+    if (tnc->rx_frame && copy > 0) {
+        memcpy(&tnc->rx_frame->data[tnc->buffer_pos], data, copy);
+    }
+    tnc->buffer_pos += copy;
+}
+
+// Queue the completed frame (already unescaped in its slot)
+static int kiss_complete_frame(kiss_tnc_t* tnc) {
+    if (tnc->buffer_pos == 0) {
+        return 0;
+    }
+    
+    if (!tnc->rx_frame) {
+        tnc->rx_dropped++; // Queue was full when the frame started
+        return 0;
+    }
+    
+    tnc->rx_frame->length = tnc->buffer_pos;
+    tnc->rx_frame = NULL;
+    tnc->rx_count++;
+    return 1;
+}
+
+// Claim the next free slot for a frame with the given command byte, or
+// drop the frame if the queue is full.
+static void kiss_begin_frame(kiss_tnc_t* tnc, uint8_t command) {
+    tnc->rx_frame = NULL;
+    if (tnc->rx_count < KISS_RX_SLOTS) {
+        tnc->rx_frame = &tnc->rx_slots[(tnc->rx_head + tnc->rx_count) % KISS_RX_SLOTS];
+        tnc->rx_frame->port = (command >> 4) & 0x0F;
+        tnc->rx_frame->command = command & 0x0F;
+    }
+}
+
+// Advance the receive state machine by one byte.
+// Returns 1 when a frame completed, 0 otherwise, -1 on a protocol error.
+static int kiss_process_step(kiss_tnc_t* tnc, uint8_t byte) {
+    int result = 0;
+    
     switch (tnc->state) {
         case KISS_STATE_IDLE:
             if (byte == KISS_FEND) {
@@ -165,78 +372,144 @@ int kiss_process_byte(kiss_tnc_t* tnc, uint8_t byte) {
             break;
             
         case KISS_STATE_FEND:
-            if (byte == KISS_FEND) {
-                // Empty frame, ignore
-                tnc->state = KISS_STATE_IDLE;
-            } else {
-                // Command byte
-                tnc->current_frame.port = (byte >> 4) & 0x0F;
-                tnc->current_frame.command = byte & 0x0F;
+            // Repeated FENDs are idle fill. A command byte of 0xC0 or 0xDB
+            // (port 12 data, port 13 command 11) arrives escaped.
+            if (byte == KISS_FESC) {
+                tnc->state = KISS_STATE_CMD_ESCAPE;
+            } else if (byte != KISS_FEND) {
+                kiss_begin_frame(tnc, byte);
                 tnc->state = KISS_STATE_DATA;
             }
             break;
             
+        case KISS_STATE_CMD_ESCAPE:
+            if (byte == KISS_TFEND || byte == KISS_TFESC) {
+                kiss_begin_frame(tnc, (byte == KISS_TFEND) ? KISS_FEND : KISS_FESC);
+                tnc->state = KISS_STATE_DATA;
+            } else {
+                // Invalid escape sequence; no slot was claimed
+                tnc->state = KISS_STATE_IDLE;
+                tnc->rx_frame = NULL;
+                return -1;
+            }
+            break;
+            
         case KISS_STATE_DATA:
             if (byte == KISS_FEND) {
-                // End of frame
-                if (tnc->buffer_pos > 0) {
-                    // Unescape data
-                    uint8_t* unescaped = malloc(tnc->buffer_pos);
-                    if (!unescaped) {
-                        tnc->state = KISS_STATE_IDLE;
-                        return -1;
-                    }
-                    
-                    uint16_t unescaped_len;
-                    if (kiss_unescape_data(tnc->buffer, tnc->buffer_pos, unescaped, &unescaped_len) == 0) {
-                        // Free old data
-                        if (tnc->current_frame.data) {
-                            free(tnc->current_frame.data);
-                        }
-                        
-                        // Set new frame data
-                        tnc->current_frame.data = unescaped;
-                        tnc->current_frame.length = unescaped_len;
-                        tnc->frame_ready = true;
-                    } else {
-                        free(unescaped);
-                    }
-                }
-                tnc->state = KISS_STATE_IDLE;
+                // End of frame; the FEND also opens the next one
+                result = kiss_complete_frame(tnc);
+                tnc->state = KISS_STATE_FEND;
+                tnc->buffer_pos = 0;
             } else if (byte == KISS_FESC) {
                 tnc->state = KISS_STATE_ESCAPE;
             } else {
                 // Regular data byte
-                if (tnc->buffer_pos < sizeof(tnc->buffer)) {
-                    tnc->buffer[tnc->buffer_pos++] = byte;
-                }
+                kiss_rx_append(tnc, &byte, 1);
             }
             break;
             
         case KISS_STATE_ESCAPE:
-            if (byte == KISS_TFEND) {
-                tnc->buffer[tnc->buffer_pos++] = KISS_FEND;
-            } else if (byte == KISS_TFESC) {
-                tnc->buffer[tnc->buffer_pos++] = KISS_FESC;
+            if (byte == KISS_TFEND || byte == KISS_TFESC) {
+                uint8_t decoded = (byte == KISS_TFEND) ? KISS_FEND : KISS_FESC;
+                kiss_rx_append(tnc, &decoded, 1);
+                tnc->state = KISS_STATE_DATA;
             } else {
-                // Invalid escape sequence
+                // Invalid escape sequence; the slot is not queued
                 tnc->state = KISS_STATE_IDLE;
+                tnc->rx_frame = NULL;
                 return -1;
             }
-            tnc->state = KISS_STATE_DATA;
             break;
     }
     
-    return 0;
+    return result;
+}
+
+// Process incoming byte
+int kiss_process_byte(kiss_tnc_t* tnc, uint8_t byte) {
+    if (!tnc) {
+        return -1;
+    }
+    
+    return kiss_process_step(tnc, byte) < 0 ? -1 : 0;
+}
+
+// Hand every queued frame to the handler, oldest first. The slot leaves
+// the queue before the call, so a handler may reset the decoder; nothing
+// overwrites the slot until decoding resumes.
+static int kiss_drain(kiss_tnc_t* tnc, kiss_rx_handler_t handler, void* ctx) {
+    int drained = 0;
+    while (tnc->rx_count > 0) {
+        const kiss_rx_slot_t* frame = &tnc->rx_slots[tnc->rx_head];
+        tnc->rx_head = (tnc->rx_head + 1) % KISS_RX_SLOTS;
+        tnc->rx_count--;
+        handler(ctx, frame);
+        drained++;
+    }
+    return drained;
+}
+
+// Runs of plain data are located with vector compares and copied with
+// memcpy; the state machine only sees frame delimiters, escapes and
+// command bytes. With a handler the queue is drained as each frame
+// completes.
+static int kiss_decode(kiss_tnc_t* tnc, const uint8_t* data, size_t length,
+                       kiss_rx_handler_t handler, void* ctx) {
+    int frames = 0;
+    size_t pos = 0;
+    
+    while (pos < length) {
+        if (tnc->state == KISS_STATE_DATA) {
+            size_t run = kiss_find_special(&data[pos], length - pos, KISS_FEND, KISS_FESC);
+            if (run > 0) {
+                kiss_rx_append(tnc, &data[pos], run);
+                pos += run;
+                continue;
+            }
+        } else if (tnc->state == KISS_STATE_IDLE) {
+            // Skip line noise up to the next frame delimiter
+            pos += kiss_find_special(&data[pos], length - pos, KISS_FEND, KISS_FEND);
+            if (pos == length) {
+                break;
+            }
+        }
+        
+        if (kiss_process_step(tnc, data[pos++]) > 0) {
+            frames = handler ? frames + kiss_drain(tnc, handler, ctx) : frames + 1;
+        }
+    }
+    
+    return frames;
+}
+
+// Process a block of received bytes.
+// Returns the number of frames completed; malformed frames are dropped.
+int kiss_process_buffer(kiss_tnc_t* tnc, const uint8_t* data, size_t length) {
+    if (!tnc || (!data && length > 0)) {
+        return -1;
+    }
+    
+    return kiss_decode(tnc, data, length, NULL, NULL);
+}
+
+// Decode a block of received bytes, delivering each frame as soon as it
+// completes. Returns the number of frames delivered.
+int kiss_decode_frames(kiss_tnc_t* tnc, const uint8_t* data, size_t length,
+                       kiss_rx_handler_t handler, void* ctx) {
+    if (!tnc || !handler || (!data && length > 0)) {
+        return -1;
+    }
+    
+    return kiss_decode(tnc, data, length, handler, ctx);
 }
 
-// Check if frame is ready
+// Check if frames are ready (number queued)
 int kiss_frame_ready(const kiss_tnc_t* tnc) {
     if (!tnc) {
         return 0;
     }
     
-    return tnc->frame_ready ? 1 : 0;
+    return tnc->rx_count;
 }
 
 // Escape data for KISS transmission
@@ -245,60 +518,99 @@ int kiss_escape_data(const uint8_t* input, uint16_t input_len, uint8_t* output,
         return -1;
     }
     
+    uint16_t in_pos = 0;
     uint16_t out_pos = 0;
     
-    for (uint16_t i = 0; i < input_len; i++) {
-        if (out_pos >= *output_len) {
+    while (in_pos < input_len) {
+        // Copy the clean run up to the next special byte
+        uint16_t run = kiss_find_special(&input[in_pos], input_len - in_pos, KISS_FEND, KISS_FESC);
+        if (run > *output_len - out_pos) {
             return -1; // Output buffer too small
         }
+        memcpy(&output[out_pos], &input[in_pos], run);
+        in_pos += run;
+        out_pos += run;
         
-        if (input[i] == KISS_FEND) {
-            output[out_pos++] = KISS_FESC;
-            output[out_pos++] = KISS_TFEND;
-        } else if (input[i] == KISS_FESC) {
-            output[out_pos++] = KISS_FESC;
-            output[out_pos++] = KISS_TFESC;
-        } else {
-            output[out_pos++] = input[i];
+        if (in_pos == input_len) {
+            break;
         }
+        if (*output_len - out_pos < 2) {
+            return -1; // Output buffer too small
+        }
+        output[out_pos++] = KISS_FESC;
+        output[out_pos++] = (input[in_pos++] == KISS_FEND) ? KISS_TFEND : KISS_TFESC;
     }
     
     *output_len = out_pos;
     return 0;
 }
 
+// Encode a complete data frame (FEND, command, escaped data, FEND)
+int kiss_encode_frame(const uint8_t* data, uint16_t length, uint8_t port, uint8_t* out) {
+    if ((!data && length > 0) || !out) {
+        return -1;
+    }
+    
+    size_t pos = 0;
+    uint8_t cmd = (port << 4) | KISS_CMD_DATA;
+    out[pos++] = KISS_FEND;
+    if (cmd == KISS_FEND || cmd == KISS_FESC) {
+        out[pos++] = KISS_FESC;
+        out[pos++] = (cmd == KISS_FEND) ? KISS_TFEND : KISS_TFESC;
+    } else {
+        out[pos++] = cmd;
+    }
+    
+    if (length > 0) {
+        uint16_t escaped_len = (length > UINT16_MAX / 2) ? UINT16_MAX : 2 * length;
+        if (kiss_escape_data(data, length, &out[pos], &escaped_len) != 0) {
+            return -1;
+        }
+        pos += escaped_len;
+    }
+    out[pos++] = KISS_FEND;
+    
+    return (int)pos;
+}
+
 // Unescape data from KISS transmission
 int kiss_unescape_data(const uint8_t* input, uint16_t input_len, uint8_t* output, uint16_t* output_len) {
     if (!input || !output || !output_len) {
         return -1;
     }
     
+    uint16_t in_pos = 0;
     uint16_t out_pos = 0;
-    bool escaped = false;
     
-    for (uint16_t i = 0; i < input_len; i++) {
+    while (in_pos < input_len) {
+        // Copy the clean run up to the next escape
+        uint16_t run = kiss_find_special(&input[in_pos], input_len - in_pos, KISS_FESC, KISS_FESC);
+        if (run > *output_len - out_pos) {
+            return -1; // Output buffer too small
+        }
+        memcpy(&output[out_pos], &input[in_pos], run);
+        in_pos += run;
+        out_pos += run;
+        
+        if (in_pos == input_len) {
+            break;
+        }
+        if (in_pos + 1 >= input_len) {
+            return -1; // Incomplete escape sequence
+        }
         if (out_pos >= *output_len) {
             return -1; // Output buffer too small
         }
         
-        if (escaped) {
-            if (input[i] == KISS_TFEND) {
-                output[out_pos++] = KISS_FEND;
-            } else if (input[i] == KISS_TFESC) {
-                output[out_pos++] = KISS_FESC;
-            } else {
-                return -1; // Invalid escape sequence
-            }
-            escaped = false;
-        } else if (input[i] == KISS_FESC) {
-            escaped = true;
+        uint8_t code = input[in_pos + 1];
+        if (code == KISS_TFEND) {
+            output[out_pos++] = KISS_FEND;
+        } else if (code == KISS_TFESC) {
+            output[out_pos++] = KISS_FESC;
         } else {
-            output[out_pos++] = input[i];
+            return -1; // Invalid escape sequence
         }
-    }
-    
-    if (escaped) {
-        return -1; // Incomplete escape sequence
+        in_pos += 2;
     }
     
     *output_len = out_pos;
@@ -340,17 +652,77 @@ int kiss_serial_send(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length) {
     }
     
     // Write data to USB CDC port
+    // No fsync: it does not drain a tty and only adds a syscall per frame
     ssize_t bytes_written = write(fd, data, length);
     if (bytes_written < 0) {
         return -1; // Write error
     }
     
-    // Flush USB CDC buffer
-    fsync(fd);
-    
     return bytes_written;
 }
 
+// Write a complete iovec list, resuming after partial writes
+static int kiss_write_iov(int fd, const struct iovec* iov, int iovcnt, bool is_socket) {
+    if (iovcnt <= 0 || iovcnt > KISS_IOV_MAX) {
+        return -1;
+    }
+    
+    // Local copy so partially written segments can be advanced
+    struct iovec pending[KISS_IOV_MAX];
+    memcpy(pending, iov, iovcnt * sizeof(struct iovec));
+    struct iovec* cur = pending;
+    int remaining = iovcnt;
+    size_t total = 0;
+    
+    while (remaining > 0) {
+        ssize_t written;
+        if (is_socket) {
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = cur;
+            msg.msg_iovlen = remaining;
+            written = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        } else {
+            written = writev(fd, cur, remaining);
+        }
+        
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1; // Write error
+        }
+        total += written;
+        
+        // Skip fully written segments, then trim the partial one
+        while (remaining > 0 && (size_t)written >= cur->iov_len) {
+            written -= cur->iov_len;
+            cur++;
+            remaining--;
+        }
+        if (remaining > 0) {
+            cur->iov_base = (uint8_t*)cur->iov_base + written;
+            cur->iov_len -= written;
+        }
+    }
+    
+    return (int)total;
+}
+
+// Gather write to the USB CDC port
+int kiss_serial_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt) {
+    if (!tnc || !iov) {
+        return -1;
+    }
+    
+    int fd = tnc->serial_fd;
+    if (fd < 0) {
+        return -1; // USB CDC not initialized
+    }
+    
+    return kiss_write_iov(fd, iov, iovcnt, false);
+}
+
 int kiss_serial_receive(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length) {
     if (!tnc || !data || !length) {
         return -1;
@@ -409,6 +781,20 @@ int kiss_tcp_send(kiss_tnc_t* tnc, const uint8_t* data, uint16_t length) {
     return bytes_sent;
 }
 
+// Gather send on the TCP socket; MSG_NOSIGNAL turns a closed peer into EPIPE
+int kiss_tcp_send_iov(kiss_tnc_t* tnc, const struct iovec* iov, int iovcnt) {
+    if (!tnc || !iov) {
+        return -1;
+    }
+    
+    int sockfd = tnc->tcp_socket;
+    if (sockfd < 0) {
+        return -1; // TCP socket not initialized
+    }
+    
+    return kiss_write_iov(sockfd, iov, iovcnt, true);
+}
+
 int kiss_tcp_receive(kiss_tnc_t* tnc, uint8_t* data, uint16_t* length) {
     if (!tnc || !data || !length) {
         return -1;
@@ -0,0 +1,323 @@
+//--------------------------------------------------------------------
+// KISS Serial Port
+//
+// Non-blocking KISS serial backend with a coalescing transmit ring
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "kiss_serial.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define KISS_SERIAL_READ_SIZE   4096    // Bytes per read
+
+struct kiss_serial {
+    kiss_serial_config_t config;
+    int fd;
+    kiss_tnc_t decoder;         // Receive state and frame queue
+    uint8_t* tx_ring;           // Encoded frames awaiting transmission
+    size_t tx_mask;             // Ring size - 1
+    size_t tx_head;             // Next byte to write
+    size_t tx_tail;             // Next free byte
+    kiss_serial_stats_t stats;
+};
+
+// Default configuration
+void kiss_serial_default_config(kiss_serial_config_t* config) {
+    if (!config) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    config->baud_rate = KISS_SERIAL_DEFAULT_BAUD;
+    config->tx_buffer_size = KISS_SERIAL_DEFAULT_TX_BUFFER;
+}
+
+static speed_t kiss_serial_speed(uint32_t baud_rate) {
+    switch (baud_rate) {
+    case 1200:   return B1200;
+    case 2400:   return B2400;
+    case 4800:   return B4800;
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return B0;
+    }
+}
+
+// Raw 8N1 line, optionally at a new speed
+static int kiss_serial_configure_line(int fd, uint32_t baud_rate) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        return -1;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+
+    if (baud_rate != 0) {
+        speed_t speed = kiss_serial_speed(baud_rate);
+        if (speed == B0 || cfsetispeed(&tio, speed) != 0 || cfsetospeed(&tio, speed) != 0) {
+            return -1;
+        }
+    }
+
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+// Take ownership of a descriptor and switch it to non-blocking mode
+kiss_serial_t* kiss_serial_attach(int fd, const kiss_serial_config_t* config) {
+    if (fd < 0 || !config || config->tx_buffer_size == 0) {
+        return NULL;
+    }
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        return NULL;
+    }
+
+    kiss_serial_t* serial = calloc(1, sizeof(kiss_serial_t));
+    if (!serial) {
+        return NULL;
+    }
+
+    size_t size = 1;
+    while (size < config->tx_buffer_size) {
+        size <<= 1;
+    }
+    serial->tx_ring = malloc(size);
+    if (!serial->tx_ring) {
+        free(serial);
+        return NULL;
+    }
+
+    serial->config = *config;
+    serial->config.tx_buffer_size = size;
+    serial->tx_mask = size - 1;
+    serial->fd = fd;
+    kiss_init(&serial->decoder);
+    return serial;
+}
+
+// Open a serial device in raw, non-blocking mode
+kiss_serial_t* kiss_serial_open(const char* device, const kiss_serial_config_t* config) {
+    if (!device || !config) {
+        return NULL;
+    }
+
+    int fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (kiss_serial_configure_line(fd, config->baud_rate) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    kiss_serial_t* serial = kiss_serial_attach(fd, config);
+    if (!serial) {
+        close(fd);
+    }
+    return serial;
+}
+
+// Close the port and release the ring; unsent frames are discarded
+void kiss_serial_close(kiss_serial_t* serial) {
+    if (!serial) {
+        return;
+    }
+
+    kiss_cleanup(&serial->decoder);
+    close(serial->fd);
+    free(serial->tx_ring);
+    free(serial);
+}
+
+int kiss_serial_fd(const kiss_serial_t* serial) {
+    return serial ? serial->fd : -1;
+}
+
+size_t kiss_serial_pending(const kiss_serial_t* serial) {
+    return serial ? serial->tx_tail - serial->tx_head : 0;
+}
+
+// Encode a frame into the transmit ring
+int kiss_serial_queue(kiss_serial_t* serial, const uint8_t* data, uint16_t length, uint8_t port) {
+    if (!serial || (!data && length > 0) || length > KISS_MAX_FRAME_LEN) {
+        return -1;
+    }
+
+    size_t size = serial->tx_mask + 1;
+    size_t free_bytes = size - (serial->tx_tail - serial->tx_head);
+    size_t offset = serial->tx_tail & serial->tx_mask;
+    size_t contiguous = size - offset;
+    if (contiguous > free_bytes) {
+        contiguous = free_bytes;
+    }
+
+    int encoded;
+    if (contiguous >= KISS_ENCODED_MAX(length)) {
+        // Common case: encode straight into the ring
+        encoded = kiss_encode_frame(data, length, port, &serial->tx_ring[offset]);
+    } else {
+        // Near the wrap point or a nearly full ring: stage, then copy if it fits
+        uint8_t staging[KISS_ENCODED_MAX(KISS_MAX_FRAME_LEN)];
+        encoded = kiss_encode_frame(data, length, port, staging);
+        if (encoded < 0 || (size_t)encoded > free_bytes) {
+            serial->stats.frames_dropped++;
+            return -1;
+        }
+        size_t first = (size_t)encoded < size - offset ? (size_t)encoded : size - offset;
+        memcpy(&serial->tx_ring[offset], staging, first);
+        memcpy(serial->tx_ring, &staging[first], encoded - first);
+    }
+    if (encoded < 0) {
+        return -1;
+    }
+
+    serial->tx_tail += encoded;
+    serial->stats.frames_out++;
+    return 0;
+}
+
+// Write the queued bytes with as few writev calls as the port allows
+int kiss_serial_flush(kiss_serial_t* serial) {
+    if (!serial) {
+        return -1;
+    }
+
+    while (serial->tx_tail != serial->tx_head) {
+        size_t size = serial->tx_mask + 1;
+        size_t pending = serial->tx_tail - serial->tx_head;
+        size_t offset = serial->tx_head & serial->tx_mask;
+        size_t first = (pending < size - offset) ? pending : size - offset;
+
+        struct iovec iov[2];
+        iov[0].iov_base = &serial->tx_ring[offset];
+        iov[0].iov_len = first;
+        iov[1].iov_base = serial->tx_ring;
+        iov[1].iov_len = pending - first;
+
+        ssize_t written = writev(serial->fd, iov, (pending > first) ? 2 : 1);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break; // Port buffer full; resume when writable
+            }
+            return -1;
+        }
+
+        serial->tx_head += written;
+        serial->stats.writes++;
+        serial->stats.bytes_out += written;
+    }
+
+    // Restart at the ring base so frames are encoded in place again
+    if (serial->tx_head == serial->tx_tail) {
+        serial->tx_head = 0;
+        serial->tx_tail = 0;
+    }
+
+    return (int)(serial->tx_tail - serial->tx_head);
+}
+
+// Count and forward one decoded frame
+static void kiss_serial_on_frame(void* ctx, const kiss_rx_slot_t* frame) {
+    kiss_serial_t* serial = (kiss_serial_t*)ctx;
+
+    serial->stats.frames_in++;
+    if (serial->config.on_frame) {
+        serial->config.on_frame(serial->config.ctx, frame->data, frame->length, frame->port,
+                                frame->command);
+    }
+}
+
+// Read until the port has no more data, decoding as bytes arrive
+int kiss_serial_read(kiss_serial_t* serial) {
+    if (!serial) {
+        return -1;
+    }
+
+    uint8_t buffer[KISS_SERIAL_READ_SIZE];
+    int delivered = 0;
+
+    for (;;) {
+        ssize_t received = read(serial->fd, buffer, sizeof(buffer));
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return delivered;
+            }
+            return -1;
+        }
+        if (received == 0) {
+            return -1; // Hangup
+        }
+
+        serial->stats.reads++;
+        serial->stats.bytes_in += received;
+
+        delivered += kiss_decode_frames(&serial->decoder, buffer, received,
+                                        kiss_serial_on_frame, serial);
+    }
+}
+
+// Run one iteration of the event loop
+int kiss_serial_poll(kiss_serial_t* serial, int timeout_ms) {
+    if (!serial) {
+        return -1;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = serial->fd;
+    pfd.events = POLLIN | ((serial->tx_tail != serial->tx_head) ? POLLOUT : 0);
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+        return (ready == 0 || errno == EINTR) ? 0 : -1;
+    }
+
+    int delivered = 0;
+    if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+        delivered = kiss_serial_read(serial);
+        if (delivered < 0) {
+            return -1;
+        }
+    }
+    if (pfd.revents & POLLOUT) {
+        if (kiss_serial_flush(serial) < 0) {
+            return -1;
+        }
+    }
+
+    return delivered;
+}
+
+// Get statistics
+int kiss_serial_get_stats(const kiss_serial_t* serial, kiss_serial_stats_t* stats) {
+    if (!serial || !stats) {
+        return -1;
+    }
+
+    *stats = serial->stats;
+    return 0;
+}
@@ -0,0 +1,550 @@
+//--------------------------------------------------------------------
+// KISS-over-TCP Server
+//
+// Multi-client KISS TCP server driven by a single epoll loop
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#define _GNU_SOURCE // accept4
+#include "kiss_tcp_server.h"
+#include "kiss_protocol.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define KISS_TCP_EVENTS       64      // Events handled per epoll_wait
+#define KISS_TCP_READ_SIZE    4096    // Bytes per recv
+#define KISS_TCP_WRITE_IOV    16      // Queued frames per sendmsg
+#define KISS_TCP_ACCEPT_RETRY 100     // ms between accepts while paused
+
+// Encoded frame shared by every client queue it is placed on
+typedef struct {
+    uint32_t refs;
+    uint32_t length;
+    uint8_t data[];
+} kiss_tcp_buffer_t;
+
+typedef struct kiss_tcp_client {
+    int fd;
+    int id;                                            // Index in the client table
+    kiss_tnc_t decoder;                                // Receive state and frame queue
+    kiss_tcp_buffer_t* queue[KISS_TCP_CLIENT_QUEUE_LEN];
+    uint16_t queue_head;
+    uint16_t queue_count;
+    uint32_t queue_offset;                             // Bytes of the head frame already sent
+    size_t queued_bytes;                               // Unsent bytes across the queue
+    bool want_write;                                   // EPOLLOUT registered
+    struct kiss_tcp_client* next_closed;               // Deferred free list
+} kiss_tcp_client_t;
+
+struct kiss_tcp_server {
+    kiss_tcp_server_config_t config;
+    int epoll_fd;
+    int listen_fd;
+    uint16_t port;
+    kiss_tcp_client_t** clients;                       // config.max_clients entries
+    kiss_tcp_client_t* closed;                         // Closed, freed after event dispatch
+    bool in_poll;
+    bool accept_paused;                                // Listener out of the epoll set
+    kiss_tcp_server_stats_t stats;
+};
+
+// Context for draining one client's receive queue
+typedef struct {
+    kiss_tcp_server_t* server;
+    kiss_tcp_client_t* client;
+} kiss_tcp_rx_ctx_t;
+
+// Default configuration
+void kiss_tcp_server_default_config(kiss_tcp_server_config_t* config) {
+    if (!config) {
+        return;
+    }
+
+    memset(config, 0, sizeof(*config));
+    config->bind_address = NULL;
+    config->port = KISS_TCP_DEFAULT_PORT;
+    config->max_clients = KISS_TCP_DEFAULT_MAX_CLIENTS;
+    config->max_queued_bytes = KISS_TCP_DEFAULT_QUEUE_BYTES;
+    config->relay_clients = false;
+}
+
+// Encode a frame once into a shared buffer (reference count 1)
+static kiss_tcp_buffer_t* kiss_tcp_encode(const uint8_t* data, uint16_t length, uint8_t port) {
+    kiss_tcp_buffer_t* buf = malloc(sizeof(kiss_tcp_buffer_t) + KISS_ENCODED_MAX(length));
+    if (!buf) {
+        return NULL;
+    }
+
+    int encoded = kiss_encode_frame(data, length, port, buf->data);
+    if (encoded < 0) {
+        free(buf);
+        return NULL;
+    }
+
+    buf->length = encoded;
+    buf->refs = 1;
+    return buf;
+}
+
+static void kiss_tcp_buffer_release(kiss_tcp_buffer_t* buf) {
+    if (--buf->refs == 0) {
+        free(buf);
+    }
+}
+
+static void kiss_tcp_free_closed(kiss_tcp_server_t* server) {
+    while (server->closed) {
+        kiss_tcp_client_t* client = server->closed;
+        server->closed = client->next_closed;
+        free(client);
+    }
+}
+
+// Watch the listening socket again, or stop while no descriptor is free:
+// it stays readable, so a paused accept would otherwise wake every poll
+static void kiss_tcp_set_accepting(kiss_tcp_server_t* server, bool accepting) {
+    if (server->accept_paused == !accepting) {
+        return;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = accepting ? EPOLLIN : 0;
+    ev.data.ptr = NULL;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, server->listen_fd, &ev);
+    server->accept_paused = !accepting;
+    if (!accepting) {
+        server->stats.accept_pauses++;
+    }
+}
+
+// Close a client; the memory is freed once no event can refer to it
+static void kiss_tcp_close_client(kiss_tcp_server_t* server, kiss_tcp_client_t* client) {
+    if (client->fd < 0) {
+        return;
+    }
+
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    client->fd = -1;
+    kiss_tcp_set_accepting(server, true); // A descriptor is free again
+
+    while (client->queue_count > 0) {
+        kiss_tcp_buffer_release(client->queue[client->queue_head]);
+        client->queue_head = (client->queue_head + 1) % KISS_TCP_CLIENT_QUEUE_LEN;
+        client->queue_count--;
+    }
+
+    kiss_cleanup(&client->decoder);
+    server->clients[client->id] = NULL;
+    server->stats.clients--;
+
+    client->next_closed = server->closed;
+    server->closed = client;
+    if (!server->in_poll) {
+        kiss_tcp_free_closed(server);
+    }
+}
+
+// Register or drop interest in writability
+static int kiss_tcp_set_want_write(kiss_tcp_server_t* server, kiss_tcp_client_t* client,
+                                   bool want_write) {
+    if (client->want_write == want_write) {
+        return 0;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | (want_write ? EPOLLOUT : 0);
+    ev.data.ptr = client;
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, client->fd, &ev) != 0) {
+        return -1;
+    }
+    client->want_write = want_write;
+    return 0;
+}
+
+// Write as much of the client's queue as the socket accepts
+static int kiss_tcp_flush(kiss_tcp_server_t* server, kiss_tcp_client_t* client) {
+    while (client->queue_count > 0) {
+        struct iovec iov[KISS_TCP_WRITE_IOV];
+        int iovcnt = 0;
+        for (uint16_t i = 0; i < client->queue_count && iovcnt < KISS_TCP_WRITE_IOV; i++) {
+            kiss_tcp_buffer_t* buf =
+                client->queue[(client->queue_head + i) % KISS_TCP_CLIENT_QUEUE_LEN];
+            uint32_t skip = (i == 0) ? client->queue_offset : 0;
+            iov[iovcnt].iov_base = &buf->data[skip];
+            iov[iovcnt].iov_len = buf->length - skip;
+            iovcnt++;
+        }
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovcnt;
+        ssize_t written = sendmsg(client->fd, &msg, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break; // Socket buffer full; resume on EPOLLOUT
+            }
+            kiss_tcp_close_client(server, client);
+            return -1;
+        }
+
+        server->stats.bytes_out += written;
+        client->queued_bytes -= written;
+
+        // Release fully written frames
+        size_t remaining = written;
+        while (remaining > 0) {
+            kiss_tcp_buffer_t* buf = client->queue[client->queue_head];
+            size_t left = buf->length - client->queue_offset;
+            if (remaining < left) {
+                client->queue_offset += remaining;
+                break;
+            }
+            remaining -= left;
+            kiss_tcp_buffer_release(buf);
+            client->queue_head = (client->queue_head + 1) % KISS_TCP_CLIENT_QUEUE_LEN;
+            client->queue_count--;
+            client->queue_offset = 0;
+        }
+    }
+
+    if (kiss_tcp_set_want_write(server, client, client->queue_count > 0) != 0) {
+        kiss_tcp_close_client(server, client);
+        return -1;
+    }
+    return 0;
+}
+
+// Queue a shared frame for one client, applying back-pressure
+static int kiss_tcp_enqueue(kiss_tcp_server_t* server, kiss_tcp_client_t* client,
+                            kiss_tcp_buffer_t* buf) {
+    if (client->queue_count >= KISS_TCP_CLIENT_QUEUE_LEN ||
+        client->queued_bytes + buf->length > server->config.max_queued_bytes) {
+        server->stats.frames_dropped++;
+        return -1;
+    }
+
+    bool was_idle = (client->queue_count == 0);
+    client->queue[(client->queue_head + client->queue_count) % KISS_TCP_CLIENT_QUEUE_LEN] = buf;
+    client->queue_count++;
+    client->queued_bytes += buf->length;
+    buf->refs++;
+    server->stats.frames_out++;
+
+    // Try to write straight away; otherwise EPOLLOUT is already armed
+    if (was_idle) {
+        return kiss_tcp_flush(server, client);
+    }
+    return 0;
+}
+
+// Fan a frame out to every client except one (-1 = none)
+static int kiss_tcp_broadcast_except(kiss_tcp_server_t* server, const uint8_t* data,
+                                     uint16_t length, uint8_t port, int except_id) {
+    kiss_tcp_buffer_t* buf = kiss_tcp_encode(data, length, port);
+    if (!buf) {
+        return -1;
+    }
+
+    int queued = 0;
+    for (int i = 0; i < server->config.max_clients; i++) {
+        kiss_tcp_client_t* client = server->clients[i];
+        if (client && i != except_id && kiss_tcp_enqueue(server, client, buf) == 0) {
+            queued++;
+        }
+    }
+
+    kiss_tcp_buffer_release(buf);
+    return queued;
+}
+
+// Deliver one frame received from a client; parameter frames are for the
+// server's owner and are not relayed
+static void kiss_tcp_on_client_frame(void* ctx, const kiss_rx_slot_t* frame) {
+    kiss_tcp_rx_ctx_t* rx = (kiss_tcp_rx_ctx_t*)ctx;
+    kiss_tcp_server_t* server = rx->server;
+    if (rx->client->fd < 0) {
+        return; // Closed by an earlier frame's handler
+    }
+
+    server->stats.frames_in++;
+    if (server->config.on_frame) {
+        server->config.on_frame(server->config.ctx, rx->client->id, frame->data, frame->length,
+                                frame->port, frame->command);
+    }
+    if (server->config.relay_clients && frame->command == KISS_CMD_DATA) {
+        kiss_tcp_broadcast_except(server, frame->data, frame->length, frame->port,
+                                  rx->client->id);
+    }
+}
+
+// Read everything available from a client and decode it
+static void kiss_tcp_read(kiss_tcp_server_t* server, kiss_tcp_client_t* client) {
+    uint8_t buffer[KISS_TCP_READ_SIZE];
+    kiss_tcp_rx_ctx_t rx = { server, client };
+
+    while (client->fd >= 0) {
+        ssize_t received = recv(client->fd, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                kiss_tcp_close_client(server, client);
+            }
+            return;
+        }
+        if (received == 0) {
+            kiss_tcp_close_client(server, client); // Peer closed
+            return;
+        }
+
+        kiss_decode_frames(&client->decoder, buffer, received, kiss_tcp_on_client_frame, &rx);
+    }
+}
+
+// Accept all pending connections
+static void kiss_tcp_accept(kiss_tcp_server_t* server) {
+    for (;;) {
+        int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                // Out of descriptors: the connection waits in the backlog
+                // until a client closes or the next retry succeeds
+                kiss_tcp_set_accepting(server, false);
+                return;
+            }
+            kiss_tcp_set_accepting(server, true);
+            return; // EAGAIN: backlog drained
+        }
+
+        int id = -1;
+        for (int i = 0; i < server->config.max_clients; i++) {
+            if (!server->clients[i]) {
+                id = i;
+                break;
+            }
+        }
+
+        kiss_tcp_client_t* client = (id >= 0) ? calloc(1, sizeof(kiss_tcp_client_t)) : NULL;
+        if (!client) {
+            server->stats.rejected++;
+            close(fd);
+            continue;
+        }
+
+        // KISS frames are small; do not wait to coalesce them
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        client->fd = fd;
+        client->id = id;
+        kiss_init(&client->decoder);
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = client;
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(client);
+            server->stats.rejected++;
+            continue;
+        }
+
+        server->clients[id] = client;
+        server->stats.clients++;
+        server->stats.accepted++;
+    }
+}
+
+// Create server and start listening
+kiss_tcp_server_t* kiss_tcp_server_create(const kiss_tcp_server_config_t* config) {
+    if (!config || config->max_clients <= 0) {
+        return NULL;
+    }
+
+    kiss_tcp_server_t* server = calloc(1, sizeof(kiss_tcp_server_t));
+    if (!server) {
+        return NULL;
+    }
+    server->config = *config;
+    server->epoll_fd = -1;
+    server->listen_fd = -1;
+
+    server->clients = calloc(config->max_clients, sizeof(kiss_tcp_client_t*));
+    server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    server->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (!server->clients || server->epoll_fd < 0 || server->listen_fd < 0) {
+        kiss_tcp_server_destroy(server);
+        return NULL;
+    }
+
+    int one = 1;
+    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config->port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (config->bind_address && inet_pton(AF_INET, config->bind_address, &addr.sin_addr) != 1) {
+        kiss_tcp_server_destroy(server);
+        return NULL;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    if (bind(server->listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(server->listen_fd, SOMAXCONN) != 0 ||
+        getsockname(server->listen_fd, (struct sockaddr*)&addr, &addr_len) != 0) {
+        kiss_tcp_server_destroy(server);
+        return NULL;
+    }
+    server->port = ntohs(addr.sin_port);
+
+    // The listening socket is tagged with a NULL pointer
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &ev) != 0) {
+        kiss_tcp_server_destroy(server);
+        return NULL;
+    }
+
+    return server;
+}
+
+// Close all clients and release the server
+void kiss_tcp_server_destroy(kiss_tcp_server_t* server) {
+    if (!server) {
+        return;
+    }
+
+    if (server->clients) {
+        server->in_poll = false;
+        for (int i = 0; i < server->config.max_clients; i++) {
+            if (server->clients[i]) {
+                kiss_tcp_close_client(server, server->clients[i]);
+            }
+        }
+        free(server->clients);
+    }
+    kiss_tcp_free_closed(server);
+
+    if (server->listen_fd >= 0) {
+        close(server->listen_fd);
+    }
+    if (server->epoll_fd >= 0) {
+        close(server->epoll_fd);
+    }
+    free(server);
+}
+
+// Bound port (useful with an ephemeral port)
+uint16_t kiss_tcp_server_port(const kiss_tcp_server_t* server) {
+    return server ? server->port : 0;
+}
+
+// Run one iteration of the event loop
+int kiss_tcp_server_poll(kiss_tcp_server_t* server, int timeout_ms) {
+    if (!server) {
+        return -1;
+    }
+
+    // While accepting is paused, descriptors may be freed by something
+    // other than this server; retry on every pass and at least every
+    // KISS_TCP_ACCEPT_RETRY ms
+    if (server->accept_paused) {
+        kiss_tcp_accept(server);
+        if (server->accept_paused && (timeout_ms < 0 || timeout_ms > KISS_TCP_ACCEPT_RETRY)) {
+            timeout_ms = KISS_TCP_ACCEPT_RETRY;
+        }
+    }
+
+    struct epoll_event events[KISS_TCP_EVENTS];
+    int count = epoll_wait(server->epoll_fd, events, KISS_TCP_EVENTS, timeout_ms);
+    if (count < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    server->in_poll = true;
+    for (int i = 0; i < count; i++) {
+        kiss_tcp_client_t* client = (kiss_tcp_client_t*)events[i].data.ptr;
+        if (!client) {
+            kiss_tcp_accept(server);
+            continue;
+        }
+
+        // Closed earlier in this batch (e.g. by a failed relay write)
+        if (client->fd < 0) {
+            continue;
+        }
+
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            kiss_tcp_read(server, client);
+        }
+        if (client->fd >= 0 && (events[i].events & EPOLLOUT)) {
+            kiss_tcp_flush(server, client);
+        }
+    }
+    server->in_poll = false;
+    kiss_tcp_free_closed(server);
+
+    return count;
+}
+
+// Send a frame to every connected client
+int kiss_tcp_server_broadcast(kiss_tcp_server_t* server, const uint8_t* data, uint16_t length,
+                              uint8_t port) {
+    if (!server || (!data && length > 0)) {
+        return -1;
+    }
+
+    return kiss_tcp_broadcast_except(server, data, length, port, -1);
+}
+
+// Send a frame to one client
+int kiss_tcp_server_send(kiss_tcp_server_t* server, int client_id, const uint8_t* data,
+                         uint16_t length, uint8_t port) {
+    if (!server || (!data && length > 0) || client_id < 0 ||
+        client_id >= server->config.max_clients || !server->clients[client_id]) {
+        return -1;
+    }
+
+    kiss_tcp_buffer_t* buf = kiss_tcp_encode(data, length, port);
+    if (!buf) {
+        return -1;
+    }
+
+    int result = kiss_tcp_enqueue(server, server->clients[client_id], buf);
+    kiss_tcp_buffer_release(buf);
+    return result;
+}
+
+// Get statistics
+int kiss_tcp_server_get_stats(const kiss_tcp_server_t* server, kiss_tcp_server_stats_t* stats) {
+    if (!server || !stats) {
+        return -1;
+    }
+
+    *stats = server->stats;
+    return 0;
+}
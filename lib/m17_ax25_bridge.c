@@ -8,11 +8,18 @@
 // M17 Foundation, 19 April 2025
 //--------------------------------------------------------------------
 #include "m17_ax25_bridge.h"
+#include "timer_wheel.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
+// Hand encoded AX.25 frames from the TNC to the KISS interface
+static int m17_ax25_bridge_ax25_tx_handler(void* ctx, const struct iovec* iov, int iovcnt) {
+    m17_ax25_bridge_t* bridge = (m17_ax25_bridge_t*)ctx;
+    return kiss_send_iov(&bridge->kiss_tnc, iov, iovcnt, 0);
+}
+
 // Initialize M17-AX.25 bridge
 int m17_ax25_bridge_init(m17_ax25_bridge_t* bridge) {
     if (!bridge) {
@@ -29,6 +36,7 @@ int m17_ax25_bridge_init(m17_ax25_bridge_t* bridge) {
         kiss_cleanup(&bridge->kiss_tnc);
         return -1;
     }
+    ax25_set_tx_handler(&bridge->ax25_tnc, m17_ax25_bridge_ax25_tx_handler, bridge);
     
     // Initialize bridge state
     bridge->state.config.m17_enabled = true;
@@ -40,6 +48,10 @@ int m17_ax25_bridge_init(m17_ax25_bridge_t* bridge) {
     strncpy(bridge->state.config.ax25_callsign, "N0CALL", sizeof(bridge->state.config.ax25_callsign) - 1);
     bridge->state.config.ax25_callsign[sizeof(bridge->state.config.ax25_callsign) - 1] = '\0';
     bridge->state.config.ax25_ssid = 0;
+    bridge->state.config.fx25_enabled = false;
+    bridge->state.config.il2p_enabled = false;
+    bridge->state.config.fx25_rs_type = FX25_RS_255_239;
+    bridge->state.config.il2p_debug = 0;
     
     bridge->state.current_protocol = PROTOCOL_UNKNOWN;
     bridge->state.m17_active = false;
@@ -68,6 +80,8 @@ int m17_ax25_bridge_init(m17_ax25_bridge_t* bridge) {
     bridge->num_mappings = 0;
     memset(bridge->mappings, 0, sizeof(bridge->mappings));
     
+    m17_lsf_cache_init(&bridge->lsf_cache, M17_LSF_CACHE_TIMEOUT_MS);
+    
     return 0;
 }
 
@@ -258,9 +272,9 @@ int m17_ax25_bridge_convert_m17_to_ax25(m17_ax25_bridge_t* bridge, const uint8_t
     uint8_t frame_type = m17_data[2];
     
     // Create AX.25 frame based on M17 frame type
-    if (frame_type == 0x00) { // LSF -> APRS beacon
+    if (frame_type == M17_FRAME_TYPE_LSF) { // LSF -> APRS beacon
         return m17_ax25_bridge_convert_m17_lsf_to_aprs(bridge, m17_data, m17_length, ax25_data, ax25_length);
-    } else if (frame_type == 0x02) { // Packet -> AX.25 UI frame
+    } else if (frame_type == M17_FRAME_TYPE_PACKET) { // Packet -> AX.25 UI frame
         return m17_ax25_bridge_convert_m17_packet_to_ax25(bridge, m17_data, m17_length, ax25_data, ax25_length);
     } else {
         return -1; // Unsupported M17 frame type for conversion
@@ -278,18 +292,18 @@ int m17_ax25_bridge_convert_m17_lsf_to_aprs(m17_ax25_bridge_t* bridge, const uin
         return -1; // Buffer too small
     }
     
-    // Extract M17 callsigns
-    char src_callsign[10] = {0};
-    char dst_callsign[10] = {0};
+    // Extract M17 callsigns (base-40 encoded DST and SRC fields)
+    char src_callsign[M17_CALLSIGN_BUF_LEN] = {0};
+    char dst_callsign[M17_CALLSIGN_BUF_LEN] = {0};
     
     // Validate bounds before array access
-    if (m17_length < 22) {
+    if (m17_length < M17_LSF_OFFSET + 2 * M17_ADDR_LEN) {
         return -1; // Buffer too small for callsign extraction
     }
     
-    for (int i = 0; i < 9; i++) {
-        src_callsign[i] = m17_data[3 + i];
-        dst_callsign[i] = m17_data[13 + i];
+    if (m17_callsign_decode(&m17_data[M17_LSF_DST_OFFSET], dst_callsign) != 0 ||
+        m17_callsign_decode(&m17_data[M17_LSF_SRC_OFFSET], src_callsign) != 0) {
+        return -1; // Invalid or reserved address
     }
     
     // Find AX.25 callsign mapping
@@ -371,57 +385,118 @@ int m17_ax25_bridge_convert_m17_lsf_to_aprs(m17_ax25_bridge_t* bridge, const uin
     return 0;
 }
 
-// Convert M17 packet to AX.25 UI frame
+// Convert a single-frame M17 packet to AX.25; longer packets need the
+// reassembler (see m17_packet_reasm_push and m17_ax25_bridge_packet_to_ax25)
 int m17_ax25_bridge_convert_m17_packet_to_ax25(m17_ax25_bridge_t* bridge, const uint8_t* m17_data, uint16_t m17_length,
                                               uint8_t* ax25_data, uint16_t* ax25_length) {
-    if (!bridge || !m17_data || m17_length < 16 || !ax25_data || !ax25_length) {
+    if (!bridge || !m17_data || m17_length < M17_BRIDGE_PACKET_LEN || !ax25_data || !ax25_length) {
         return -1;
     }
     
-    if (*ax25_length < 50) {
-        return -1; // Buffer too small
+    const uint8_t* chunk = &m17_data[M17_PACKET_FRAME_OFFSET];
+    uint8_t meta = chunk[M17_PACKET_CHUNK_LEN];
+    uint8_t used = (meta >> M17_PACKET_META_SHIFT) & M17_PACKET_META_MASK;
+    if (!(meta & M17_PACKET_META_EOF) || used < 3 || used > M17_PACKET_CHUNK_LEN) {
+        return -1; // Not a complete packet
     }
     
-    // Extract M17 packet data
-    uint16_t packet_start = 3; // Skip frame markers and type
-    uint16_t packet_length = m17_length - packet_start;
+    uint16_t crc = ((uint16_t)chunk[used - 2] << 8) | chunk[used - 1];
+    if (m17_crc(chunk, used - 2) != crc) {
+        return -1;
+    }
     
-    // Create AX.25 UI frame
-    int pos = 0;
+    m17_packet_t packet;
+    packet.protocol = chunk[0];
+    packet.length = used - 3;
+    memcpy(packet.data, &chunk[1], packet.length);
+    return m17_ax25_bridge_packet_to_ax25(bridge, &packet, ax25_data, ax25_length);
+}
+
+// Flags and FCS around one AX.25 frame; returns the bytes written or -1
+static int m17_ax25_bridge_wrap_frame(const uint8_t* frame, uint16_t length,
+                                      uint8_t* ax25_data, uint16_t space) {
+    // Two addresses and a control field at least
+    if (length < 2 * AX25_ADDR_LEN + 1 || length + 4 > space) {
+        return -1;
+    }
     
-    // Opening flag
-    ax25_data[pos++] = 0x7E;
+    uint16_t fcs = ax25_calculate_fcs(frame, length);
+    ax25_data[0] = AX25_FLAG;
+    memcpy(&ax25_data[1], frame, length);
+    ax25_data[length + 1] = fcs & 0xFF;
+    ax25_data[length + 2] = (fcs >> 8) & 0xFF;
+    ax25_data[length + 3] = AX25_FLAG;
+    return length + 4;
+}
+
+// Rebuild AX.25 frames from a reassembled M17 packet
+int m17_ax25_bridge_packet_to_ax25(m17_ax25_bridge_t* bridge, const m17_packet_t* packet,
+                                   uint8_t* ax25_data, uint16_t* ax25_length) {
+    if (!bridge || !packet || !ax25_data || !ax25_length) {
+        return -1;
+    }
     
-    // Destination address (broadcast)
-    for (int i = 0; i < 6; i++) {
-        ax25_data[pos++] = ('Q' << 1);
+    if (packet->protocol == M17_PACKET_PROTO_AX25) {
+        int written = m17_ax25_bridge_wrap_frame(packet->data, packet->length, ax25_data, *ax25_length);
+        if (written < 0) {
+            return -1;
+        }
+        *ax25_length = written;
+        return 0;
     }
-    ax25_data[pos++] = 0x00;
     
-    // Source address (use bridge callsign)
-    for (int i = 0; i < 6; i++) {
-        ax25_data[pos++] = (bridge->state.config.ax25_callsign[i] << 1);
+    if (packet->protocol == M17_PACKET_PROTO_AX25_BATCH) {
+        // Aggregated frames, flagged back to back
+        uint16_t pos = 0;
+        uint16_t offset = 0;
+        const uint8_t* frame;
+        uint16_t length;
+        int result;
+        while ((result = m17_packet_batch_next(packet, &offset, &frame, &length)) == 1) {
+            int written = m17_ax25_bridge_wrap_frame(frame, length, &ax25_data[pos], *ax25_length - pos);
+            if (written < 0) {
+                return -1;
+            }
+            pos += written;
+        }
+        if (result < 0 || pos == 0) {
+            return -1;
+        }
+        *ax25_length = pos;
+        return 0;
     }
-    ax25_data[pos++] = (bridge->state.config.ax25_ssid << 1) | 0x60;
     
-    // Control field (UI frame)
-    ax25_data[pos++] = 0x03;
+    if (packet->length > AX25_MAX_INFO || 2 * AX25_ADDR_LEN + 2 + packet->length + 4 > *ax25_length) {
+        return -1;
+    }
+    uint16_t pos = 0;
+    ax25_data[pos++] = AX25_FLAG;
     
-    // PID (no layer 3)
-    ax25_data[pos++] = 0xF0;
+    // Destination address (broadcast)
+    for (int i = 0; i < 6; i++) {
+        ax25_data[pos++] = ('Q' << 1);
+    }
+    ax25_data[pos++] = 0x60;
     
-    // Copy M17 packet data as information field
-    uint16_t info_len = (packet_length > 20) ? 20 : packet_length;
-    for (uint16_t i = 0; i < info_len && pos < *ax25_length - 3; i++) {
-        ax25_data[pos++] = m17_data[packet_start + i];
+    // Source address (use bridge callsign, space padded)
+    const char* callsign = bridge->state.config.ax25_callsign;
+    bool ended = false;
+    for (int i = 0; i < 6; i++) {
+        ended = ended || callsign[i] == '\0';
+        ax25_data[pos++] = (ended ? ' ' : callsign[i]) << 1;
     }
+    ax25_data[pos++] = (bridge->state.config.ax25_ssid << 1) | 0x61; // Last address
     
-    // FCS (simplified)
-    ax25_data[pos++] = 0x00;
-    ax25_data[pos++] = 0x00;
+    ax25_data[pos++] = AX25_CTRL_UI;
+    ax25_data[pos++] = AX25_PID_NONE;
+    memcpy(&ax25_data[pos], packet->data, packet->length);
+    pos += packet->length;
     
-    // Closing flag
-    ax25_data[pos++] = 0x7E;
+    // FCS over everything after the opening flag
+    uint16_t fcs = ax25_calculate_fcs(&ax25_data[1], pos - 1);
+    ax25_data[pos++] = fcs & 0xFF;
+    ax25_data[pos++] = (fcs >> 8) & 0xFF;
+    ax25_data[pos++] = AX25_FLAG;
     
     *ax25_length = pos;
     return 0;
@@ -474,20 +549,21 @@ int m17_ax25_bridge_convert_ax25_to_m17(m17_ax25_bridge_t* bridge, const uint8_t
     m17_data[0] = 0x5D;
     m17_data[1] = 0x5F;
     
-    // Parse AX.25 frame properly
-    ax25_frame_t ax25_frame;
-    if (ax25_parse_frame(ax25_data, frame_end + 1, &ax25_frame) != 0) {
+    // Index the AX.25 frame in place (between the flags)
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, ax25_data + 1, frame_end - 1) != 0) {
         return -1; // Invalid AX.25 frame
     }
     
     // Extract information field from AX.25 frame
-    uint16_t info_start = 16; // Skip addresses and control/PID
-    uint16_t info_len = (frame_end + 1) - info_start - 2; // Subtract FCS
+    uint16_t info_len = 0;
+    const uint8_t* info = ax25_frame_view_info(&view, &info_len);
     
-    if (info_len > 0 && info_len <= 10) {
-        for (uint16_t i = 0; i < info_len; i++) {
-            m17_data[2 + i] = ax25_data[info_start + i];
-        }
+    if (info_len > 10) {
+        info_len = 0;
+    }
+    if (info_len > 0) {
+        memcpy(&m17_data[2], info, info_len);
     }
     
     *m17_length = 2 + info_len;
@@ -637,17 +713,13 @@ int m17_ax25_bridge_process_m17_lsf(m17_ax25_bridge_t* bridge, const uint8_t* da
     }
     
     // Extract callsigns from LSF
-    char src_callsign[10] = {0};
-    char dst_callsign[10] = {0};
-    
-    // Parse source callsign (bytes 3-12)
-    for (int i = 0; i < 9; i++) {
-        src_callsign[i] = data[3 + i];
-    }
+    char src_callsign[M17_CALLSIGN_BUF_LEN] = {0};
+    char dst_callsign[M17_CALLSIGN_BUF_LEN] = {0};
     
-    // Parse destination callsign (bytes 13-22)
-    for (int i = 0; i < 9; i++) {
-        dst_callsign[i] = data[13 + i];
+    // Decode destination and source addresses (6 bytes each, base-40)
+    if (m17_callsign_decode(&data[M17_LSF_DST_OFFSET], dst_callsign) != 0 ||
+        m17_callsign_decode(&data[M17_LSF_SRC_OFFSET], src_callsign) != 0) {
+        return -1; // Invalid or reserved address
     }
     
     // Update bridge state with M17 callsigns
@@ -657,6 +729,11 @@ int m17_ax25_bridge_process_m17_lsf(m17_ax25_bridge_t* bridge, const uint8_t* da
     // Log M17 LSF reception
     M17_DEBUG_PRINT(bridge, "M17 LSF: %s -> %s\n", src_callsign, dst_callsign);
     
+    // The stream that follows only needs its LICH checked against this
+    if (length >= M17_BRIDGE_LSF_LEN) {
+        m17_lsf_cache_seed(&bridge->lsf_cache, 0, &data[M17_LSF_OFFSET], timer_wheel_clock_ms());
+    }
+    
     // Note: Callsigns extracted for potential future use
     (void)src_callsign;  // Suppress unused variable warning
     (void)dst_callsign;  // Suppress unused variable warning
@@ -674,6 +751,23 @@ int m17_ax25_bridge_process_m17_stream(m17_ax25_bridge_t* bridge, const uint8_t*
     // M17 stream frames contain encoded audio data
     M17_DEBUG_PRINT(bridge, "M17 Stream Frame: %d bytes\n", length);
     
+    // Full stream frames carry the LSF a chunk at a time in the LICH; one
+    // RF channel per bridge, so one stream key
+    if (length >= M17_BRIDGE_STREAM_LEN) {
+        uint8_t lsf[M17_BRIDGE_LSF_LEN] = { 0x5D, 0x5F, M17_FRAME_TYPE_LSF };
+        int result = m17_lsf_cache_push(&bridge->lsf_cache, 0, &data[M17_STREAM_LICH_OFFSET],
+                                        timer_wheel_clock_ms(), &lsf[M17_LSF_OFFSET]);
+        if (result == M17_LSF_CACHE_COMPLETE) {
+            // Joined mid-stream: the LICH stands in for the missed LSF frame
+            m17_ax25_bridge_process_m17_lsf(bridge, lsf, sizeof(lsf));
+        }
+        if (data[M17_STREAM_FN_OFFSET] & M17_STREAM_FN_EOS) {
+            m17_lsf_cache_end(&bridge->lsf_cache, 0);
+        }
+        data += M17_STREAM_PAYLOAD_OFFSET;
+        length = M17_BRIDGE_STREAM_LEN - M17_STREAM_PAYLOAD_OFFSET;
+    }
+    
     // Implement audio decoding
     if (bridge->state.current_protocol == PROTOCOL_M17) {
         // M17 audio frame decoding
@@ -798,40 +892,28 @@ int m17_ax25_bridge_parse_ax25_frame(m17_ax25_bridge_t* bridge, const uint8_t* d
         return -1;
     }
     
-    // Extract addresses (minimum 2 addresses + control)
-    char src_callsign[7] = {0};
-    char dst_callsign[7] = {0};
-    uint8_t src_ssid = 0;
-    uint8_t dst_ssid = 0;
-    
-    // Parse destination address (bytes 1-7)
-    for (int i = 0; i < 6; i++) {
-        dst_callsign[i] = data[1 + i] >> 1;
-    }
-    dst_ssid = (data[7] >> 1) & 0x0F;  // SSID is in bits 4-1
-    
-    // Parse source address (bytes 8-14)
-    for (int i = 0; i < 6; i++) {
-        src_callsign[i] = data[8 + i] >> 1;
+    // Index the frame in place (after the opening flag); only the fields
+    // needed for dispatch are decoded
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data + 1, length - 1) != 0) {
+        return -1;
     }
-    src_ssid = (data[14] >> 1) & 0x0F;  // SSID is in bits 4-1
-    
-    // Note: SSIDs are extracted for potential future use
-    (void)src_ssid;  // Suppress unused variable warning
-    (void)dst_ssid;  // Suppress unused variable warning
-    
-    // Extract control field
-    uint8_t control = data[15];
     
+    char src_callsign[7];
+    char dst_callsign[7];
+    ax25_frame_view_get_callsign(&view, 0, dst_callsign, NULL);
+    ax25_frame_view_get_callsign(&view, 1, src_callsign, NULL);
+
     // Process based on frame type
-    if (control & 0x01) {
-        // I-frame (Information frame)
+    uint8_t control = ax25_frame_view_control(&view);
+    if ((control & 0x01) == 0) {
+        // I-frame (Information frame): bit 0 clear
         return m17_ax25_bridge_process_ax25_iframe(bridge, data, length, src_callsign, dst_callsign);
-    } else if (control & 0x02) {
-        // S-frame (Supervisory frame)
+    } else if ((control & 0x03) == 0x01) {
+        // S-frame (Supervisory frame): bits 1-0 = 01
         return m17_ax25_bridge_process_ax25_sframe(bridge, data, length, src_callsign, dst_callsign);
     } else {
-        // U-frame (Unnumbered frame)
+        // U-frame (Unnumbered frame): bits 1-0 = 11
         return m17_ax25_bridge_process_ax25_uframe(bridge, data, length, src_callsign, dst_callsign);
     }
 }
@@ -845,9 +927,12 @@ int m17_ax25_bridge_process_ax25_iframe(m17_ax25_bridge_t* bridge, const uint8_t
         return -1;
     }
     
-    // Extract information field
-    uint16_t info_start = 16; // Skip addresses and control
-    uint16_t info_length = length - info_start - 2; // Subtract FCS
+    // Extract information field (the view accounts for digipeaters and PID)
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data + 1, length - 1) != 0) {
+        return -1;
+    }
+    uint16_t info_length = view.info_length;
     
     M17_DEBUG_PRINT(bridge, "AX.25 I-frame: %s -> %s (%d bytes)\n", src_callsign, dst_callsign, info_length);
     
@@ -870,7 +955,12 @@ int m17_ax25_bridge_process_ax25_sframe(m17_ax25_bridge_t* bridge, const uint8_t
         return -1;
     }
     
-    uint8_t control = data[15];
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data + 1, length - 1) != 0) {
+        return -1;
+    }
+    
+    uint8_t control = ax25_frame_view_control(&view);
     const char* frame_type = "Unknown";
     
     // Determine S-frame type
@@ -901,13 +991,13 @@ int m17_ax25_bridge_process_m17_tx(m17_ax25_bridge_t* bridge, const uint8_t* dat
     
     // Encode M17 frame
     uint8_t encoded_data[256];
-    uint16_t encoded_length;
+    uint16_t encoded_length = sizeof(encoded_data);
     if (m17_encode_frame(&m17_frame, encoded_data, &encoded_length) != 0) {
         return -1;
     }
     
     // Send via KISS TNC
-    if (kiss_serial_send(&bridge->kiss_tnc, encoded_data, encoded_length) != 0) {
+    if (kiss_send_frame(&bridge->kiss_tnc, encoded_data, encoded_length, 0) < 0) {
         return -1;
     }
     
@@ -921,31 +1011,33 @@ int m17_ax25_bridge_process_ax25_tx(m17_ax25_bridge_t* bridge, const uint8_t* da
         return -1;
     }
     
-    // Create AX.25 frame
-    ax25_frame_t ax25_frame;
-    ax25_address_t src_addr, dst_addr;
+    // Create AX.25 UI header (destination first)
+    ax25_address_t addresses[2];
     
     // Set default addresses
-    ax25_set_address(&src_addr, "N0CALL", 0, false);
-    ax25_set_address(&dst_addr, "N0CALL", 0, false);
+    ax25_set_address(&addresses[0], "N0CALL", 0, false);
+    ax25_set_address(&addresses[1], "N0CALL", 0, false);
     
-    if (ax25_create_frame(&ax25_frame, &src_addr, &dst_addr, 0x03, 0xF0, data, length) != 0) {
+    ax25_header_template_t tmpl;
+    if (ax25_header_template_init(&tmpl, addresses, 2, AX25_CTRL_UI, AX25_PID_NONE) != 0) {
         return -1;
     }
     
-    // Encode AX.25 frame
-    uint8_t encoded_data[256];
-    uint16_t encoded_length;
-    if (ax25_encode_frame(&ax25_frame, encoded_data, &encoded_length) != 0) {
+    // Encode AX.25 frame with the payload referenced in place
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, data, length, fcs, iov);
+    if (iovcnt < 0) {
         return -1;
     }
     
     // Send via KISS TNC
-    if (kiss_serial_send(&bridge->kiss_tnc, encoded_data, encoded_length) != 0) {
+    int sent = kiss_send_iov(&bridge->kiss_tnc, iov, iovcnt, 0);
+    if (sent < 0) {
         return -1;
     }
     
-    M17_DEBUG_PRINT(bridge, "AX.25 TX: %d bytes transmitted\n", encoded_length);
+    M17_DEBUG_PRINT(bridge, "AX.25 TX: %d bytes transmitted\n", sent);
     return 0;
 }
 
@@ -1026,7 +1118,12 @@ int m17_ax25_bridge_process_ax25_uframe(m17_ax25_bridge_t* bridge, const uint8_t
         return -1;
     }
     
-    uint8_t control = data[15];
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data + 1, length - 1) != 0) {
+        return -1;
+    }
+    
+    uint8_t control = ax25_frame_view_control(&view);
     const char* frame_type = "Unknown";
     
     // Determine U-frame type
@@ -1043,11 +1140,9 @@ int m17_ax25_bridge_process_ax25_uframe(m17_ax25_bridge_t* bridge, const uint8_t
     (void)frame_type;  // Suppress unused variable warning - used in debug output
     
     // Check for APRS (UI frame with PID 0xF0)
-    if (control == 0x03 && length > 18) {
-        uint8_t pid = data[16];
-        if (pid == 0xF0) {
-            return m17_ax25_bridge_process_aprs_frame(bridge, data, length, src_callsign, dst_callsign);
-        }
+    if (control == AX25_CTRL_UI && view.info_length > 0 &&
+        ax25_frame_view_pid(&view) == AX25_PID_NONE) {
+        return m17_ax25_bridge_process_aprs_frame(bridge, data, length, src_callsign, dst_callsign);
     }
     
     return 0;
@@ -1063,8 +1158,12 @@ int m17_ax25_bridge_process_aprs_frame(m17_ax25_bridge_t* bridge, const uint8_t*
     }
     
     // Extract APRS data (after PID)
-    uint16_t aprs_start = 17;
-    uint16_t aprs_length = length - aprs_start - 2; // Subtract FCS
+    ax25_frame_view_t view;
+    if (ax25_frame_view_init(&view, data + 1, length - 1) != 0) {
+        return -1;
+    }
+    uint16_t aprs_length = 0;
+    ax25_frame_view_info(&view, &aprs_length);
     
     M17_DEBUG_PRINT(bridge, "APRS: %s -> %s (%d bytes)\n", src_callsign, dst_callsign, aprs_length);
     (void)aprs_length;  // Suppress unused variable warning - used in debug output
@@ -0,0 +1,210 @@
+//--------------------------------------------------------------------
+// M17 Base-40 Callsign Codec
+//
+// Lookup-table driven encoder/decoder for the 6-byte base-40
+// addresses carried in M17 Link Setup Frames
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_callsign.h"
+#include <string.h>
+#include <pthread.h>
+
+// Base-40 alphabet: value 0 is padding, rendered as a space
+static const char m17_base40_charset[40] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-/.";
+
+// Character class table for encoding. Entries hold (digit + 1) so that the
+// zero-initialised remainder of the table marks invalid characters.
+static const uint8_t m17_base40_class[256] = {
+    [' '] = 1,
+    ['A'] = 2,  ['B'] = 3,  ['C'] = 4,  ['D'] = 5,  ['E'] = 6,  ['F'] = 7,  ['G'] = 8,
+    ['H'] = 9,  ['I'] = 10, ['J'] = 11, ['K'] = 12, ['L'] = 13, ['M'] = 14, ['N'] = 15,
+    ['O'] = 16, ['P'] = 17, ['Q'] = 18, ['R'] = 19, ['S'] = 20, ['T'] = 21, ['U'] = 22,
+    ['V'] = 23, ['W'] = 24, ['X'] = 25, ['Y'] = 26, ['Z'] = 27,
+    ['a'] = 2,  ['b'] = 3,  ['c'] = 4,  ['d'] = 5,  ['e'] = 6,  ['f'] = 7,  ['g'] = 8,
+    ['h'] = 9,  ['i'] = 10, ['j'] = 11, ['k'] = 12, ['l'] = 13, ['m'] = 14, ['n'] = 15,
+    ['o'] = 16, ['p'] = 17, ['q'] = 18, ['r'] = 19, ['s'] = 20, ['t'] = 21, ['u'] = 22,
+    ['v'] = 23, ['w'] = 24, ['x'] = 25, ['y'] = 26, ['z'] = 27,
+    ['0'] = 28, ['1'] = 29, ['2'] = 30, ['3'] = 31, ['4'] = 32, ['5'] = 33, ['6'] = 34,
+    ['7'] = 35, ['8'] = 36, ['9'] = 37,
+    ['-'] = 38, ['/'] = 39, ['.'] = 40,
+};
+
+// Digit-pair table for decoding: entry p holds the characters for
+// digits (p % 40, p / 40), so one division by 1600 yields two characters
+#define M17_BASE40_PAIRS 1600
+#define M17_BASE40_SPLIT 2560000u // 40^4
+static char m17_base40_pairs[M17_BASE40_PAIRS][2];
+static pthread_once_t m17_base40_pairs_once = PTHREAD_ONCE_INIT;
+
+// 40^1 .. 40^8, thresholds for the decoded length
+static const uint64_t m17_base40_powers[M17_CALLSIGN_MAX_LEN - 1] = {
+    40ULL,          1600ULL,          64000ULL,          2560000ULL,
+    102400000ULL,   4096000000ULL,    163840000000ULL,   6553600000000ULL,
+};
+
+static void m17_base40_build_pairs(void) {
+    for (int p = 0; p < M17_BASE40_PAIRS; p++) {
+        m17_base40_pairs[p][0] = m17_base40_charset[p % 40];
+        m17_base40_pairs[p][1] = m17_base40_charset[p / 40];
+    }
+}
+
+static void m17_addr_pack(uint64_t value, uint8_t addr[M17_ADDR_LEN]) {
+    for (int i = M17_ADDR_LEN - 1; i >= 0; i--) {
+        addr[i] = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+static uint64_t m17_addr_unpack(const uint8_t addr[M17_ADDR_LEN]) {
+    uint64_t value = 0;
+    for (int i = 0; i < M17_ADDR_LEN; i++) {
+        value = (value << 8) | addr[i];
+    }
+    return value;
+}
+
+// Decode without one-time initialisation; caller guarantees the pair table is built
+static int m17_callsign_from_value_nolock(uint64_t value, char callsign[M17_CALLSIGN_BUF_LEN]) {
+    callsign[0] = '\0';
+
+    if (value == M17_ADDR_BROADCAST) {
+        memcpy(callsign, M17_CALLSIGN_BROADCAST, sizeof(M17_CALLSIGN_BROADCAST));
+        return 0;
+    }
+
+    if (value == 0 || value > M17_ADDR_MAX_BASE40) {
+        return -1; // Invalid or reserved address
+    }
+
+    // Split once into two 32-bit halves of four and five digits so the
+    // per-pair divisions below stay in cheap 32-bit arithmetic
+    uint32_t lo = (uint32_t)(value % M17_BASE40_SPLIT);
+    uint32_t hi = (uint32_t)(value / M17_BASE40_SPLIT);
+
+    memcpy(&callsign[0], m17_base40_pairs[lo % M17_BASE40_PAIRS], 2);
+    memcpy(&callsign[2], m17_base40_pairs[lo / M17_BASE40_PAIRS], 2);
+    memcpy(&callsign[4], m17_base40_pairs[hi % M17_BASE40_PAIRS], 2);
+    hi /= M17_BASE40_PAIRS;
+    memcpy(&callsign[6], m17_base40_pairs[hi % M17_BASE40_PAIRS], 2);
+    callsign[8] = m17_base40_pairs[hi / M17_BASE40_PAIRS][0];
+
+    // Length is the position of the most significant non-zero digit
+    int len = 1;
+    for (int i = 0; i < M17_CALLSIGN_MAX_LEN - 1; i++) {
+        len += value >= m17_base40_powers[i];
+    }
+    callsign[len] = '\0';
+
+    return 0;
+}
+
+// Convert callsign to its numeric base-40 value
+int m17_callsign_to_value(const char* callsign, uint64_t* value) {
+    if (!callsign || !value) {
+        return -1;
+    }
+
+    if (strcmp(callsign, M17_CALLSIGN_BROADCAST) == 0) {
+        *value = M17_ADDR_BROADCAST;
+        return 0;
+    }
+
+    size_t len = strlen(callsign);
+    if (len == 0 || len > M17_CALLSIGN_MAX_LEN) {
+        return -1; // Invalid length
+    }
+
+    // Horner evaluation from the most significant (last) character
+    uint64_t v = 0;
+    for (size_t i = len; i > 0; i--) {
+        uint8_t digit = m17_base40_class[(uint8_t)callsign[i - 1]];
+        if (digit == 0) {
+            return -1; // Invalid character
+        }
+        v = v * 40 + (digit - 1);
+    }
+
+    if (v == 0) {
+        return -1; // All padding
+    }
+
+    *value = v;
+    return 0;
+}
+
+// Convert numeric base-40 value to callsign
+int m17_callsign_from_value(uint64_t value, char callsign[M17_CALLSIGN_BUF_LEN]) {
+    if (!callsign) {
+        return -1;
+    }
+
+    pthread_once(&m17_base40_pairs_once, m17_base40_build_pairs);
+    return m17_callsign_from_value_nolock(value, callsign);
+}
+
+// Encode callsign into 6-byte M17 address
+int m17_callsign_encode(const char* callsign, uint8_t addr[M17_ADDR_LEN]) {
+    if (!callsign || !addr) {
+        return -1;
+    }
+
+    uint64_t value;
+    if (m17_callsign_to_value(callsign, &value) != 0) {
+        return -1;
+    }
+
+    m17_addr_pack(value, addr);
+    return 0;
+}
+
+// Decode 6-byte M17 address into callsign
+int m17_callsign_decode(const uint8_t addr[M17_ADDR_LEN], char callsign[M17_CALLSIGN_BUF_LEN]) {
+    if (!addr || !callsign) {
+        return -1;
+    }
+
+    return m17_callsign_from_value(m17_addr_unpack(addr), callsign);
+}
+
+// Encode array of callsigns
+size_t m17_callsign_encode_batch(const char* const* callsigns, uint8_t (*addrs)[M17_ADDR_LEN],
+                                 size_t count) {
+    if (!callsigns || !addrs) {
+        return count;
+    }
+
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t value;
+        if (!callsigns[i] || m17_callsign_to_value(callsigns[i], &value) != 0) {
+            memset(addrs[i], 0, M17_ADDR_LEN);
+            failed++;
+            continue;
+        }
+        m17_addr_pack(value, addrs[i]);
+    }
+
+    return failed;
+}
+
+// Decode array of addresses
+size_t m17_callsign_decode_batch(const uint8_t (*addrs)[M17_ADDR_LEN],
+                                 char (*callsigns)[M17_CALLSIGN_BUF_LEN], size_t count) {
+    if (!addrs || !callsigns) {
+        return count;
+    }
+
+    // Table is built once per batch rather than checked per address
+    pthread_once(&m17_base40_pairs_once, m17_base40_build_pairs);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (m17_callsign_from_value_nolock(m17_addr_unpack(addrs[i]), callsigns[i]) != 0) {
+            failed++;
+        }
+    }
+
+    return failed;
+}
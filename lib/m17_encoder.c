@@ -0,0 +1,225 @@
+//--------------------------------------------------------------------
+// M17 Channel Encoder
+//
+// Table-driven convolutional coding, a combined puncture and interleave
+// gather, and the sync word and randomiser as one XOR mask
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_encoder.h"
+#include "m17_viterbi.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define M17_LICH_CODED_BITS    (M17_LICH_CODED_BYTES * 8)
+#define M17_ENCODER_MAX_INPUT  ((M17_CONV_MAX_BITS + M17_CONV_TAIL_BITS + 7) / 8)
+#define M17_ENCODER_SOURCE_LEN (M17_LICH_CODED_BYTES + 2 * M17_ENCODER_MAX_INPUT)
+
+// Randomiser sequence, MSB first
+static const uint8_t m17_randomiser[M17_FRAME_CODED_BITS / 8] = {
+    0xD6, 0xB5, 0xE2, 0x30, 0x82, 0xFF, 0x84, 0x62, 0xBA, 0x4E, 0x96, 0x90, 0xD8, 0x98, 0xDD, 0x5D,
+    0x0C, 0xC8, 0x52, 0x43, 0x91, 0x1D, 0xF8, 0x6E, 0x68, 0x2F, 0x35, 0xDA, 0x14, 0xEA, 0xCD, 0x76,
+    0x19, 0x8D, 0xD5, 0x80, 0xD1, 0x33, 0x87, 0x13, 0x57, 0x18, 0x2D, 0x29, 0x78, 0xC3
+};
+
+// One frame type: where each transmitted bit comes from, and the mask
+// holding its sync word and the randomiser
+typedef struct {
+    uint16_t gather[M17_FRAME_CODED_BITS];  // Bit positions in the source buffer
+    uint8_t mask[M17_FRAME_SYMBOLS] __attribute__((aligned(16)));
+    uint16_t payload_bits;
+    uint16_t prefix_bits;                   // Uncoded bits ahead of the coded ones (LICH)
+} m17_encoder_frame_t;
+
+static pthread_once_t m17_encoder_once = PTHREAD_ONCE_INIT;
+
+// Sixteen coded bits for eight input bits from each encoder state, and
+// the state the byte leaves behind
+static uint16_t m17_conv_table[M17_CONV_STATES][256];
+static uint8_t m17_conv_next[256];
+
+// Interleaver: transmitted bit i is coded bit (45i + 92i^2) mod 368, an
+// involution, so the same table undoes it
+static uint16_t m17_interleave[M17_FRAME_CODED_BITS];
+
+static m17_encoder_frame_t m17_frame_lsf;
+static m17_encoder_frame_t m17_frame_stream;
+static m17_encoder_frame_t m17_frame_packet;
+
+static void m17_encoder_build_frame(m17_encoder_frame_t* frame, uint16_t sync,
+                                    m17_puncture_t puncture, uint16_t payload_bits,
+                                    uint16_t prefix_bits) {
+    uint16_t length = 1;
+    const uint8_t* pattern = m17_conv_puncture_pattern(puncture, &length);
+    uint16_t source[M17_FRAME_CODED_BITS];
+    uint16_t count = 0;
+
+    for (uint16_t i = 0; i < prefix_bits; i++) {
+        source[count++] = i;
+    }
+    for (uint16_t i = 0; i < 2 * (payload_bits + M17_CONV_TAIL_BITS); i++) {
+        if (pattern[i % length]) {
+            source[count++] = prefix_bits + i;
+        }
+    }
+    for (uint16_t i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        frame->gather[i] = source[m17_interleave[i]];
+    }
+
+    for (int i = 0; i < M17_SYNC_SYMBOLS; i++) {
+        frame->mask[i] = (sync >> (14 - 2 * i)) & 3;
+    }
+    for (int i = 0; i < M17_PAYLOAD_SYMBOLS; i++) {
+        frame->mask[M17_SYNC_SYMBOLS + i] = (m17_randomiser[i / 4] >> (6 - 2 * (i % 4))) & 3;
+    }
+    frame->payload_bits = payload_bits;
+    frame->prefix_bits = prefix_bits;
+}
+
+static void m17_encoder_init(void) {
+    for (uint8_t state = 0; state < M17_CONV_STATES; state++) {
+        for (int byte = 0; byte < 256; byte++) {
+            uint8_t s = state;
+            uint16_t word = 0;
+            for (int bit = 7; bit >= 0; bit--) {
+                uint8_t u = (byte >> bit) & 1;
+                // Same taps as m17_conv_encode, most recent bit in bit 3
+                uint8_t g1 = u ^ ((s >> 1) & 1) ^ (s & 1);
+                uint8_t g2 = u ^ ((s >> 3) & 1) ^ ((s >> 2) & 1) ^ (s & 1);
+                word = (uint16_t)((word << 2) | (g1 << 1) | g2);
+                s = (uint8_t)((u << 3) | (s >> 1));
+            }
+            m17_conv_table[state][byte] = word;
+            m17_conv_next[byte] = s;
+        }
+    }
+
+    for (uint32_t i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        m17_interleave[i] = (uint16_t)((45 * i + 92 * i * i) % M17_FRAME_CODED_BITS);
+    }
+
+    m17_encoder_build_frame(&m17_frame_lsf, M17_SYNC_LSF, M17_PUNCTURE_LSF,
+                            M17_LSF_PAYLOAD_BITS, 0);
+    m17_encoder_build_frame(&m17_frame_stream, M17_SYNC_STREAM, M17_PUNCTURE_STREAM,
+                            M17_STREAM_PAYLOAD_BITS, M17_LICH_CODED_BITS);
+    m17_encoder_build_frame(&m17_frame_packet, M17_SYNC_PACKET, M17_PUNCTURE_PACKET,
+                            M17_PACKET_PAYLOAD_BITS, 0);
+}
+
+static void m17_encoder_run(const m17_encoder_frame_t* frame, const uint8_t* prefix,
+                            const uint8_t* payload, uint8_t* dibits) {
+    uint8_t source[M17_ENCODER_SOURCE_LEN];
+    uint8_t input[M17_ENCODER_MAX_INPUT];
+    uint16_t payload_bytes = (frame->payload_bits + 7) / 8;
+    uint16_t input_bytes = (frame->payload_bits + M17_CONV_TAIL_BITS + 7) / 8;
+    uint16_t prefix_bytes = frame->prefix_bits / 8;
+
+    // Payload, unused bits of its last byte cleared, then the zero tail
+    memcpy(input, payload, payload_bytes);
+    if (frame->payload_bits % 8) {
+        input[payload_bytes - 1] &= (uint8_t)(0xFF << (8 - frame->payload_bits % 8));
+    }
+    memset(input + payload_bytes, 0, input_bytes - payload_bytes);
+
+    if (prefix_bytes) {
+        memcpy(source, prefix, prefix_bytes);
+    }
+    uint8_t* coded = source + prefix_bytes;
+    uint8_t state = 0;
+    for (uint16_t i = 0; i < input_bytes; i++) {
+        uint16_t word = m17_conv_table[state][input[i]];
+        coded[2 * i] = (uint8_t)(word >> 8);
+        coded[2 * i + 1] = (uint8_t)word;
+        state = m17_conv_next[input[i]];
+    }
+
+    // Punctured, interleaved bits in pairs; the sync positions stay zero
+    // so the mask writes the sync word there
+    memset(dibits, 0, M17_SYNC_SYMBOLS);
+    const uint16_t* gather = frame->gather;
+    for (int i = 0; i < M17_PAYLOAD_SYMBOLS; i++) {
+        uint16_t a = gather[2 * i];
+        uint16_t b = gather[2 * i + 1];
+        dibits[M17_SYNC_SYMBOLS + i] = (uint8_t)((((source[a >> 3] >> (7 - (a & 7))) & 1) << 1) |
+                                                 ((source[b >> 3] >> (7 - (b & 7))) & 1));
+    }
+
+#if defined(__SSE2__)
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)&dibits[i]);
+        v = _mm_xor_si128(v, _mm_load_si128((const __m128i*)&frame->mask[i]));
+        _mm_storeu_si128((__m128i*)&dibits[i], v);
+    }
+#else
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i++) {
+        dibits[i] ^= frame->mask[i];
+    }
+#endif
+}
+
+int m17_encode_lsf(const uint8_t* lsf, uint8_t* dibits) {
+    if (!lsf || !dibits) {
+        return -1;
+    }
+    pthread_once(&m17_encoder_once, m17_encoder_init);
+    m17_encoder_run(&m17_frame_lsf, NULL, lsf, dibits);
+    return 0;
+}
+
+int m17_encode_stream(const uint8_t* lich, const uint8_t* frame, uint8_t* dibits) {
+    if (!lich || !frame || !dibits) {
+        return -1;
+    }
+    pthread_once(&m17_encoder_once, m17_encoder_init);
+    m17_encoder_run(&m17_frame_stream, lich, frame, dibits);
+    return 0;
+}
+
+int m17_encode_packet(const uint8_t* frame, uint8_t* dibits) {
+    if (!frame || !dibits) {
+        return -1;
+    }
+    pthread_once(&m17_encoder_once, m17_encoder_init);
+    m17_encoder_run(&m17_frame_packet, NULL, frame, dibits);
+    return 0;
+}
+
+void m17_encode_preamble(uint8_t* dibits) {
+    // +3 is dibit 1, -3 is dibit 3
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i++) {
+        dibits[i] = (i & 1) ? 3 : 1;
+    }
+}
+
+void m17_encode_eot(uint8_t* dibits) {
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i++) {
+        dibits[i] = (M17_SYNC_EOT >> (14 - 2 * (i % M17_SYNC_SYMBOLS))) & 3;
+    }
+}
+
+void m17_dibits_to_symbols(const uint8_t* dibits, size_t count, float* symbols) {
+    static const float levels[4] = M17_DIBIT_SYMBOLS;
+    for (size_t i = 0; i < count; i++) {
+        symbols[i] = levels[dibits[i] & 3];
+    }
+}
+
+int m17_deinterleave_soft(const uint8_t* soft, uint8_t* coded) {
+    if (!soft || !coded) {
+        return -1;
+    }
+    pthread_once(&m17_encoder_once, m17_encoder_init);
+
+    for (int i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        uint8_t value = soft[i];
+        if ((m17_randomiser[i / 8] >> (7 - i % 8)) & 1) {
+            value = (uint8_t)(255 - value);
+        }
+        coded[m17_interleave[i]] = value;
+    }
+    return 0;
+}
@@ -0,0 +1,318 @@
+//--------------------------------------------------------------------
+// M17 LICH: Golay(24,12) Coding and LSF Reassembly
+//
+// Table-driven Golay encoder and syndrome decoder, LICH chunk coding
+// and the per-stream LSF cache
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_lich.h"
+#include "m17_packet.h"
+#include <pthread.h>
+#include <string.h>
+
+#define M17_GOLAY_UNCORRECTABLE  0xFFFFFFFFu
+#define M17_LSF_CACHE_ALL_CHUNKS ((1u << M17_LICH_CHUNKS) - 1)
+
+// Parity of each data bit (bit 0 first): x^(i+11) mod g(x), g = 0xC75,
+// shifted up by one with the overall parity bit below
+static const uint16_t m17_golay_matrix[12] = {
+    0x8EB, 0x93E, 0xA97, 0xDC6, 0x367, 0x6CD, 0xD99, 0x3DA, 0x7B4, 0xF68, 0x63B, 0xC75
+};
+
+static pthread_once_t m17_golay_once = PTHREAD_ONCE_INIT;
+static uint16_t m17_golay_parity[4096];
+// Error pattern of each syndrome, for patterns of up to three bits
+static uint32_t m17_golay_syndrome[4096];
+
+static uint16_t m17_golay_syndrome_of(uint32_t codeword) {
+    return m17_golay_parity[codeword >> 12] ^ (codeword & 0xFFF);
+}
+
+static void m17_golay_init(void) {
+    for (uint32_t data = 0; data < 4096; data++) {
+        uint16_t parity = 0;
+        for (int i = 0; i < 12; i++) {
+            if (data & (1u << i)) {
+                parity ^= m17_golay_matrix[i];
+            }
+        }
+        m17_golay_parity[data] = parity;
+        m17_golay_syndrome[data] = M17_GOLAY_UNCORRECTABLE;
+    }
+
+    // Minimum distance 8: the 2325 patterns of weight 0..3 all have
+    // distinct syndromes
+    m17_golay_syndrome[0] = 0;
+    for (int a = 0; a < 24; a++) {
+        uint32_t ea = 1u << a;
+        m17_golay_syndrome[m17_golay_syndrome_of(ea)] = ea;
+        for (int b = a + 1; b < 24; b++) {
+            uint32_t eb = ea | (1u << b);
+            m17_golay_syndrome[m17_golay_syndrome_of(eb)] = eb;
+            for (int c = b + 1; c < 24; c++) {
+                uint32_t ec = eb | (1u << c);
+                m17_golay_syndrome[m17_golay_syndrome_of(ec)] = ec;
+            }
+        }
+    }
+}
+
+uint32_t m17_golay_encode(uint16_t data) {
+    pthread_once(&m17_golay_once, m17_golay_init);
+    data &= 0xFFF;
+    return ((uint32_t)data << 12) | m17_golay_parity[data];
+}
+
+int m17_golay_decode(uint32_t codeword, uint16_t* data) {
+    if (!data) {
+        return -1;
+    }
+    pthread_once(&m17_golay_once, m17_golay_init);
+
+    codeword &= 0xFFFFFF;
+    uint32_t error = m17_golay_syndrome[m17_golay_syndrome_of(codeword)];
+    if (error == M17_GOLAY_UNCORRECTABLE) {
+        return -1;
+    }
+    *data = (uint16_t)((codeword ^ error) >> 12);
+    return __builtin_popcount(error);
+}
+
+int m17_lich_encode(const uint8_t* lsf, uint8_t counter, uint8_t* coded) {
+    if (!lsf || !coded || counter >= M17_LICH_CHUNKS) {
+        return -1;
+    }
+
+    uint8_t chunk[M17_LICH_CHUNK_LEN];
+    memcpy(chunk, &lsf[counter * M17_LICH_LSF_BYTES], M17_LICH_LSF_BYTES);
+    chunk[M17_LICH_LSF_BYTES] = (uint8_t)(counter << M17_LICH_COUNTER_SHIFT);
+
+    // Two 12-bit words per three chunk bytes, three coded bytes each
+    for (int i = 0; i < 2; i++) {
+        const uint8_t* in = &chunk[3 * i];
+        uint16_t words[2] = {
+            (uint16_t)((in[0] << 4) | (in[1] >> 4)),
+            (uint16_t)(((in[1] & 0x0F) << 8) | in[2]),
+        };
+        for (int j = 0; j < 2; j++) {
+            uint32_t codeword = m17_golay_encode(words[j]);
+            uint8_t* out = &coded[6 * i + 3 * j];
+            out[0] = (uint8_t)(codeword >> 16);
+            out[1] = (uint8_t)(codeword >> 8);
+            out[2] = (uint8_t)codeword;
+        }
+    }
+    return 0;
+}
+
+int m17_lich_decode(const uint8_t* coded, uint8_t* chunk) {
+    if (!coded || !chunk) {
+        return -1;
+    }
+
+    int corrected = 0;
+    uint16_t words[4];
+    for (int i = 0; i < 4; i++) {
+        const uint8_t* in = &coded[3 * i];
+        uint32_t codeword = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+        int errors = m17_golay_decode(codeword, &words[i]);
+        if (errors < 0) {
+            return -1;
+        }
+        corrected += errors;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        uint8_t* out = &chunk[3 * i];
+        out[0] = (uint8_t)(words[2 * i] >> 4);
+        out[1] = (uint8_t)(((words[2 * i] & 0x0F) << 4) | (words[2 * i + 1] >> 8));
+        out[2] = (uint8_t)words[2 * i + 1];
+    }
+    return corrected;
+}
+
+int m17_lsf_cache_init(m17_lsf_cache_t* cache, uint32_t timeout_ms) {
+    if (!cache) {
+        return -1;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    cache->timeout_ms = timeout_ms;
+    return 0;
+}
+
+static bool m17_lsf_cache_expired(const m17_lsf_cache_t* cache,
+                                  const m17_lsf_cache_slot_t* slot, uint64_t now_ms) {
+    return now_ms > slot->last_ms && now_ms - slot->last_ms > cache->timeout_ms;
+}
+
+// Slot of a stream: its own, a free one, or the least recently fed, in
+// that order
+static m17_lsf_cache_slot_t* m17_lsf_cache_slot(m17_lsf_cache_t* cache, uint64_t key,
+                                                uint64_t now_ms) {
+    m17_lsf_cache_slot_t* free_slot = NULL;
+    m17_lsf_cache_slot_t* oldest = NULL;
+
+    for (int i = 0; i < M17_LSF_CACHE_SLOTS; i++) {
+        m17_lsf_cache_slot_t* slot = &cache->slots[i];
+        if (slot->active && m17_lsf_cache_expired(cache, slot, now_ms)) {
+            slot->active = false;
+            cache->stats.timeouts++;
+        }
+        if (!slot->active) {
+            if (!free_slot) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (slot->key == key) {
+            return slot;
+        }
+        if (!oldest || slot->last_ms < oldest->last_ms) {
+            oldest = slot;
+        }
+    }
+
+    m17_lsf_cache_slot_t* slot = free_slot;
+    if (!slot) {
+        slot = oldest;
+        cache->stats.evictions++;
+    }
+    slot->key = key;
+    slot->received = 0;
+    slot->next_counter = 0;
+    slot->known = false;
+    slot->active = true;
+    return slot;
+}
+
+// Records a CRC-checked LSF and the LICH each counter will carry
+static void m17_lsf_cache_learn(m17_lsf_cache_slot_t* slot, const uint8_t* lsf) {
+    memcpy(slot->lsf, lsf, M17_LICH_LSF_LEN);
+    for (uint8_t counter = 0; counter < M17_LICH_CHUNKS; counter++) {
+        m17_lich_encode(slot->lsf, counter, slot->coded[counter]);
+    }
+    slot->received = M17_LSF_CACHE_ALL_CHUNKS;
+    slot->known = true;
+}
+
+static bool m17_lsf_crc_valid(const uint8_t* lsf) {
+    uint16_t crc = ((uint16_t)lsf[M17_LICH_LSF_LEN - 2] << 8) | lsf[M17_LICH_LSF_LEN - 1];
+    return m17_crc(lsf, M17_LICH_LSF_LEN - 2) == crc;
+}
+
+// Bits in which two coded LICH differ; most chunks arrive clean
+static int m17_lsf_cache_distance(const uint8_t* a, const uint8_t* b) {
+    uint64_t a0, b0;
+    uint32_t a1, b1;
+    memcpy(&a0, a, sizeof(a0));
+    memcpy(&b0, b, sizeof(b0));
+    memcpy(&a1, a + sizeof(a0), sizeof(a1));
+    memcpy(&b1, b + sizeof(b0), sizeof(b1));
+    if (a0 == b0 && a1 == b1) {
+        return 0;
+    }
+    return __builtin_popcountll(a0 ^ b0) + __builtin_popcount(a1 ^ b1);
+}
+
+int m17_lsf_cache_push(m17_lsf_cache_t* cache, uint64_t key, const uint8_t* coded,
+                       uint64_t now_ms, uint8_t* lsf) {
+    if (!cache || !coded || !lsf) {
+        return -1;
+    }
+
+    cache->stats.chunks++;
+    m17_lsf_cache_slot_t* slot = m17_lsf_cache_slot(cache, key, now_ms);
+    slot->last_ms = now_ms;
+
+    // Known LSF: the next counter's LICH is predictable
+    if (slot->known &&
+        m17_lsf_cache_distance(coded, slot->coded[slot->next_counter]) <=
+            M17_LSF_CACHE_MATCH_BITS) {
+        slot->next_counter = (slot->next_counter + 1) % M17_LICH_CHUNKS;
+        cache->stats.confirmed++;
+        cache->stats.fast_matches++;
+        memcpy(lsf, slot->lsf, M17_LICH_LSF_LEN);
+        return M17_LSF_CACHE_CONFIRMED;
+    }
+
+    uint8_t chunk[M17_LICH_CHUNK_LEN];
+    int corrected = m17_lich_decode(coded, chunk);
+    uint8_t counter = chunk[M17_LICH_LSF_BYTES] >> M17_LICH_COUNTER_SHIFT;
+    if (corrected < 0 || counter >= M17_LICH_CHUNKS) {
+        cache->stats.rejected++;
+        return -1;
+    }
+    cache->stats.corrected_bits += corrected;
+    slot->next_counter = (counter + 1) % M17_LICH_CHUNKS;
+
+    uint8_t* piece = &slot->lsf[counter * M17_LICH_LSF_BYTES];
+    if (slot->known) {
+        // Out of sequence but the same LSF, or a different one
+        if (memcmp(piece, chunk, M17_LICH_LSF_BYTES) == 0) {
+            cache->stats.confirmed++;
+            memcpy(lsf, slot->lsf, M17_LICH_LSF_LEN);
+            return M17_LSF_CACHE_CONFIRMED;
+        }
+        cache->stats.changes++;
+        slot->known = false;
+        slot->received = 0;
+    }
+
+    memcpy(piece, chunk, M17_LICH_LSF_BYTES);
+    slot->received |= (uint8_t)(1u << counter);
+    if (slot->received != M17_LSF_CACHE_ALL_CHUNKS) {
+        return M17_LSF_CACHE_PENDING;
+    }
+
+    if (!m17_lsf_crc_valid(slot->lsf)) {
+        // Some older chunk is stale; keep collecting from this one
+        cache->stats.crc_errors++;
+        slot->received = (uint8_t)(1u << counter);
+        return M17_LSF_CACHE_PENDING;
+    }
+    m17_lsf_cache_learn(slot, slot->lsf);
+    cache->stats.lsfs++;
+    memcpy(lsf, slot->lsf, M17_LICH_LSF_LEN);
+    return M17_LSF_CACHE_COMPLETE;
+}
+
+int m17_lsf_cache_seed(m17_lsf_cache_t* cache, uint64_t key, const uint8_t* lsf,
+                       uint64_t now_ms) {
+    if (!cache || !lsf || !m17_lsf_crc_valid(lsf)) {
+        return -1;
+    }
+
+    m17_lsf_cache_slot_t* slot = m17_lsf_cache_slot(cache, key, now_ms);
+    slot->last_ms = now_ms;
+    if (slot->known && memcmp(slot->lsf, lsf, M17_LICH_LSF_LEN) == 0) {
+        return 0; // Already known; keep following the counter
+    }
+    slot->next_counter = 0;
+    m17_lsf_cache_learn(slot, lsf);
+    return 0;
+}
+
+int m17_lsf_cache_end(m17_lsf_cache_t* cache, uint64_t key) {
+    if (!cache) {
+        return -1;
+    }
+
+    for (int i = 0; i < M17_LSF_CACHE_SLOTS; i++) {
+        if (cache->slots[i].active && cache->slots[i].key == key) {
+            cache->slots[i].active = false;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int m17_lsf_cache_get_stats(const m17_lsf_cache_t* cache, m17_lsf_cache_stats_t* stats) {
+    if (!cache || !stats) {
+        return -1;
+    }
+
+    *stats = cache->stats;
+    return 0;
+}
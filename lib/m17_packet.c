@@ -0,0 +1,363 @@
+//--------------------------------------------------------------------
+// M17 Packet Mode Segmentation and Reassembly
+//
+// 25-byte packet frames with CRC-checked superframe reassembly
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_packet.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define M17_CRC_POLY  0x5935
+
+// M17 CRC: MSB first, no final XOR
+uint16_t m17_crc(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    if (!data) {
+        return crc;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ M17_CRC_POLY) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+int m17_packet_frame_count(uint16_t length) {
+    if (length > M17_PACKET_MAX_DATA) {
+        return 0;
+    }
+    return (length + 3 + M17_PACKET_CHUNK_LEN - 1) / M17_PACKET_CHUNK_LEN;
+}
+
+// Build the superframe, then cut it into chunks; the last chunk is
+// zero-padded and its metadata carries the bytes in use
+int m17_packet_encode(uint8_t protocol, const uint8_t* data, uint16_t length,
+                      uint8_t* frames, size_t frames_size) {
+    int count = m17_packet_frame_count(length);
+    if ((!data && length > 0) || !frames || count == 0 ||
+        frames_size < (size_t)count * M17_PACKET_FRAME_LEN) {
+        return -1;
+    }
+
+    uint8_t superframe[M17_PACKET_MAX_SUPERFRAME];
+    uint16_t total = 0;
+    superframe[total++] = protocol;
+    if (length > 0) {
+        memcpy(&superframe[total], data, length);
+        total += length;
+    }
+    uint16_t crc = m17_crc(superframe, total);
+    superframe[total++] = crc >> 8;
+    superframe[total++] = crc & 0xFF;
+
+    for (int i = 0; i < count; i++) {
+        uint8_t* frame = &frames[i * M17_PACKET_FRAME_LEN];
+        uint16_t offset = i * M17_PACKET_CHUNK_LEN;
+        uint16_t chunk = total - offset;
+        if (chunk > M17_PACKET_CHUNK_LEN) {
+            chunk = M17_PACKET_CHUNK_LEN;
+        }
+
+        memcpy(frame, &superframe[offset], chunk);
+        memset(&frame[chunk], 0, M17_PACKET_CHUNK_LEN - chunk);
+        if (i == count - 1) {
+            frame[M17_PACKET_CHUNK_LEN] = M17_PACKET_META_EOF | (chunk << M17_PACKET_META_SHIFT);
+        } else {
+            frame[M17_PACKET_CHUNK_LEN] = (uint8_t)(i << M17_PACKET_META_SHIFT);
+        }
+    }
+    return count;
+}
+
+uint32_t m17_packet_airtime_ms(uint16_t length) {
+    return (M17_PACKET_OVERHEAD_FRAMES + m17_packet_frame_count(length)) * M17_FRAME_MS;
+}
+
+// Allocate every slot now; nothing is allocated while frames arrive
+int m17_packet_reasm_init(m17_packet_reasm_t* reasm, uint16_t num_slots, uint32_t timeout_ms) {
+    if (!reasm || num_slots == 0) {
+        return -1;
+    }
+
+    reasm->slots = calloc(num_slots, sizeof(m17_packet_slot_t));
+    if (!reasm->slots) {
+        return -1;
+    }
+    reasm->num_slots = num_slots;
+    reasm->timeout_ms = timeout_ms;
+    memset(&reasm->stats, 0, sizeof(reasm->stats));
+    return 0;
+}
+
+void m17_packet_reasm_free(m17_packet_reasm_t* reasm) {
+    if (!reasm) {
+        return;
+    }
+
+    free(reasm->slots);
+    reasm->slots = NULL;
+    reasm->num_slots = 0;
+}
+
+static bool m17_packet_slot_expired(const m17_packet_reasm_t* reasm,
+                                    const m17_packet_slot_t* slot, uint64_t now_ms) {
+    return now_ms > slot->last_ms && now_ms - slot->last_ms > reasm->timeout_ms;
+}
+
+// Slot for a sender's next packet: its own, a free one, or the least
+// recently fed, in that order
+static m17_packet_slot_t* m17_packet_reasm_slot(m17_packet_reasm_t* reasm, uint64_t key,
+                                                uint64_t now_ms, bool create) {
+    m17_packet_slot_t* free_slot = NULL;
+    m17_packet_slot_t* oldest = NULL;
+
+    for (uint16_t i = 0; i < reasm->num_slots; i++) {
+        m17_packet_slot_t* slot = &reasm->slots[i];
+        if (slot->active && m17_packet_slot_expired(reasm, slot, now_ms)) {
+            slot->active = false;
+            reasm->stats.timeouts++;
+        }
+        if (!slot->active) {
+            if (!free_slot) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (slot->key == key) {
+            return slot;
+        }
+        if (!oldest || slot->last_ms < oldest->last_ms) {
+            oldest = slot;
+        }
+    }
+
+    if (!create) {
+        return NULL;
+    }
+    m17_packet_slot_t* slot = free_slot;
+    if (!slot) {
+        slot = oldest;
+        reasm->stats.evictions++;
+    }
+    slot->key = key;
+    slot->length = 0;
+    slot->next_counter = 0;
+    slot->active = true;
+    return slot;
+}
+
+int m17_packet_reasm_push(m17_packet_reasm_t* reasm, uint64_t key,
+                          const uint8_t frame[M17_PACKET_FRAME_LEN], uint64_t now_ms,
+                          m17_packet_t* packet) {
+    if (!reasm || !reasm->slots || !frame || !packet) {
+        return -1;
+    }
+
+    reasm->stats.frames++;
+    uint8_t meta = frame[M17_PACKET_CHUNK_LEN];
+    bool eof = (meta & M17_PACKET_META_EOF) != 0;
+    uint8_t counter = (meta >> M17_PACKET_META_SHIFT) & M17_PACKET_META_MASK;
+
+    // A packet starts with frame 0, or is a single last frame
+    bool starts = eof || counter == 0;
+    m17_packet_slot_t* slot = m17_packet_reasm_slot(reasm, key, now_ms, false);
+    if (slot && !eof && counter != slot->next_counter) {
+        // Restarted or out of order: the partial packet is lost
+        reasm->stats.sequence_errors++;
+        slot->active = false;
+        slot = NULL;
+        if (counter != 0) {
+            return -1;
+        }
+    }
+    if (!slot) {
+        if (!starts) {
+            reasm->stats.sequence_errors++;
+            return -1;
+        }
+        slot = m17_packet_reasm_slot(reasm, key, now_ms, true);
+    }
+
+    uint16_t chunk = eof ? counter : M17_PACKET_CHUNK_LEN;
+    if (chunk == 0 || chunk > M17_PACKET_CHUNK_LEN ||
+        slot->length + chunk > M17_PACKET_MAX_SUPERFRAME) {
+        reasm->stats.sequence_errors++;
+        slot->active = false;
+        return -1;
+    }
+    memcpy(&slot->data[slot->length], frame, chunk);
+    slot->length += chunk;
+    slot->last_ms = now_ms;
+    slot->next_counter++;
+    if (!eof) {
+        return 0;
+    }
+
+    // Complete: protocol byte, data, CRC
+    slot->active = false;
+    if (slot->length < 3) {
+        reasm->stats.crc_errors++;
+        return -1;
+    }
+    uint16_t data_len = slot->length - 3;
+    uint16_t crc = ((uint16_t)slot->data[slot->length - 2] << 8) | slot->data[slot->length - 1];
+    if (m17_crc(slot->data, slot->length - 2) != crc) {
+        reasm->stats.crc_errors++;
+        return -1;
+    }
+
+    packet->protocol = slot->data[0];
+    packet->length = data_len;
+    memcpy(packet->data, &slot->data[1], data_len);
+    reasm->stats.packets++;
+    return 1;
+}
+
+int m17_packet_reasm_expire(m17_packet_reasm_t* reasm, uint64_t now_ms) {
+    if (!reasm || !reasm->slots) {
+        return -1;
+    }
+
+    int expired = 0;
+    for (uint16_t i = 0; i < reasm->num_slots; i++) {
+        m17_packet_slot_t* slot = &reasm->slots[i];
+        if (slot->active && m17_packet_slot_expired(reasm, slot, now_ms)) {
+            slot->active = false;
+            reasm->stats.timeouts++;
+            expired++;
+        }
+    }
+    return expired;
+}
+
+uint16_t m17_packet_reasm_active(const m17_packet_reasm_t* reasm) {
+    if (!reasm || !reasm->slots) {
+        return 0;
+    }
+
+    uint16_t active = 0;
+    for (uint16_t i = 0; i < reasm->num_slots; i++) {
+        active += reasm->slots[i].active;
+    }
+    return active;
+}
+
+// Get statistics
+int m17_packet_reasm_get_stats(const m17_packet_reasm_t* reasm, m17_packet_stats_t* stats) {
+    if (!reasm || !stats) {
+        return -1;
+    }
+
+    *stats = reasm->stats;
+    return 0;
+}
+
+int m17_packet_batch_init(m17_packet_batch_t* batch, uint16_t max_length) {
+    if (!batch) {
+        return -1;
+    }
+
+    memset(batch, 0, sizeof(*batch));
+    return m17_packet_batch_set_max_length(batch, max_length);
+}
+
+int m17_packet_batch_set_max_length(m17_packet_batch_t* batch, uint16_t max_length) {
+    // Room for one length prefix and a frame at least
+    if (!batch || max_length < 3 || max_length > M17_PACKET_MAX_DATA) {
+        return -1;
+    }
+
+    batch->max_length = max_length;
+    return 0;
+}
+
+int m17_packet_batch_add(m17_packet_batch_t* batch, const uint8_t* frame, uint16_t length,
+                         uint64_t now_ms) {
+    if (!batch || !frame || length == 0 || batch->length + 2 + length > batch->max_length) {
+        return -1;
+    }
+
+    if (batch->count == 0) {
+        batch->opened_ms = now_ms;
+    }
+    batch->data[batch->length++] = length >> 8;
+    batch->data[batch->length++] = length & 0xFF;
+    memcpy(&batch->data[batch->length], frame, length);
+    batch->length += length;
+    batch->count++;
+    batch->separate_ms += m17_packet_airtime_ms(length);
+    batch->stats.frames++;
+    return 0;
+}
+
+bool m17_packet_batch_due(const m17_packet_batch_t* batch, uint32_t window_ms, uint64_t now_ms) {
+    return batch && batch->count > 0 && now_ms >= batch->opened_ms + window_ms;
+}
+
+int m17_packet_batch_flush(m17_packet_batch_t* batch, uint8_t* frames, size_t frames_size) {
+    if (!batch || !frames) {
+        return -1;
+    }
+    if (batch->count == 0) {
+        return 0;
+    }
+
+    int count;
+    uint16_t sent;
+    if (batch->count == 1) {
+        sent = batch->length - 2;
+        count = m17_packet_encode(M17_PACKET_PROTO_AX25, &batch->data[2], sent, frames, frames_size);
+    } else {
+        sent = batch->length;
+        count = m17_packet_encode(M17_PACKET_PROTO_AX25_BATCH, batch->data, sent, frames,
+                                  frames_size);
+    }
+    if (count < 0) {
+        return -1;
+    }
+
+    uint32_t airtime = m17_packet_airtime_ms(sent);
+    batch->stats.packets++;
+    batch->stats.airtime_ms += airtime;
+    batch->stats.airtime_saved_ms += batch->separate_ms - airtime;
+    batch->length = 0;
+    batch->count = 0;
+    batch->separate_ms = 0;
+    return count;
+}
+
+int m17_packet_batch_next(const m17_packet_t* packet, uint16_t* offset,
+                          const uint8_t** frame, uint16_t* length) {
+    if (!packet || !offset || !frame || !length || *offset > packet->length) {
+        return -1;
+    }
+    if (*offset == packet->length) {
+        return 0;
+    }
+    if (packet->length - *offset < 2) {
+        return -1;
+    }
+
+    uint16_t frame_len = ((uint16_t)packet->data[*offset] << 8) | packet->data[*offset + 1];
+    if (frame_len == 0 || frame_len > packet->length - *offset - 2) {
+        return -1;
+    }
+    *frame = &packet->data[*offset + 2];
+    *length = frame_len;
+    *offset += 2 + frame_len;
+    return 1;
+}
+
+int m17_packet_batch_get_stats(const m17_packet_batch_t* batch, m17_packet_batch_stats_t* stats) {
+    if (!batch || !stats) {
+        return -1;
+    }
+
+    *stats = batch->stats;
+    return 0;
+}
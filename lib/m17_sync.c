@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------
+// M17 Sync Word Search
+//
+// Block-wise VOLK correlation against the four sync words and
+// peak picking with a per-frame holdoff
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_sync.h"
+#include <math.h>
+#include <string.h>
+#include <volk/volk.h>
+
+#define M17_SYNC_BLOCK         256     // Window positions correlated per pass
+
+void m17_sync_search_init(m17_sync_search_t* search) {
+    static const uint16_t words[M17_SYNC_TYPES] = { M17_SYNC_LSF, M17_SYNC_STREAM,
+                                                    M17_SYNC_PACKET, M17_SYNC_BERT };
+    static const float levels[4] = M17_DIBIT_SYMBOLS;
+
+    if (!search) {
+        return;
+    }
+
+    // Sync words only use the outer symbols, +3 and -3
+    for (int s = 0; s < M17_SYNC_TYPES; s++) {
+        for (int k = 0; k < M17_SYNC_SYMBOLS; k++) {
+            search->signs[s][k] = levels[(words[s] >> (14 - 2 * k)) & 3] > 0 ? 1.0f : -1.0f;
+        }
+    }
+    search->previous = 0.0f;
+    search->holdoff = 0;
+}
+
+// Best normalised correlation and its sync word at n <= M17_SYNC_BLOCK
+// positions; symbols must hold n + M17_SYNC_SYMBOLS - 1 values
+static void m17_sync_score(const m17_sync_search_t* search, const float* symbols, size_t n,
+                           float* score, uint8_t* type) {
+    float square[M17_SYNC_BLOCK + M17_SYNC_SYMBOLS - 1];
+    float energy[M17_SYNC_BLOCK];
+    float corr[M17_SYNC_TYPES][M17_SYNC_BLOCK];
+    size_t squares = n + M17_SYNC_SYMBOLS - 1;
+
+    // Window energy: running sum of eight squares
+    volk_32f_x2_multiply_32f(square, symbols, symbols, squares);
+    memcpy(energy, square, n * sizeof(float));
+    for (int k = 1; k < M17_SYNC_SYMBOLS; k++) {
+        volk_32f_x2_add_32f(energy, energy, square + k, n);
+    }
+
+    // Each sync word symbol adds or subtracts the input shifted by its tap
+    for (int s = 0; s < M17_SYNC_TYPES; s++) {
+        volk_32f_s32f_multiply_32f(corr[s], symbols, search->signs[s][0], n);
+        for (int k = 1; k < M17_SYNC_SYMBOLS; k++) {
+            if (search->signs[s][k] > 0) {
+                volk_32f_x2_add_32f(corr[s], corr[s], symbols + k, n);
+            } else {
+                volk_32f_x2_subtract_32f(corr[s], corr[s], symbols + k, n);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        // Normalised: pattern energy is eight, window energy measured
+        float scale = energy[i] > M17_SYNC_MIN_ENERGY * M17_SYNC_SYMBOLS
+                          ? 1.0f / sqrtf(M17_SYNC_SYMBOLS * energy[i])
+                          : 0.0f;
+        score[i] = corr[0][i] * scale;
+        type[i] = M17_SYNC_TYPE_LSF;
+        for (int s = 1; s < M17_SYNC_TYPES; s++) {
+            float value = corr[s][i] * scale;
+            if (value > score[i]) {
+                score[i] = value;
+                type[i] = (uint8_t)s;
+            }
+        }
+    }
+}
+
+int m17_sync_search(m17_sync_search_t* search, const float* symbols, size_t count,
+                    float threshold, m17_sync_hit_t* hits, size_t max_hits) {
+    float score[M17_SYNC_BLOCK];
+    uint8_t type[M17_SYNC_BLOCK];
+    float best = 0.0f;
+    m17_sync_type_t best_type = M17_SYNC_TYPE_LSF;
+    int found = 0;
+
+    if (!search || !symbols || !hits || max_hits < M17_SYNC_MAX_HITS(count)) {
+        return -1;
+    }
+
+    // Position count is scored only to see whether count - 1 peaks; the
+    // next call scores it again as its position 0
+    for (size_t start = 0; start <= count; start += M17_SYNC_BLOCK) {
+        size_t n = count + 1 - start < M17_SYNC_BLOCK ? count + 1 - start : M17_SYNC_BLOCK;
+        m17_sync_score(search, symbols + start, n, score, type);
+
+        for (size_t j = 0; j < n; j++) {
+            if (start + j > 0) {
+                // The position before j peaks if it beats both neighbours
+                if (search->holdoff > 0) {
+                    search->holdoff--;
+                } else if (best >= threshold && best > search->previous && best >= score[j]) {
+                    hits[found].offset = start + j - 1;
+                    hits[found].type = best_type;
+                    hits[found].strength = best;
+                    found++;
+                    search->holdoff = M17_SYNC_HOLDOFF;
+                }
+                search->previous = best;
+            }
+            best = score[j];
+            best_type = (m17_sync_type_t)type[j];
+        }
+    }
+
+    return found;
+}
@@ -70,9 +70,17 @@ m17_to_ax25_impl::m17_to_ax25_impl(const std::string& callsign, const std::strin
     config.il2p_debug = 0;
 
     if (m17_ax25_bridge_set_config(&d_bridge, &config) != 0) {
+        m17_ax25_bridge_cleanup(&d_bridge);
         throw std::runtime_error("Failed to configure M17-AX.25 bridge");
     }
 
+    // Packet reassembly slots are allocated once, here
+    if (m17_packet_reasm_init(&d_reassembler, M17_PACKET_REASM_SLOTS,
+                              M17_PACKET_REASM_TIMEOUT_MS) != 0) {
+        m17_ax25_bridge_cleanup(&d_bridge);
+        throw std::runtime_error("Failed to allocate M17 packet reassembler");
+    }
+
     // Set up message ports for control
     message_port_register_in(pmt::mp("control"));
     set_msg_handler(pmt::mp("control"), [this](pmt::pmt_t msg) { handle_control_message(msg); });
@@ -80,9 +88,26 @@ m17_to_ax25_impl::m17_to_ax25_impl(const std::string& callsign, const std::strin
 
 m17_to_ax25_impl::~m17_to_ax25_impl() {
     // Cleanup the M17-AX.25 bridge
+    m17_packet_reasm_free(&d_reassembler);
     m17_ax25_bridge_cleanup(&d_bridge);
 }
 
+/*!
+ * \brief Bridge frame length for a frame type
+ * \param frame_type Byte after the 0x5D 0x5F marker
+ * \return Length including marker and type, or 0 if the type is not converted
+ */
+static size_t m17_bridge_frame_length(uint8_t frame_type) {
+    switch (frame_type) {
+    case M17_FRAME_TYPE_LSF:
+        return M17_BRIDGE_LSF_LEN;
+    case M17_FRAME_TYPE_PACKET:
+        return M17_BRIDGE_PACKET_LEN;
+    default:
+        return 0;
+    }
+}
+
 /*!
  * \brief Main processing function for M17 to AX.25 conversion
  * \param noutput_items Number of output items to produce
@@ -95,44 +120,39 @@ int m17_to_ax25_impl::work(int noutput_items, gr_vector_const_void_star& input_i
     const uint8_t* in = (const uint8_t*)input_items[0];
     uint8_t* out = (uint8_t*)output_items[0];
 
-    int consumed = 0;
     int produced = 0;
 
-    // Process input data in chunks
     for (int i = 0; i < noutput_items; i++) {
-        // Add data to frame buffer
         d_frame_buffer.push_back(in[i]);
-        consumed++;
-
-        // Check for M17 frame markers (0x5D 0x5F)
-        if (d_frame_buffer.size() >= 2 && d_frame_buffer[d_frame_buffer.size() - 2] == 0x5D &&
-            d_frame_buffer[d_frame_buffer.size() - 1] == 0x5F) {
-
-            // We have a potential M17 frame, try to convert it
-            uint8_t ax25_data[256];
-            uint16_t ax25_length = sizeof(ax25_data);
 
-            if (m17_ax25_bridge_convert_m17_to_ax25(&d_bridge, d_frame_buffer.data(),
-                                                    d_frame_buffer.size(), ax25_data,
-                                                    &ax25_length) == 0) {
-
-                // Copy converted AX.25 data to output
-                int to_copy = std::min((int)ax25_length, noutput_items - produced);
-                memcpy(&out[produced], ax25_data, to_copy);
-                produced += to_copy;
-
-                // If we couldn't fit all the data, store the rest
-                if (to_copy < ax25_length) {
-                    d_output_buffer.assign(ax25_data + to_copy, ax25_data + ax25_length);
-                }
+        // Hunt for the 0x5D 0x5F marker
+        if (d_frame_buffer.size() == 1 && d_frame_buffer[0] != 0x5D) {
+            d_frame_buffer.clear();
+            continue;
+        }
+        if (d_frame_buffer.size() == 2 && d_frame_buffer[1] != 0x5F) {
+            d_frame_buffer.clear();
+            if (in[i] == 0x5D) {
+                d_frame_buffer.push_back(in[i]);
             }
+            continue;
+        }
+        if (d_frame_buffer.size() < M17_PACKET_FRAME_OFFSET) {
+            continue;
+        }
 
-            // Clear frame buffer for next frame
+        size_t needed = m17_bridge_frame_length(d_frame_buffer[M17_PACKET_FRAME_OFFSET - 1]);
+        if (needed == 0) {
+            d_frame_buffer.clear(); // Frame type not converted; resynchronise
+            continue;
+        }
+        if (d_frame_buffer.size() == needed) {
+            process_m17_frame();
             d_frame_buffer.clear();
         }
     }
 
-    // Output any remaining buffered data
+    // Output converted AX.25 frames
     if (!d_output_buffer.empty()) {
         int to_copy = std::min((int)d_output_buffer.size(), noutput_items - produced);
         memcpy(&out[produced], d_output_buffer.data(), to_copy);
@@ -143,6 +163,33 @@ int m17_to_ax25_impl::work(int noutput_items, gr_vector_const_void_star& input_i
     return produced;
 }
 
+void m17_to_ax25_impl::process_m17_frame() {
+    uint8_t ax25_data[M17_BRIDGE_PACKET_AX25_MAX];
+    uint16_t ax25_length = sizeof(ax25_data);
+    uint64_t now_ms = timer_wheel_clock_ms();
+
+    if (d_frame_buffer[M17_PACKET_FRAME_OFFSET - 1] == M17_FRAME_TYPE_PACKET) {
+        // Single sender per stream, so one reassembly key
+        int result = m17_packet_reasm_push(&d_reassembler, 0,
+                                           &d_frame_buffer[M17_PACKET_FRAME_OFFSET], now_ms,
+                                           &d_packet);
+        if (result != 1 ||
+            m17_ax25_bridge_packet_to_ax25(&d_bridge, &d_packet, ax25_data, &ax25_length) != 0) {
+            return;
+        }
+    } else {
+        m17_packet_reasm_expire(&d_reassembler, now_ms);
+        if (m17_ax25_bridge_convert_m17_to_ax25(&d_bridge, d_frame_buffer.data(),
+                                                d_frame_buffer.size(), ax25_data,
+                                                &ax25_length) != 0) {
+            return;
+        }
+    }
+
+    d_output_buffer.insert(d_output_buffer.end(), ax25_data, ax25_data + ax25_length);
+    d_frame_counter++;
+}
+
 void m17_to_ax25_impl::set_destination(const std::string& destination) {
     d_destination = destination;
 
@@ -182,32 +229,16 @@ void m17_to_ax25_impl::handle_control_message(pmt::pmt_t msg) {
     if (pmt::is_dict(msg)) {
         // Handle configuration changes
         if (pmt::dict_has_key(msg, pmt::mp("destination"))) {
-            d_destination =
-                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("destination"), pmt::mp("")));
-            initialize_ax25_frame();
+            set_destination(
+                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("destination"), pmt::mp(""))));
         }
 
         if (pmt::dict_has_key(msg, pmt::mp("callsign"))) {
-            d_callsign =
-                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("callsign"), pmt::mp("")));
-            initialize_ax25_frame();
+            set_callsign(
+                pmt::symbol_to_string(pmt::dict_ref(msg, pmt::mp("callsign"), pmt::mp(""))));
         }
     }
 }
 
-void m17_to_ax25_impl::set_destination(const std::string& destination) {
-    d_destination = destination;
-    initialize_ax25_frame();
-}
-
-void m17_to_ax25_impl::set_callsign(const std::string& callsign) {
-    d_callsign = callsign;
-    initialize_ax25_frame();
-}
-
-void m17_to_ax25_impl::set_fec_enabled(bool enabled) {
-    d_enable_fec = enabled;
-}
-
 } // namespace m17_bridge
 } // namespace gr
@@ -39,6 +39,8 @@ class m17_to_ax25_impl : public m17_to_ax25 {
     int d_frame_counter;                            //!< Frame counter for statistics
     std::vector<uint8_t> d_ax25_frame;              //!< AX.25 frame buffer
     std::vector<uint8_t> d_output_buffer;           //!< Output buffer for converted frames
+    m17_packet_reasm_t d_reassembler;               //!< Rebuilds multi-frame M17 packets
+    m17_packet_t d_packet;                          //!< Last packet reassembled
 
   public:
     /*!
@@ -83,6 +85,11 @@ class m17_to_ax25_impl : public m17_to_ax25 {
     void set_fec_enabled(bool enabled);
 
   private:
+    /*!
+     * \brief Convert one complete bridge frame (marker, type and body)
+     */
+    void process_m17_frame();
+
     /*!
      * \brief Handle control messages
      * \param msg Control message
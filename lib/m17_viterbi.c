@@ -0,0 +1,385 @@
+//--------------------------------------------------------------------
+// M17 Convolutional Code and Soft-Decision Viterbi Decoder
+//
+// K=5 encoder, P1/P2/P3 puncturing and a 16-state Viterbi decoder in
+// scalar, SSE2 and AVX2 forms
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "m17_viterbi.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define M17_VITERBI_HAVE_AVX2 1
+#endif
+
+#define M17_VITERBI_MAX_STEPS    (M17_CONV_MAX_BITS + M17_CONV_TAIL_BITS)
+#define M17_VITERBI_START_PENALTY 4096  // States the encoder cannot start in
+#define M17_VITERBI_RENORM_MASK  7      // Renormalise every eighth step
+
+// State: the last four input bits, most recent in bit 3. Input u moves
+// state s to (u << 3) | (s >> 1), so states 2j and 2j+1 both lead to j
+// (u = 0) and j + 8 (u = 1).
+
+// P1: 1, then 1,0,1,1 fifteen times
+static const uint8_t m17_puncture_p1[61] = {
+    1,
+    1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1,
+    1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1,
+    1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1
+};
+static const uint8_t m17_puncture_p2[12] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 };
+static const uint8_t m17_puncture_p3[8] = { 1, 1, 1, 1, 1, 1, 1, 0 };
+static const uint8_t m17_puncture_none[1] = { 1 };
+
+typedef int32_t (*m17_viterbi_fn)(const int16_t* symbols, uint16_t steps, uint16_t* decisions);
+
+static int32_t m17_viterbi_scalar(const int16_t* symbols, uint16_t steps, uint16_t* decisions);
+#if defined(__SSE2__)
+static int32_t m17_viterbi_sse2(const int16_t* symbols, uint16_t steps, uint16_t* decisions);
+#endif
+#if defined(M17_VITERBI_HAVE_AVX2)
+static int32_t m17_viterbi_avx2(const int16_t* symbols, uint16_t steps, uint16_t* decisions);
+#endif
+
+static pthread_once_t m17_viterbi_once = PTHREAD_ONCE_INIT;
+static m17_viterbi_fn m17_viterbi_run = m17_viterbi_scalar;
+static m17_viterbi_impl_t m17_viterbi_impl = M17_VITERBI_SCALAR;
+
+static void m17_viterbi_pick(void) {
+#if defined(M17_VITERBI_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        m17_viterbi_run = m17_viterbi_avx2;
+        m17_viterbi_impl = M17_VITERBI_AVX2;
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    m17_viterbi_run = m17_viterbi_sse2;
+    m17_viterbi_impl = M17_VITERBI_SSE2;
+#endif
+}
+
+const uint8_t* m17_conv_puncture_pattern(m17_puncture_t puncture, uint16_t* length) {
+    switch (puncture) {
+    case M17_PUNCTURE_NONE:
+        *length = sizeof(m17_puncture_none);
+        return m17_puncture_none;
+    case M17_PUNCTURE_LSF:
+        *length = sizeof(m17_puncture_p1);
+        return m17_puncture_p1;
+    case M17_PUNCTURE_STREAM:
+        *length = sizeof(m17_puncture_p2);
+        return m17_puncture_p2;
+    case M17_PUNCTURE_PACKET:
+        *length = sizeof(m17_puncture_p3);
+        return m17_puncture_p3;
+    }
+    return NULL;
+}
+
+uint16_t m17_conv_coded_bits(m17_puncture_t puncture, uint16_t num_bits) {
+    uint16_t length = 1;
+    const uint8_t* pattern = m17_conv_puncture_pattern(puncture, &length);
+    if (!pattern || num_bits == 0 || num_bits > M17_CONV_MAX_BITS) {
+        return 0;
+    }
+
+    // Whole repetitions of the pattern, then the part of one
+    uint16_t total = 2 * (num_bits + M17_CONV_TAIL_BITS);
+    uint16_t ones = 0;
+    uint16_t partial = 0;
+    for (uint16_t i = 0; i < length; i++) {
+        ones += pattern[i];
+        if (i < total % length) {
+            partial += pattern[i];
+        }
+    }
+    return (total / length) * ones + partial;
+}
+
+int m17_conv_encode(const uint8_t* data, uint16_t num_bits, m17_puncture_t puncture,
+                    uint8_t* coded, size_t coded_size) {
+    uint16_t length = 1;
+    const uint8_t* pattern = m17_conv_puncture_pattern(puncture, &length);
+    uint16_t coded_bits = m17_conv_coded_bits(puncture, num_bits);
+    if (!data || !coded || coded_bits == 0 || coded_size < coded_bits) {
+        return -1;
+    }
+
+    uint8_t state = 0;
+    uint16_t out = 0;
+    uint16_t position = 0;
+    for (uint16_t i = 0; i < num_bits + M17_CONV_TAIL_BITS; i++) {
+        uint8_t u = i < num_bits ? (data[i / 8] >> (7 - i % 8)) & 1 : 0;
+        // G1 = u + D^3 + D^4, G2 = u + D + D^2 + D^4
+        uint8_t g1 = u ^ ((state >> 1) & 1) ^ (state & 1);
+        uint8_t g2 = u ^ ((state >> 3) & 1) ^ ((state >> 2) & 1) ^ (state & 1);
+        state = (uint8_t)((u << 3) | (state >> 1));
+
+        if (pattern[position++ % length]) {
+            coded[out++] = g1;
+        }
+        if (pattern[position++ % length]) {
+            coded[out++] = g2;
+        }
+    }
+    return out;
+}
+
+// Branch metric of the transition from state 2j with input 0; the other
+// three transitions between {2j, 2j+1} and {j, j+8} flip both expected
+// bits, so their metric is this one or its negation
+static inline int16_t m17_viterbi_branch(uint8_t j, int16_t v1, int16_t v2) {
+    int16_t g1 = (j & 1) ? (int16_t)-v1 : v1;
+    int16_t g2 = (((j >> 2) ^ (j >> 1)) & 1) ? (int16_t)-v2 : v2;
+    return g1 + g2;
+}
+
+// Metrics are costs: each symbol adds +v when a 0 was expected and -v
+// when a 1 was, v being the soft bit less 128. State 0's metric is
+// subtracted every eighth step, which keeps every metric within about
+// +/-6000, so the 16-bit forms never saturate and all three
+// implementations make the same decisions. The return value is the
+// final metric of state 0.
+static int32_t m17_viterbi_scalar(const int16_t* symbols, uint16_t steps, uint16_t* decisions) {
+    int32_t metrics[M17_CONV_STATES];
+    int32_t next[M17_CONV_STATES];
+    int32_t offset = 0;
+
+    for (int s = 0; s < M17_CONV_STATES; s++) {
+        metrics[s] = s == 0 ? 0 : M17_VITERBI_START_PENALTY;
+    }
+
+    for (uint16_t t = 0; t < steps; t++) {
+        uint16_t decision = 0;
+        for (uint8_t j = 0; j < 8; j++) {
+            int32_t bm = m17_viterbi_branch(j, symbols[2 * t], symbols[2 * t + 1]);
+            int32_t even = metrics[2 * j];
+            int32_t odd = metrics[2 * j + 1];
+
+            // Input 0 into j, input 1 into j + 8
+            int32_t c0 = even + bm;
+            int32_t c1 = odd - bm;
+            next[j] = c0 > c1 ? c1 : c0;
+            decision |= (uint16_t)(c0 > c1) << j;
+
+            c0 = even - bm;
+            c1 = odd + bm;
+            next[j + 8] = c0 > c1 ? c1 : c0;
+            decision |= (uint16_t)(c0 > c1) << (j + 8);
+        }
+        decisions[t] = decision;
+
+        int32_t norm = (t & M17_VITERBI_RENORM_MASK) == M17_VITERBI_RENORM_MASK ? next[0] : 0;
+        offset += norm;
+        for (int s = 0; s < M17_CONV_STATES; s++) {
+            metrics[s] = next[s] - norm;
+        }
+    }
+    return offset + metrics[0];
+}
+
+#if defined(__SSE2__)
+// Even and odd state metrics of a pair of 8-lane halves
+static inline __m128i m17_viterbi_even_sse2(__m128i lo, __m128i hi) {
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16),
+                           _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+}
+
+static inline __m128i m17_viterbi_odd_sse2(__m128i lo, __m128i hi) {
+    return _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16));
+}
+
+static int32_t m17_viterbi_sse2(const int16_t* symbols, uint16_t steps, uint16_t* decisions) {
+    const __m128i mask1 = _mm_setr_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+    const __m128i mask2 = _mm_setr_epi16(0, 0, -1, -1, -1, -1, 0, 0);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_insert_epi16(_mm_set1_epi16(M17_VITERBI_START_PENALTY), 0, 0);
+    __m128i hi = _mm_set1_epi16(M17_VITERBI_START_PENALTY);
+    int32_t offset = 0;
+
+    for (uint16_t t = 0; t < steps; t++) {
+        __m128i v1 = _mm_set1_epi16(symbols[2 * t]);
+        __m128i v2 = _mm_set1_epi16(symbols[2 * t + 1]);
+        __m128i bm = _mm_add_epi16(_mm_sub_epi16(_mm_xor_si128(v1, mask1), mask1),
+                                   _mm_sub_epi16(_mm_xor_si128(v2, mask2), mask2));
+        __m128i neg = _mm_sub_epi16(zero, bm);
+
+        __m128i even = m17_viterbi_even_sse2(lo, hi);
+        __m128i odd = m17_viterbi_odd_sse2(lo, hi);
+        __m128i c0_lo = _mm_adds_epi16(even, bm);
+        __m128i c1_lo = _mm_adds_epi16(odd, neg);
+        __m128i c0_hi = _mm_adds_epi16(even, neg);
+        __m128i c1_hi = _mm_adds_epi16(odd, bm);
+
+        __m128i d_lo = _mm_cmpgt_epi16(c0_lo, c1_lo);
+        __m128i d_hi = _mm_cmpgt_epi16(c0_hi, c1_hi);
+        decisions[t] = (uint16_t)_mm_movemask_epi8(_mm_packs_epi16(d_lo, d_hi));
+        lo = _mm_min_epi16(c0_lo, c1_lo);
+        hi = _mm_min_epi16(c0_hi, c1_hi);
+
+        if ((t & M17_VITERBI_RENORM_MASK) == M17_VITERBI_RENORM_MASK) {
+            int16_t norm = (int16_t)_mm_cvtsi128_si32(lo);
+            offset += norm;
+            __m128i n = _mm_set1_epi16(norm);
+            lo = _mm_subs_epi16(lo, n);
+            hi = _mm_subs_epi16(hi, n);
+        }
+    }
+    return offset + (int16_t)_mm_cvtsi128_si32(lo);
+}
+#endif
+
+#if defined(M17_VITERBI_HAVE_AVX2)
+__attribute__((target("avx2")))
+static int32_t m17_viterbi_avx2(const int16_t* symbols, uint16_t steps, uint16_t* decisions) {
+    // Lanes are target states; the upper eight take input 1, which flips
+    // the expected bits
+    const __m256i mask1 = _mm256_setr_epi16(0, -1, 0, -1, 0, -1, 0, -1,
+                                            -1, 0, -1, 0, -1, 0, -1, 0);
+    const __m256i mask2 = _mm256_setr_epi16(0, 0, -1, -1, -1, -1, 0, 0,
+                                            -1, -1, 0, 0, 0, 0, -1, -1);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i metrics = _mm256_insert_epi16(_mm256_set1_epi16(M17_VITERBI_START_PENALTY), 0, 0);
+    int32_t offset = 0;
+
+    for (uint16_t t = 0; t < steps; t++) {
+        __m256i v1 = _mm256_set1_epi16(symbols[2 * t]);
+        __m256i v2 = _mm256_set1_epi16(symbols[2 * t + 1]);
+        __m256i bm = _mm256_add_epi16(_mm256_sub_epi16(_mm256_xor_si256(v1, mask1), mask1),
+                                      _mm256_sub_epi16(_mm256_xor_si256(v2, mask2), mask2));
+
+        // Metrics of states 2j and 2j+1, j = 0..7, repeated in both halves
+        __m256i even32 = _mm256_srai_epi32(_mm256_slli_epi32(metrics, 16), 16);
+        __m256i odd32 = _mm256_srai_epi32(metrics, 16);
+        __m256i even = _mm256_permute4x64_epi64(_mm256_packs_epi32(even32, even32),
+                                                _MM_SHUFFLE(2, 0, 2, 0));
+        __m256i odd = _mm256_permute4x64_epi64(_mm256_packs_epi32(odd32, odd32),
+                                               _MM_SHUFFLE(2, 0, 2, 0));
+
+        __m256i c0 = _mm256_adds_epi16(even, bm);
+        __m256i c1 = _mm256_adds_epi16(odd, _mm256_sub_epi16(zero, bm));
+        __m256i d = _mm256_cmpgt_epi16(c0, c1);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_packs_epi16(d, d));
+        decisions[t] = (uint16_t)((mask & 0xFF) | ((mask >> 8) & 0xFF00));
+        metrics = _mm256_min_epi16(c0, c1);
+
+        if ((t & M17_VITERBI_RENORM_MASK) == M17_VITERBI_RENORM_MASK) {
+            int16_t norm = (int16_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(metrics));
+            offset += norm;
+            metrics = _mm256_subs_epi16(metrics, _mm256_set1_epi16(norm));
+        }
+    }
+    return offset + (int16_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(metrics));
+}
+#endif
+
+int32_t m17_viterbi_decode(const uint8_t* soft, uint16_t soft_len, m17_puncture_t puncture,
+                           uint8_t* data, uint16_t num_bits) {
+    uint16_t length = 1;
+    const uint8_t* pattern = m17_conv_puncture_pattern(puncture, &length);
+    if (!soft || !data || soft_len == 0 || soft_len != m17_conv_coded_bits(puncture, num_bits)) {
+        return -1;
+    }
+
+    pthread_once(&m17_viterbi_once, m17_viterbi_pick);
+
+    // Depuncture: punctured positions carry no information
+    int16_t symbols[2 * M17_VITERBI_MAX_STEPS];
+    uint16_t steps = num_bits + M17_CONV_TAIL_BITS;
+    uint16_t in = 0;
+    uint16_t position = 0;
+    int32_t ideal = 0;
+    for (uint16_t i = 0; i < 2 * steps; i++) {
+        int16_t v = 0;
+        if (pattern[position]) {
+            v = (int16_t)soft[in++] - M17_SOFT_ERASURE;
+        }
+        if (++position == length) {
+            position = 0;
+        }
+        symbols[i] = v;
+        ideal -= v < 0 ? -v : v;
+    }
+
+    uint16_t decisions[M17_VITERBI_MAX_STEPS];
+    int32_t metric = m17_viterbi_run(symbols, steps, decisions);
+
+    // The tail returns the encoder to state 0; trace back from there
+    memset(data, 0, (num_bits + 7) / 8);
+    uint8_t state = 0;
+    for (int t = steps - 1; t >= 0; t--) {
+        uint8_t u = state >> 3;
+        if (t < num_bits && u) {
+            data[t / 8] |= 0x80 >> (t % 8);
+        }
+        state = (uint8_t)(((state & 7) << 1) | ((decisions[t] >> state) & 1));
+    }
+    return (metric - ideal) / 2;
+}
+
+int m17_viterbi_set_impl(m17_viterbi_impl_t impl) {
+    if (!m17_viterbi_impl_supported(impl)) {
+        return -1;
+    }
+
+    pthread_once(&m17_viterbi_once, m17_viterbi_pick);
+    switch (impl) {
+    case M17_VITERBI_AUTO:
+        m17_viterbi_run = m17_viterbi_scalar;
+        m17_viterbi_impl = M17_VITERBI_SCALAR;
+        m17_viterbi_pick();
+        break;
+    case M17_VITERBI_SCALAR:
+        m17_viterbi_run = m17_viterbi_scalar;
+        m17_viterbi_impl = impl;
+        break;
+#if defined(__SSE2__)
+    case M17_VITERBI_SSE2:
+        m17_viterbi_run = m17_viterbi_sse2;
+        m17_viterbi_impl = impl;
+        break;
+#endif
+#if defined(M17_VITERBI_HAVE_AVX2)
+    case M17_VITERBI_AVX2:
+        m17_viterbi_run = m17_viterbi_avx2;
+        m17_viterbi_impl = impl;
+        break;
+#endif
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+m17_viterbi_impl_t m17_viterbi_get_impl(void) {
+    pthread_once(&m17_viterbi_once, m17_viterbi_pick);
+    return m17_viterbi_impl;
+}
+
+bool m17_viterbi_impl_supported(m17_viterbi_impl_t impl) {
+    switch (impl) {
+    case M17_VITERBI_AUTO:
+    case M17_VITERBI_SCALAR:
+        return true;
+    case M17_VITERBI_SSE2:
+#if defined(__SSE2__)
+        return true;
+#else
+        return false;
+#endif
+    case M17_VITERBI_AVX2:
+#if defined(M17_VITERBI_HAVE_AVX2)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
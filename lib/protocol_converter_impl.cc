@@ -44,16 +44,22 @@ protocol_converter_impl::protocol_converter_impl(const std::string& m17_callsign
       d_m17_callsign(m17_callsign), d_m17_destination(m17_destination),
       d_ax25_callsign(ax25_callsign), d_ax25_destination(ax25_destination),
       d_enable_fx25(enable_fx25), d_enable_il2p(enable_il2p), d_conversion_mode(CONVERSION_AUTO),
-      d_frame_counter(0), d_error_count(0) {
+      d_frame_counter(0), d_error_count(0), d_route_valid(false) {
     // Set up message ports for control
     message_port_register_in(pmt::mp("control"));
     set_msg_handler(pmt::mp("control"), [this](pmt::pmt_t msg) { handle_control_message(msg); });
 
+    // Packet reassembly slots are allocated once, here
+    if (m17_packet_reasm_init(&d_reassembler, M17_PACKET_REASM_SLOTS,
+                              M17_PACKET_REASM_TIMEOUT_MS) != 0) {
+        throw std::runtime_error("Failed to allocate M17 packet reassembler");
+    }
+
     // Initialize protocol handlers
     initialize_protocol_handlers();
 }
 
-protocol_converter_impl::~protocol_converter_impl() {}
+protocol_converter_impl::~protocol_converter_impl() { m17_packet_reasm_free(&d_reassembler); }
 
 void protocol_converter_impl::initialize_protocol_handlers() {
     // Initialize M17 to AX.25 converter
@@ -110,23 +116,23 @@ int protocol_converter_impl::work(int noutput_items, gr_vector_const_void_star&
 std::vector<uint8_t>
 protocol_converter_impl::convert_m17_to_ax25(const std::vector<uint8_t>& m17_data) {
     std::vector<uint8_t> result;
+    uint64_t now_ms = timer_wheel_clock_ms();
+
+    // Packet frames: 0x5D 0x5F marker, frame type, chunk and metadata byte
+    size_t i = 0;
+    while (i + M17_BRIDGE_PACKET_LEN <= m17_data.size()) {
+        if (m17_data[i] != 0x5D || m17_data[i + 1] != 0x5F ||
+            m17_data[i + 2] != M17_FRAME_TYPE_PACKET) {
+            i++;
+            continue;
+        }
 
-    // Detect M17 frame boundaries
-    for (size_t i = 0; i < m17_data.size(); i++) {
-        if (m17_data[i] == 0x5D) { // M17 sync word
-            // Extract M17 frame
-            std::vector<uint8_t> m17_frame;
-            size_t frame_start = i;
-            size_t frame_end = std::min(i + 48, m17_data.size());
-
-            m17_frame.assign(m17_data.begin() + frame_start, m17_data.begin() + frame_end);
-
-            // Convert to AX.25
-            std::vector<uint8_t> ax25_frame = convert_single_m17_to_ax25(m17_frame);
+        if (m17_packet_reasm_push(&d_reassembler, 0, &m17_data[i + M17_PACKET_FRAME_OFFSET],
+                                  now_ms, &d_packet) == 1) {
+            std::vector<uint8_t> ax25_frame = convert_m17_packet_to_ax25(d_packet);
             result.insert(result.end(), ax25_frame.begin(), ax25_frame.end());
-
-            i = frame_end - 1; // Skip processed frame
         }
+        i += M17_BRIDGE_PACKET_LEN;
     }
 
     return result;
@@ -165,128 +171,116 @@ protocol_converter_impl::convert_ax25_to_m17(const std::vector<uint8_t>& ax25_da
     return result;
 }
 
-std::vector<uint8_t>
-protocol_converter_impl::convert_single_m17_to_ax25(const std::vector<uint8_t>& m17_frame) {
-    if (m17_frame.size() < 48) {
-        return {}; // Incomplete frame
+std::vector<uint8_t> protocol_converter_impl::wrap_ax25_frame(const uint8_t* frame,
+                                                              uint16_t length) {
+    // Flags and FCS around addresses through information field
+    if (length < 2 * AX25_ADDR_LEN + 1) {
+        return {};
     }
-
-    // Extract M17 payload
-    std::vector<uint8_t> payload;
-    payload.assign(m17_frame.begin() + 2, m17_frame.end() - 2); // Skip sync and CRC
-
-    // Create AX.25 frame
-    std::vector<uint8_t> ax25_frame;
-
-    // AX.25 header
-    ax25_frame.push_back(0x7E); // Opening flag
-
-    // Destination address
-    std::string dest = d_ax25_destination;
-    dest.resize(6, ' ');
-    for (size_t i = 0; i < 6; i++) {
-        ax25_frame.push_back(dest[i] << 1);
-    }
-    ax25_frame.push_back(0x00); // SSID
-
-    // Source address
-    std::string src = d_ax25_callsign;
-    src.resize(6, ' ');
-    for (size_t i = 0; i < 6; i++) {
-        ax25_frame.push_back(src[i] << 1);
-    }
-    ax25_frame.push_back(0x60); // SSID
-
-    // Control field
-    ax25_frame.push_back(0x03); // I-frame
-
-    // PID
-    ax25_frame.push_back(0xF0);
-
-    // Information field (M17 payload)
-    ax25_frame.insert(ax25_frame.end(), payload.begin(), payload.end());
-
-    // Calculate FCS
-    uint16_t fcs = calculate_ax25_fcs(ax25_frame);
-    ax25_frame.push_back(fcs & 0xFF);
-    ax25_frame.push_back((fcs >> 8) & 0xFF);
-
-    // Closing flag
-    ax25_frame.push_back(0x7E);
-
+    std::vector<uint8_t> ax25_frame(length + 4);
+    ax25_frame[0] = 0x7E;
+    memcpy(&ax25_frame[1], frame, length);
+    uint16_t fcs = ax25_calculate_fcs(frame, length);
+    ax25_frame[length + 1] = fcs & 0xFF;
+    ax25_frame[length + 2] = (fcs >> 8) & 0xFF;
+    ax25_frame[length + 3] = 0x7E;
     return ax25_frame;
 }
 
 std::vector<uint8_t>
-protocol_converter_impl::convert_single_ax25_to_m17(const std::vector<uint8_t>& ax25_frame) {
-    if (ax25_frame.size() < 10) {
-        return {}; // Incomplete frame
+protocol_converter_impl::convert_m17_packet_to_ax25(const m17_packet_t& packet) {
+    if (packet.protocol == M17_PACKET_PROTO_AX25) {
+        // The packet is the AX.25 frame itself
+        return wrap_ax25_frame(packet.data, packet.length);
     }
 
-    // Extract AX.25 information field
-    std::vector<uint8_t> payload;
-    size_t header_size = 14; // Destination + source + control + PID
-    if (ax25_frame.size() > header_size + 2) {
-        payload.assign(ax25_frame.begin() + header_size, ax25_frame.end() - 3); // Skip FCS and flag
+    if (packet.protocol == M17_PACKET_PROTO_AX25_BATCH) {
+        // Aggregated frames; a malformed container is dropped whole
+        std::vector<uint8_t> result;
+        uint16_t offset = 0;
+        const uint8_t* frame;
+        uint16_t length;
+        int status;
+        while ((status = m17_packet_batch_next(&packet, &offset, &frame, &length)) == 1) {
+            std::vector<uint8_t> ax25_frame = wrap_ax25_frame(frame, length);
+            if (ax25_frame.empty()) {
+                return {};
+            }
+            result.insert(result.end(), ax25_frame.begin(), ax25_frame.end());
+        }
+        if (status < 0) {
+            return {};
+        }
+        return result;
     }
 
-    // Create M17 frame
-    std::vector<uint8_t> m17_frame;
-
-    // M17 sync word
-    m17_frame.push_back(0x5D);
-
-    // Frame type
-    m17_frame.push_back(0x00);
-
-    // Payload
-    m17_frame.insert(m17_frame.end(), payload.begin(), payload.end());
-
-    // Pad to M17 frame size
-    while (m17_frame.size() < 48) {
-        m17_frame.push_back(0x00);
+    if (packet.length > AX25_MAX_INFO) {
+        return {};
+    }
+    const uint8_t* payload = packet.data;
+    uint16_t payload_len = packet.length;
+
+    std::lock_guard<std::mutex> lock(d_route_mutex);
+    if (!d_route_valid) {
+        build_route_header();
+        if (!d_route_valid) {
+            return {};
+        }
     }
 
-    // Calculate M17 CRC
-    uint16_t crc = calculate_m17_crc(m17_frame);
-    m17_frame.push_back(crc & 0xFF);
-    m17_frame.push_back((crc >> 8) & 0xFF);
+    // Flag, cached header, information field (M17 payload), FCS and flag
+    std::vector<uint8_t> ax25_frame(1 + d_route_header.length + payload_len + 3);
+    uint8_t* out = ax25_frame.data();
+    *out++ = 0x7E; // Opening flag
+    memcpy(out, d_route_header.bytes, d_route_header.length);
+    out += d_route_header.length;
+    memcpy(out, payload, payload_len);
+    out += payload_len;
+
+    // Only the payload runs through the CRC; the header is in fcs_state
+    uint16_t fcs = ax25_fcs_update(d_route_header.fcs_state, payload, payload_len) ^ 0xFFFF;
+    *out++ = fcs & 0xFF;
+    *out++ = (fcs >> 8) & 0xFF;
+    *out = 0x7E; // Closing flag
 
-    return m17_frame;
+    return ax25_frame;
 }
 
-uint16_t protocol_converter_impl::calculate_ax25_fcs(const std::vector<uint8_t>& frame) {
-    uint16_t fcs = 0xFFFF;
+void protocol_converter_impl::build_route_header() {
+    // UI command frame: the command bit is set in the destination address
+    ax25_address_t addresses[2];
+    ax25_set_address(&addresses[0], d_ax25_destination.c_str(), 0, true);
+    ax25_set_address(&addresses[1], d_ax25_callsign.c_str(), 0, false);
+    d_route_valid = ax25_header_template_init(&d_route_header, addresses, 2,
+                                              AX25_CTRL_UI, AX25_PID_NONE) == 0;
+}
 
-    for (uint8_t byte : frame) {
-        fcs ^= byte;
-        for (int i = 0; i < 8; i++) {
-            if (fcs & 0x0001) {
-                fcs = (fcs >> 1) ^ 0x8408;
-            } else {
-                fcs >>= 1;
-            }
-        }
+std::vector<uint8_t>
+protocol_converter_impl::convert_single_ax25_to_m17(const std::vector<uint8_t>& ax25_frame) {
+    // Opening flag, two addresses, control field, FCS and closing flag
+    if (ax25_frame.size() < 1 + 2 * AX25_ADDR_LEN + 1 + 3) {
+        return {}; // Incomplete frame
     }
 
-    return fcs ^ 0xFFFF;
-}
-
-uint16_t protocol_converter_impl::calculate_m17_crc(const std::vector<uint8_t>& frame) {
-    uint16_t crc = 0xFFFF;
+    // The whole frame between the flags, less its FCS, as one M17 packet
+    uint8_t frames[M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN];
+    int count = m17_packet_encode(M17_PACKET_PROTO_AX25, ax25_frame.data() + 1,
+                                  ax25_frame.size() - 4, frames, sizeof(frames));
+    if (count < 0) {
+        return {};
+    }
 
-    for (uint8_t byte : frame) {
-        crc ^= (byte << 8);
-        for (int i = 0; i < 8; i++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
-            }
-        }
+    std::vector<uint8_t> m17_frames;
+    m17_frames.reserve(count * M17_BRIDGE_PACKET_LEN);
+    for (int i = 0; i < count; i++) {
+        const uint8_t* frame = &frames[i * M17_PACKET_FRAME_LEN];
+        m17_frames.push_back(0x5D);
+        m17_frames.push_back(0x5F);
+        m17_frames.push_back(M17_FRAME_TYPE_PACKET);
+        m17_frames.insert(m17_frames.end(), frame, frame + M17_PACKET_FRAME_LEN);
     }
 
-    return crc;
+    return m17_frames;
 }
 
 void protocol_converter_impl::handle_control_message(pmt::pmt_t msg) {
@@ -318,11 +312,15 @@ void protocol_converter_impl::set_m17_destination(const std::string& destination
 }
 
 void protocol_converter_impl::set_ax25_callsign(const std::string& callsign) {
+    std::lock_guard<std::mutex> lock(d_route_mutex);
     d_ax25_callsign = callsign;
+    d_route_valid = false;
 }
 
 void protocol_converter_impl::set_ax25_destination(const std::string& destination) {
+    std::lock_guard<std::mutex> lock(d_route_mutex);
     d_ax25_destination = destination;
+    d_route_valid = false;
 }
 
 void protocol_converter_impl::set_fx25_enabled(bool enabled) {
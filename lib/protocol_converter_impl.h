@@ -0,0 +1,127 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_PROTOCOL_CONVERTER_IMPL_H
+#define INCLUDED_M17_BRIDGE_PROTOCOL_CONVERTER_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <ax25_protocol.h>
+#include <ax25_to_m17.h>
+#include <callsign_mapper.h>
+#include <m17_packet.h>
+#include <m17_to_ax25.h>
+#include <protocol_converter.h>
+#include <pmt/pmt.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of the bidirectional M17/AX.25 protocol converter
+ * \ingroup m17_bridge
+ *
+ * The AX.25 header of the configured route (destination, source, control
+ * and PID) is encoded once together with the FCS register after it. Each converted frame is then a copy of the cached header plus
+ * a CRC pass over the payload. The setters invalidate the cached header.
+ */
+class protocol_converter_impl : public protocol_converter {
+  private:
+    std::string d_m17_callsign;              //!< M17 source callsign
+    std::string d_m17_destination;           //!< M17 destination callsign
+    std::string d_ax25_callsign;             //!< AX.25 source callsign
+    std::string d_ax25_destination;          //!< AX.25 destination callsign
+    bool d_enable_fx25;                      //!< Enable FX.25 Forward Error Correction
+    bool d_enable_il2p;                      //!< Enable IL2P protocol support
+    conversion_mode_t d_conversion_mode;     //!< Active conversion direction(s)
+    int d_frame_counter;                     //!< Frame counter for statistics
+    int d_error_count;                       //!< Conversion error counter
+    m17_to_ax25::sptr d_m17_to_ax25;         //!< M17 to AX.25 converter
+    ax25_to_m17::sptr d_ax25_to_m17;         //!< AX.25 to M17 converter
+    callsign_mapper::sptr d_callsign_mapper; //!< Callsign mapper
+    std::mutex d_route_mutex;                //!< Protects the route and its cached header
+    ax25_header_template_t d_route_header;   //!< Cached AX.25 header for the route
+    bool d_route_valid;                      //!< Cached header matches the route
+    m17_packet_reasm_t d_reassembler;        //!< Rebuilds multi-frame M17 packets
+    m17_packet_t d_packet;                   //!< Last packet reassembled
+
+  public:
+    /*!
+     * \brief Constructor for the protocol converter
+     * \param m17_callsign M17 source callsign
+     * \param m17_destination M17 destination callsign
+     * \param ax25_callsign AX.25 source callsign
+     * \param ax25_destination AX.25 destination callsign
+     * \param enable_fx25 Enable FX.25 Forward Error Correction
+     * \param enable_il2p Enable IL2P protocol support
+     */
+    protocol_converter_impl(const std::string& m17_callsign,
+                            const std::string& m17_destination,
+                            const std::string& ax25_callsign,
+                            const std::string& ax25_destination,
+                            bool enable_fx25,
+                            bool enable_il2p);
+
+    /*!
+     * \brief Destructor
+     */
+    ~protocol_converter_impl();
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int work(int noutput_items, gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+    void set_conversion_mode(conversion_mode_t mode);
+    void set_m17_callsign(const std::string& callsign);
+    void set_m17_destination(const std::string& destination);
+    void set_ax25_callsign(const std::string& callsign);
+    void set_ax25_destination(const std::string& destination);
+    void set_fx25_enabled(bool enabled);
+    void set_il2p_enabled(bool enabled);
+
+  private:
+    /*!
+     * \brief Create the per-direction converters and the callsign mapper
+     */
+    void initialize_protocol_handlers();
+
+    /*!
+     * \brief Encode the route header and its FCS prefix state
+     *
+     * Caller holds d_route_mutex.
+     */
+    void build_route_header();
+
+    std::vector<uint8_t> convert_m17_to_ax25(const std::vector<uint8_t>& m17_data);
+    std::vector<uint8_t> convert_ax25_to_m17(const std::vector<uint8_t>& ax25_data);
+    std::vector<uint8_t> convert_m17_packet_to_ax25(const m17_packet_t& packet);
+    std::vector<uint8_t> wrap_ax25_frame(const uint8_t* frame, uint16_t length);
+    std::vector<uint8_t> convert_single_ax25_to_m17(const std::vector<uint8_t>& ax25_frame);
+
+    /*!
+     * \brief Handle control messages
+     * \param msg Control message
+     */
+    void handle_control_message(pmt::pmt_t msg);
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_PROTOCOL_CONVERTER_IMPL_H */
@@ -0,0 +1,91 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "sync_correlator_impl.h"
+
+#include <cstring>
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Create M17 sync correlator block
+ * \param threshold Lowest normalised correlation reported (0..1)
+ * \return Shared pointer to the correlator block
+ */
+sync_correlator::sptr sync_correlator::make(float threshold) {
+    return gnuradio::make_block_sptr<sync_correlator_impl>(threshold);
+}
+
+static float sync_correlator_check_threshold(float threshold) {
+    if (!(threshold > 0.0f && threshold <= 1.0f)) {
+        throw std::invalid_argument("sync_correlator: threshold must be in (0, 1]");
+    }
+    return threshold;
+}
+
+sync_correlator_impl::sync_correlator_impl(float threshold)
+    : gr::sync_block("sync_correlator", gr::io_signature::make(1, 1, sizeof(float)),
+                     gr::io_signature::make(1, 1, sizeof(float))),
+      d_threshold(sync_correlator_check_threshold(threshold)), d_syncs_found(0),
+      d_sync_key(pmt::mp("m17_sync")) {
+    const char* names[M17_SYNC_TYPES] = { "lsf", "stream", "packet", "bert" };
+    for (int s = 0; s < M17_SYNC_TYPES; s++) {
+        d_sync_names[s] = pmt::mp(names[s]);
+    }
+    m17_sync_search_init(&d_search);
+
+    // One extra window past the last output, to see whether it peaks
+    set_history(M17_SYNC_SYMBOLS + 1);
+}
+
+sync_correlator_impl::~sync_correlator_impl() {}
+
+int sync_correlator_impl::work(int noutput_items, gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items) {
+    const float* in = (const float*)input_items[0];
+    float* out = (float*)output_items[0];
+
+    // Window i starts at output i; the search also scores window
+    // noutput_items to decide whether the last output peaks
+    d_hits.resize(M17_SYNC_MAX_HITS(noutput_items));
+    int found = m17_sync_search(&d_search, in, noutput_items, d_threshold, d_hits.data(),
+                                d_hits.size());
+    for (int h = 0; h < found; h++) {
+        const m17_sync_hit_t& hit = d_hits[h];
+        pmt::pmt_t value = pmt::cons(d_sync_names[hit.type], pmt::from_double(hit.strength));
+        add_item_tag(0, nitems_written(0) + hit.offset, d_sync_key, value);
+        d_syncs_found++;
+    }
+
+    memcpy(out, in, noutput_items * sizeof(float));
+    return noutput_items;
+}
+
+void sync_correlator_impl::set_threshold(float threshold) {
+    d_threshold = sync_correlator_check_threshold(threshold);
+}
+
+float sync_correlator_impl::threshold() const {
+    return d_threshold;
+}
+
+uint64_t sync_correlator_impl::syncs_found() const {
+    return d_syncs_found;
+}
+
+} // namespace m17_bridge
+} // namespace gr
@@ -0,0 +1,72 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_IMPL_H
+#define INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <m17_sync.h>
+#include <pmt/pmt.h>
+#include <sync_correlator.h>
+
+#include <atomic>
+#include <vector>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of the M17 sync correlator
+ * \ingroup m17_bridge
+ *
+ * The search itself is m17_sync_search(), which carries the peak
+ * state from one work buffer to the next; this block tags its peaks
+ * and passes the symbols through.
+ */
+class sync_correlator_impl : public sync_correlator {
+  private:
+    std::atomic<float> d_threshold;           //!< Lowest correlation reported
+    std::atomic<uint64_t> d_syncs_found;      //!< Sync words tagged so far
+    m17_sync_search_t d_search;               //!< Search state across work calls
+    pmt::pmt_t d_sync_names[M17_SYNC_TYPES];  //!< Tag value of each sync word
+    pmt::pmt_t d_sync_key;                    //!< Tag key
+    std::vector<m17_sync_hit_t> d_hits;       //!< Peaks found in one work call
+
+  public:
+    /*!
+     * \brief Constructor for the sync correlator
+     * \param threshold Lowest normalised correlation reported
+     */
+    sync_correlator_impl(float threshold);
+
+    /*!
+     * \brief Destructor
+     */
+    ~sync_correlator_impl();
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int work(int noutput_items, gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+    void set_threshold(float threshold);
+    float threshold() const;
+    uint64_t syncs_found() const;
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_SYNC_CORRELATOR_IMPL_H */
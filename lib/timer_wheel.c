@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------
+// Hierarchical Timer Wheel
+//
+// O(1) arm/cancel/expire protocol timers
+//
+// M17 Bridge Project
+//--------------------------------------------------------------------
+#include "timer_wheel.h"
+#include <string.h>
+#include <time.h>
+
+#define TIMER_WHEEL_MASK  (TIMER_WHEEL_SLOTS - 1)
+
+// Start an empty wheel at now_ms
+int timer_wheel_init(timer_wheel_t* wheel, uint32_t tick_ms, uint64_t now_ms) {
+    if (!wheel || tick_ms == 0) {
+        return -1;
+    }
+
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->tick_ms = tick_ms;
+    wheel->base_ms = now_ms;
+    return 0;
+}
+
+void timer_wheel_timer_init(timer_wheel_timer_t* timer, timer_wheel_cb_t callback, void* ctx) {
+    if (!timer) {
+        return;
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->callback = callback;
+    timer->ctx = ctx;
+}
+
+bool timer_wheel_armed(const timer_wheel_timer_t* timer) {
+    return timer && timer->pprev != NULL;
+}
+
+// File a timer by its distance from the current tick. Slots are indexed
+// by absolute expiry, so a timer on level l is picked up when the level
+// l-1 wheel wraps onto its slot, which is less than one level l-1 turn
+// before it is due.
+static void timer_wheel_place(timer_wheel_t* wheel, timer_wheel_timer_t* timer) {
+    uint64_t expires = timer->expires;
+    uint64_t delta = expires - wheel->tick;
+    if (delta >= TIMER_WHEEL_RANGE) {
+        expires = wheel->tick + TIMER_WHEEL_RANGE - 1; // Re-filed when this slot comes round
+        delta = TIMER_WHEEL_RANGE - 1;
+    }
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           (delta >> (TIMER_WHEEL_SLOT_BITS * (level + 1))) != 0) {
+        level++;
+    }
+    unsigned slot = (expires >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_MASK;
+
+    timer_wheel_timer_t** head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (*head) {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+    wheel->occupied[level] |= 1ULL << slot;
+}
+
+// Unlink without touching the occupancy bitmap (cleared lazily)
+static void timer_wheel_unlink(timer_wheel_timer_t* timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+int timer_wheel_arm(timer_wheel_t* wheel, timer_wheel_timer_t* timer, uint32_t delay_ms) {
+    if (!wheel || !timer || !timer->callback) {
+        return -1;
+    }
+
+    if (timer->pprev) {
+        timer_wheel_unlink(timer);
+    } else {
+        wheel->armed++;
+    }
+
+    uint64_t ticks = (delay_ms + wheel->tick_ms - 1) / wheel->tick_ms;
+    timer->expires = wheel->tick + (ticks ? ticks : 1);
+    timer_wheel_place(wheel, timer);
+    return 0;
+}
+
+void timer_wheel_cancel(timer_wheel_t* wheel, timer_wheel_timer_t* timer) {
+    if (!wheel || !timer || !timer->pprev) {
+        return;
+    }
+
+    timer_wheel_unlink(timer);
+    wheel->armed--;
+}
+
+// Move every timer of a coarse slot to the finer wheels
+static void timer_wheel_cascade(timer_wheel_t* wheel, int level, unsigned slot) {
+    timer_wheel_timer_t* timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(1ULL << slot);
+
+    while (timer) {
+        timer_wheel_timer_t* next = timer->next;
+        timer->pprev = NULL;
+        timer_wheel_place(wheel, timer);
+        wheel->stats.cascaded++;
+        timer = next;
+    }
+}
+
+// Process one tick: cascade the coarse slots that come due (top level
+// first, so re-filed timers land in slots not yet visited), then run the
+// level 0 slot. Callbacks are taken one at a time from the slot itself, so
+// they may cancel or re-arm any timer, including others due now.
+static int timer_wheel_step(timer_wheel_t* wheel) {
+    uint64_t tick = ++wheel->tick;
+    wheel->stats.ticks++;
+
+    for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        uint64_t below = (1ULL << (TIMER_WHEEL_SLOT_BITS * level)) - 1;
+        if ((tick & below) != 0) {
+            continue;
+        }
+        unsigned slot = (tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_MASK;
+        if (wheel->occupied[level] & (1ULL << slot)) {
+            timer_wheel_cascade(wheel, level, slot);
+        }
+    }
+
+    unsigned slot = tick & TIMER_WHEEL_MASK;
+    if (!(wheel->occupied[0] & (1ULL << slot))) {
+        return 0;
+    }
+
+    int expired = 0;
+    timer_wheel_timer_t** head = &wheel->slots[0][slot];
+    while (*head) {
+        timer_wheel_timer_t* timer = *head;
+        timer_wheel_unlink(timer);
+        wheel->armed--;
+        wheel->stats.expired++;
+        expired++;
+        timer->callback(timer->ctx, timer);
+    }
+    if (!wheel->slots[0][slot]) {
+        wheel->occupied[0] &= ~(1ULL << slot);
+    }
+    return expired;
+}
+
+// Run the wheel up to now_ms
+int timer_wheel_advance(timer_wheel_t* wheel, uint64_t now_ms) {
+    if (!wheel) {
+        return -1;
+    }
+
+    if (now_ms < wheel->base_ms) {
+        return 0;
+    }
+    uint64_t target = (now_ms - wheel->base_ms) / wheel->tick_ms;
+
+    int expired = 0;
+    while (wheel->tick < target) {
+        if (wheel->armed == 0) {
+            // Nothing can fire; skip the idle ticks
+            wheel->stats.ticks += target - wheel->tick;
+            wheel->tick = target;
+            break;
+        }
+        expired += timer_wheel_step(wheel);
+    }
+    return expired;
+}
+
+uint64_t timer_wheel_now(const timer_wheel_t* wheel) {
+    return wheel ? wheel->base_ms + wheel->tick * wheel->tick_ms : 0;
+}
+
+// Get statistics
+int timer_wheel_get_stats(const timer_wheel_t* wheel, timer_wheel_stats_t* stats) {
+    if (!wheel || !stats) {
+        return -1;
+    }
+
+    *stats = wheel->stats;
+    return 0;
+}
+
+uint64_t timer_wheel_clock_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
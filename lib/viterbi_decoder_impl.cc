@@ -0,0 +1,108 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "viterbi_decoder_impl.h"
+
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Create M17 Viterbi decoder block
+ * \param frame_type LSF, stream or packet frames
+ * \return Shared pointer to the decoder block
+ */
+viterbi_decoder::sptr viterbi_decoder::make(int frame_type) {
+    return gnuradio::make_block_sptr<viterbi_decoder_impl>(frame_type);
+}
+
+bool viterbi_decoder_impl::frame_parameters(int frame_type, m17_puncture_t* puncture,
+                                            int* payload_bits) {
+    switch (frame_type) {
+    case FRAME_LSF:
+        *puncture = M17_PUNCTURE_LSF;
+        *payload_bits = M17_LSF_PAYLOAD_BITS;
+        return true;
+    case FRAME_STREAM:
+        *puncture = M17_PUNCTURE_STREAM;
+        *payload_bits = M17_STREAM_PAYLOAD_BITS;
+        return true;
+    case FRAME_PACKET:
+        *puncture = M17_PUNCTURE_PACKET;
+        *payload_bits = M17_PACKET_PAYLOAD_BITS;
+        return true;
+    }
+    return false;
+}
+
+static int viterbi_decoder_coded_bits(int frame_type) {
+    m17_puncture_t puncture;
+    int payload_bits;
+    if (!viterbi_decoder_impl::frame_parameters(frame_type, &puncture, &payload_bits)) {
+        throw std::invalid_argument("viterbi_decoder: unknown frame type " +
+                                    std::to_string(frame_type));
+    }
+    return m17_conv_coded_bits(puncture, payload_bits);
+}
+
+static int viterbi_decoder_payload_bytes(int frame_type) {
+    m17_puncture_t puncture;
+    int payload_bits = 0;
+    viterbi_decoder_impl::frame_parameters(frame_type, &puncture, &payload_bits);
+    return (payload_bits + 7) / 8;
+}
+
+viterbi_decoder_impl::viterbi_decoder_impl(int frame_type)
+    : gr::sync_block("viterbi_decoder",
+                     gr::io_signature::make(1, 1, viterbi_decoder_coded_bits(frame_type)),
+                     gr::io_signature::make(1, 1, viterbi_decoder_payload_bytes(frame_type))),
+      d_last_cost(0), d_cost_key(pmt::mp("viterbi_cost")) {
+    frame_parameters(frame_type, &d_puncture, &d_payload_bits);
+    d_coded_bits = m17_conv_coded_bits(d_puncture, d_payload_bits);
+}
+
+viterbi_decoder_impl::~viterbi_decoder_impl() {}
+
+int viterbi_decoder_impl::work(int noutput_items, gr_vector_const_void_star& input_items,
+                               gr_vector_void_star& output_items) {
+    const uint8_t* in = (const uint8_t*)input_items[0];
+    uint8_t* out = (uint8_t*)output_items[0];
+    int payload_bytes = (d_payload_bits + 7) / 8;
+
+    for (int i = 0; i < noutput_items; i++) {
+        int32_t cost = m17_viterbi_decode(&in[i * d_coded_bits], d_coded_bits, d_puncture,
+                                          &out[i * payload_bytes], d_payload_bits);
+        d_last_cost = cost;
+        add_item_tag(0, nitems_written(0) + i, d_cost_key, pmt::from_long(cost));
+    }
+
+    return noutput_items;
+}
+
+int viterbi_decoder_impl::coded_bits() const {
+    return d_coded_bits;
+}
+
+int viterbi_decoder_impl::payload_bytes() const {
+    return (d_payload_bits + 7) / 8;
+}
+
+int viterbi_decoder_impl::last_cost() const {
+    return d_last_cost;
+}
+
+} // namespace m17_bridge
+} // namespace gr
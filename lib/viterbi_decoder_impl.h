@@ -0,0 +1,76 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#ifndef INCLUDED_M17_BRIDGE_VITERBI_DECODER_IMPL_H
+#define INCLUDED_M17_BRIDGE_VITERBI_DECODER_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <m17_viterbi.h>
+#include <pmt/pmt.h>
+#include <viterbi_decoder.h>
+
+#include <atomic>
+
+namespace gr {
+namespace m17_bridge {
+
+/*!
+ * \brief Implementation of the M17 Viterbi decoder
+ * \ingroup m17_bridge
+ *
+ * One input vector of soft bits becomes one output vector of payload
+ * bytes; the decoding itself is m17_viterbi_decode, which runs the AVX2
+ * or SSE2 form when the CPU has it.
+ */
+class viterbi_decoder_impl : public viterbi_decoder {
+  private:
+    m17_puncture_t d_puncture;    //!< Puncture pattern of the frame type
+    int d_payload_bits;           //!< Decoded bits per frame
+    int d_coded_bits;             //!< Soft bits per frame
+    std::atomic<int> d_last_cost; //!< Path cost of the last frame
+    pmt::pmt_t d_cost_key;        //!< Tag key for the path cost
+
+  public:
+    /*!
+     * \brief Constructor for the Viterbi decoder
+     * \param frame_type LSF, stream or packet frames
+     */
+    viterbi_decoder_impl(int frame_type);
+
+    /*!
+     * \brief Destructor
+     */
+    ~viterbi_decoder_impl();
+
+    /*!
+     * \brief Main processing function
+     * \param noutput_items Number of output items to produce
+     * \param input_items Input data
+     * \param output_items Output data
+     * \return Number of items produced
+     */
+    int work(int noutput_items, gr_vector_const_void_star& input_items,
+             gr_vector_void_star& output_items);
+
+    int coded_bits() const;
+    int payload_bytes() const;
+    int last_cost() const;
+
+    /*!
+     * \brief Puncture pattern and payload size of a frame type
+     * \return false for an unknown frame type
+     */
+    static bool frame_parameters(int frame_type, m17_puncture_t* puncture, int* payload_bits);
+};
+
+} // namespace m17_bridge
+} // namespace gr
+
+#endif /* INCLUDED_M17_BRIDGE_VITERBI_DECODER_IMPL_H */
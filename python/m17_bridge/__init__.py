@@ -7,10 +7,16 @@ from .m17_to_ax25 import m17_to_ax25
 from .ax25_to_m17 import ax25_to_m17
 from .protocol_converter import protocol_converter
 from .callsign_mapper import callsign_mapper
+from .viterbi_decoder import viterbi_decoder
+from .channel_encoder import channel_encoder
+from .sync_correlator import sync_correlator
 
 __all__ = [
     'm17_to_ax25',
     'ax25_to_m17', 
     'protocol_converter',
-    'callsign_mapper'
+    'callsign_mapper',
+    'viterbi_decoder',
+    'channel_encoder',
+    'sync_correlator'
 ]
@@ -21,10 +21,13 @@ class ax25_to_m17(gr.hier_block2):
         callsign (str): Source callsign for M17 frames (default: "N0CALL")
         destination (str): Destination callsign for M17 frames (default: "APRS")
         enable_fec (bool): Enable FX.25 Forward Error Correction (default: False)
+        batch_window_ms (int): Batching window in ms, 0 to send every frame
+            on its own (default: 0)
+        batch_max_bytes (int): Largest aggregated M17 packet (default: 822)
     """
     
     def __init__(self, callsign="N0CALL", destination="APRS",
-                 enable_fec=False):
+                 enable_fec=False, batch_window_ms=0, batch_max_bytes=822):
         """
         Initialize the AX.25 to M17 converter.
         
@@ -32,6 +35,8 @@ class ax25_to_m17(gr.hier_block2):
             callsign (str): Source callsign for M17 frames
             destination (str): Destination callsign for M17 frames
             enable_fec (bool): Enable FX.25 Forward Error Correction
+            batch_window_ms (int): Batching window in milliseconds
+            batch_max_bytes (int): Largest aggregated M17 packet in bytes
         """
         gr.hier_block2.__init__(
             self, "ax25_to_m17",
@@ -40,7 +45,7 @@ class ax25_to_m17(gr.hier_block2):
         )
         
         self.ax25_to_m17 = m17_bridge_swig.ax25_to_m17_make(
-            callsign, destination, enable_fec)
+            callsign, destination, enable_fec, batch_window_ms, batch_max_bytes)
         
         self.connect((self, 0), (self.ax25_to_m17, 0))
         self.connect((self.ax25_to_m17, 0), (self, 0))
@@ -72,3 +77,30 @@ class ax25_to_m17(gr.hier_block2):
         """
         self.ax25_to_m17.set_fec_enabled(enabled)
     
+    def set_batch_window(self, window_ms):
+        """
+        Set the batching window.
+        
+        Args:
+            window_ms (int): Milliseconds a frame may wait to share an M17
+                packet with others; 0 disables batching
+        """
+        self.ax25_to_m17.set_batch_window(window_ms)
+    
+    def set_batch_max_bytes(self, max_bytes):
+        """
+        Set the largest aggregated M17 packet.
+        
+        Args:
+            max_bytes (int): Container limit in bytes (3..822)
+        """
+        self.ax25_to_m17.set_batch_max_bytes(max_bytes)
+    
+    def airtime_saved_ms(self):
+        """
+        Get the airtime saved by batching.
+        
+        Returns:
+            int: Milliseconds of preamble, LSF and EOT not sent
+        """
+        return self.ax25_to_m17.airtime_saved_ms()
@@ -12,17 +12,23 @@ class callsign_mapper(gr.hier_block2):
     Callsign mapping between M17 and AX.25 protocols
     """
     
-    def __init__(self):
+    def __init__(self, auto_mapping_capacity=1024):
         gr.hier_block2.__init__(
             self, "callsign_mapper",
             gr.io_signature(1, 1, gr.sizeof_char),
             gr.io_signature(1, 1, gr.sizeof_char)
         )
         
-        self.callsign_mapper = m17_bridge_swig.callsign_mapper_make()
+        self.callsign_mapper = m17_bridge_swig.callsign_mapper_make(auto_mapping_capacity)
         
         self.connect((self, 0), (self.callsign_mapper, 0))
         self.connect((self.callsign_mapper, 0), (self, 0))
+        
+        # Control messages (e.g. get_stats) in, cache statistics out
+        self.message_port_register_hier_in("control")
+        self.message_port_register_hier_out("stats")
+        self.msg_connect(self, "control", self.callsign_mapper, "control")
+        self.msg_connect(self.callsign_mapper, "stats", self, "stats")
     
     def add_mapping(self, m17_callsign, ax25_callsign):
         """Add a callsign mapping"""
@@ -48,8 +54,16 @@ class callsign_mapper(gr.hier_block2):
         """Check if auto-mapping is enabled"""
         return self.callsign_mapper.is_auto_mapping_enabled()
     
+    def set_auto_mapping_capacity(self, capacity):
+        """Set the maximum number of auto-generated mappings"""
+        self.callsign_mapper.set_auto_mapping_capacity(capacity)
+    
+    def auto_mapping_capacity(self):
+        """Get the maximum number of auto-generated mappings"""
+        return self.callsign_mapper.auto_mapping_capacity()
+    
     def get_mapping_table(self):
-        """Get the current mapping table"""
+        """Get the pinned (manual) mapping table"""
         return self.callsign_mapper.get_mapping_table()
     
     def clear_mappings(self):
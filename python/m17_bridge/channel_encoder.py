@@ -0,0 +1,42 @@
+# -*- coding: utf-8 -*-
+"""
+M17 channel encoder hierarchical block.
+
+This module provides a GNU Radio hierarchical block for turning M17
+frame payloads into dibits for a 4FSK modulator.
+"""
+
+from gnuradio import gr
+from . import m17_bridge_swig as m17_bridge_swig
+
+
+class channel_encoder(gr.hier_block2):
+    """
+    M17 transmit channel encoder.
+    
+    Each input item is one frame's payload; each output item is the
+    frame's 192 dibits (0..3), sync word included.
+    
+    Args:
+        frame_type (int): 0 for the LSF, 1 for stream frames (Golay-coded
+            LICH chunk, then payload), 2 for packet frames (default: 2)
+    """
+    
+    def __init__(self, frame_type=2):
+        """
+        Initialize the channel encoder.
+        
+        Args:
+            frame_type (int): Frame type selecting the sync word and
+                puncture pattern
+        """
+        self.channel_encoder = m17_bridge_swig.channel_encoder_make(frame_type)
+        
+        gr.hier_block2.__init__(
+            self, "channel_encoder",
+            gr.io_signature(1, 1, self.channel_encoder.payload_bytes()),
+            gr.io_signature(1, 1, self.channel_encoder.frame_symbols())
+        )
+        
+        self.connect((self, 0), (self.channel_encoder, 0))
+        self.connect((self.channel_encoder, 0), (self, 0))
@@ -15,6 +15,9 @@
 #include "ax25_to_m17.h"
 #include "protocol_converter.h"
 #include "callsign_mapper.h"
+#include "viterbi_decoder.h"
+#include "channel_encoder.h"
+#include "sync_correlator.h"
 
 namespace py = pybind11;
 
@@ -39,17 +42,22 @@ void bind_ax25_to_m17(py::module& m)
 {
     using ax25_to_m17 = gr::m17_bridge::ax25_to_m17;
 
-    py::class_<ax25_to_m17, gr::sync_block, gr::block, gr::basic_block,
+    py::class_<ax25_to_m17, gr::block, gr::basic_block,
                std::shared_ptr<ax25_to_m17>>(m, "ax25_to_m17")
 
         .def(py::init(&ax25_to_m17::make),
              py::arg("callsign"),
              py::arg("destination"),
-             py::arg("enable_fec") = false)
+             py::arg("enable_fec") = false,
+             py::arg("batch_window_ms") = 0,
+             py::arg("batch_max_bytes") = 822)
 
         .def("set_destination", &ax25_to_m17::set_destination)
         .def("set_callsign", &ax25_to_m17::set_callsign)
-        .def("set_fec_enabled", &ax25_to_m17::set_fec_enabled);
+        .def("set_fec_enabled", &ax25_to_m17::set_fec_enabled)
+        .def("set_batch_window", &ax25_to_m17::set_batch_window)
+        .def("set_batch_max_bytes", &ax25_to_m17::set_batch_max_bytes)
+        .def("airtime_saved_ms", &ax25_to_m17::airtime_saved_ms);
 }
 
 void bind_protocol_converter(py::module& m)
@@ -88,7 +96,8 @@ void bind_callsign_mapper(py::module& m)
     py::class_<callsign_mapper, gr::sync_block, gr::block, gr::basic_block,
                std::shared_ptr<callsign_mapper>>(m, "callsign_mapper")
 
-        .def(py::init(&callsign_mapper::make))
+        .def(py::init(&callsign_mapper::make),
+             py::arg("auto_mapping_capacity") = 1024)
 
         .def("add_mapping", &callsign_mapper::add_mapping)
         .def("remove_mapping", &callsign_mapper::remove_mapping)
@@ -96,12 +105,73 @@ void bind_callsign_mapper(py::module& m)
         .def("get_m17_callsign", &callsign_mapper::get_m17_callsign)
         .def("set_auto_mapping_enabled", &callsign_mapper::set_auto_mapping_enabled)
         .def("is_auto_mapping_enabled", &callsign_mapper::is_auto_mapping_enabled)
+        .def("set_auto_mapping_capacity", &callsign_mapper::set_auto_mapping_capacity)
+        .def("auto_mapping_capacity", &callsign_mapper::auto_mapping_capacity)
         .def("get_mapping_table", &callsign_mapper::get_mapping_table)
         .def("clear_mappings", &callsign_mapper::clear_mappings)
         .def("load_mappings_from_file", &callsign_mapper::load_mappings_from_file)
         .def("save_mappings_to_file", &callsign_mapper::save_mappings_to_file);
 }
 
+void bind_viterbi_decoder(py::module& m)
+{
+    using viterbi_decoder = gr::m17_bridge::viterbi_decoder;
+
+    py::class_<viterbi_decoder, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<viterbi_decoder>>
+        decoder(m, "viterbi_decoder");
+
+    py::enum_<viterbi_decoder::frame_type_t>(decoder, "frame_type_t")
+        .value("FRAME_LSF", viterbi_decoder::FRAME_LSF)
+        .value("FRAME_STREAM", viterbi_decoder::FRAME_STREAM)
+        .value("FRAME_PACKET", viterbi_decoder::FRAME_PACKET)
+        .export_values();
+
+    decoder
+        .def(py::init(&viterbi_decoder::make),
+             py::arg("frame_type") = 0)
+
+        .def("coded_bits", &viterbi_decoder::coded_bits)
+        .def("payload_bytes", &viterbi_decoder::payload_bytes)
+        .def("last_cost", &viterbi_decoder::last_cost);
+}
+
+void bind_channel_encoder(py::module& m)
+{
+    using channel_encoder = gr::m17_bridge::channel_encoder;
+
+    py::class_<channel_encoder, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<channel_encoder>>
+        encoder(m, "channel_encoder");
+
+    py::enum_<channel_encoder::frame_type_t>(encoder, "frame_type_t")
+        .value("FRAME_LSF", channel_encoder::FRAME_LSF)
+        .value("FRAME_STREAM", channel_encoder::FRAME_STREAM)
+        .value("FRAME_PACKET", channel_encoder::FRAME_PACKET)
+        .export_values();
+
+    encoder
+        .def(py::init(&channel_encoder::make),
+             py::arg("frame_type") = 2)
+
+        .def("payload_bytes", &channel_encoder::payload_bytes)
+        .def("frame_symbols", &channel_encoder::frame_symbols);
+}
+
+void bind_sync_correlator(py::module& m)
+{
+    using sync_correlator = gr::m17_bridge::sync_correlator;
+
+    py::class_<sync_correlator, gr::sync_block, gr::block, gr::basic_block,
+               std::shared_ptr<sync_correlator>>(m, "sync_correlator")
+        .def(py::init(&sync_correlator::make),
+             py::arg("threshold") = 0.9f)
+
+        .def("set_threshold", &sync_correlator::set_threshold)
+        .def("threshold", &sync_correlator::threshold)
+        .def("syncs_found", &sync_correlator::syncs_found);
+}
+
 PYBIND11_MODULE(m17_bridge_swig, m)
 {
     m.doc() = "M17 Bridge - Protocol conversion between M17 and AX.25";
@@ -110,4 +180,7 @@ PYBIND11_MODULE(m17_bridge_swig, m)
     bind_ax25_to_m17(m);
     bind_protocol_converter(m);
     bind_callsign_mapper(m);
+    bind_viterbi_decoder(m);
+    bind_channel_encoder(m);
+    bind_sync_correlator(m);
 }
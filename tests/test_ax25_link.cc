@@ -0,0 +1,479 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// TNC whose transmitted frames are collected for delivery by the test
+struct station {
+    ax25_tnc_t tnc;
+    std::vector<std::vector<uint8_t>> outbox;
+
+    explicit station(const char* callsign)
+    {
+        ax25_init(&tnc);
+        ax25_set_address(&tnc.config.my_address, callsign, 0, false);
+        ax25_set_tx_handler(&tnc, capture, this);
+    }
+    ~station() { ax25_cleanup(&tnc); }
+
+    static int capture(void* ctx, const struct iovec* iov, int iovcnt)
+    {
+        std::vector<uint8_t> frame;
+        for (int i = 0; i < iovcnt; i++) {
+            const uint8_t* p = static_cast<const uint8_t*>(iov[i].iov_base);
+            frame.insert(frame.end(), p, p + iov[i].iov_len);
+        }
+        static_cast<station*>(ctx)->outbox.push_back(frame);
+        return 0;
+    }
+
+    void advance(uint32_t ms) { ax25_timer_tick(&tnc, timer_wheel_now(&tnc.timers) + ms); }
+
+    ax25_connection_t* session(const station& peer)
+    {
+        return ax25_session_find(&tnc.sessions, &tnc.config.my_address,
+                                 &peer.tnc.config.my_address);
+    }
+};
+
+// Control field of a two-address frame
+uint8_t control_of(const std::vector<uint8_t>& frame) { return frame[2 * AX25_ADDR_LEN]; }
+
+bool is_command(const std::vector<uint8_t>& frame)
+{
+    return (frame[6] & 0x80) != 0 && (frame[13] & 0x80) == 0;
+}
+
+// Deliver queued frames both ways until neither side has anything to say
+void pump(station& a, station& b)
+{
+    while (!a.outbox.empty() || !b.outbox.empty()) {
+        auto from_a = std::move(a.outbox);
+        auto from_b = std::move(b.outbox);
+        a.outbox.clear();
+        b.outbox.clear();
+        for (const auto& frame : from_a) {
+            ax25_input_frame(&b.tnc, frame.data(), frame.size());
+        }
+        for (const auto& frame : from_b) {
+            ax25_input_frame(&a.tnc, frame.data(), frame.size());
+        }
+    }
+}
+
+// Payloads of the I frames in the receive queue, oldest first
+std::vector<std::string> drain(station& s)
+{
+    std::vector<std::string> payloads;
+    ax25_frame_t frame;
+    while (ax25_rx_dequeue(&s.tnc, &frame) == 1) {
+        payloads.emplace_back((const char*)frame.info, frame.info_length);
+    }
+    return payloads;
+}
+
+// Frame from one station to another with the given control field
+std::vector<uint8_t> make_frame(const station& from, const station& to, uint8_t control,
+                                bool command)
+{
+    ax25_address_t addresses[2] = { to.tnc.config.my_address, from.tnc.config.my_address };
+    addresses[command ? 0 : 1].ssid |= 0x80;
+    ax25_header_template_t tmpl;
+    ax25_header_template_init(&tmpl, addresses, 2, control, AX25_PID_NONE);
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, nullptr, 0, fcs, iov);
+    std::vector<uint8_t> frame;
+    for (int i = 0; i < iovcnt; i++) {
+        const uint8_t* p = static_cast<const uint8_t*>(iov[i].iov_base);
+        frame.insert(frame.end(), p, p + iov[i].iov_len);
+    }
+    return frame;
+}
+
+void connect(station& a, station& b)
+{
+    ASSERT_EQ(ax25_connect(&a.tnc, &b.tnc.config.my_address), 0);
+    pump(a, b);
+    ASSERT_NE(a.session(b), nullptr);
+    ASSERT_NE(b.session(a), nullptr);
+    ASSERT_EQ(a.session(b)->state, AX25_STATE_CONNECTED);
+    ASSERT_EQ(b.session(a)->state, AX25_STATE_CONNECTED);
+}
+
+} // namespace
+
+TEST(TestAX25Link, ConnectTransferDisconnect)
+{
+    station a("N0AAA"), b("N0BBB");
+    connect(a, b);
+
+    // Idle links run T3 only
+    ax25_connection_t* conn = a.session(b);
+    EXPECT_TRUE(timer_wheel_armed(&conn->t3));
+    EXPECT_FALSE(timer_wheel_armed(&conn->t1));
+
+    const char* lines[] = { "one", "two", "three" };
+    for (const char* line : lines) {
+        ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, (const uint8_t*)line,
+                                 strlen(line)),
+                  0);
+    }
+    EXPECT_TRUE(timer_wheel_armed(&conn->t1));
+    pump(a, b);
+
+    for (const char* line : lines) {
+        ax25_address_t from;
+        uint8_t data[AX25_MAX_INFO];
+        uint16_t length = sizeof(data);
+        ASSERT_EQ(ax25_receive_data(&b.tnc, &from, data, &length), (int)strlen(line));
+        EXPECT_EQ(std::string((const char*)data, length), line);
+        EXPECT_TRUE(ax25_address_equal(&from, &a.tnc.config.my_address));
+    }
+
+    // B holds the acknowledgement for T2, then sends one RR for all three
+    EXPECT_TRUE(b.session(a)->ack_pending);
+    EXPECT_EQ(conn->ack_seq, 0);
+    b.advance(b.tnc.config.t2_timeout - AX25_TIMER_TICK_MS);
+    EXPECT_TRUE(b.outbox.empty());
+    b.advance(AX25_TIMER_TICK_MS);
+    ASSERT_EQ(b.outbox.size(), 1u);
+    EXPECT_EQ(control_of(b.outbox[0]), AX25_CTRL_RR | (3 << 5));
+    pump(a, b);
+    EXPECT_EQ(conn->ack_seq, 3);
+    EXPECT_FALSE(timer_wheel_armed(&conn->t1));
+    EXPECT_TRUE(timer_wheel_armed(&conn->t3));
+
+    ASSERT_EQ(ax25_disconnect(&a.tnc, &b.tnc.config.my_address), 0);
+    EXPECT_EQ(conn->state, AX25_STATE_DISCONNECTING);
+    pump(a, b);
+    EXPECT_EQ(a.session(b), nullptr);
+    EXPECT_EQ(b.session(a), nullptr);
+    EXPECT_EQ(a.tnc.timers.armed, 0u);
+    EXPECT_EQ(b.tnc.timers.armed, 0u);
+}
+
+TEST(TestAX25Link, T1RetriesThenGivesUp)
+{
+    station a("N0AAA"), b("N0BBB");
+    ASSERT_EQ(ax25_connect(&a.tnc, &b.tnc.config.my_address), 0);
+
+    // Nothing reaches B: SABM is repeated on each T1 expiry
+    for (int retry = 0; retry < a.tnc.config.max_retries; retry++) {
+        a.advance(a.tnc.config.t1_timeout);
+    }
+    ASSERT_EQ(a.outbox.size(), 1u + a.tnc.config.max_retries);
+    for (const auto& frame : a.outbox) {
+        EXPECT_EQ(control_of(frame), AX25_CTRL_SABM | AX25_CTRL_PF);
+        EXPECT_TRUE(is_command(frame));
+    }
+    ASSERT_NE(a.session(b), nullptr);
+
+    a.advance(a.tnc.config.t1_timeout);
+    EXPECT_EQ(a.session(b), nullptr);
+    EXPECT_EQ(a.tnc.timers.armed, 0u);
+
+    // Polling a station with no link gets DM
+    a.outbox.clear();
+    connect(a, b);
+    ASSERT_EQ(ax25_disconnect(&b.tnc, &a.tnc.config.my_address), 0);
+    b.outbox.clear(); // DISC lost; A still thinks it is connected
+    ASSERT_NE(b.tnc.timers.armed, 0u); // T1 waits for the UA
+    ASSERT_EQ(ax25_session_remove(&b.tnc.sessions, &b.tnc.config.my_address,
+                                  &a.tnc.config.my_address), 0);
+    EXPECT_EQ(b.tnc.timers.armed, 0u); // Removal cancels it
+    a.advance(a.tnc.config.t3_timeout);
+    ASSERT_EQ(a.outbox.size(), 1u);
+    EXPECT_EQ(control_of(a.outbox[0]), AX25_CTRL_RR | AX25_CTRL_PF);
+    pump(a, b);
+    EXPECT_EQ(a.session(b), nullptr);
+}
+
+TEST(TestAX25Link, LostFrameRecoveredByPoll)
+{
+    station a("N0AAA"), b("N0BBB");
+    connect(a, b);
+    ax25_connection_t* conn = a.session(b);
+
+    const uint8_t payload[] = { 0xAA, 0x55 };
+    ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, payload, sizeof(payload)), 0);
+    a.outbox.clear(); // I frame lost
+
+    // T1 expiry sends an enquiry; B's answer restates N(R) = 0
+    a.advance(a.tnc.config.t1_timeout);
+    ASSERT_EQ(a.outbox.size(), 1u);
+    EXPECT_EQ(control_of(a.outbox[0]), AX25_CTRL_RR | AX25_CTRL_PF);
+    EXPECT_TRUE(is_command(a.outbox[0]));
+    EXPECT_TRUE(conn->poll_pending);
+    ax25_input_frame(&b.tnc, a.outbox[0].data(), a.outbox[0].size());
+    a.outbox.clear();
+    ASSERT_EQ(b.outbox.size(), 1u);
+    EXPECT_EQ(control_of(b.outbox[0]), AX25_CTRL_RR | AX25_CTRL_PF);
+    EXPECT_FALSE(is_command(b.outbox[0]));
+    pump(a, b);
+
+    // The answer shows the frame missing, so it is sent again
+    EXPECT_FALSE(conn->poll_pending);
+    EXPECT_EQ(conn->retry_count, 0);
+    EXPECT_EQ(conn->ack_seq, 0);
+    EXPECT_EQ(conn->retransmits, 1u);
+    EXPECT_TRUE(timer_wheel_armed(&conn->t1));
+    EXPECT_EQ(drain(b).size(), 1u);
+}
+
+TEST(TestAX25Link, OutOfSequenceFrameRejectedOnce)
+{
+    station a("N0AAA"), b("N0BBB");
+    connect(a, b);
+
+    for (uint8_t c : { 'a', 'b', 'c' }) {
+        ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, &c, 1), 0);
+    }
+    a.outbox.erase(a.outbox.begin()); // N(S) = 0 lost
+    for (const auto& frame : a.outbox) {
+        ax25_input_frame(&b.tnc, frame.data(), frame.size());
+    }
+    a.outbox.clear();
+
+    // One REJ for the gap; the following frame is discarded silently
+    ASSERT_EQ(b.outbox.size(), 1u);
+    EXPECT_EQ(control_of(b.outbox[0]), AX25_CTRL_REJ);
+    EXPECT_EQ(ax25_rx_pending(&b.tnc), 0u);
+    EXPECT_TRUE(b.session(a)->reject_sent);
+
+    // Modulo 8 recovery is go-back-N: the whole window is sent again
+    pump(a, b);
+    EXPECT_EQ(a.session(b)->retransmits, 3u);
+    EXPECT_EQ(drain(b), (std::vector<std::string>{ "a", "b", "c" }));
+    EXPECT_EQ(b.session(a)->recv_seq, 3);
+    EXPECT_FALSE(b.session(a)->reject_sent);
+}
+
+TEST(TestAX25Link, IdleLinkPolledByT3)
+{
+    station a("N0AAA"), b("N0BBB");
+    connect(a, b);
+
+    a.advance(a.tnc.config.t3_timeout - AX25_TIMER_TICK_MS);
+    EXPECT_TRUE(a.outbox.empty());
+    a.advance(AX25_TIMER_TICK_MS);
+    ASSERT_EQ(a.outbox.size(), 1u);
+    EXPECT_EQ(control_of(a.outbox[0]), AX25_CTRL_RR | AX25_CTRL_PF);
+    EXPECT_TRUE(timer_wheel_armed(&a.session(b)->t1));
+
+    pump(a, b);
+    ax25_connection_t* conn = a.session(b);
+    EXPECT_FALSE(conn->poll_pending);
+    EXPECT_FALSE(timer_wheel_armed(&conn->t1));
+    EXPECT_TRUE(timer_wheel_armed(&conn->t3));
+}
+
+TEST(TestAX25Link, ExtendedModeWindowAndWrap)
+{
+    station a("N0AAA"), b("N0BBB");
+    a.tnc.config.extended = true;
+    a.tnc.config.window_size_ext = 200; // Clamped to 127
+    b.tnc.config.window_size_ext = 12;
+    connect(a, b);
+
+    ax25_connection_t* conn = a.session(b);
+    EXPECT_EQ(conn->modulo, AX25_MODULO_EXT);
+    EXPECT_EQ(conn->window_size, AX25_MAX_WINDOW_EXT);
+    EXPECT_EQ(b.session(a)->modulo, AX25_MODULO_EXT);
+
+    // 127 frames may be outstanding; the 128th waits
+    std::vector<std::vector<uint8_t>> sent;
+    for (int i = 0; i < AX25_MAX_WINDOW_EXT; i++) {
+        uint8_t payload[2] = { (uint8_t)i, (uint8_t)(i >> 8) };
+        ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, payload, 2), 0);
+    }
+    const uint8_t extra = 0xFF;
+    EXPECT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, &extra, 1), -1);
+
+    // Two control octets, then the PID: N(S) = 5, N(R) = 0
+    const auto& frame = a.outbox[5];
+    EXPECT_EQ(frame[2 * AX25_ADDR_LEN], 5 << 1);
+    EXPECT_EQ(frame[2 * AX25_ADDR_LEN + 1], 0);
+    EXPECT_EQ(frame[2 * AX25_ADDR_LEN + 2], AX25_PID_IP);
+
+    // Deliver one at a time so the receive queue never fills
+    std::vector<std::string> received;
+    for (const auto& f : a.outbox) {
+        ax25_input_frame(&b.tnc, f.data(), f.size());
+        for (auto& payload : drain(b)) {
+            received.push_back(payload);
+        }
+    }
+    a.outbox.clear();
+    ASSERT_EQ(received.size(), (size_t)AX25_MAX_WINDOW_EXT);
+    EXPECT_EQ((uint8_t)received[126][0], 126);
+    EXPECT_EQ(b.session(a)->recv_seq, 127);
+
+    // Keep going past the sequence number wrap
+    b.advance(b.tnc.config.t2_timeout);
+    pump(a, b);
+    EXPECT_EQ(conn->ack_seq, 127);
+    for (int i = 0; i < 10; i++) {
+        uint8_t payload = (uint8_t)i;
+        ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, &payload, 1), 0);
+    }
+    pump(a, b);
+    EXPECT_EQ(drain(b).size(), 10u);
+    EXPECT_EQ(b.session(a)->recv_seq, 9);
+    b.advance(b.tnc.config.t2_timeout);
+    pump(a, b);
+    EXPECT_EQ(conn->ack_seq, 9);
+    EXPECT_EQ(conn->retransmits, 0u);
+}
+
+TEST(TestAX25Link, SelectiveRejectResendsOnlyLostFrames)
+{
+    station a("N0AAA"), b("N0BBB");
+    a.tnc.config.extended = true;
+    connect(a, b);
+
+    for (uint8_t i = 0; i < 12; i++) {
+        ASSERT_EQ(ax25_send_data(&a.tnc, &b.tnc.config.my_address, &i, 1), 0);
+    }
+    a.outbox.erase(a.outbox.begin() + 8); // N(S) = 8 lost
+    a.outbox.erase(a.outbox.begin() + 3); // N(S) = 3 lost
+    for (const auto& frame : a.outbox) {
+        ax25_input_frame(&b.tnc, frame.data(), frame.size());
+    }
+    a.outbox.clear();
+
+    // Frames after each gap are held; each missing frame is asked for once
+    EXPECT_EQ(drain(b).size(), 3u);
+    ASSERT_EQ(b.outbox.size(), 2u);
+    EXPECT_EQ(b.outbox[0][2 * AX25_ADDR_LEN], AX25_CTRL_SREJ);
+    EXPECT_EQ(b.outbox[0][2 * AX25_ADDR_LEN + 1], 3 << 1);
+    EXPECT_EQ(b.outbox[1][2 * AX25_ADDR_LEN + 1], 8 << 1);
+
+    pump(a, b);
+    EXPECT_EQ(a.session(b)->retransmits, 2u);
+    std::vector<std::string> received = drain(b);
+    ASSERT_EQ(received.size(), 9u);
+    for (uint8_t i = 0; i < 9; i++) {
+        EXPECT_EQ((uint8_t)received[i][0], i + 3);
+    }
+    EXPECT_EQ(b.session(a)->recv_seq, 12);
+
+    b.advance(b.tnc.config.t2_timeout);
+    pump(a, b);
+    EXPECT_EQ(a.session(b)->ack_seq, 12);
+    EXPECT_FALSE(timer_wheel_armed(&a.session(b)->t1));
+}
+
+TEST(TestAX25Link, FallsBackToSabmWhenSabmeRefused)
+{
+    station a("N0AAA"), b("N0BBB");
+    a.tnc.config.extended = true;
+    ASSERT_EQ(ax25_connect(&a.tnc, &b.tnc.config.my_address), 0);
+    ASSERT_EQ(a.outbox.size(), 1u);
+    EXPECT_EQ(control_of(a.outbox[0]), AX25_CTRL_SABME | AX25_CTRL_PF);
+    a.outbox.clear();
+
+    // An AX.25 v2.0 station answers SABME with DM
+    auto dm = make_frame(b, a, AX25_CTRL_DM | AX25_CTRL_PF, false);
+    ASSERT_EQ(ax25_input_frame(&a.tnc, dm.data(), dm.size()), 0);
+    ASSERT_EQ(a.outbox.size(), 1u);
+    EXPECT_EQ(control_of(a.outbox[0]), AX25_CTRL_SABM | AX25_CTRL_PF);
+    pump(a, b);
+
+    ASSERT_NE(a.session(b), nullptr);
+    EXPECT_EQ(a.session(b)->state, AX25_STATE_CONNECTED);
+    EXPECT_EQ(a.session(b)->modulo, AX25_MODULO);
+    EXPECT_EQ(a.session(b)->window_size, 4);
+    EXPECT_EQ(a.session(b)->rx_window, nullptr);
+}
+
+TEST(TestAX25Link, TenThousandSessionsConstantTickCost)
+{
+    const uint32_t sessions = 10000;
+    const uint32_t per_tick = 10;
+    station node("N0NODE");
+
+    // Remote stations answer each SABM with UA; sessions open 10 per tick
+    // over the first 10 s, so their T3 deadlines are spread out
+    uint32_t opened = 0;
+    while (opened < sessions) {
+        for (uint32_t i = 0; i < per_tick; i++, opened++) {
+            char callsign[7] = "N0";
+            callsign[2] = 'A' + opened % 26;
+            callsign[3] = 'A' + (opened / 26) % 26;
+            callsign[4] = 'A' + (opened / 676) % 26;
+            callsign[5] = '\0';
+            ax25_address_t addresses[2];
+            ax25_set_address(&addresses[0], "N0NODE", 0, false);
+            ax25_set_address(&addresses[1], callsign, (opened / 17576) % 16, true);
+            ASSERT_EQ(ax25_connect(&node.tnc, &addresses[1]), 0);
+
+            ax25_header_template_t tmpl;
+            ASSERT_EQ(ax25_header_template_init(&tmpl, addresses, 2,
+                                                AX25_CTRL_UA | AX25_CTRL_PF, 0),
+                      0);
+            struct iovec iov[AX25_IOV_SEGMENTS];
+            uint8_t fcs[2];
+            int iovcnt = ax25_encode_iov(&tmpl, nullptr, 0, fcs, iov);
+            std::vector<uint8_t> ua;
+            for (int s = 0; s < iovcnt; s++) {
+                const uint8_t* p = static_cast<const uint8_t*>(iov[s].iov_base);
+                ua.insert(ua.end(), p, p + iov[s].iov_len);
+            }
+            ASSERT_EQ(ax25_input_frame(&node.tnc, ua.data(), ua.size()), 0);
+        }
+        node.advance(AX25_TIMER_TICK_MS);
+    }
+    node.outbox.clear();
+    ASSERT_EQ(ax25_session_count(&node.tnc.sessions), sessions);
+    ASSERT_EQ(node.tnc.timers.armed, sessions);
+
+    // Idle stretch of 1900 ticks: every session has a T3 armed, yet a
+    // tick only touches the timers that move or expire. A scan of all
+    // sessions per tick would cost sessions x ticks = 19M checks.
+    const uint32_t ticks = 1900;
+    timer_wheel_stats_t before, after;
+    timer_wheel_get_stats(&node.tnc.timers, &before);
+    uint64_t max_tick_work = 0;
+    for (uint32_t t = 0; t < ticks; t++) {
+        timer_wheel_stats_t s0, s1;
+        timer_wheel_get_stats(&node.tnc.timers, &s0);
+        node.advance(AX25_TIMER_TICK_MS);
+        timer_wheel_get_stats(&node.tnc.timers, &s1);
+        max_tick_work = std::max(max_tick_work,
+                                 (s1.expired + s1.cascaded) - (s0.expired + s0.cascaded));
+    }
+    timer_wheel_get_stats(&node.tnc.timers, &after);
+    EXPECT_EQ(after.ticks - before.ticks, ticks);
+    EXPECT_EQ(after.expired - before.expired, 0u);
+    EXPECT_LE(after.cascaded - before.cascaded, sessions); // At most once per timer here
+    EXPECT_LE(max_tick_work, (uint64_t)TIMER_WHEEL_SLOTS * per_tick);
+    EXPECT_TRUE(node.outbox.empty());
+
+    // Every session is polled once its T3 runs out (before T1 gives up)
+    node.advance(11000);
+    uint32_t polled = 0;
+    ax25_session_foreach(
+        &node.tnc.sessions,
+        [](void* ctx, ax25_connection_t* conn) {
+            *static_cast<uint32_t*>(ctx) += conn->poll_pending;
+        },
+        &polled);
+    EXPECT_EQ(polled, sessions);
+    EXPECT_EQ(ax25_session_count(&node.tnc.sessions), sessions);
+}
@@ -0,0 +1,679 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+class TestAX25Protocol : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Set up test fixtures
+    }
+
+    void TearDown() override
+    {
+        // Clean up test fixtures
+    }
+};
+
+TEST_F(TestAX25Protocol, FcsCheckValue)
+{
+    // CRC-16/X.25 check value
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    ASSERT_EQ(ax25_calculate_fcs(check, sizeof(check)), 0x906E);
+
+    // Incremental updates match a single pass
+    uint16_t reg = ax25_fcs_update(0xFFFF, check, 4);
+    reg = ax25_fcs_update(reg, check + 4, 5);
+    ASSERT_EQ(reg ^ 0xFFFF, 0x906E);
+}
+
+TEST_F(TestAX25Protocol, FcsPatchMatchesRecompute)
+{
+    std::mt19937 rng(25);
+    for (int iter = 0; iter < 2000; iter++) {
+        uint16_t length = 1 + rng() % 400;
+        std::vector<uint8_t> data(length);
+        for (auto& b : data) {
+            b = rng() & 0xFF;
+        }
+        uint16_t fcs = ax25_calculate_fcs(data.data(), length);
+
+        uint16_t offset = rng() % length;
+        uint16_t count = 1 + rng() % (length - offset);
+        std::vector<uint8_t> old_bytes(data.begin() + offset, data.begin() + offset + count);
+        for (uint16_t i = 0; i < count; i++) {
+            data[offset + i] = rng() & 0xFF;
+        }
+
+        uint16_t patched =
+            ax25_fcs_patch(fcs, length, offset, old_bytes.data(), &data[offset], count);
+        ASSERT_EQ(patched, ax25_calculate_fcs(data.data(), length))
+            << "length " << length << " offset " << offset << " count " << count;
+    }
+}
+
+TEST_F(TestAX25Protocol, EncodeParseRoundTrip)
+{
+    ax25_address_t src, dst;
+    ASSERT_EQ(ax25_set_address(&src, "N0CALL", 7, false), 0);
+    ASSERT_EQ(ax25_set_address(&dst, "APRS", 0, true), 0);
+
+    const uint8_t info[] = "!4903.50N/07201.75W-";
+    ax25_frame_t frame;
+    ASSERT_EQ(ax25_create_frame(&frame, &src, &dst, AX25_CTRL_UI, AX25_PID_NONE, info,
+                                sizeof(info) - 1),
+              0);
+
+    uint8_t encoded[512];
+    uint16_t encoded_len = sizeof(encoded);
+    ASSERT_EQ(ax25_encode_frame(&frame, encoded, &encoded_len), 0);
+
+    uint16_t fcs = encoded[encoded_len - 2] | (encoded[encoded_len - 1] << 8);
+    ASSERT_TRUE(ax25_check_fcs(encoded, encoded_len - 2, fcs));
+}
+
+namespace {
+
+// Append a raw address field (shifted callsign, SSID byte)
+void append_address(std::vector<uint8_t>& frame, const char* callsign, uint8_t ssid, bool last)
+{
+    size_t len = strlen(callsign);
+    for (size_t i = 0; i < 6; i++) {
+        frame.push_back((i < len ? callsign[i] : ' ') << 1);
+    }
+    frame.push_back(0x60 | ((ssid & 0x0F) << 1) | (last ? 0x01 : 0x00));
+}
+
+void append_fcs(std::vector<uint8_t>& frame)
+{
+    uint16_t fcs = ax25_calculate_fcs(frame.data(), frame.size());
+    frame.push_back(fcs & 0xFF);
+    frame.push_back(fcs >> 8);
+}
+
+} // namespace
+
+TEST_F(TestAX25Protocol, FrameViewDigipeaterPath)
+{
+    std::vector<uint8_t> frame;
+    append_address(frame, "APRS", 0, false);
+    append_address(frame, "N0CALL", 7, false);
+    append_address(frame, "WIDE1", 1, false);
+    append_address(frame, "WIDE2", 2, true);
+    frame.push_back(AX25_CTRL_UI);
+    frame.push_back(AX25_PID_NONE);
+    const char info[] = ">status";
+    frame.insert(frame.end(), info, info + sizeof(info) - 1);
+    append_fcs(frame);
+
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, frame.data(), frame.size()), 0);
+    ASSERT_EQ(view.num_addresses, 4);
+    ASSERT_EQ(view.control_offset, 28);
+    ASSERT_TRUE(view.has_pid);
+    ASSERT_EQ(ax25_frame_view_control(&view), AX25_CTRL_UI);
+    ASSERT_EQ(ax25_frame_view_pid(&view), AX25_PID_NONE);
+
+    uint16_t info_len = 0;
+    const uint8_t* info_ptr = ax25_frame_view_info(&view, &info_len);
+    ASSERT_EQ(info_len, sizeof(info) - 1);
+    ASSERT_EQ(info_ptr, frame.data() + 30); // Points into the buffer
+    ASSERT_EQ(memcmp(info_ptr, info, info_len), 0);
+    ASSERT_TRUE(ax25_frame_view_check_fcs(&view));
+
+    char callsign[7];
+    uint8_t ssid = 0;
+    ASSERT_EQ(ax25_frame_view_get_callsign(&view, 1, callsign, &ssid), 0);
+    ASSERT_STREQ(callsign, "N0CALL");
+    ASSERT_EQ(ssid, 7);
+    ASSERT_EQ(ax25_frame_view_get_callsign(&view, 3, callsign, &ssid), 0);
+    ASSERT_STREQ(callsign, "WIDE2");
+    ASSERT_EQ(ssid, 2);
+    ASSERT_NE(ax25_frame_view_get_callsign(&view, 4, callsign, &ssid), 0);
+
+    ax25_address_t addr;
+    ax25_set_address(&addr, "APRS", 0, false);
+    ASSERT_TRUE(ax25_frame_view_address_equal(&view, 0, &addr));
+    ax25_set_address(&addr, "N0CALL", 8, false);
+    ASSERT_FALSE(ax25_frame_view_address_equal(&view, 1, &addr));
+    ax25_set_address(&addr, "WIDE", 1, false);
+    ASSERT_FALSE(ax25_frame_view_address_equal(&view, 2, &addr));
+
+    // Full parse agrees with the view
+    ax25_frame_t parsed;
+    ASSERT_EQ(ax25_parse_frame(frame.data(), frame.size(), &parsed), 0);
+    ASSERT_EQ(parsed.num_addresses, 4);
+    ASSERT_EQ(parsed.pid, AX25_PID_NONE);
+    ASSERT_EQ(parsed.info_length, sizeof(info) - 1);
+    ASSERT_EQ(memcmp(parsed.info, info, parsed.info_length), 0);
+}
+
+TEST_F(TestAX25Protocol, FrameViewSupervisoryHasNoPid)
+{
+    std::vector<uint8_t> frame;
+    append_address(frame, "N0CALL", 0, false);
+    append_address(frame, "W1AW", 0, true);
+    frame.push_back(0x21); // RR, N(R) = 1
+    append_fcs(frame);
+
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, frame.data(), frame.size()), 0);
+    ASSERT_FALSE(view.has_pid);
+    ASSERT_EQ(ax25_frame_view_pid(&view), AX25_PID_NONE);
+    ASSERT_EQ(view.info_length, 0);
+    ASSERT_TRUE(ax25_frame_view_check_fcs(&view));
+}
+
+TEST_F(TestAX25Protocol, FrameViewRejectsMalformed)
+{
+    ax25_frame_view_t view;
+
+    // Extension bit never set
+    std::vector<uint8_t> unterminated;
+    append_address(unterminated, "N0CALL", 0, false);
+    append_address(unterminated, "W1AW", 0, false);
+    unterminated.push_back(AX25_CTRL_UI);
+    append_fcs(unterminated);
+    ASSERT_NE(ax25_frame_view_init(&view, unterminated.data(), unterminated.size()), 0);
+
+    // Single address
+    std::vector<uint8_t> single;
+    append_address(single, "N0CALL", 0, true);
+    single.push_back(AX25_CTRL_UI);
+    single.push_back(AX25_PID_NONE);
+    append_fcs(single);
+    ASSERT_NE(ax25_frame_view_init(&view, single.data(), single.size()), 0);
+
+    // Truncated before the FCS
+    std::vector<uint8_t> truncated;
+    append_address(truncated, "N0CALL", 0, false);
+    append_address(truncated, "W1AW", 0, true);
+    truncated.push_back(AX25_CTRL_UI);
+    ASSERT_NE(ax25_frame_view_init(&view, truncated.data(), truncated.size()), 0);
+}
+
+TEST_F(TestAX25Protocol, EncodeIovMatchesFlatEncoder)
+{
+    ax25_address_t src, dst, digi;
+    ax25_set_address(&src, "N0CALL", 7, false);
+    ax25_set_address(&dst, "APRS", 0, true);
+    ax25_set_address(&digi, "WIDE1", 1, false);
+
+    const uint8_t info[] = "!4903.50N/07201.75W-";
+    ax25_frame_t frame;
+    ASSERT_EQ(ax25_create_frame(&frame, &src, &dst, AX25_CTRL_UI, AX25_PID_NONE, info,
+                                sizeof(info) - 1),
+              0);
+    frame.addresses[2] = digi;
+    frame.num_addresses = 3;
+
+    uint8_t flat[512];
+    uint16_t flat_len = sizeof(flat);
+    ASSERT_EQ(ax25_encode_frame(&frame, flat, &flat_len), 0);
+
+    ax25_header_template_t tmpl;
+    ASSERT_EQ(ax25_header_template_init(&tmpl, frame.addresses, 3, AX25_CTRL_UI, AX25_PID_NONE),
+              0);
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, info, sizeof(info) - 1, fcs, iov);
+    ASSERT_EQ(iovcnt, 3);
+    ASSERT_EQ(iov[1].iov_base, (const void*)info); // Payload is not copied
+
+    std::vector<uint8_t> gathered;
+    for (int i = 0; i < iovcnt; i++) {
+        const uint8_t* p = static_cast<const uint8_t*>(iov[i].iov_base);
+        gathered.insert(gathered.end(), p, p + iov[i].iov_len);
+    }
+    ASSERT_EQ(gathered, std::vector<uint8_t>(flat, flat + flat_len));
+
+    // UI frames keep their PID
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, flat, flat_len), 0);
+    ASSERT_TRUE(view.has_pid);
+    ASSERT_EQ(view.info_length, sizeof(info) - 1);
+    ASSERT_TRUE(ax25_frame_view_check_fcs(&view));
+}
+
+TEST_F(TestAX25Protocol, HeaderTemplateControlUpdate)
+{
+    ax25_address_t addresses[2];
+    ax25_set_address(&addresses[0], "W1AW", 0, true);
+    ax25_set_address(&addresses[1], "N0CALL", 0, false);
+
+    ax25_header_template_t tmpl;
+    ASSERT_EQ(ax25_header_template_init(&tmpl, addresses, 2, AX25_CTRL_I, AX25_PID_IP), 0);
+
+    const uint8_t payload[] = { 0x45, 0x00, 0xC0, 0xDB };
+    for (uint8_t seq = 0; seq < 8; seq++) {
+        ASSERT_EQ(ax25_header_template_set_control(&tmpl, AX25_CTRL_I | (seq << 1)), 0);
+
+        ax25_frame_t frame;
+        ASSERT_EQ(ax25_create_frame(&frame, &addresses[1], &addresses[0], AX25_CTRL_I | (seq << 1),
+                                    AX25_PID_IP, payload, sizeof(payload)),
+                  0);
+        uint8_t flat[128];
+        uint16_t flat_len = sizeof(flat);
+        ASSERT_EQ(ax25_encode_frame(&frame, flat, &flat_len), 0);
+
+        struct iovec iov[AX25_IOV_SEGMENTS];
+        uint8_t fcs[2];
+        ASSERT_EQ(ax25_encode_iov(&tmpl, payload, sizeof(payload), fcs, iov), 3);
+        ASSERT_EQ(memcmp(iov[0].iov_base, flat, iov[0].iov_len), 0);
+        ASSERT_EQ(memcmp(fcs, flat + flat_len - 2, 2), 0);
+    }
+
+    // Switching to a frame type without PID would change the layout
+    ASSERT_NE(ax25_header_template_set_control(&tmpl, 0x01), 0);
+}
+
+TEST_F(TestAX25Protocol, ExtendedControlField)
+{
+    ax25_address_t addresses[2];
+    ax25_set_address(&addresses[0], "W1AW", 0, true);
+    ax25_set_address(&addresses[1], "N0CALL", 0, false);
+
+    // Modulo 128 I frame: N(S) = 100, N(R) = 77, P set
+    const uint16_t control = (100 << 1) | AX25_CTRL_EXT_PF | (77 << 9);
+    const uint8_t payload[] = { 0x45, 0x00 };
+    ax25_header_template_t tmpl;
+    ASSERT_EQ(ax25_header_template_init_ext(&tmpl, addresses, 2, control, AX25_PID_IP), 0);
+    EXPECT_EQ(tmpl.control_length, 2);
+    EXPECT_EQ(tmpl.length, 2 * AX25_ADDR_LEN + 3);
+    EXPECT_NE(ax25_header_template_set_control(&tmpl, AX25_CTRL_I), 0);
+
+    struct iovec iov[AX25_IOV_SEGMENTS];
+    uint8_t fcs[2];
+    int iovcnt = ax25_encode_iov(&tmpl, payload, sizeof(payload), fcs, iov);
+    std::vector<uint8_t> flat;
+    for (int i = 0; i < iovcnt; i++) {
+        const uint8_t* p = static_cast<const uint8_t*>(iov[i].iov_base);
+        flat.insert(flat.end(), p, p + iov[i].iov_len);
+    }
+
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init_ext(&view, flat.data(), flat.size(), true), 0);
+    EXPECT_EQ(ax25_frame_view_control_ext(&view), control);
+    EXPECT_EQ(ax25_frame_view_pid(&view), AX25_PID_IP);
+    EXPECT_EQ(view.info_length, sizeof(payload));
+    EXPECT_TRUE(ax25_frame_view_check_fcs(&view));
+
+    // U frames keep one control octet in either mode
+    ASSERT_EQ(ax25_header_template_init_ext(&tmpl, addresses, 2, AX25_CTRL_UA, AX25_PID_NONE), 0);
+    EXPECT_EQ(tmpl.control_length, 1);
+    EXPECT_EQ(tmpl.length, 2 * AX25_ADDR_LEN + 1);
+}
+
+namespace {
+
+// UI frame whose information field carries a sequence number
+ax25_frame_t make_numbered_frame(uint8_t control, uint32_t seq)
+{
+    ax25_address_t src, dst;
+    ax25_set_address(&src, "N0CALL", 1, false);
+    ax25_set_address(&dst, "APRS", 0, true);
+    uint8_t info[4];
+    memcpy(info, &seq, sizeof(seq));
+    ax25_frame_t frame;
+    ax25_create_frame(&frame, &src, &dst, control, AX25_PID_NONE, info, sizeof(info));
+    return frame;
+}
+
+uint32_t frame_seq(const uint8_t* info)
+{
+    uint32_t seq;
+    memcpy(&seq, info, sizeof(seq));
+    return seq;
+}
+
+} // namespace
+
+TEST_F(TestAX25Protocol, RxQueueKeepsBurst)
+{
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+
+    // A burst of UI frames followed by an I frame, all before any receive call
+    for (uint32_t seq = 0; seq < 10; seq++) {
+        ax25_frame_t frame = make_numbered_frame(AX25_CTRL_UI, seq);
+        ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), 0);
+    }
+    ax25_frame_t iframe = make_numbered_frame(AX25_CTRL_I, 99);
+    ASSERT_EQ(ax25_rx_enqueue(&tnc, &iframe), 0);
+    EXPECT_EQ(ax25_rx_pending(&tnc), 11u);
+
+    ax25_address_t src, dst, digis[2];
+    uint8_t pid, info[AX25_MAX_INFO];
+    for (uint32_t seq = 0; seq < 10; seq++) {
+        uint8_t num_digis = 2;
+        uint16_t info_len = sizeof(info);
+        ASSERT_EQ(ax25_receive_ui_frame(&tnc, &src, &dst, digis, &num_digis, &pid, info, &info_len),
+                  4);
+        EXPECT_EQ(frame_seq(info), seq);
+        EXPECT_EQ(num_digis, 0);
+    }
+
+    // The I frame is left for ax25_receive_data
+    uint8_t num_digis = 2;
+    uint16_t info_len = sizeof(info);
+    EXPECT_EQ(ax25_receive_ui_frame(&tnc, &src, &dst, digis, &num_digis, &pid, info, &info_len), 0);
+    uint16_t length = 2;
+    EXPECT_EQ(ax25_receive_data(&tnc, &src, info, &length), -1); // Too small; stays queued
+    length = sizeof(info);
+    EXPECT_EQ(ax25_receive_data(&tnc, &src, info, &length), 4);
+    EXPECT_EQ(frame_seq(info), 99u);
+    EXPECT_EQ(ax25_rx_pending(&tnc), 0u);
+
+    ax25_rx_stats_t stats;
+    ASSERT_EQ(ax25_rx_get_stats(&tnc, &stats), 0);
+    EXPECT_EQ(stats.frames_in, 11u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.high_water, 11u);
+}
+
+TEST_F(TestAX25Protocol, RxQueuesSeparateFrameTypes)
+{
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+
+    // I, UI, I, UI: each reader gets its own type whatever is oldest
+    for (uint32_t seq = 0; seq < 4; seq++) {
+        ax25_frame_t frame = make_numbered_frame((seq & 1) ? AX25_CTRL_UI : AX25_CTRL_I, seq);
+        ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), 0);
+    }
+
+    ax25_address_t src, dst, digis[2];
+    uint8_t pid, info[AX25_MAX_INFO];
+    uint8_t num_digis = 2;
+    uint16_t info_len = sizeof(info);
+    ASSERT_EQ(ax25_receive_ui_frame(&tnc, &src, &dst, digis, &num_digis, &pid, info, &info_len), 4);
+    EXPECT_EQ(frame_seq(info), 1u);
+    uint16_t length = sizeof(info);
+    ASSERT_EQ(ax25_receive_data(&tnc, &src, info, &length), 4);
+    EXPECT_EQ(frame_seq(info), 0u);
+    length = sizeof(info);
+    ASSERT_EQ(ax25_receive_data(&tnc, &src, info, &length), 4);
+    EXPECT_EQ(frame_seq(info), 2u);
+    length = sizeof(info);
+    EXPECT_EQ(ax25_receive_data(&tnc, &src, info, &length), 0);
+
+    // Dequeueing either type keeps arrival order across the queues
+    for (uint32_t seq = 4; seq < 8; seq++) {
+        ax25_frame_t frame = make_numbered_frame((seq & 2) ? AX25_CTRL_UI : AX25_CTRL_I, seq);
+        ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), 0);
+    }
+    ax25_frame_t frame;
+    for (uint32_t seq : { 3u, 4u, 5u, 6u, 7u }) {
+        ASSERT_EQ(ax25_rx_dequeue(&tnc, &frame), 1);
+        EXPECT_EQ(frame_seq(frame.info), seq);
+    }
+    EXPECT_EQ(ax25_rx_dequeue(&tnc, &frame), 0);
+}
+
+TEST_F(TestAX25Protocol, RxQueueKeepsFramesForBadView)
+{
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+    ASSERT_EQ(ax25_rx_set_policy(&tnc, AX25_RX_DROP_OLDEST), 0);
+    for (uint32_t seq = 0; seq < AX25_RX_QUEUE_LEN; seq++) {
+        ax25_frame_t frame = make_numbered_frame(AX25_CTRL_UI, seq);
+        ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), 0);
+    }
+
+    // A UI frame view that fails to decode: its information field has been
+    // stretched past the limit
+    ax25_address_t addresses[2];
+    ax25_set_address(&addresses[0], "APRS", 0, true);
+    ax25_set_address(&addresses[1], "N0CALL", 0, false);
+    ax25_header_template_t tmpl;
+    ASSERT_EQ(ax25_header_template_init(&tmpl, addresses, 2, AX25_CTRL_UI, AX25_PID_NONE), 0);
+    std::vector<uint8_t> raw(tmpl.bytes, tmpl.bytes + tmpl.length);
+    raw.resize(raw.size() + 2 * AX25_MAX_INFO, 'x');
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, raw.data(), tmpl.length + 6), 0);
+    view.info_length = AX25_MAX_INFO + 1;
+
+    EXPECT_EQ(ax25_rx_enqueue_view(&tnc, &view), -1);
+    ax25_rx_stats_t stats;
+    ax25_rx_get_stats(&tnc, &stats);
+    EXPECT_EQ(stats.dropped, 0u);
+    ax25_frame_t frame;
+    ASSERT_EQ(ax25_rx_dequeue(&tnc, &frame), 1);
+    EXPECT_EQ(frame_seq(frame.info), 0u);
+}
+
+TEST_F(TestAX25Protocol, RxQueuesSkipLinkControlFrames)
+{
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+
+    // S and U frames other than UI are not handed to the application
+    for (uint8_t control : { AX25_CTRL_RR, AX25_CTRL_SABM | AX25_CTRL_PF, AX25_CTRL_DISC,
+                             AX25_CTRL_UA, AX25_CTRL_DM }) {
+        ax25_frame_t frame = make_numbered_frame(control, control);
+        EXPECT_EQ(ax25_rx_enqueue(&tnc, &frame), -1);
+    }
+    EXPECT_EQ(ax25_rx_pending(&tnc), 0u);
+
+    // A UI frame with P/F set is still UI; the digipeater path is optional
+    ax25_frame_t frame = make_numbered_frame(AX25_CTRL_UI | AX25_CTRL_PF, 7);
+    ax25_set_address(&frame.addresses[2], "WIDE1", 1, false);
+    frame.num_addresses = 3;
+    ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), 0);
+
+    ax25_address_t src, dst;
+    uint8_t pid, info[AX25_MAX_INFO];
+    uint8_t num_digis = 4;
+    uint16_t info_len = sizeof(info);
+    ASSERT_EQ(ax25_receive_ui_frame(&tnc, &src, &dst, NULL, &num_digis, &pid, info, &info_len), 4);
+    EXPECT_EQ(frame_seq(info), 7u);
+    EXPECT_EQ(num_digis, 0);
+}
+
+TEST_F(TestAX25Protocol, RxQueueDropPolicies)
+{
+    for (auto policy : { AX25_RX_DROP_NEWEST, AX25_RX_DROP_OLDEST }) {
+        ax25_tnc_t tnc;
+        ASSERT_EQ(ax25_init(&tnc), 0);
+        ASSERT_EQ(ax25_rx_set_policy(&tnc, policy), 0);
+
+        const uint32_t total = AX25_RX_QUEUE_LEN + 5;
+        for (uint32_t seq = 0; seq < total; seq++) {
+            ax25_frame_t frame = make_numbered_frame(AX25_CTRL_UI, seq);
+            int expected = (policy == AX25_RX_DROP_NEWEST && seq >= AX25_RX_QUEUE_LEN) ? -1 : 0;
+            ASSERT_EQ(ax25_rx_enqueue(&tnc, &frame), expected);
+        }
+
+        uint32_t first = (policy == AX25_RX_DROP_NEWEST) ? 0 : total - AX25_RX_QUEUE_LEN;
+        ax25_frame_t frame;
+        for (uint32_t i = 0; i < AX25_RX_QUEUE_LEN; i++) {
+            ASSERT_EQ(ax25_rx_dequeue(&tnc, &frame), 1);
+            EXPECT_EQ(frame_seq(frame.info), first + i);
+        }
+        EXPECT_EQ(ax25_rx_dequeue(&tnc, &frame), 0);
+
+        ax25_rx_stats_t stats;
+        ASSERT_EQ(ax25_rx_get_stats(&tnc, &stats), 0);
+        EXPECT_EQ(stats.dropped, 5u);
+        EXPECT_EQ(stats.high_water, (uint32_t)AX25_RX_QUEUE_LEN);
+    }
+}
+
+TEST_F(TestAX25Protocol, RxQueueConcurrentProducer)
+{
+    // Decoder thread and application thread sharing one TNC
+    for (auto policy : { AX25_RX_DROP_NEWEST, AX25_RX_DROP_OLDEST }) {
+        ax25_tnc_t tnc;
+        ASSERT_EQ(ax25_init(&tnc), 0);
+        ASSERT_EQ(ax25_rx_set_policy(&tnc, policy), 0);
+
+        const uint32_t total = 200000;
+        std::atomic<bool> done{ false };
+        std::thread producer([&] {
+            for (uint32_t seq = 0; seq < total; seq++) {
+                // The PID repeats the number, far from the info field, so a
+                // copy torn by an eviction shows up as a mismatch
+                ax25_frame_t frame = make_numbered_frame(AX25_CTRL_UI, seq);
+                frame.pid = (uint8_t)seq;
+                ax25_rx_enqueue(&tnc, &frame);
+            }
+            done = true;
+        });
+
+        uint32_t received = 0;
+        int64_t last = -1;
+        bool ordered = true;
+        ax25_frame_t frame;
+        for (;;) {
+            bool finished = done;
+            while (ax25_rx_dequeue(&tnc, &frame) == 1) {
+                int64_t seq = frame_seq(frame.info);
+                ordered = ordered && seq > last && frame.info_length == 4 &&
+                          frame.pid == (uint8_t)seq;
+                last = seq;
+                received++;
+            }
+            if (finished) {
+                break;
+            }
+        }
+        producer.join();
+
+        ax25_rx_stats_t stats;
+        ASSERT_EQ(ax25_rx_get_stats(&tnc, &stats), 0);
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(received + stats.dropped, total);
+        EXPECT_EQ(stats.frames_in, total - (policy == AX25_RX_DROP_NEWEST ? stats.dropped : 0));
+    }
+}
+
+namespace {
+
+// Distinct station for each index: 4-letter callsign plus SSID
+ax25_address_t make_station(uint32_t index)
+{
+    char callsign[7] = "N0";
+    callsign[2] = 'A' + index % 26;
+    callsign[3] = 'A' + (index / 26) % 26;
+    callsign[4] = 'A' + (index / 676) % 26;
+    callsign[5] = '\0';
+    ax25_address_t addr;
+    ax25_set_address(&addr, callsign, (index / 17576) % 16, false);
+    return addr;
+}
+
+} // namespace
+
+TEST_F(TestAX25Protocol, SessionTableChurn)
+{
+    ax25_session_table_t table;
+    ASSERT_EQ(ax25_session_table_init(&table), 0);
+    ax25_address_t local;
+    ax25_set_address(&local, "N0NODE", 0, false);
+
+    const uint32_t sessions = 5000;
+    std::vector<ax25_connection_t*> created(sessions);
+    for (uint32_t i = 0; i < sessions; i++) {
+        ax25_address_t remote = make_station(i);
+        created[i] = ax25_session_insert(&table, &local, &remote);
+        ASSERT_NE(created[i], nullptr);
+        created[i]->send_seq = i % 8;
+    }
+    EXPECT_EQ(ax25_session_count(&table), sessions);
+
+    // Inserting again returns the same session; the C/R bit is not part of the key
+    ax25_address_t again = make_station(1234);
+    again.ssid |= 0x80;
+    again.command = true;
+    EXPECT_EQ(ax25_session_insert(&table, &local, &again), created[1234]);
+    EXPECT_EQ(ax25_session_count(&table), sessions);
+
+    // Remove a shuffled half; the rest stay reachable and in place
+    std::vector<uint32_t> order(sessions);
+    for (uint32_t i = 0; i < sessions; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(41));
+    for (uint32_t i = 0; i < sessions / 2; i++) {
+        ax25_address_t remote = make_station(order[i]);
+        ASSERT_EQ(ax25_session_remove(&table, &local, &remote), 0);
+        EXPECT_EQ(ax25_session_remove(&table, &local, &remote), -1);
+    }
+    for (uint32_t i = 0; i < sessions; i++) {
+        ax25_address_t remote = make_station(order[i]);
+        ax25_connection_t* session = ax25_session_find(&table, &local, &remote);
+        if (i < sessions / 2) {
+            EXPECT_EQ(session, nullptr);
+        } else {
+            ASSERT_EQ(session, created[order[i]]);
+            EXPECT_EQ(session->send_seq, order[i] % 8);
+            EXPECT_TRUE(ax25_address_equal(&session->remote_addr, &remote));
+        }
+    }
+
+    // The local address is part of the key too
+    ax25_address_t other_local;
+    ax25_set_address(&other_local, "N0NODE", 1, false);
+    ax25_address_t remote = make_station(order[sessions - 1]);
+    EXPECT_EQ(ax25_session_find(&table, &other_local, &remote), nullptr);
+
+    uint32_t visited = 0;
+    ax25_session_foreach(
+        &table, [](void* ctx, ax25_connection_t*) { (*static_cast<uint32_t*>(ctx))++; }, &visited);
+    EXPECT_EQ(visited, sessions - sessions / 2);
+
+    ax25_session_table_free(&table);
+    EXPECT_EQ(ax25_session_count(&table), 0u);
+}
+
+TEST_F(TestAX25Protocol, TncConnectsBeyondSixteenSessions)
+{
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+    ax25_set_address(&tnc.config.my_address, "N0NODE", 0, false);
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        ax25_address_t remote = make_station(i);
+        ASSERT_EQ(ax25_connect(&tnc, &remote), 0);
+    }
+    EXPECT_EQ(ax25_session_count(&tnc.sessions), 1000u);
+
+    ax25_address_t remote = make_station(500);
+    ax25_connection_t* session = ax25_session_find(&tnc.sessions, &tnc.config.my_address, &remote);
+    ASSERT_NE(session, nullptr);
+    EXPECT_EQ(session->state, AX25_STATE_CONNECTING);
+
+    // Data needs an established session
+    const uint8_t payload[] = { 1, 2, 3 };
+    EXPECT_EQ(ax25_send_data(&tnc, &remote, payload, sizeof(payload)), -1);
+    session->state = AX25_STATE_CONNECTED;
+    EXPECT_EQ(ax25_send_data(&tnc, &remote, payload, sizeof(payload)), 0);
+    EXPECT_EQ(session->send_seq, 1);
+
+    // An established session waits for UA; an unanswered SABM is abandoned
+    EXPECT_EQ(ax25_disconnect(&tnc, &remote), 0);
+    EXPECT_EQ(session->state, AX25_STATE_DISCONNECTING);
+    EXPECT_EQ(ax25_session_count(&tnc.sessions), 1000u);
+    ax25_address_t pending = make_station(501);
+    EXPECT_EQ(ax25_disconnect(&tnc, &pending), 0);
+    EXPECT_EQ(ax25_disconnect(&tnc, &pending), -1);
+    EXPECT_EQ(ax25_session_count(&tnc.sessions), 999u);
+    ax25_cleanup(&tnc);
+}
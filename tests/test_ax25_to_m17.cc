@@ -10,6 +10,70 @@
 
 #include <gtest/gtest.h>
 #include <gnuradio/m17_bridge/ax25_to_m17.h>
+#include <gnuradio/m17_bridge/m17_packet.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// AX.25 frame body (addresses through info) whose bytes avoid the flag
+std::vector<uint8_t> make_frame(int seed, size_t info_len)
+{
+    std::vector<uint8_t> frame(16 + info_len);
+    for (size_t i = 0; i < frame.size(); i++) {
+        frame[i] = 0x40 + (seed * 11 + i) % 0x30;
+    }
+    return frame;
+}
+
+// Flag, frame, dummy FCS, flag
+void append_flagged(std::vector<uint8_t>& stream, const std::vector<uint8_t>& frame)
+{
+    stream.push_back(0x7E);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    stream.insert(stream.end(), { 0x12, 0x34 });
+    stream.push_back(0x7E);
+}
+
+// Runs the block with no new input, as the scheduler does once forecast
+// stops asking for input, until output appears or a second has passed
+std::vector<uint8_t> drain_idle(gr::m17_bridge::ax25_to_m17::sptr block)
+{
+    std::vector<uint8_t> out(4096);
+    gr_vector_int ninput = { 0 };
+    gr_vector_const_void_star in_items = { nullptr };
+    gr_vector_void_star out_items = { out.data() };
+    for (int i = 0; i < 200; i++) {
+        gr_vector_int required(1);
+        block->forecast((int)out.size(), required);
+        if (required[0] == 0) {
+            int produced = block->general_work((int)out.size(), ninput, in_items, out_items);
+            out.resize(produced);
+            return out;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return {};
+}
+
+// Reassembles the packet carried by the block's output
+bool reassemble(const std::vector<uint8_t>& stream, m17_packet_t& packet)
+{
+    const size_t frame_len = 3 + M17_PACKET_FRAME_LEN; // Marker and frame type first
+    m17_packet_reasm_t reasm;
+    m17_packet_reasm_init(&reasm, 1, M17_PACKET_REASM_TIMEOUT_MS);
+    int result = 0;
+    for (size_t pos = 0; pos + frame_len <= stream.size() && result == 0; pos += frame_len) {
+        result = m17_packet_reasm_push(&reasm, 1, &stream[pos + 3], 0, &packet);
+    }
+    m17_packet_reasm_free(&reasm);
+    return result == 1;
+}
+
+} // namespace
 
 class TestAX25ToM17 : public ::testing::Test
 {
@@ -59,3 +123,69 @@ TEST_F(TestAX25ToM17, FECSetting)
     // These should not throw exceptions
     SUCCEED();
 }
+
+TEST_F(TestAX25ToM17, BatchSetting)
+{
+    auto block = gr::m17_bridge::ax25_to_m17::make(
+        "N0CALL", "APRS", false, 250, 400);
+    
+    // Test batching setters
+    block->set_batch_window(500);
+    block->set_batch_max_bytes(822);
+    block->set_batch_window(0);
+    
+    // Nothing sent yet, so nothing saved
+    EXPECT_EQ(block->airtime_saved_ms(), 0u);
+}
+
+TEST_F(TestAX25ToM17, BatchMaxBytesOutOfRange)
+{
+    EXPECT_THROW(gr::m17_bridge::ax25_to_m17::make("N0CALL", "APRS", false, 250, 1000),
+                 std::invalid_argument);
+}
+
+TEST_F(TestAX25ToM17, IdleChannelFlushesBatch)
+{
+    auto block = gr::m17_bridge::ax25_to_m17::make("N0CALL", "APRS", false, 20, 822);
+    ASSERT_TRUE(block->start());
+
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 4; i++) {
+        frames.push_back(make_frame(i, 10 + i));
+        append_flagged(stream, frames.back());
+    }
+
+    // The frames wait for the window, and no more input ever arrives
+    std::vector<uint8_t> out(4096);
+    gr_vector_int ninput = { (int)stream.size() };
+    gr_vector_const_void_star in_items = { stream.data() };
+    gr_vector_void_star out_items = { out.data() };
+    ASSERT_EQ(block->general_work((int)out.size(), ninput, in_items, out_items), 0);
+
+    // One container carries all four
+    m17_packet_t packet;
+    ASSERT_TRUE(reassemble(drain_idle(block), packet));
+    EXPECT_EQ(packet.protocol, M17_PACKET_PROTO_AX25_BATCH);
+    uint16_t offset = 0;
+    const uint8_t* frame;
+    uint16_t length;
+    for (const auto& expected : frames) {
+        ASSERT_EQ(m17_packet_batch_next(&packet, &offset, &frame, &length), 1);
+        EXPECT_EQ(std::vector<uint8_t>(frame, frame + length), expected);
+    }
+    EXPECT_EQ(m17_packet_batch_next(&packet, &offset, &frame, &length), 0);
+    EXPECT_GT(block->airtime_saved_ms(), 0u);
+
+    // A lone frame goes as plain AX.25
+    stream.clear();
+    append_flagged(stream, frames[0]);
+    ninput[0] = (int)stream.size();
+    in_items[0] = stream.data();
+    ASSERT_EQ(block->general_work((int)out.size(), ninput, in_items, out_items), 0);
+    ASSERT_TRUE(reassemble(drain_idle(block), packet));
+    EXPECT_EQ(packet.protocol, M17_PACKET_PROTO_AX25);
+    EXPECT_EQ(std::vector<uint8_t>(packet.data, packet.data + packet.length), frames[0]);
+
+    ASSERT_TRUE(block->stop());
+}
@@ -10,6 +10,17 @@
 
 #include <gtest/gtest.h>
 #include <gnuradio/m17_bridge/callsign_mapper.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+#include <gnuradio/m17_bridge/callsign_snapshot.h>
+#include "callsign_clock_cache.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 class TestCallsignMapper : public ::testing::Test
 {
@@ -88,3 +99,403 @@ TEST_F(TestCallsignMapper, MappingTableOperations)
     
     SUCCEED();
 }
+
+TEST_F(TestCallsignMapper, ConcurrentLookupsDuringUpdates)
+{
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->set_auto_mapping_enabled(false);
+    block->add_mapping("SP5WWP", "SP5WWP-1");
+
+    std::atomic<bool> running(true);
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> readers;
+
+    // Readers must always see the stable mapping while the table is rewritten
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&]() {
+            while (running.load()) {
+                if (block->get_ax25_callsign("SP5WWP") != "SP5WWP-1" ||
+                    block->get_m17_callsign("SP5WWP-1") != "SP5WWP") {
+                    mismatches++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 500; i++) {
+        std::string call = "TMP" + std::to_string(i);
+        block->add_mapping(call, call + "-7");
+        if (i % 2) {
+            block->remove_mapping(call);
+        }
+    }
+
+    running = false;
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    ASSERT_EQ(mismatches.load(), 0);
+    ASSERT_EQ(block->get_ax25_callsign("TMP498"), "TMP498-7");
+    ASSERT_EQ(block->get_ax25_callsign("TMP499"), "TMP499");
+}
+
+TEST_F(TestCallsignMapper, ConcurrentWritersAndReaders)
+{
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->set_auto_mapping_enabled(false);
+    block->add_mapping("SP5WWP", "SP5WWP-1");
+
+    std::atomic<bool> running(true);
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+
+    // Back-to-back writers flip the epoch twice while a reader may be between
+    // reading it and registering; a snapshot freed under a reader shows up as
+    // a wrong answer here, or as a use-after-free under AddressSanitizer
+    for (int r = 0; r < 6; r++) {
+        threads.emplace_back([&, r]() {
+            while (running.load()) {
+                if (block->get_ax25_callsign("SP5WWP") != "SP5WWP-1" ||
+                    block->get_m17_callsign("SP5WWP-1") != "SP5WWP") {
+                    mismatches++;
+                }
+                std::string call = block->get_ax25_callsign("W0" + std::to_string(r));
+                if (call != "W0" + std::to_string(r) && call != "W0" + std::to_string(r) + "-9") {
+                    mismatches++;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 3; w++) {
+        writers.emplace_back([&, w]() {
+            for (int i = 0; i < 2000; i++) {
+                std::string call = "W0" + std::to_string((i + w) % 6);
+                block->add_mapping(call, call + "-9");
+                block->remove_mapping(call);
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+
+    running = false;
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(mismatches.load(), 0);
+    ASSERT_EQ(block->get_ax25_callsign("SP5WWP"), "SP5WWP-1");
+}
+
+TEST_F(TestCallsignMapper, AutoMappingCacheIsBounded)
+{
+    // Three slots form a single bucket, so eviction order is exact
+    gr::m17_bridge::callsign_clock_cache cache(3);
+
+    cache.insert("A1A");
+    cache.insert("B1B");
+    cache.insert("C1C");
+    ASSERT_TRUE(cache.lookup("A1A")); // A1A is referenced
+    cache.insert("D1D");              // A1A gets a second chance, B1B goes
+
+    ASSERT_FALSE(cache.lookup("B1B"));
+    ASSERT_TRUE(cache.lookup("C1C"));
+    ASSERT_TRUE(cache.lookup("D1D"));
+
+    auto stats = cache.get_stats();
+    ASSERT_EQ(stats.hits, 3u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.evictions, 1u);
+    ASSERT_EQ(stats.size, 3u);
+
+    // Shrinking keeps a referenced entry over the unreferenced A1A
+    cache.set_capacity(1);
+    stats = cache.get_stats();
+    ASSERT_EQ(stats.size, 1u);
+    ASSERT_EQ(stats.capacity, 1u);
+    ASSERT_EQ(stats.evictions, 3u);
+    ASSERT_FALSE(cache.lookup("A1A"));
+    ASSERT_TRUE(cache.lookup("C1C") || cache.lookup("D1D"));
+
+    // Erased and unencodable callsigns are not found
+    cache.erase("C1C");
+    cache.erase("D1D");
+    ASSERT_EQ(cache.get_stats().size, 0u);
+    cache.insert("TOOLONGCALL");
+    ASSERT_FALSE(cache.lookup("TOOLONGCALL"));
+    ASSERT_EQ(cache.get_stats().size, 0u);
+}
+
+TEST_F(TestCallsignMapper, AutoMappingCacheConcurrentLookups)
+{
+    gr::m17_bridge::callsign_clock_cache cache(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 20000; i++) {
+                // A hot set shared by every thread plus a stream of one-offs
+                std::string call = (i % 2) ? "HOT" + std::to_string(i % 16)
+                                           : "T" + std::to_string(t) + "X" + std::to_string(i);
+                if (!cache.lookup(call)) {
+                    cache.insert(call);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = cache.get_stats();
+    ASSERT_LE(stats.size, 64u);
+    ASSERT_EQ(stats.hits + stats.misses, 80000u);
+    ASSERT_GT(stats.hits, 20000u); // The hot set stays cached
+}
+
+TEST_F(TestCallsignMapper, AutoMappingCacheResizesUnderLoad)
+{
+    // Each resize frees the table it replaces once in-flight operations
+    // have drained, so repeated resizes neither leak nor race the readers
+    gr::m17_bridge::callsign_clock_cache cache(64);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, &done, t] {
+            for (int i = 0; !done.load(); i++) {
+                std::string call = "R" + std::to_string(t) + "X" + std::to_string(i % 500);
+                if (!cache.lookup(call)) {
+                    cache.insert(call);
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 2000; i++) {
+        cache.set_capacity(16 + (i % 7) * 16);
+    }
+    done.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = cache.get_stats();
+    ASSERT_EQ(stats.capacity, 16u + (1999 % 7) * 16);
+    ASSERT_LE(stats.size, stats.capacity);
+}
+
+TEST_F(TestCallsignMapper, AutoMappingsNotPinned)
+{
+    auto block = gr::m17_bridge::callsign_mapper::make(16);
+    block->clear_mappings();
+    block->add_mapping("SP5WWP", "SP5WWP-1");
+    ASSERT_EQ(block->auto_mapping_capacity(), 16);
+
+    // Many unseen callsigns resolve to themselves but never enter the pinned table
+    for (int i = 0; i < 1000; i++) {
+        std::string call = "AUTO" + std::to_string(i);
+        ASSERT_EQ(block->get_ax25_callsign(call), call);
+    }
+    ASSERT_EQ(block->get_mapping_table().size(), 1u);
+    ASSERT_EQ(block->get_ax25_callsign("SP5WWP"), "SP5WWP-1");
+    ASSERT_EQ(block->get_m17_callsign("SP5WWP-1"), "SP5WWP");
+}
+
+TEST_F(TestCallsignMapper, TextMappingFileRoundTrip)
+{
+    const std::string path = "test_mappings_roundtrip.txt";
+    {
+        std::ofstream out(path);
+        out << "# comment line\n"
+            << "SP5WWP  SP5WWP-1\n"
+            << "\n"
+            << "N0CALL N0CALL-9   # trailing comment\n";
+    }
+
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->load_mappings_from_file(path);
+    auto table = block->get_mapping_table();
+    ASSERT_EQ(table.size(), 2u);
+    ASSERT_EQ(table["SP5WWP"], "SP5WWP-1");
+    ASSERT_EQ(block->get_m17_callsign("N0CALL-9"), "N0CALL");
+
+    block->add_mapping("W1AW", "W1AW-5");
+    block->save_mappings_to_file(path);
+
+    auto reloaded = gr::m17_bridge::callsign_mapper::make();
+    reloaded->load_mappings_from_file(path);
+    ASSERT_EQ(reloaded->get_mapping_table(), block->get_mapping_table());
+    std::remove(path.c_str());
+}
+
+TEST_F(TestCallsignMapper, BinarySnapshotLookups)
+{
+    const std::string path = "test_mappings_snapshot.snap";
+    const uint32_t count = 1000;
+
+    std::vector<callsign_snapshot_record_t> forward(count);
+    std::vector<callsign_snapshot_record_t> reverse(count);
+    for (uint32_t i = 0; i < count; i++) {
+        std::string m17 = "M" + std::to_string(i);
+        std::string ax25 = "AX" + std::to_string(i) + "-1";
+        ASSERT_EQ(callsign_snapshot_record_set(&forward[i], m17.c_str(), ax25.c_str()), 0);
+        ASSERT_EQ(callsign_snapshot_record_set(&reverse[i], ax25.c_str(), m17.c_str()), 0);
+    }
+    ASSERT_EQ(callsign_snapshot_write(path.c_str(), forward.data(), count, reverse.data(),
+                                      count),
+              0);
+    ASSERT_TRUE(callsign_snapshot_probe(path.c_str()));
+
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->set_auto_mapping_enabled(false);
+    block->load_mappings_from_file(path);
+
+    ASSERT_EQ(block->get_mapping_table().size(), count);
+    ASSERT_EQ(block->get_ax25_callsign("M0"), "AX0-1");
+    ASSERT_EQ(block->get_ax25_callsign("M999"), "AX999-1");
+    ASSERT_EQ(block->get_m17_callsign("AX500-1"), "M500");
+    ASSERT_EQ(block->get_ax25_callsign("M1000"), "M1000");
+
+    // Overlay edits on top of the mapped table
+    block->remove_mapping("M7");
+    ASSERT_EQ(block->get_ax25_callsign("M7"), "M7");
+    ASSERT_EQ(block->get_m17_callsign("AX7-1"), "AX7-1");
+    block->add_mapping("M8", "OTHER-2");
+    ASSERT_EQ(block->get_ax25_callsign("M8"), "OTHER-2");
+    auto table = block->get_mapping_table();
+    ASSERT_EQ(table.size(), count - 1);
+    ASSERT_EQ(table["M8"], "OTHER-2");
+
+    // A flipped byte fails the checksum
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(CALLSIGN_SNAPSHOT_HEADER_LEN + 5);
+        f.put('#');
+    }
+    ASSERT_THROW(block->load_mappings_from_file(path), std::runtime_error);
+    ASSERT_EQ(block->get_ax25_callsign("M8"), "OTHER-2");
+
+    // A missing file keeps the current table
+    std::remove(path.c_str());
+    block->load_mappings_from_file(path);
+    ASSERT_EQ(block->get_mapping_table().size(), count - 1);
+}
+
+static std::vector<uint8_t> make_ui_frame(const char* src_call, uint8_t src_ssid,
+                                          const char* dst_call)
+{
+    ax25_address_t src, dst;
+    ax25_set_address(&src, src_call, src_ssid, false);
+    ax25_set_address(&dst, dst_call, 0, true);
+
+    const uint8_t info[] = ">status";
+    ax25_frame_t frame;
+    ax25_create_frame(&frame, &src, &dst, AX25_CTRL_UI, AX25_PID_NONE, info, sizeof(info) - 1);
+
+    uint8_t encoded[512];
+    uint16_t encoded_len = sizeof(encoded);
+    ax25_encode_frame(&frame, encoded, &encoded_len);
+    return std::vector<uint8_t>(encoded, encoded + encoded_len);
+}
+
+TEST_F(TestCallsignMapper, FrameRewriting)
+{
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->add_mapping("SP5WWP", "SP5WWP-7");
+
+    std::vector<uint8_t> mapped = make_ui_frame("SP5WWP", 0, "APRS");
+    std::vector<uint8_t> unmapped = make_ui_frame("W1XYZ", 3, "APRS");
+
+    // flag, mapped frame, flag, unmapped frame, flag, first half of another frame
+    std::vector<uint8_t> stream = { AX25_FLAG };
+    stream.insert(stream.end(), mapped.begin(), mapped.end());
+    stream.push_back(AX25_FLAG);
+    stream.insert(stream.end(), unmapped.begin(), unmapped.end());
+    stream.push_back(AX25_FLAG);
+    size_t partial_start = stream.size() - 1;
+    stream.insert(stream.end(), mapped.begin(), mapped.begin() + 10);
+
+    std::vector<uint8_t> out(stream.size());
+    gr_vector_const_void_star in_items = { stream.data() };
+    gr_vector_void_star out_items = { out.data() };
+    int produced = block->work((int)stream.size(), in_items, out_items);
+
+    // The incomplete trailing frame is held back from its opening flag
+    ASSERT_EQ(produced, (int)partial_start);
+
+    // Source SSID rewritten to 7, FCS still valid
+    const uint8_t* frame = &out[1];
+    uint16_t len = (uint16_t)mapped.size();
+    ASSERT_EQ((frame[13] >> 1) & 0x0F, 7);
+    ASSERT_EQ(memcmp(frame, mapped.data(), 13), 0);
+    uint16_t fcs = frame[len - 2] | (frame[len - 1] << 8);
+    ASSERT_TRUE(ax25_check_fcs(frame, len - 2, fcs));
+    ASSERT_NE(memcmp(frame, mapped.data(), len), 0);
+
+    // Unmapped frame passes through untouched
+    ASSERT_EQ(memcmp(&out[2 + mapped.size()], unmapped.data(), unmapped.size()), 0);
+
+    // A mapped frame closed by the held-back flag is still rewritten
+    std::vector<uint8_t> closing = { AX25_FLAG };
+    closing.insert(closing.end(), unmapped.begin(), unmapped.end());
+    closing.push_back(AX25_FLAG);
+    closing.insert(closing.end(), mapped.begin(), mapped.end());
+    closing.push_back(AX25_FLAG);
+    std::vector<uint8_t> closing_out(closing.size());
+    in_items = { closing.data() };
+    out_items = { closing_out.data() };
+    ASSERT_EQ(block->work((int)closing.size(), in_items, out_items),
+              (int)closing.size() - 1);
+    frame = &closing_out[2 + unmapped.size()];
+    ASSERT_EQ((frame[13] >> 1) & 0x0F, 7);
+    fcs = frame[len - 2] | (frame[len - 1] << 8);
+    ASSERT_TRUE(ax25_check_fcs(frame, len - 2, fcs));
+
+    // Data without flags is not treated as frames
+    std::vector<uint8_t> raw(64, 0x55);
+    std::vector<uint8_t> raw_out(raw.size());
+    in_items = { raw.data() };
+    out_items = { raw_out.data() };
+    ASSERT_EQ(block->work((int)raw.size(), in_items, out_items), (int)raw.size());
+    ASSERT_EQ(raw, raw_out);
+}
+
+TEST_F(TestCallsignMapper, FrameSplitAfterOpeningFlag)
+{
+    auto block = gr::m17_bridge::callsign_mapper::make();
+    block->add_mapping("SP5WWP", "SP5WWP-7");
+
+    std::vector<uint8_t> mapped = make_ui_frame("SP5WWP", 0, "APRS");
+    std::vector<uint8_t> unmapped = make_ui_frame("W1XYZ", 3, "APRS");
+
+    // The input ends with the flag opening the mapped frame
+    std::vector<uint8_t> first = { AX25_FLAG };
+    first.insert(first.end(), unmapped.begin(), unmapped.end());
+    first.push_back(AX25_FLAG);
+    std::vector<uint8_t> out(first.size());
+    gr_vector_const_void_star in_items = { first.data() };
+    gr_vector_void_star out_items = { out.data() };
+    int produced = block->work((int)first.size(), in_items, out_items);
+    ASSERT_EQ(produced, (int)first.size() - 1);
+
+    // A lone flag is held until more input arrives
+    in_items = { &first.back() };
+    ASSERT_EQ(block->work(1, in_items, out_items), 0);
+
+    // The next call resumes at the held flag and sees the whole frame
+    std::vector<uint8_t> second = { AX25_FLAG };
+    second.insert(second.end(), mapped.begin(), mapped.end());
+    second.push_back(AX25_FLAG);
+    out.assign(second.size(), 0);
+    in_items = { second.data() };
+    out_items = { out.data() };
+    ASSERT_EQ(block->work((int)second.size(), in_items, out_items), (int)second.size() - 1);
+
+    const uint8_t* frame = &out[1];
+    uint16_t len = (uint16_t)mapped.size();
+    ASSERT_EQ((frame[13] >> 1) & 0x0F, 7);
+    uint16_t fcs = frame[len - 2] | (frame[len - 1] << 8);
+    ASSERT_TRUE(ax25_check_fcs(frame, len - 2, fcs));
+}
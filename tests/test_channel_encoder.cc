@@ -0,0 +1,50 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/channel_encoder.h>
+
+#include <stdexcept>
+
+class TestChannelEncoder : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Set up test fixtures
+    }
+    
+    void TearDown() override
+    {
+        // Clean up test fixtures
+    }
+};
+
+TEST_F(TestChannelEncoder, FrameSizes)
+{
+    using gr::m17_bridge::channel_encoder;
+
+    auto lsf = channel_encoder::make(channel_encoder::FRAME_LSF);
+    ASSERT_NE(lsf, nullptr);
+    EXPECT_EQ(lsf->payload_bytes(), 30);
+    EXPECT_EQ(lsf->frame_symbols(), 192);
+
+    auto stream = channel_encoder::make(channel_encoder::FRAME_STREAM);
+    EXPECT_EQ(stream->payload_bytes(), 30);
+
+    auto packet = channel_encoder::make(channel_encoder::FRAME_PACKET);
+    EXPECT_EQ(packet->payload_bytes(), 26);
+    EXPECT_EQ(packet->frame_symbols(), 192);
+}
+
+TEST_F(TestChannelEncoder, UnknownFrameType)
+{
+    EXPECT_THROW(gr::m17_bridge::channel_encoder::make(-1), std::invalid_argument);
+}
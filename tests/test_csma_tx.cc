@@ -0,0 +1,308 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+#include <gnuradio/m17_bridge/csma_tx.h>
+
+#include <vector>
+
+namespace {
+
+struct radio {
+    std::vector<std::vector<uint8_t>> frames;   //!< Frames sent, in air order
+    std::vector<size_t> bursts;                 //!< Frames sent per key-up
+    bool keyed = false;                         //!< PTT state
+    int keyups = 0;                             //!< PTT assertions
+};
+
+int radio_send(void* ctx, const uint8_t* data, uint16_t length)
+{
+    auto* r = static_cast<radio*>(ctx);
+    r->frames.emplace_back(data, data + length);
+    r->bursts.back()++;
+    return 0;
+}
+
+void radio_ptt(void* ctx, bool keyed)
+{
+    auto* r = static_cast<radio*>(ctx);
+    EXPECT_NE(r->keyed, keyed);
+    r->keyed = keyed;
+    if (keyed) {
+        r->keyups++;
+        r->bursts.push_back(0);
+    }
+}
+
+// Poll at every scheduled event until the queues are empty
+void run_until_idle(csma_tx_t* tx)
+{
+    uint64_t next;
+    while ((next = csma_tx_next_event(tx)) != CSMA_TX_IDLE_EVENT) {
+        csma_tx_poll(tx, next);
+    }
+}
+
+} // namespace
+
+class TestCSMATx : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        csma_tx_config_init(&config);
+        config.persistence = 255; // Win every draw unless a test says otherwise
+        config.bit_rate = 1200;
+    }
+
+    void TearDown() override { csma_tx_destroy(tx); }
+
+    void create()
+    {
+        tx = csma_tx_create(&config, CSMA_TX_DEFAULT_DEPTH);
+        ASSERT_NE(tx, nullptr);
+        csma_tx_set_handlers(tx, radio_send, radio_ptt, &air);
+    }
+
+    void queue(uint8_t priority, uint8_t tag, uint16_t length = 30)
+    {
+        std::vector<uint8_t> frame(length, tag);
+        ASSERT_EQ(csma_tx_enqueue(tx, priority, frame.data(), length), 0);
+    }
+
+    csma_tx_config_t config;  //!< Scheduler settings
+    csma_tx_t* tx = nullptr;  //!< Scheduler under test
+    radio air;                //!< Records the transmitter
+};
+
+TEST_F(TestCSMATx, BurstPaysTxDelayOnce)
+{
+    create();
+    for (int i = 0; i < 5; i++) {
+        queue(CSMA_TX_PRIO_DATA, (uint8_t)i);
+    }
+
+    EXPECT_EQ(csma_tx_poll(tx, 1000), 0);
+    EXPECT_TRUE(air.keyed);
+    EXPECT_EQ(csma_tx_get_state(tx), CSMA_TX_KEYUP);
+    EXPECT_EQ(csma_tx_next_event(tx), 1500u);
+
+    // Nothing goes out before TXDELAY has run
+    EXPECT_EQ(csma_tx_poll(tx, 1499), 0);
+    EXPECT_EQ(csma_tx_poll(tx, 1500), 5);
+    ASSERT_EQ(air.frames.size(), 5u);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(air.frames[i][0], i);
+    }
+
+    // Five 30-byte frames with six flags at 1200 bit/s
+    uint64_t airtime = ((5 * 30 + 6) * 8 * 1000 + 1199) / 1200;
+    EXPECT_EQ(csma_tx_next_event(tx), 1500 + airtime);
+    run_until_idle(tx);
+    EXPECT_FALSE(air.keyed);
+    EXPECT_EQ(air.keyups, 1);
+
+    csma_tx_stats_t stats;
+    ASSERT_EQ(csma_tx_get_stats(tx, &stats), 0);
+    EXPECT_EQ(stats.keyups, 1u);
+    EXPECT_EQ(stats.frames, 5u);
+    EXPECT_EQ(stats.bytes, 150u);
+    EXPECT_EQ(stats.keyed_ms, 500 + airtime + 50);
+    EXPECT_EQ(stats.overhead_ms, 550u);
+}
+
+TEST_F(TestCSMATx, BurstLimitsSplitKeyups)
+{
+    config.max_burst_frames = 3;
+    config.max_burst_bytes = 100;
+    create();
+    for (int i = 0; i < 7; i++) {
+        queue(CSMA_TX_PRIO_DATA, (uint8_t)i, 40);
+    }
+    run_until_idle(tx);
+
+    // Two 40-byte frames fit in 100 bytes, so the frame limit never binds
+    EXPECT_EQ(air.bursts, (std::vector<size_t>{ 2, 2, 2, 1 }));
+
+    config.max_burst_bytes = 0;
+    ASSERT_EQ(csma_tx_set_config(tx, &config), 0);
+    for (int i = 0; i < 7; i++) {
+        queue(CSMA_TX_PRIO_DATA, (uint8_t)i, 40);
+    }
+    run_until_idle(tx);
+    EXPECT_EQ(air.bursts, (std::vector<size_t>{ 2, 2, 2, 1, 3, 3, 1 }));
+    EXPECT_EQ(air.frames.size(), 14u);
+}
+
+TEST_F(TestCSMATx, HigherPriorityGoesFirst)
+{
+    create();
+    queue(CSMA_TX_PRIO_UNPROTO, 'U');
+    queue(CSMA_TX_PRIO_DATA, 'I');
+    csma_tx_poll(tx, 0);
+
+    // Queued during TXDELAY: still in this burst, and ahead of the rest
+    queue(CSMA_TX_PRIO_CONTROL, 'S');
+    queue(CSMA_TX_PRIO_DATA, 'J');
+    run_until_idle(tx);
+
+    ASSERT_EQ(air.frames.size(), 4u);
+    EXPECT_EQ(air.frames[0][0], 'S');
+    EXPECT_EQ(air.frames[1][0], 'I');
+    EXPECT_EQ(air.frames[2][0], 'J');
+    EXPECT_EQ(air.frames[3][0], 'U');
+    EXPECT_EQ(air.keyups, 1);
+}
+
+TEST_F(TestCSMATx, DefersToCarrierAndPersistence)
+{
+    config.persistence = 63;
+    config.seed = 7;
+    create();
+
+    // Busy channel: one carrier check per 100 ms slot, no key-up
+    queue(CSMA_TX_PRIO_DATA, 1);
+    csma_tx_set_carrier(tx, true);
+    for (uint64_t t = 0; t < 1000; t += 100) {
+        csma_tx_poll(tx, t);
+    }
+    EXPECT_EQ(air.keyups, 0);
+    csma_tx_stats_t stats;
+    csma_tx_get_stats(tx, &stats);
+    EXPECT_EQ(stats.busy_slots, 10u);
+    EXPECT_EQ(stats.persist_slots, 0u);
+    EXPECT_EQ(csma_tx_next_event(tx), 1000u);
+
+    // Clear channel: p = 64/256 waits (1 - p) / p = 3 slots on average
+    csma_tx_set_carrier(tx, false);
+    const int trials = 4000;
+    for (int i = 0; i < trials; i++) {
+        if (i > 0) {
+            queue(CSMA_TX_PRIO_DATA, 1);
+        }
+        run_until_idle(tx);
+    }
+    csma_tx_get_stats(tx, &stats);
+    EXPECT_EQ(stats.keyups, (uint64_t)trials);
+    EXPECT_NEAR(stats.persist_slots / (double)trials, 3.0, 0.3);
+
+    // Full duplex ignores both
+    config.full_duplex = true;
+    config.persistence = 0;
+    csma_tx_set_config(tx, &config);
+    csma_tx_set_carrier(tx, true);
+    queue(CSMA_TX_PRIO_DATA, 2);
+    uint64_t now = csma_tx_next_event(tx);
+    csma_tx_poll(tx, now);
+    EXPECT_TRUE(air.keyed);
+    run_until_idle(tx);
+}
+
+TEST_F(TestCSMATx, ClassifiesAX25Frames)
+{
+    create();
+    ax25_tnc_t tnc;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+    ax25_set_address(&tnc.config.my_address, "N0CALL", 0, false);
+    ax25_set_tx_handler(&tnc, csma_tx_ax25_output, tx);
+
+    ax25_address_t peer, aprs, digi;
+    ax25_set_address(&peer, "N0PEER", 1, false);
+    ax25_set_address(&aprs, "APRS", 0, false);
+    ax25_set_address(&digi, "WIDE1", 1, false);
+    const uint8_t beacon[] = "!4903.50N/07201.75W-";
+    ASSERT_EQ(ax25_send_ui_frame(&tnc, &tnc.config.my_address, &aprs, &digi, 1, AX25_PID_NONE,
+                                 beacon, sizeof(beacon) - 1),
+              0);
+    ASSERT_EQ(ax25_connect(&tnc, &peer), 0);
+
+    EXPECT_EQ(csma_tx_pending(tx, CSMA_TX_PRIO_UNPROTO), 1u);
+    EXPECT_EQ(csma_tx_pending(tx, CSMA_TX_PRIO_CONTROL), 1u);
+    run_until_idle(tx);
+
+    // The SABM overtakes the beacon queued before it
+    ASSERT_EQ(air.frames.size(), 2u);
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, air.frames[0].data(), air.frames[0].size()), 0);
+    EXPECT_EQ(ax25_frame_view_control(&view) & AX25_CTRL_U_MASK, AX25_CTRL_SABM);
+    ASSERT_EQ(ax25_frame_view_init(&view, air.frames[1].data(), air.frames[1].size()), 0);
+    EXPECT_EQ(ax25_frame_view_control(&view), AX25_CTRL_UI);
+    EXPECT_EQ(air.keyups, 1);
+
+    ax25_cleanup(&tnc);
+}
+
+namespace {
+
+int collect_frame(void* ctx, const struct iovec* iov, int iovcnt)
+{
+    auto* out = static_cast<std::vector<std::vector<uint8_t>>*>(ctx);
+    std::vector<uint8_t> frame;
+    for (int i = 0; i < iovcnt; i++) {
+        const auto* base = static_cast<const uint8_t*>(iov[i].iov_base);
+        frame.insert(frame.end(), base, base + iov[i].iov_len);
+    }
+    out->push_back(frame);
+    return 0;
+}
+
+} // namespace
+
+TEST_F(TestCSMATx, LinkFramesKeepTheirOrder)
+{
+    create();
+    ax25_tnc_t tnc, peer;
+    ASSERT_EQ(ax25_init(&tnc), 0);
+    ASSERT_EQ(ax25_init(&peer), 0);
+    ax25_set_address(&tnc.config.my_address, "N0CALL", 0, false);
+    ax25_set_address(&peer.config.my_address, "N0PEER", 1, false);
+    ax25_set_tx_handler(&tnc, csma_tx_ax25_output, tx);
+    std::vector<std::vector<uint8_t>> replies;
+    ax25_set_tx_handler(&peer, collect_frame, &replies);
+
+    // SABM over the scheduler, UA straight back
+    ASSERT_EQ(ax25_connect(&tnc, &peer.config.my_address), 0);
+    run_until_idle(tx);
+    ASSERT_EQ(air.frames.size(), 1u);
+    ASSERT_EQ(ax25_input_frame(&peer, air.frames[0].data(), air.frames[0].size()), 0);
+    ASSERT_EQ(replies.size(), 1u);
+    ASSERT_EQ(ax25_input_frame(&tnc, replies[0].data(), replies[0].size()), 0);
+    air.frames.clear();
+
+    // I frames, then DISC on the same link, then another link's SABM
+    const uint8_t payload[] = { 0x01, 0x02, 0x03 };
+    ASSERT_EQ(ax25_send_data(&tnc, &peer.config.my_address, payload, sizeof(payload)), 0);
+    ASSERT_EQ(ax25_send_data(&tnc, &peer.config.my_address, payload, sizeof(payload)), 0);
+    ASSERT_EQ(ax25_disconnect(&tnc, &peer.config.my_address), 0);
+    ax25_address_t other;
+    ax25_set_address(&other, "N0OTHR", 0, false);
+    ASSERT_EQ(ax25_connect(&tnc, &other), 0);
+    EXPECT_EQ(csma_tx_pending(tx, CSMA_TX_PRIO_CONTROL), 1u);
+    EXPECT_EQ(csma_tx_pending(tx, CSMA_TX_PRIO_DATA), 3u);
+    run_until_idle(tx);
+
+    // The other link's SABM still goes first; the DISC waits for the I frames
+    ASSERT_EQ(air.frames.size(), 4u);
+    const uint16_t expected[] = { AX25_CTRL_SABM, AX25_FRAME_I, AX25_FRAME_I, AX25_CTRL_DISC };
+    for (size_t i = 0; i < air.frames.size(); i++) {
+        ax25_frame_view_t view;
+        ASSERT_EQ(ax25_frame_view_init(&view, air.frames[i].data(), air.frames[i].size()), 0);
+        uint16_t control = ax25_frame_view_control(&view);
+        if (expected[i] == AX25_FRAME_I) {
+            EXPECT_EQ(control & 0x01, AX25_FRAME_I) << "frame " << i;
+        } else {
+            EXPECT_EQ(control & AX25_CTRL_U_MASK, expected[i]) << "frame " << i;
+        }
+    }
+
+    ax25_cleanup(&peer);
+    ax25_cleanup(&tnc);
+}
@@ -0,0 +1,415 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/kiss_io.h>
+#include <gnuradio/m17_bridge/kiss_protocol.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct link_events {
+    std::map<int, std::vector<std::vector<uint8_t>>> frames; //!< Payloads per link
+    std::map<int, std::vector<uint8_t>> ports;               //!< KISS ports per link
+    std::map<int, std::vector<uint8_t>> commands;            //!< KISS commands per link
+    std::vector<int> closed;                                 //!< Links reported closed
+    size_t total = 0;
+};
+
+void record_frame(void* ctx, int link_id, const uint8_t* data, uint16_t length, uint8_t port,
+                  uint8_t command)
+{
+    auto* events = static_cast<link_events*>(ctx);
+    events->frames[link_id].emplace_back(data, data + length);
+    events->ports[link_id].push_back(port);
+    events->commands[link_id].push_back(command);
+    events->total++;
+}
+
+void record_close(void* ctx, int link_id)
+{
+    static_cast<link_events*>(ctx)->closed.push_back(link_id);
+}
+
+std::vector<uint8_t> make_payload(int seed, size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; i++) {
+        payload[i] = static_cast<uint8_t>(seed * 13 + i * 5);
+    }
+    payload[0] = KISS_FEND;
+    return payload;
+}
+
+// Connected loopback TCP socket pair
+bool tcp_pair(int fds[2])
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    bool ok = listener >= 0 && bind(listener, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+              listen(listener, 1) == 0 &&
+              getsockname(listener, (struct sockaddr*)&addr, &len) == 0;
+    fds[0] = ok ? socket(AF_INET, SOCK_STREAM, 0) : -1;
+    ok = ok && fds[0] >= 0 && connect(fds[0], (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    fds[1] = ok ? accept(listener, NULL, NULL) : -1;
+    close(listener);
+    return ok && fds[1] >= 0;
+}
+
+} // namespace
+
+// Two engines on the same backend, one on each end of every link.
+// The parameter forces the POSIX backend.
+class TestKISSIO : public ::testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() override
+    {
+        kiss_io_config_t config;
+        kiss_io_default_config(&config);
+        config.force_posix = GetParam();
+        config.on_frame = record_frame;
+        config.on_close = record_close;
+
+        config.ctx = &a_events;
+        a = kiss_io_create(&config);
+        config.ctx = &b_events;
+        b = kiss_io_create(&config);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+
+        if (GetParam()) {
+            ASSERT_EQ(kiss_io_backend(a), KISS_IO_BACKEND_POSIX);
+        } else if (kiss_io_backend(a) != KISS_IO_BACKEND_URING) {
+            GTEST_SKIP() << "io_uring is not available";
+        }
+    }
+
+    void TearDown() override
+    {
+        kiss_io_destroy(a);
+        kiss_io_destroy(b);
+    }
+
+    // Poll both engines until the condition holds (or a time limit)
+    bool pump(const std::function<bool()>& done)
+    {
+        for (int i = 0; i < 500 && !done(); i++) {
+            if (kiss_io_poll(a, 0) < 0 || kiss_io_poll(b, 10) < 0) {
+                return false;
+            }
+        }
+        return done();
+    }
+
+    kiss_io_t* a = nullptr;
+    kiss_io_t* b = nullptr;
+    link_events a_events;
+    link_events b_events;
+};
+
+TEST_P(TestKISSIO, TcpLinksCarryFramesBothWays)
+{
+    const int links = 4;
+    int a_links[links];
+    int b_links[links];
+    for (int i = 0; i < links; i++) {
+        int fds[2];
+        ASSERT_TRUE(tcp_pair(fds));
+        a_links[i] = kiss_io_add_link(a, fds[0]);
+        b_links[i] = kiss_io_add_link(b, fds[1]);
+        ASSERT_GE(a_links[i], 0);
+        ASSERT_GE(b_links[i], 0);
+    }
+
+    // More frames per link than the decoder's receive queue holds
+    for (int i = 0; i < links; i++) {
+        for (int f = 0; f < 100; f++) {
+            auto payload = make_payload(f, 1 + (f * 37) % 300);
+            ASSERT_EQ(kiss_io_send(a, a_links[i], payload.data(), payload.size(), f % 8), 0);
+        }
+        for (int f = 0; f < 20; f++) {
+            auto payload = make_payload(f + i, 50);
+            ASSERT_EQ(kiss_io_send(b, b_links[i], payload.data(), payload.size(), i), 0);
+        }
+    }
+
+    ASSERT_TRUE(pump([&] { return b_events.total == 400 && a_events.total == 80; }));
+
+    for (int i = 0; i < links; i++) {
+        const auto& received = b_events.frames[b_links[i]];
+        ASSERT_EQ(received.size(), 100u);
+        for (int f = 0; f < 100; f++) {
+            EXPECT_EQ(received[f], make_payload(f, 1 + (f * 37) % 300));
+            EXPECT_EQ(b_events.ports[b_links[i]][f], f % 8);
+        }
+        ASSERT_EQ(a_events.frames[a_links[i]].size(), 20u);
+        EXPECT_EQ(a_events.frames[a_links[i]][19], make_payload(19 + i, 50));
+    }
+    EXPECT_EQ(kiss_io_pending(a, a_links[0]), 0u);
+}
+
+TEST_P(TestKISSIO, PtyLinkCarriesFrames)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(grantpt(master), 0);
+    ASSERT_EQ(unlockpt(master), 0);
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+    struct termios tio;
+    ASSERT_EQ(tcgetattr(slave, &tio), 0);
+    cfmakeraw(&tio);
+    ASSERT_EQ(tcsetattr(slave, TCSANOW, &tio), 0);
+
+    int a_link = kiss_io_add_link(a, master);
+    int b_link = kiss_io_add_link(b, slave);
+    ASSERT_GE(a_link, 0);
+    ASSERT_GE(b_link, 0);
+
+    for (int f = 0; f < 50; f++) {
+        auto payload = make_payload(f, 10 + f * 3);
+        ASSERT_EQ(kiss_io_send(a, a_link, payload.data(), payload.size(), 0), 0);
+        ASSERT_EQ(kiss_io_send(b, b_link, payload.data(), payload.size(), 1), 0);
+    }
+
+    ASSERT_TRUE(pump([&] { return b_events.total == 50 && a_events.total == 50; }));
+    for (int f = 0; f < 50; f++) {
+        EXPECT_EQ(b_events.frames[b_link][f], make_payload(f, 10 + f * 3));
+        EXPECT_EQ(a_events.frames[a_link][f], make_payload(f, 10 + f * 3));
+        EXPECT_EQ(a_events.ports[a_link][f], 1);
+    }
+}
+
+TEST_P(TestKISSIO, HangupClosesLinkAndFreesSlot)
+{
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int link = kiss_io_add_link(a, fds[0]);
+    ASSERT_EQ(link, 0);
+
+    close(fds[1]);
+    ASSERT_TRUE(pump([&] { return !a_events.closed.empty(); }));
+    EXPECT_EQ(a_events.closed[0], link);
+    uint8_t payload[1] = { 0x41 };
+    EXPECT_EQ(kiss_io_send(a, link, payload, sizeof(payload), 0), -1);
+
+    // The slot is reused once the link has been released
+    ASSERT_TRUE(tcp_pair(fds));
+    int reused = -1;
+    ASSERT_TRUE(pump([&] {
+        if (reused < 0) {
+            reused = kiss_io_add_link(a, fds[0]);
+        }
+        return reused >= 0;
+    }));
+    EXPECT_EQ(reused, link);
+    close(fds[1]);
+}
+
+TEST_P(TestKISSIO, RemovedLinkRejectsFrames)
+{
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int link = kiss_io_add_link(a, fds[0]);
+    ASSERT_GE(link, 0);
+
+    uint8_t payload[4] = { 1, 2, 3, 4 };
+    EXPECT_EQ(kiss_io_remove_link(a, link), 0);
+    EXPECT_EQ(kiss_io_send(a, link, payload, sizeof(payload), 0), -1);
+    EXPECT_EQ(kiss_io_remove_link(a, link), -1);
+    EXPECT_TRUE(a_events.closed.empty()); // Only hangups are reported
+    close(fds[1]);
+}
+
+TEST_P(TestKISSIO, OnePollSubmitsEveryLink)
+{
+    if (GetParam()) {
+        GTEST_SKIP() << "POSIX backend writes each link separately";
+    }
+
+    const int links = 8;
+    for (int i = 0; i < links; i++) {
+        int fds[2];
+        ASSERT_TRUE(tcp_pair(fds));
+        int link = kiss_io_add_link(a, fds[0]);
+        ASSERT_GE(kiss_io_add_link(b, fds[1]), 0);
+        for (int f = 0; f < 10; f++) {
+            auto payload = make_payload(f, 64);
+            ASSERT_EQ(kiss_io_send(a, link, payload.data(), payload.size(), 0), 0);
+        }
+    }
+
+    // Receive arming and all 80 frames on 8 links go out in one syscall
+    kiss_io_stats_t before, after;
+    kiss_io_get_stats(a, &before);
+    ASSERT_GE(kiss_io_poll(a, 0), 0);
+    kiss_io_get_stats(a, &after);
+    EXPECT_EQ(after.syscalls - before.syscalls, 1u);
+
+    ASSERT_TRUE(pump([&] { return b_events.total == 80; }));
+}
+
+TEST_P(TestKISSIO, PollsFromAnotherThread)
+{
+    // Like a flowgraph: engines are built on one thread and run on another
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int link = kiss_io_add_link(a, fds[0]);
+    ASSERT_GE(kiss_io_add_link(b, fds[1]), 0);
+    for (int f = 0; f < 10; f++) {
+        auto payload = make_payload(f, 40);
+        ASSERT_EQ(kiss_io_send(a, link, payload.data(), payload.size(), 0), 0);
+    }
+
+    bool delivered = false;
+    std::thread worker([&] { delivered = pump([&] { return b_events.total == 10; }); });
+    worker.join();
+    ASSERT_TRUE(delivered);
+    EXPECT_EQ(b_events.frames[0].back(), make_payload(9, 40));
+}
+
+TEST_P(TestKISSIO, ShortFrameBurstIsNotDropped)
+{
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int link = kiss_io_add_link(b, fds[1]);
+    ASSERT_GE(link, 0);
+
+    // Many more one-byte frames than the receive queue holds, written at
+    // once so a single read completes them all
+    const size_t count = KISS_RX_SLOTS * 12;
+    std::vector<uint8_t> wire;
+    for (size_t f = 0; f < count; f++) {
+        wire.insert(wire.end(), { KISS_FEND, KISS_CMD_DATA, static_cast<uint8_t>(f) });
+    }
+    wire.push_back(KISS_FEND);
+    ASSERT_EQ(write(fds[0], wire.data(), wire.size()), (ssize_t)wire.size());
+
+    ASSERT_TRUE(pump([&] { return b_events.total == count; }));
+    for (size_t f = 0; f < count; f++) {
+        EXPECT_EQ(b_events.frames[link][f], std::vector<uint8_t>({ static_cast<uint8_t>(f) }));
+    }
+    close(fds[0]);
+}
+
+TEST_P(TestKISSIO, ParameterFramesKeepTheirCommand)
+{
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int link = kiss_io_add_link(b, fds[1]);
+    ASSERT_GE(link, 0);
+
+    // TXDELAY on port 3, then a data frame on port 3
+    const uint8_t wire[] = { KISS_FEND, 0x31, 0x30, KISS_FEND, KISS_FEND, 0x30, 'x', KISS_FEND };
+    ASSERT_EQ(write(fds[0], wire, sizeof(wire)), (ssize_t)sizeof(wire));
+
+    ASSERT_TRUE(pump([&] { return b_events.total == 2; }));
+    EXPECT_EQ(b_events.commands[link], std::vector<uint8_t>({ KISS_CMD_TXDELAY, KISS_CMD_DATA }));
+    EXPECT_EQ(b_events.ports[link], std::vector<uint8_t>({ 3, 3 }));
+    close(fds[0]);
+}
+
+TEST_P(TestKISSIO, RemovedLinkRestoresFileFlags)
+{
+    int fds[2];
+    ASSERT_TRUE(tcp_pair(fds));
+    int keep = dup(fds[1]); // Shares the file status flags
+    ASSERT_GE(keep, 0);
+
+    // Start from the blocking mode the backend does not use
+    int flags = fcntl(keep, F_GETFL);
+    int original = GetParam() ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    ASSERT_EQ(fcntl(keep, F_SETFL, original), 0);
+
+    int link = kiss_io_add_link(b, fds[1]);
+    ASSERT_GE(link, 0);
+    ASSERT_NE(fcntl(keep, F_GETFL), original);
+
+    ASSERT_EQ(kiss_io_remove_link(b, link), 0);
+    ASSERT_TRUE(pump([&] { return fcntl(keep, F_GETFL) == original; }));
+    close(keep);
+    close(fds[0]);
+}
+
+TEST_P(TestKISSIO, ShortSendOnWrappedRingKeepsStream)
+{
+    // A small transmit ring on a link with small socket buffers, so the
+    // queued bytes wrap the ring and the kernel takes them in short sends
+    kiss_io_config_t config;
+    kiss_io_default_config(&config);
+    config.force_posix = GetParam();
+    config.tx_buffer_size = 16384;
+    kiss_io_t* small = kiss_io_create(&config);
+    ASSERT_NE(small, nullptr);
+
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    int bufsize = 4096;
+    ASSERT_EQ(setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize)), 0);
+    ASSERT_EQ(setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize)), 0);
+    int link = kiss_io_add_link(small, fds[0]);
+    ASSERT_GE(kiss_io_add_link(b, fds[1]), 0);
+
+    // Queue more than the sockets hold and let one send move the head into
+    // the ring, then refill so the pending bytes run across its end with a
+    // first segment larger than the sockets can take at once
+    int queued = 0;
+    auto queue_until = [&](size_t limit) {
+        while (kiss_io_pending(small, link) < limit) {
+            auto payload = make_payload(queued, 300);
+            if (kiss_io_send(small, link, payload.data(), payload.size(), 0) != 0) {
+                break;
+            }
+            queued++;
+        }
+    };
+    queue_until(12000);
+    size_t before = kiss_io_pending(small, link);
+    for (int i = 0; i < 50 && kiss_io_pending(small, link) == before; i++) {
+        ASSERT_GE(kiss_io_poll(small, 20), 0);
+    }
+    ASSERT_LT(kiss_io_pending(small, link), before);
+    queue_until(SIZE_MAX);
+    ASSERT_GT(kiss_io_pending(small, link), 12000u);
+
+    // Drain with the reader running; every frame arrives whole and in order
+    for (int i = 0; i < 2000 && b_events.total < (size_t)queued; i++) {
+        ASSERT_GE(kiss_io_poll(small, 0), 0);
+        ASSERT_GE(kiss_io_poll(b, 5), 0);
+    }
+    ASSERT_EQ(b_events.total, (size_t)queued);
+    for (int f = 0; f < queued; f++) {
+        ASSERT_EQ(b_events.frames[0][f], make_payload(f, 300)) << "frame " << f;
+    }
+    kiss_io_destroy(small);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         TestKISSIO,
+                         ::testing::Values(false, true),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                             return std::string(info.param ? "Posix" : "IoUring");
+                         });
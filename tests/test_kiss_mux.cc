@@ -0,0 +1,272 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/kiss_mux.h>
+#include <gnuradio/m17_bridge/kiss_protocol.h>
+
+#include <vector>
+
+namespace {
+
+struct tx_record {
+    std::vector<uint8_t> ports;                  //!< Port of each frame, in link order
+    std::vector<std::vector<uint8_t>> frames;    //!< Payloads, in link order
+    size_t accept = SIZE_MAX;                    //!< Frames the link takes before refusing
+};
+
+int record_tx(void* ctx, const uint8_t* data, uint16_t length, uint8_t port)
+{
+    auto* record = static_cast<tx_record*>(ctx);
+    if (record->frames.size() >= record->accept) {
+        return -1;
+    }
+    record->ports.push_back(port);
+    record->frames.emplace_back(data, data + length);
+    return 0;
+}
+
+std::vector<uint8_t> make_payload(int seed, size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; i++) {
+        payload[i] = static_cast<uint8_t>(seed * 7 + i * 3);
+    }
+    payload[0] = KISS_FEND;
+    return payload;
+}
+
+// Append one encoded KISS data frame to a link byte stream
+void append_frame(std::vector<uint8_t>& stream, const std::vector<uint8_t>& payload, uint8_t port)
+{
+    std::vector<uint8_t> encoded(KISS_ENCODED_MAX(payload.size()));
+    int length = kiss_encode_frame(payload.data(), payload.size(), port, encoded.data());
+    ASSERT_GT(length, 0);
+    stream.insert(stream.end(), encoded.begin(), encoded.begin() + length);
+}
+
+} // namespace
+
+class TestKISSMux : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        mux = kiss_mux_create();
+        ASSERT_NE(mux, nullptr);
+    }
+
+    void TearDown() override { kiss_mux_destroy(mux); }
+
+    kiss_mux_t* mux = nullptr;
+};
+
+TEST_F(TestKISSMux, RoutesFramesByPort)
+{
+    ASSERT_EQ(kiss_mux_open_port(mux, 0, 1, 64), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 3, 1, 64), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 12, 1, 64), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 15, 1, 64), 0);
+    EXPECT_EQ(kiss_mux_open_port(mux, 3, 1, 64), -1);
+    EXPECT_EQ(kiss_mux_open_port(mux, 16, 1, 64), -1);
+
+    // Interleaved ports, more frames than the decoder queue holds. Port 12
+    // data frames have the escaped command byte 0xC0.
+    const uint8_t ports[] = { 0, 3, 15, 5, 12 };
+    std::vector<uint8_t> stream;
+    for (int f = 0; f < 50; f++) {
+        append_frame(stream, make_payload(f, 20 + f), ports[f % 5]);
+    }
+    EXPECT_EQ(kiss_mux_input(mux, stream.data(), stream.size()), 50);
+    EXPECT_EQ(kiss_mux_unrouted(mux), 10u);
+
+    for (int first : { 0, 1, 2, 4 }) {
+        uint8_t port = ports[first];
+        uint8_t data[KISS_MAX_FRAME_LEN];
+        for (int f = first; f < 50; f += 5) {
+            uint16_t length = sizeof(data);
+            ASSERT_EQ(kiss_mux_receive(mux, port, data, &length), 1);
+            EXPECT_EQ(std::vector<uint8_t>(data, data + length), make_payload(f, 20 + f));
+        }
+        uint16_t length = sizeof(data);
+        EXPECT_EQ(kiss_mux_receive(mux, port, data, &length), 0);
+
+        kiss_mux_port_stats_t stats;
+        ASSERT_EQ(kiss_mux_get_port_stats(mux, port, &stats), 0);
+        EXPECT_EQ(stats.rx_frames, 10u);
+        EXPECT_EQ(stats.rx_dropped, 0u);
+    }
+}
+
+TEST_F(TestKISSMux, ParameterFramesAreNotQueued)
+{
+    ASSERT_EQ(kiss_mux_open_port(mux, 2, 1, 16), 0);
+
+    // TXDELAY and SETHW on port 2 around a data frame
+    const uint8_t wire[] = { KISS_FEND, 0x21, 0x30, KISS_FEND,
+                             KISS_FEND, 0x20, 'a', 'b', KISS_FEND,
+                             KISS_FEND, 0x26, 0x01, 0x02, KISS_FEND };
+    EXPECT_EQ(kiss_mux_input(mux, wire, sizeof(wire)), 3);
+
+    uint8_t data[KISS_MAX_FRAME_LEN];
+    uint16_t length = sizeof(data);
+    ASSERT_EQ(kiss_mux_receive(mux, 2, data, &length), 1);
+    EXPECT_EQ(std::vector<uint8_t>(data, data + length), std::vector<uint8_t>({ 'a', 'b' }));
+    length = sizeof(data);
+    EXPECT_EQ(kiss_mux_receive(mux, 2, data, &length), 0);
+
+    kiss_mux_port_stats_t stats;
+    ASSERT_EQ(kiss_mux_get_port_stats(mux, 2, &stats), 0);
+    EXPECT_EQ(stats.rx_frames, 1u);
+    EXPECT_EQ(stats.rx_commands, 2u);
+}
+
+TEST_F(TestKISSMux, ShortFrameBurstIsFullyRouted)
+{
+    ASSERT_EQ(kiss_mux_open_port(mux, 0, 1, 128), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 1, 1, 128), 0);
+
+    // One-byte frames: a hundred fit in a few hundred bytes of one input
+    std::vector<uint8_t> stream;
+    for (int f = 0; f < 100; f++) {
+        append_frame(stream, { static_cast<uint8_t>(f) }, f % 2);
+    }
+    EXPECT_EQ(kiss_mux_input(mux, stream.data(), stream.size()), 100);
+
+    for (uint8_t port : { 0, 1 }) {
+        uint8_t data[KISS_MAX_FRAME_LEN];
+        for (int f = port; f < 100; f += 2) {
+            uint16_t length = sizeof(data);
+            ASSERT_EQ(kiss_mux_receive(mux, port, data, &length), 1);
+            ASSERT_EQ(length, 1);
+            EXPECT_EQ(data[0], f);
+        }
+        kiss_mux_port_stats_t stats;
+        ASSERT_EQ(kiss_mux_get_port_stats(mux, port, &stats), 0);
+        EXPECT_EQ(stats.rx_frames, 50u);
+        EXPECT_EQ(stats.rx_dropped, 0u);
+    }
+}
+
+TEST_F(TestKISSMux, WeightsShareTheLink)
+{
+    ASSERT_EQ(kiss_mux_open_port(mux, 1, 3, 64), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 2, 1, 64), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 4, 1, 64), 0);
+
+    // Port 4 sends frames larger than one quantum
+    for (int f = 0; f < 60; f++) {
+        ASSERT_EQ(kiss_mux_send(mux, 1, make_payload(f, 100).data(), 100), 0);
+        ASSERT_EQ(kiss_mux_send(mux, 2, make_payload(f, 100).data(), 100), 0);
+    }
+    for (int f = 0; f < 20; f++) {
+        ASSERT_EQ(kiss_mux_send(mux, 4, make_payload(f, 300).data(), 300), 0);
+    }
+
+    // While all ports are backlogged, link bytes follow the 3:1:1 weights
+    tx_record record;
+    ASSERT_GT(kiss_mux_transmit(mux, record_tx, &record, 6000), 0);
+    size_t bytes[KISS_MUX_PORTS] = {};
+    for (size_t i = 0; i < record.frames.size(); i++) {
+        bytes[record.ports[i]] += record.frames[i].size();
+    }
+    EXPECT_NEAR(double(bytes[1]) / bytes[2], 3.0, 0.5);
+    EXPECT_NEAR(double(bytes[4]) / bytes[2], 1.0, 0.3);
+
+    // The rest drains in order within each port
+    ASSERT_GT(kiss_mux_transmit(mux, record_tx, &record, 0), 0);
+    ASSERT_EQ(record.frames.size(), 140u);
+    int next[KISS_MUX_PORTS] = {};
+    for (size_t i = 0; i < record.frames.size(); i++) {
+        uint8_t port = record.ports[i];
+        EXPECT_EQ(record.frames[i], make_payload(next[port]++, port == 4 ? 300 : 100));
+    }
+    EXPECT_EQ(kiss_mux_pending(mux, 1), 0u);
+
+    kiss_mux_port_stats_t stats;
+    ASSERT_EQ(kiss_mux_get_port_stats(mux, 4, &stats), 0);
+    EXPECT_EQ(stats.tx_frames, 20u);
+    EXPECT_EQ(stats.tx_bytes, 6000u);
+}
+
+TEST_F(TestKISSMux, RefusedFramesStayQueued)
+{
+    ASSERT_EQ(kiss_mux_open_port(mux, 0, 1, 4), 0);
+    for (int f = 0; f < 6; f++) {
+        EXPECT_EQ(kiss_mux_send(mux, 0, make_payload(f, 10).data(), 10), f < 4 ? 0 : -1);
+    }
+    EXPECT_EQ(kiss_mux_pending(mux, 0), 4u);
+
+    tx_record record;
+    record.accept = 1;
+    EXPECT_EQ(kiss_mux_transmit(mux, record_tx, &record, 0), 1);
+    EXPECT_EQ(kiss_mux_pending(mux, 0), 3u);
+
+    record.accept = SIZE_MAX;
+    EXPECT_EQ(kiss_mux_transmit(mux, record_tx, &record, 0), 3);
+    ASSERT_EQ(record.frames.size(), 4u);
+    EXPECT_EQ(record.frames[3], make_payload(3, 10));
+
+    kiss_mux_port_stats_t stats;
+    ASSERT_EQ(kiss_mux_get_port_stats(mux, 0, &stats), 0);
+    EXPECT_EQ(stats.tx_frames, 4u);
+    EXPECT_EQ(stats.tx_dropped, 2u);
+
+    // Receive side drops the newest frames once the queue is full
+    std::vector<uint8_t> stream;
+    for (int f = 0; f < 6; f++) {
+        append_frame(stream, make_payload(f, 30), 0);
+    }
+    kiss_mux_input(mux, stream.data(), stream.size());
+    ASSERT_EQ(kiss_mux_get_port_stats(mux, 0, &stats), 0);
+    EXPECT_EQ(stats.rx_frames, 4u);
+    EXPECT_EQ(stats.rx_dropped, 2u);
+}
+
+TEST_F(TestKISSMux, BridgesRunPerPort)
+{
+    m17_ax25_bridge_t bridge_a;
+    m17_ax25_bridge_t bridge_b;
+    ASSERT_EQ(m17_ax25_bridge_init(&bridge_a), 0);
+    ASSERT_EQ(m17_ax25_bridge_init(&bridge_b), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 2, 1, 16), 0);
+    ASSERT_EQ(kiss_mux_open_port(mux, 7, 1, 16), 0);
+    ASSERT_EQ(kiss_mux_attach_bridge(mux, 2, &bridge_a), 0);
+    ASSERT_EQ(kiss_mux_attach_bridge(mux, 7, &bridge_b), 0);
+
+    // Bridge output is queued on the port the bridge is attached to
+    const uint8_t text[] = "HELLO";
+    ASSERT_EQ(m17_ax25_bridge_process_ax25_tx(&bridge_b, text, 5), 0);
+    EXPECT_EQ(kiss_mux_pending(mux, 7), 1u);
+    EXPECT_EQ(kiss_mux_pending(mux, 2), 0u);
+
+    tx_record record;
+    EXPECT_EQ(kiss_mux_transmit(mux, record_tx, &record, 0), 1);
+    ASSERT_EQ(record.ports.size(), 1u);
+    EXPECT_EQ(record.ports[0], 7);
+    const auto& frame = record.frames[0];
+    ASSERT_GT(frame.size(), 7u);
+    EXPECT_TRUE(std::equal(text, text + 5, frame.end() - 7)); // Payload precedes the FCS
+
+    // Received frames reach only their own port's bridge
+    std::vector<uint8_t> stream;
+    append_frame(stream, { 0x5D, 0x5F, 0x00, 0x00, 0x11, 0x22 }, 2);
+    ASSERT_EQ(kiss_mux_input(mux, stream.data(), stream.size()), 1);
+    EXPECT_EQ(kiss_mux_dispatch(mux, 16), 1);
+    EXPECT_TRUE(bridge_a.state.m17_active);
+    EXPECT_FALSE(bridge_b.state.m17_active);
+
+    // Closing the port gives the bridge its own interface back
+    ASSERT_EQ(kiss_mux_close_port(mux, 7), 0);
+    EXPECT_EQ(bridge_b.kiss_tnc.tx_handler, nullptr);
+
+    m17_ax25_bridge_cleanup(&bridge_a);
+    m17_ax25_bridge_cleanup(&bridge_b);
+}
@@ -0,0 +1,394 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+#include <gnuradio/m17_bridge/kiss_protocol.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+class TestKISSProtocol : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(kiss_init(&tnc), 0);
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        tnc.tcp_socket = fds[0];
+    }
+
+    void TearDown() override
+    {
+        kiss_cleanup(&tnc);
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    std::vector<uint8_t> read_peer()
+    {
+        std::vector<uint8_t> out(4096);
+        ssize_t n = recv(fds[1], out.data(), out.size(), MSG_DONTWAIT);
+        out.resize(n > 0 ? n : 0);
+        return out;
+    }
+
+    // Reference encoding through the flat escaper
+    static std::vector<uint8_t> flat_kiss(const std::vector<uint8_t>& payload, uint8_t port)
+    {
+        std::vector<uint8_t> escaped(2 * payload.size() + 1);
+        uint16_t escaped_len = escaped.size();
+        kiss_escape_data(payload.data(), payload.size(), escaped.data(), &escaped_len);
+
+        std::vector<uint8_t> out = { KISS_FEND, static_cast<uint8_t>(port << 4) };
+        out.insert(out.end(), escaped.begin(), escaped.begin() + escaped_len);
+        out.push_back(KISS_FEND);
+        return out;
+    }
+
+    kiss_tnc_t tnc;
+    int fds[2];
+};
+
+TEST_F(TestKISSProtocol, EncodeIovReferencesPayload)
+{
+    std::vector<uint8_t> a = { 0x01, KISS_FEND, 0x02, 0x03 };
+    std::vector<uint8_t> b = { KISS_FESC, 0x04 };
+    struct iovec in[2] = { { a.data(), a.size() }, { b.data(), b.size() } };
+
+    kiss_iov_t frame;
+    ASSERT_EQ(kiss_encode_iov(in, 2, 1, KISS_CMD_DATA, &frame), 0);
+
+    // head, 01, FESC TFEND, 02 03, FESC TFESC, 04, FEND
+    ASSERT_EQ(frame.count, 7);
+    ASSERT_EQ(frame.iov[1].iov_base, (void*)a.data());
+    ASSERT_EQ(frame.iov[3].iov_base, (void*)&a[2]);
+    ASSERT_EQ(frame.iov[5].iov_base, (void*)&b[1]);
+
+    std::vector<uint8_t> gathered;
+    for (int i = 0; i < frame.count; i++) {
+        const uint8_t* p = static_cast<const uint8_t*>(frame.iov[i].iov_base);
+        gathered.insert(gathered.end(), p, p + frame.iov[i].iov_len);
+    }
+    std::vector<uint8_t> payload = a;
+    payload.insert(payload.end(), b.begin(), b.end());
+    ASSERT_EQ(gathered, flat_kiss(payload, 1));
+}
+
+TEST_F(TestKISSProtocol, SendFrameOverSocket)
+{
+    std::vector<uint8_t> payload = { 0x10, KISS_FEND, KISS_FESC, 0x20 };
+    ASSERT_GT(kiss_send_frame(&tnc, payload.data(), payload.size(), 0), 0);
+    ASSERT_EQ(read_peer(), flat_kiss(payload, 0));
+}
+
+TEST_F(TestKISSProtocol, SendFallsBackWhenEscapesExceedIovLimit)
+{
+    std::vector<uint8_t> payload(3 * KISS_IOV_MAX, KISS_FEND);
+    ASSERT_GT(kiss_send_frame(&tnc, payload.data(), payload.size(), 2), 0);
+    ASSERT_EQ(read_peer(), flat_kiss(payload, 2));
+}
+
+TEST_F(TestKISSProtocol, EscapeUnescapeRoundTrip)
+{
+    std::mt19937 rng(34);
+    for (int iter = 0; iter < 500; iter++) {
+        std::vector<uint8_t> payload(1 + rng() % 300);
+        for (auto& b : payload) {
+            // Plenty of special bytes, including at vector-width boundaries
+            uint32_t r = rng() % 8;
+            b = r == 0 ? KISS_FEND : r == 1 ? KISS_FESC : rng() & 0xFF;
+        }
+
+        std::vector<uint8_t> escaped(2 * payload.size() + 1);
+        uint16_t escaped_len = escaped.size();
+        ASSERT_EQ(kiss_escape_data(payload.data(), payload.size(), escaped.data(), &escaped_len), 0);
+        for (uint16_t i = 0; i < escaped_len; i++) {
+            ASSERT_NE(escaped[i], KISS_FEND);
+        }
+
+        std::vector<uint8_t> restored(payload.size() + 1);
+        uint16_t restored_len = restored.size();
+        ASSERT_EQ(kiss_unescape_data(escaped.data(), escaped_len, restored.data(), &restored_len),
+                  0);
+        restored.resize(restored_len);
+        ASSERT_EQ(restored, payload);
+    }
+
+    // Output capacity is enforced
+    const uint8_t special[] = { 0x01, KISS_FEND };
+    uint8_t small[2];
+    uint16_t small_len = sizeof(small);
+    ASSERT_NE(kiss_escape_data(special, sizeof(special), small, &small_len), 0);
+
+    // Truncated and invalid escapes are rejected
+    const uint8_t truncated[] = { 0x01, KISS_FESC };
+    const uint8_t invalid[] = { KISS_FESC, 0x01 };
+    uint8_t out[4];
+    uint16_t out_len = sizeof(out);
+    ASSERT_NE(kiss_unescape_data(truncated, sizeof(truncated), out, &out_len), 0);
+    out_len = sizeof(out);
+    ASSERT_NE(kiss_unescape_data(invalid, sizeof(invalid), out, &out_len), 0);
+}
+
+TEST_F(TestKISSProtocol, ProcessBufferMatchesPerByteDecoder)
+{
+    std::mt19937 rng(35);
+    kiss_tnc_t bytewise;
+    ASSERT_EQ(kiss_init(&bytewise), 0);
+
+    for (int iter = 0; iter < 300; iter++) {
+        std::vector<uint8_t> payload(1 + rng() % 400);
+        for (auto& b : payload) {
+            uint32_t r = rng() % 16;
+            b = r == 0 ? KISS_FEND : r == 1 ? KISS_FESC : rng() & 0xFF;
+        }
+        uint8_t port = rng() % 8;
+        std::vector<uint8_t> wire = flat_kiss(payload, port);
+        // Leading noise and idle FENDs are skipped
+        wire.insert(wire.begin(), { 0x55, KISS_FEND });
+
+        // Bulk decoder, fed in random chunk sizes
+        size_t pos = 0;
+        int frames = 0;
+        while (pos < wire.size()) {
+            size_t chunk = std::min<size_t>(1 + rng() % 64, wire.size() - pos);
+            frames += kiss_process_buffer(&tnc, &wire[pos], chunk);
+            pos += chunk;
+        }
+        ASSERT_EQ(frames, 1);
+
+        // Per-byte decoder
+        for (uint8_t b : wire) {
+            ASSERT_EQ(kiss_process_byte(&bytewise, b), 0);
+        }
+
+        for (kiss_tnc_t* decoder : { &tnc, &bytewise }) {
+            std::vector<uint8_t> frame(1024);
+            uint16_t frame_len = frame.size();
+            uint8_t rx_port = 0xFF;
+            ASSERT_EQ(kiss_receive_frame(decoder, frame.data(), &frame_len, &rx_port),
+                      (int)payload.size());
+            frame.resize(frame_len);
+            ASSERT_EQ(frame, payload);
+            ASSERT_EQ(rx_port, port);
+        }
+    }
+
+    kiss_cleanup(&bytewise);
+}
+
+TEST_F(TestKISSProtocol, BackToBackFramesShareFend)
+{
+    // FEND closes one frame and opens the next
+    const uint8_t wire[] = { KISS_FEND, 0x00, 'a', 'b', KISS_FEND, 0x10, 'c', KISS_FEND };
+    uint8_t frame[16];
+    uint16_t frame_len;
+    uint8_t port;
+
+    ASSERT_EQ(kiss_process_buffer(&tnc, wire, 5), 1);
+    frame_len = sizeof(frame);
+    ASSERT_EQ(kiss_receive_frame(&tnc, frame, &frame_len, &port), 2);
+    ASSERT_EQ(port, 0);
+
+    ASSERT_EQ(kiss_process_buffer(&tnc, wire + 5, 3), 1);
+    frame_len = sizeof(frame);
+    ASSERT_EQ(kiss_receive_frame(&tnc, frame, &frame_len, &port), 1);
+    ASSERT_EQ(frame[0], 'c');
+    ASSERT_EQ(port, 1);
+}
+
+static void collect_frame(void* ctx, const uint8_t* data, uint16_t length, uint8_t port)
+{
+    auto* frames = static_cast<std::vector<std::vector<uint8_t>>*>(ctx);
+    std::vector<uint8_t> frame = { port };
+    frame.insert(frame.end(), data, data + length);
+    frames->push_back(frame);
+}
+
+TEST_F(TestKISSProtocol, BurstIsQueuedAndDrained)
+{
+    // More frames than slots in a single read
+    std::vector<uint8_t> wire;
+    for (int i = 0; i < KISS_RX_SLOTS + 2; i++) {
+        std::vector<uint8_t> payload = { static_cast<uint8_t>(i), KISS_FEND, 0x42 };
+        std::vector<uint8_t> frame = flat_kiss(payload, i % 4);
+        wire.insert(wire.end(), frame.begin(), frame.end());
+    }
+
+    ASSERT_EQ(kiss_process_buffer(&tnc, wire.data(), wire.size()), KISS_RX_SLOTS);
+    ASSERT_EQ(kiss_frame_ready(&tnc), KISS_RX_SLOTS);
+    ASSERT_EQ(tnc.rx_dropped, 2u);
+
+    // Drain in two calls; frames come out oldest first
+    std::vector<std::vector<uint8_t>> frames;
+    ASSERT_EQ(kiss_receive_frames(&tnc, collect_frame, &frames, 3), 3);
+    ASSERT_EQ(kiss_receive_frames(&tnc, collect_frame, &frames, 100), KISS_RX_SLOTS - 3);
+    ASSERT_EQ(kiss_frame_ready(&tnc), 0);
+    ASSERT_EQ(frames.size(), (size_t)KISS_RX_SLOTS);
+    for (int i = 0; i < KISS_RX_SLOTS; i++) {
+        std::vector<uint8_t> expected = { static_cast<uint8_t>(i % 4), static_cast<uint8_t>(i),
+                                          KISS_FEND, 0x42 };
+        ASSERT_EQ(frames[i], expected);
+    }
+
+    // Freed slots are reused, wrapping around the ring
+    for (int i = 0; i < 3 * KISS_RX_SLOTS; i++) {
+        std::vector<uint8_t> payload = { static_cast<uint8_t>(i) };
+        std::vector<uint8_t> frame = flat_kiss(payload, 0);
+        ASSERT_EQ(kiss_process_buffer(&tnc, frame.data(), frame.size()), 1);
+        uint8_t out[4];
+        uint16_t out_len = sizeof(out);
+        ASSERT_EQ(kiss_receive_frame(&tnc, out, &out_len, NULL), 1);
+        ASSERT_EQ(out[0], i);
+    }
+}
+
+static void collect_slot(void* ctx, const kiss_rx_slot_t* frame)
+{
+    auto* frames = static_cast<std::vector<std::vector<uint8_t>>*>(ctx);
+    std::vector<uint8_t> slot = { frame->command, frame->port };
+    slot.insert(slot.end(), frame->data, frame->data + frame->length);
+    frames->push_back(slot);
+}
+
+TEST_F(TestKISSProtocol, EscapedCommandByteRoundTrip)
+{
+    // Port 12 data is command byte 0xC0 and port 13 command 11 is 0xDB;
+    // both go out escaped
+    const uint8_t wire[] = { KISS_FEND, KISS_FESC, KISS_TFEND, 'A', 'B', 'C', 'D', KISS_FEND };
+    uint8_t frame[16];
+    uint16_t frame_len = sizeof(frame);
+    uint8_t port;
+
+    ASSERT_EQ(kiss_process_buffer(&tnc, wire, sizeof(wire)), 1);
+    ASSERT_EQ(kiss_receive_frame(&tnc, frame, &frame_len, &port), 4);
+    ASSERT_EQ(port, 12);
+    ASSERT_EQ(std::vector<uint8_t>(frame, frame + frame_len),
+              std::vector<uint8_t>({ 'A', 'B', 'C', 'D' }));
+
+    // Encoder output decodes back to the same port and command
+    std::vector<uint8_t> payload = { 0x01, KISS_FESC, 0x02 };
+    struct iovec in = { payload.data(), payload.size() };
+    for (auto [p, command] : { std::pair<uint8_t, uint8_t>{ 12, KISS_CMD_DATA },
+                               std::pair<uint8_t, uint8_t>{ 13, 0x0B } }) {
+        kiss_iov_t encoded;
+        ASSERT_EQ(kiss_encode_iov(&in, 1, p, command, &encoded), 0);
+        std::vector<uint8_t> bytes;
+        for (int i = 0; i < encoded.count; i++) {
+            const uint8_t* b = static_cast<const uint8_t*>(encoded.iov[i].iov_base);
+            bytes.insert(bytes.end(), b, b + encoded.iov[i].iov_len);
+        }
+
+        std::vector<std::vector<uint8_t>> frames;
+        ASSERT_EQ(kiss_decode_frames(&tnc, bytes.data(), bytes.size(), collect_slot, &frames), 1);
+        std::vector<uint8_t> expected = { command, p };
+        expected.insert(expected.end(), payload.begin(), payload.end());
+        ASSERT_EQ(frames[0], expected);
+    }
+
+    // Anything else after an escaped command byte is a protocol error
+    const uint8_t bad[] = { KISS_FEND, KISS_FESC, 'x' };
+    ASSERT_EQ(kiss_process_byte(&tnc, bad[0]), 0);
+    ASSERT_EQ(kiss_process_byte(&tnc, bad[1]), 0);
+    ASSERT_EQ(kiss_process_byte(&tnc, bad[2]), -1);
+}
+
+TEST_F(TestKISSProtocol, DecodeFramesDeliversWholeBurst)
+{
+    // Many more one-byte parameter frames than slots, and a data frame
+    std::vector<uint8_t> wire;
+    for (int i = 0; i < 4 * KISS_RX_SLOTS; i++) {
+        wire.insert(wire.end(), { KISS_FEND, 0x21, static_cast<uint8_t>(i) });
+    }
+    wire.insert(wire.end(), { KISS_FEND, 0x00, 'x', KISS_FEND });
+
+    std::vector<std::vector<uint8_t>> frames;
+    ASSERT_EQ(kiss_decode_frames(&tnc, wire.data(), wire.size(), collect_slot, &frames),
+              4 * KISS_RX_SLOTS + 1);
+    ASSERT_EQ(tnc.rx_dropped, 0u);
+    ASSERT_EQ(kiss_frame_ready(&tnc), 0);
+    for (int i = 0; i < 4 * KISS_RX_SLOTS; i++) {
+        std::vector<uint8_t> expected = { KISS_CMD_TXDELAY, 2, static_cast<uint8_t>(i) };
+        ASSERT_EQ(frames[i], expected);
+    }
+    ASSERT_EQ(frames.back(), std::vector<uint8_t>({ KISS_CMD_DATA, 0, 'x' }));
+    ASSERT_EQ(kiss_decode_frames(&tnc, wire.data(), wire.size(), NULL, NULL), -1);
+}
+
+// Resets the decoder from inside the handler, as a link closing does
+static void reset_on_first(void* ctx, const kiss_rx_slot_t* frame)
+{
+    auto* tnc = static_cast<kiss_tnc_t*>(ctx);
+    if (frame->data[0] == 0) {
+        kiss_cleanup(tnc);
+    }
+}
+
+TEST_F(TestKISSProtocol, DecodeFramesSurvivesResetInHandler)
+{
+    // Leave frames queued so the first drain has more than one
+    std::vector<uint8_t> wire;
+    for (int i = 0; i < 3; i++) {
+        wire.insert(wire.end(), { KISS_FEND, 0x00, static_cast<uint8_t>(i) });
+    }
+    wire.push_back(KISS_FEND);
+    ASSERT_EQ(kiss_process_buffer(&tnc, wire.data(), wire.size()), 3);
+
+    // The reset discards the rest of the queue; later bytes decode afresh
+    const uint8_t more[] = { 0x00, 'x', KISS_FEND };
+    ASSERT_EQ(kiss_decode_frames(&tnc, more, sizeof(more), reset_on_first, &tnc), 1);
+    ASSERT_EQ(kiss_frame_ready(&tnc), 0);
+    ASSERT_EQ(kiss_decode_frames(&tnc, more, sizeof(more), reset_on_first, &tnc), 0);
+    const uint8_t next[] = { KISS_FEND, 0x00, 'y', KISS_FEND };
+    ASSERT_EQ(kiss_decode_frames(&tnc, next, sizeof(next), reset_on_first, &tnc), 1);
+    ASSERT_EQ(kiss_frame_ready(&tnc), 0);
+}
+
+static int capture_tx(void* ctx, const struct iovec* iov, int iovcnt)
+{
+    kiss_tnc_t* kiss = static_cast<kiss_tnc_t*>(ctx);
+    return kiss_send_iov(kiss, iov, iovcnt, 0);
+}
+
+TEST_F(TestKISSProtocol, AX25UiFrameReachesKiss)
+{
+    ax25_tnc_t ax25;
+    ASSERT_EQ(ax25_init(&ax25), 0);
+    ASSERT_EQ(ax25_set_tx_handler(&ax25, capture_tx, &tnc), 0);
+
+    ax25_address_t src, dst;
+    ax25_set_address(&src, "N0CALL", 0, true);
+    ax25_set_address(&dst, "APRS", 0, false);
+    const char info[] = ">status";
+    ASSERT_EQ(ax25_send_ui_frame(&ax25, &src, &dst, NULL, 0, AX25_PID_NONE,
+                                 reinterpret_cast<const uint8_t*>(info), sizeof(info) - 1),
+              0);
+
+    // Unescape the KISS frame and check the AX.25 content
+    std::vector<uint8_t> wire = read_peer();
+    ASSERT_GE(wire.size(), 4u);
+    ASSERT_EQ(wire.front(), KISS_FEND);
+    ASSERT_EQ(wire.back(), KISS_FEND);
+    std::vector<uint8_t> frame(wire.size());
+    uint16_t frame_len = frame.size();
+    ASSERT_EQ(kiss_unescape_data(&wire[2], wire.size() - 3, frame.data(), &frame_len), 0);
+
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, frame.data(), frame_len), 0);
+    ASSERT_TRUE(ax25_frame_view_check_fcs(&view));
+    uint16_t info_len = 0;
+    const uint8_t* info_ptr = ax25_frame_view_info(&view, &info_len);
+    ASSERT_EQ(info_len, sizeof(info) - 1);
+    ASSERT_EQ(memcmp(info_ptr, info, info_len), 0);
+}
@@ -0,0 +1,304 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/kiss_protocol.h>
+#include <gnuradio/m17_bridge/kiss_serial.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct received_frame {
+    std::vector<uint8_t> data;
+    uint8_t port;
+    uint8_t command;
+};
+
+void record_frame(void* ctx, const uint8_t* data, uint16_t length, uint8_t port)
+{
+    auto* frames = static_cast<std::vector<received_frame>*>(ctx);
+    frames->push_back({ std::vector<uint8_t>(data, data + length), port, KISS_CMD_DATA });
+}
+
+void record_serial_frame(void* ctx, const uint8_t* data, uint16_t length, uint8_t port,
+                         uint8_t command)
+{
+    auto* frames = static_cast<std::vector<received_frame>*>(ctx);
+    frames->push_back({ std::vector<uint8_t>(data, data + length), port, command });
+}
+
+std::vector<uint8_t> make_payload(int seed, size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; i++) {
+        payload[i] = static_cast<uint8_t>(seed * 31 + i * 7);
+    }
+    payload[0] = KISS_FEND; // Force escapes in every frame
+    payload[length - 1] = KISS_FESC;
+    return payload;
+}
+
+} // namespace
+
+// The port under test is the pty slave; the test drives the master side
+class TestKISSSerial : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master, 0);
+        ASSERT_EQ(grantpt(master), 0);
+        ASSERT_EQ(unlockpt(master), 0);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+        kiss_serial_default_config(&config);
+        config.on_frame = record_serial_frame;
+        config.ctx = &frames;
+    }
+
+    void TearDown() override
+    {
+        kiss_serial_close(serial);
+        if (master >= 0) {
+            close(master);
+        }
+    }
+
+    void open_port()
+    {
+        serial = kiss_serial_open(ptsname(master), &config);
+        ASSERT_NE(serial, nullptr);
+    }
+
+    // Read everything the port wrote and decode it
+    std::vector<received_frame> drain_master()
+    {
+        std::vector<received_frame> decoded;
+        kiss_tnc_t tnc;
+        kiss_init(&tnc);
+        uint8_t buffer[4096];
+        while (poll_master(100)) {
+            ssize_t n = read(master, buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            for (ssize_t pos = 0; pos < n; pos += 64) {
+                size_t slice = (n - pos < 64) ? n - pos : 64;
+                kiss_process_buffer(&tnc, &buffer[pos], slice);
+                kiss_receive_frames(&tnc, record_frame, &decoded, KISS_RX_SLOTS);
+            }
+        }
+        kiss_cleanup(&tnc);
+        return decoded;
+    }
+
+    bool poll_master(int timeout_ms)
+    {
+        struct pollfd pfd = { master, POLLIN, 0 };
+        return poll(&pfd, 1, timeout_ms) > 0 && (pfd.revents & POLLIN);
+    }
+
+    kiss_serial_stats_t stats()
+    {
+        kiss_serial_stats_t s;
+        kiss_serial_get_stats(serial, &s);
+        return s;
+    }
+
+    int master = -1;
+    kiss_serial_config_t config;
+    kiss_serial_t* serial = nullptr;
+    std::vector<received_frame> frames;
+};
+
+TEST_F(TestKISSSerial, QueuedFramesLeaveInOneWrite)
+{
+    open_port();
+
+    std::vector<std::vector<uint8_t>> sent;
+    for (int i = 0; i < 10; i++) {
+        sent.push_back(make_payload(i, 40 + i));
+        ASSERT_EQ(kiss_serial_queue(serial, sent.back().data(), sent.back().size(), i % 4), 0);
+    }
+    EXPECT_GT(kiss_serial_pending(serial), 0u);
+    EXPECT_EQ(stats().writes, 0u); // Queueing alone does not write
+
+    EXPECT_EQ(kiss_serial_poll(serial, 100), 0);
+    EXPECT_EQ(kiss_serial_pending(serial), 0u);
+    EXPECT_EQ(stats().writes, 1u);
+    EXPECT_EQ(stats().frames_out, 10u);
+
+    auto decoded = drain_master();
+    ASSERT_EQ(decoded.size(), sent.size());
+    for (size_t i = 0; i < sent.size(); i++) {
+        EXPECT_EQ(decoded[i].data, sent[i]);
+        EXPECT_EQ(decoded[i].port, i % 4);
+    }
+}
+
+TEST_F(TestKISSSerial, BurstIsReadAndDecodedInBulk)
+{
+    open_port();
+
+    // Encode a burst larger than the decoder's receive queue
+    std::vector<uint8_t> stream;
+    std::vector<std::vector<uint8_t>> sent;
+    for (int i = 0; i < 30; i++) {
+        sent.push_back(make_payload(i, 20 + i));
+        std::vector<uint8_t> escaped(2 * sent.back().size());
+        uint16_t escaped_len = escaped.size();
+        ASSERT_EQ(kiss_escape_data(sent.back().data(), sent.back().size(), escaped.data(),
+                                   &escaped_len),
+                  0);
+        stream.push_back(KISS_FEND);
+        stream.push_back(KISS_CMD_DATA);
+        stream.insert(stream.end(), escaped.begin(), escaped.begin() + escaped_len);
+        stream.push_back(KISS_FEND);
+    }
+    ASSERT_EQ(write(master, stream.data(), stream.size()), (ssize_t)stream.size());
+
+    int delivered = 0;
+    for (int i = 0; i < 50 && delivered < 30; i++) {
+        int result = kiss_serial_poll(serial, 100);
+        ASSERT_GE(result, 0);
+        delivered += result;
+    }
+    EXPECT_EQ(delivered, 30);
+    ASSERT_EQ(frames.size(), sent.size());
+    for (size_t i = 0; i < sent.size(); i++) {
+        EXPECT_EQ(frames[i].data, sent[i]);
+    }
+    EXPECT_EQ(stats().frames_in, 30u);
+    EXPECT_LT(stats().reads, 30u);
+}
+
+TEST_F(TestKISSSerial, ParameterFramesKeepTheirCommand)
+{
+    open_port();
+
+    // TXDELAY on port 1, then a data frame on port 1
+    const uint8_t stream[] = { KISS_FEND, 0x11, 0x30, KISS_FEND, KISS_FEND, 0x10, 'x', KISS_FEND };
+    ASSERT_EQ(write(master, stream, sizeof(stream)), (ssize_t)sizeof(stream));
+
+    int delivered = 0;
+    for (int i = 0; i < 50 && delivered < 2; i++) {
+        int result = kiss_serial_poll(serial, 100);
+        ASSERT_GE(result, 0);
+        delivered += result;
+    }
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].command, KISS_CMD_TXDELAY);
+    EXPECT_EQ(frames[0].data, std::vector<uint8_t>({ 0x30 }));
+    EXPECT_EQ(frames[1].command, KISS_CMD_DATA);
+    EXPECT_EQ(frames[1].port, 1);
+}
+
+TEST_F(TestKISSSerial, ShortFrameBurstIsNotDropped)
+{
+    open_port();
+
+    // Many more one-byte frames than the receive queue holds, in a single
+    // write, so one read completes them all
+    const int count = KISS_RX_SLOTS * 12;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < count; i++) {
+        stream.insert(stream.end(), { KISS_FEND, KISS_CMD_DATA, static_cast<uint8_t>(i) });
+    }
+    stream.push_back(KISS_FEND);
+    ASSERT_EQ(write(master, stream.data(), stream.size()), (ssize_t)stream.size());
+
+    int delivered = 0;
+    for (int i = 0; i < 50 && delivered < count; i++) {
+        int result = kiss_serial_poll(serial, 100);
+        ASSERT_GE(result, 0);
+        delivered += result;
+    }
+    ASSERT_EQ(delivered, count);
+    ASSERT_EQ(frames.size(), (size_t)count);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(frames[i].data, std::vector<uint8_t>({ static_cast<uint8_t>(i) }));
+    }
+}
+
+TEST_F(TestKISSSerial, FullRingRefusesFramesAndWraps)
+{
+    config.tx_buffer_size = 1000; // Rounded up to 1024
+    open_port();
+
+    // Fill the ring without writing
+    std::vector<uint8_t> payload = make_payload(1, 200);
+    ASSERT_EQ(kiss_serial_queue(serial, payload.data(), payload.size(), 0), 0);
+    size_t frame_bytes = kiss_serial_pending(serial);
+    size_t queued = 1;
+    while (kiss_serial_queue(serial, payload.data(), payload.size(), 0) == 0) {
+        queued++;
+    }
+    EXPECT_EQ(queued, 1024 / frame_bytes);
+    EXPECT_EQ(stats().frames_dropped, 1u);
+
+    // Keep writing until the pty is full and a write is partial, leaving
+    // the ring mid-way, then top it up so frames wrap around its end
+    ASSERT_EQ(kiss_serial_flush(serial), 0);
+    int rounds = 0;
+    do {
+        for (int i = 0; i < 3; i++) {
+            ASSERT_EQ(kiss_serial_queue(serial, payload.data(), payload.size(), 1), 0);
+        }
+    } while (kiss_serial_flush(serial) == 0 && ++rounds < 10000);
+    ASSERT_GT(kiss_serial_pending(serial), 0u);
+    while (kiss_serial_queue(serial, payload.data(), payload.size(), 1) == 0) {
+    }
+
+    // Drain the master while the event loop writes the rest
+    kiss_tnc_t tnc;
+    kiss_init(&tnc);
+    std::vector<received_frame> decoded;
+    uint8_t buffer[64];
+    while (kiss_serial_pending(serial) > 0 || poll_master(100)) {
+        ASSERT_GE(kiss_serial_poll(serial, 0), 0);
+        ssize_t n = read(master, buffer, sizeof(buffer));
+        if (n > 0) {
+            kiss_process_buffer(&tnc, buffer, n);
+            kiss_receive_frames(&tnc, record_frame, &decoded, KISS_RX_SLOTS);
+        }
+    }
+    kiss_cleanup(&tnc);
+
+    EXPECT_EQ(decoded.size(), stats().frames_out);
+    for (const auto& frame : decoded) {
+        EXPECT_EQ(frame.data, payload);
+    }
+}
+
+TEST_F(TestKISSSerial, HangupIsReported)
+{
+    open_port();
+    close(master);
+    master = -1;
+
+    EXPECT_EQ(kiss_serial_poll(serial, 100), -1);
+}
+
+TEST_F(TestKISSSerial, RejectsInvalidArguments)
+{
+    EXPECT_EQ(kiss_serial_open(nullptr, &config), nullptr);
+    EXPECT_EQ(kiss_serial_attach(-1, &config), nullptr);
+
+    open_port();
+    std::vector<uint8_t> oversize(KISS_MAX_FRAME_LEN + 1, 0x41);
+    EXPECT_EQ(kiss_serial_queue(serial, oversize.data(), oversize.size(), 0), -1);
+    EXPECT_EQ(kiss_serial_queue(serial, nullptr, 10, 0), -1);
+}
@@ -0,0 +1,322 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/kiss_protocol.h>
+#include <gnuradio/m17_bridge/kiss_tcp_server.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct received_frame {
+    int client_id;
+    std::vector<uint8_t> data;
+    uint8_t port;
+    uint8_t command;
+};
+
+void record_frame(void* ctx, int client_id, const uint8_t* data, uint16_t length, uint8_t port,
+                  uint8_t command)
+{
+    auto* frames = static_cast<std::vector<received_frame>*>(ctx);
+    frames->push_back({ client_id, std::vector<uint8_t>(data, data + length), port, command });
+}
+
+} // namespace
+
+class TestKISSTcpServer : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        kiss_tcp_server_default_config(&config);
+        config.bind_address = "127.0.0.1";
+        config.port = 0; // Ephemeral port for the test
+        config.on_frame = record_frame;
+        config.ctx = &frames;
+    }
+
+    void TearDown() override
+    {
+        for (int fd : sockets) {
+            close(fd);
+        }
+        kiss_tcp_server_destroy(server);
+    }
+
+    void start()
+    {
+        server = kiss_tcp_server_create(&config);
+        ASSERT_NE(server, nullptr);
+        ASSERT_NE(kiss_tcp_server_port(server), 0);
+    }
+
+    int connect_client(int rcvbuf = 0)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (rcvbuf > 0) {
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        }
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kiss_tcp_server_port(server));
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        sockets.push_back(fd);
+        return fd;
+    }
+
+    // Run the event loop until the condition holds (or give up)
+    bool poll_until(const std::function<bool()>& done)
+    {
+        for (int i = 0; i < 200 && !done(); i++) {
+            kiss_tcp_server_poll(server, 10);
+        }
+        return done();
+    }
+
+    kiss_tcp_server_stats_t stats()
+    {
+        kiss_tcp_server_stats_t s;
+        kiss_tcp_server_get_stats(server, &s);
+        return s;
+    }
+
+    // Read and decode exactly one KISS frame from a client socket
+    static std::vector<uint8_t> read_frame(int fd)
+    {
+        kiss_tnc_t decoder;
+        kiss_init(&decoder);
+        uint8_t byte;
+        while (kiss_frame_ready(&decoder) == 0 && recv(fd, &byte, 1, 0) == 1) {
+            kiss_process_buffer(&decoder, &byte, 1);
+        }
+        std::vector<uint8_t> frame(KISS_MAX_FRAME_LEN);
+        uint16_t length = frame.size();
+        int result = kiss_receive_frame(&decoder, frame.data(), &length, NULL);
+        frame.resize(result > 0 ? length : 0);
+        kiss_cleanup(&decoder);
+        return frame;
+    }
+
+    kiss_tcp_server_config_t config;
+    kiss_tcp_server_t* server = nullptr;
+    std::vector<received_frame> frames;
+    std::vector<int> sockets;
+};
+
+TEST_F(TestKISSTcpServer, BroadcastReachesAllClients)
+{
+    start();
+    const int num_clients = 50;
+    std::vector<int> clients;
+    for (int i = 0; i < num_clients; i++) {
+        clients.push_back(connect_client());
+    }
+    ASSERT_TRUE(poll_until([&] { return stats().clients == (uint32_t)num_clients; }));
+
+    const std::vector<uint8_t> payload = { 0x82, 0xA0, KISS_FEND, KISS_FESC, 0x03, 0xF0 };
+    ASSERT_EQ(kiss_tcp_server_broadcast(server, payload.data(), payload.size(), 0), num_clients);
+
+    for (int fd : clients) {
+        ASSERT_EQ(read_frame(fd), payload);
+    }
+    ASSERT_EQ(stats().frames_out, (uint32_t)num_clients);
+}
+
+TEST_F(TestKISSTcpServer, ClientFramesAreDeliveredAndRelayed)
+{
+    config.relay_clients = true;
+    start();
+    int sender = connect_client();
+    int listener = connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 2; }));
+
+    // Two frames in one write, the second on port 1
+    const uint8_t wire[] = { KISS_FEND, 0x00, 'a', 'b', KISS_FEND, 0x10, 'c', KISS_FESC,
+                             KISS_TFEND, KISS_FEND };
+    ASSERT_EQ(send(sender, wire, sizeof(wire), 0), (ssize_t)sizeof(wire));
+    ASSERT_TRUE(poll_until([&] { return frames.size() == 2; }));
+
+    ASSERT_EQ(frames[0].data, std::vector<uint8_t>({ 'a', 'b' }));
+    ASSERT_EQ(frames[0].port, 0);
+    ASSERT_EQ(frames[1].data, std::vector<uint8_t>({ 'c', KISS_FEND }));
+    ASSERT_EQ(frames[1].port, 1);
+    ASSERT_EQ(frames[0].command, KISS_CMD_DATA);
+    ASSERT_EQ(frames[0].client_id, frames[1].client_id);
+
+    // Relayed to the other client only
+    ASSERT_EQ(read_frame(listener), std::vector<uint8_t>({ 'a', 'b' }));
+    ASSERT_EQ(read_frame(listener), std::vector<uint8_t>({ 'c', KISS_FEND }));
+    uint8_t byte;
+    ASSERT_EQ(recv(sender, &byte, 1, MSG_DONTWAIT), -1);
+
+    // Replies go to the sender alone
+    const uint8_t reply[] = { 'o', 'k' };
+    ASSERT_EQ(kiss_tcp_server_send(server, frames[0].client_id, reply, sizeof(reply), 0), 0);
+    ASSERT_EQ(read_frame(sender), std::vector<uint8_t>({ 'o', 'k' }));
+}
+
+TEST_F(TestKISSTcpServer, SlowClientIsBackPressured)
+{
+    config.max_queued_bytes = 4096;
+    start();
+    // The slow client never reads and has a small receive window
+    connect_client(1024);
+    int fast = connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 2; }));
+
+    std::vector<uint8_t> payload(1000, 0x55);
+    int fast_frames = 0;
+    for (int i = 0; i < 8000; i++) {
+        kiss_tcp_server_broadcast(server, payload.data(), payload.size(), 0);
+        kiss_tcp_server_poll(server, 0);
+
+        // The fast client keeps up
+        uint8_t buf[65536];
+        ssize_t n;
+        while ((n = recv(fast, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+            for (ssize_t j = 0; j < n; j++) {
+                fast_frames += (buf[j] == KISS_FEND);
+            }
+        }
+    }
+
+    // Frames were dropped for the slow client but it stays connected
+    ASSERT_GT(stats().frames_dropped, 0u);
+    ASSERT_EQ(stats().clients, 2u);
+    ASSERT_GT(fast_frames, 0);
+}
+
+TEST_F(TestKISSTcpServer, ClientLimitAndDisconnect)
+{
+    config.max_clients = 2;
+    start();
+    int a = connect_client();
+    connect_client();
+    connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().accepted + stats().rejected == 3; }));
+    ASSERT_EQ(stats().clients, 2u);
+    ASSERT_EQ(stats().rejected, 1u);
+
+    close(a);
+    sockets.erase(sockets.begin());
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 1; }));
+
+    // The freed slot is reused
+    connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 2; }));
+}
+
+TEST_F(TestKISSTcpServer, ShortFrameBurstIsFullyDelivered)
+{
+    config.relay_clients = true;
+    start();
+    int sender = connect_client();
+    int listener = connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 2; }));
+
+    // Far more parameter frames than the receive queue holds, in one
+    // write, then a data frame
+    const int num_params = KISS_RX_SLOTS * 8;
+    std::vector<uint8_t> wire;
+    for (int i = 0; i < num_params; i++) {
+        wire.insert(wire.end(), { KISS_FEND, KISS_CMD_TXDELAY, (uint8_t)i });
+    }
+    wire.insert(wire.end(), { KISS_FEND, KISS_CMD_DATA, 'x', KISS_FEND });
+    ASSERT_EQ(send(sender, wire.data(), wire.size(), 0), (ssize_t)wire.size());
+    ASSERT_TRUE(poll_until([&] { return frames.size() == num_params + 1u; }));
+
+    for (int i = 0; i < num_params; i++) {
+        ASSERT_EQ(frames[i].command, KISS_CMD_TXDELAY);
+        ASSERT_EQ(frames[i].data, std::vector<uint8_t>({ (uint8_t)i }));
+    }
+    ASSERT_EQ(frames[num_params].command, KISS_CMD_DATA);
+
+    // Only the data frame is relayed
+    ASSERT_EQ(read_frame(listener), std::vector<uint8_t>({ 'x' }));
+    uint8_t byte;
+    ASSERT_EQ(recv(listener, &byte, 1, MSG_DONTWAIT), -1);
+}
+
+TEST_F(TestKISSTcpServer, AcceptPausesWhileOutOfDescriptors)
+{
+    start();
+    int a = connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().clients == 1; }));
+    connect_client(); // Waits in the backlog
+
+    // dup() takes the lowest free descriptor, so capping the limit just
+    // above it leaves the server none to accept with
+    int top = dup(0);
+    ASSERT_GE(top, 0);
+    rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    rlimit limit = saved;
+    limit.rlim_cur = top + 1;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limit), 0);
+
+    ASSERT_TRUE(poll_until([&] { return stats().accept_pauses == 1; }));
+    // The listener no longer wakes the loop
+    ASSERT_EQ(kiss_tcp_server_poll(server, 20), 0);
+    ASSERT_EQ(stats().accepted, 1u);
+
+    // A client leaving frees a descriptor for the waiting connection
+    close(a);
+    sockets.erase(sockets.begin());
+    bool resumed = poll_until([&] { return stats().accepted == 2; });
+
+    setrlimit(RLIMIT_NOFILE, &saved);
+    close(top);
+    ASSERT_TRUE(resumed);
+    ASSERT_EQ(stats().clients, 1u);
+    ASSERT_EQ(stats().accept_pauses, 1u);
+}
+
+TEST_F(TestKISSTcpServer, AcceptResumesWithoutClients)
+{
+    start();
+    connect_client(); // Waits in the backlog
+
+    // Descriptors run out with no client connected, so no close can
+    // re-enable accepting
+    int top = dup(0);
+    ASSERT_GE(top, 0);
+    rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &saved), 0);
+    rlimit limit = saved;
+    limit.rlim_cur = top + 1;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limit), 0);
+
+    bool paused = poll_until([&] { return stats().accept_pauses == 1; });
+    EXPECT_EQ(stats().accepted, 0u);
+
+    // Descriptors freed elsewhere are picked up by a later poll
+    setrlimit(RLIMIT_NOFILE, &saved);
+    close(top);
+    ASSERT_TRUE(paused);
+    ASSERT_TRUE(poll_until([&] { return stats().accepted == 1; }));
+    ASSERT_EQ(stats().clients, 1u);
+    ASSERT_EQ(stats().accept_pauses, 1u);
+
+    // Accepting is back on the listener
+    connect_client();
+    ASSERT_TRUE(poll_until([&] { return stats().accepted == 2; }));
+}
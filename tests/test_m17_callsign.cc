@@ -0,0 +1,141 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_callsign.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+class TestM17Callsign : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Set up test fixtures
+    }
+
+    void TearDown() override
+    {
+        // Clean up test fixtures
+    }
+};
+
+TEST_F(TestM17Callsign, KnownAddress)
+{
+    // A=1, B=2, '1'=28, C=3, D=4 with the first character least significant
+    uint8_t addr[M17_ADDR_LEN];
+    ASSERT_EQ(m17_callsign_encode("AB1CD", addr), 0);
+
+    uint64_t value = 0;
+    for (int i = 0; i < M17_ADDR_LEN; i++) {
+        value = (value << 8) | addr[i];
+    }
+    ASSERT_EQ(value, 1ULL + 2ULL * 40 + 28ULL * 1600 + 3ULL * 64000 + 4ULL * 2560000);
+
+    char callsign[M17_CALLSIGN_BUF_LEN];
+    ASSERT_EQ(m17_callsign_decode(addr, callsign), 0);
+    ASSERT_STREQ(callsign, "AB1CD");
+}
+
+TEST_F(TestM17Callsign, SpecialAddresses)
+{
+    uint8_t addr[M17_ADDR_LEN];
+    char callsign[M17_CALLSIGN_BUF_LEN];
+
+    // Broadcast
+    ASSERT_EQ(m17_callsign_encode("@ALL", addr), 0);
+    for (int i = 0; i < M17_ADDR_LEN; i++) {
+        ASSERT_EQ(addr[i], 0xFF);
+    }
+    ASSERT_EQ(m17_callsign_decode(addr, callsign), 0);
+    ASSERT_STREQ(callsign, "@ALL");
+
+    // Zero and reserved values are rejected
+    ASSERT_NE(m17_callsign_from_value(0, callsign), 0);
+    ASSERT_NE(m17_callsign_from_value(M17_ADDR_MAX_BASE40 + 1, callsign), 0);
+    ASSERT_EQ(m17_callsign_from_value(M17_ADDR_MAX_BASE40, callsign), 0);
+    ASSERT_STREQ(callsign, ".........");
+
+    // Invalid input
+    ASSERT_NE(m17_callsign_encode("", addr), 0);
+    ASSERT_NE(m17_callsign_encode("TOOLONGCALL", addr), 0);
+    ASSERT_NE(m17_callsign_encode("N0CALL*", addr), 0);
+    ASSERT_NE(m17_callsign_encode("   ", addr), 0);
+
+    // Lower case is accepted and decoded as upper case
+    ASSERT_EQ(m17_callsign_encode("sp5wwp", addr), 0);
+    ASSERT_EQ(m17_callsign_decode(addr, callsign), 0);
+    ASSERT_STREQ(callsign, "SP5WWP");
+}
+
+TEST_F(TestM17Callsign, ExhaustiveRoundTrip)
+{
+    // Every address of up to four base-40 digits decodes and re-encodes to itself
+    char callsign[M17_CALLSIGN_BUF_LEN];
+    for (uint64_t value = 1; value < 40ULL * 40 * 40 * 40; value++) {
+        ASSERT_EQ(m17_callsign_from_value(value, callsign), 0) << value;
+        uint64_t encoded = 0;
+        ASSERT_EQ(m17_callsign_to_value(callsign, &encoded), 0) << callsign;
+        ASSERT_EQ(encoded, value) << callsign;
+    }
+
+    // Every character in every position of a full-length callsign
+    const char* charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-/.";
+    for (int pos = 0; pos < M17_CALLSIGN_MAX_LEN; pos++) {
+        for (const char* c = charset; *c; c++) {
+            char in[M17_CALLSIGN_BUF_LEN] = "N0CALL/M1";
+            in[pos] = *c;
+            uint8_t addr[M17_ADDR_LEN];
+            ASSERT_EQ(m17_callsign_encode(in, addr), 0) << in;
+            ASSERT_EQ(m17_callsign_decode(addr, callsign), 0) << in;
+            ASSERT_STREQ(callsign, in);
+        }
+    }
+}
+
+TEST_F(TestM17Callsign, BatchMatchesSingle)
+{
+    std::mt19937_64 rng(17);
+    const size_t count = 4096;
+
+    std::vector<std::string> names(count);
+    std::vector<const char*> ptrs(count);
+    const char* charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-/.";
+    for (size_t i = 0; i < count; i++) {
+        size_t len = 1 + rng() % M17_CALLSIGN_MAX_LEN;
+        for (size_t j = 0; j < len; j++) {
+            names[i].push_back(charset[rng() % 39]);
+        }
+        ptrs[i] = names[i].c_str();
+    }
+    ptrs[7] = "BAD*CALL";
+
+    std::vector<uint8_t> addrs(count * M17_ADDR_LEN);
+    auto* addr_rows = reinterpret_cast<uint8_t(*)[M17_ADDR_LEN]>(addrs.data());
+    ASSERT_EQ(m17_callsign_encode_batch(ptrs.data(), addr_rows, count), 1u);
+
+    std::vector<char> decoded(count * M17_CALLSIGN_BUF_LEN);
+    auto* name_rows = reinterpret_cast<char(*)[M17_CALLSIGN_BUF_LEN]>(decoded.data());
+    ASSERT_EQ(m17_callsign_decode_batch(addr_rows, name_rows, count), 1u);
+
+    for (size_t i = 0; i < count; i++) {
+        if (i == 7) {
+            ASSERT_STREQ(name_rows[i], "");
+            continue;
+        }
+        uint8_t single[M17_ADDR_LEN];
+        ASSERT_EQ(m17_callsign_encode(ptrs[i], single), 0);
+        ASSERT_EQ(memcmp(single, addr_rows[i], M17_ADDR_LEN), 0);
+        ASSERT_STREQ(name_rows[i], ptrs[i]);
+    }
+}
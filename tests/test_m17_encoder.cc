@@ -0,0 +1,173 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_encoder.h>
+#include <gnuradio/m17_bridge/m17_viterbi.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+uint32_t rng_state = 1;
+
+uint32_t next_random()
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+std::vector<uint8_t> random_bytes(size_t length)
+{
+    std::vector<uint8_t> data(length);
+    for (auto& byte : data) {
+        byte = next_random() & 0xFF;
+    }
+    return data;
+}
+
+// Randomiser bit i, straight from the sequence
+const uint8_t randomiser[46] = { 0xD6, 0xB5, 0xE2, 0x30, 0x82, 0xFF, 0x84, 0x62, 0xBA, 0x4E,
+                                 0x96, 0x90, 0xD8, 0x98, 0xDD, 0x5D, 0x0C, 0xC8, 0x52, 0x43,
+                                 0x91, 0x1D, 0xF8, 0x6E, 0x68, 0x2F, 0x35, 0xDA, 0x14, 0xEA,
+                                 0xCD, 0x76, 0x19, 0x8D, 0xD5, 0x80, 0xD1, 0x33, 0x87, 0x13,
+                                 0x57, 0x18, 0x2D, 0x29, 0x78, 0xC3 };
+
+// Bit-serial reference: sync word, then coded bits interleaved and
+// randomised one at a time
+std::vector<uint8_t> reference_frame(uint16_t sync, const std::vector<uint8_t>& bits)
+{
+    std::vector<uint8_t> dibits(M17_FRAME_SYMBOLS);
+    for (int i = 0; i < M17_SYNC_SYMBOLS; i++) {
+        dibits[i] = (sync >> (14 - 2 * i)) & 3;
+    }
+    for (int i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        uint8_t bit = bits[(45 * i + 92 * i * i) % M17_FRAME_CODED_BITS];
+        bit ^= (randomiser[i / 8] >> (7 - i % 8)) & 1;
+        dibits[M17_SYNC_SYMBOLS + i / 2] |= bit << (1 - i % 2);
+    }
+    return dibits;
+}
+
+std::vector<uint8_t> conv_encode(const std::vector<uint8_t>& data, uint16_t num_bits,
+                                 m17_puncture_t puncture)
+{
+    std::vector<uint8_t> coded(M17_FRAME_CODED_BITS);
+    int count = m17_conv_encode(data.data(), num_bits, puncture, coded.data(), coded.size());
+    coded.resize(count > 0 ? count : 0);
+    return coded;
+}
+
+// Received dibits as confident soft bits
+std::vector<uint8_t> to_soft(const uint8_t* dibits)
+{
+    std::vector<uint8_t> soft(M17_FRAME_CODED_BITS);
+    for (int i = 0; i < M17_FRAME_CODED_BITS; i++) {
+        soft[i] = ((dibits[M17_SYNC_SYMBOLS + i / 2] >> (1 - i % 2)) & 1) ? 224 : 32;
+    }
+    return soft;
+}
+
+} // namespace
+
+class TestM17Encoder : public ::testing::Test
+{
+protected:
+    void SetUp() override { rng_state = 1; }
+};
+
+TEST_F(TestM17Encoder, LsfMatchesBitSerialReference)
+{
+    for (int frame = 0; frame < 20; frame++) {
+        auto lsf = random_bytes(M17_LSF_PAYLOAD_BITS / 8);
+        uint8_t dibits[M17_FRAME_SYMBOLS];
+        ASSERT_EQ(m17_encode_lsf(lsf.data(), dibits), 0);
+
+        auto coded = conv_encode(lsf, M17_LSF_PAYLOAD_BITS, M17_PUNCTURE_LSF);
+        auto expected = reference_frame(M17_SYNC_LSF, coded);
+        EXPECT_EQ(std::vector<uint8_t>(dibits, dibits + M17_FRAME_SYMBOLS), expected);
+    }
+}
+
+TEST_F(TestM17Encoder, StreamCarriesLichAheadOfCodedBits)
+{
+    auto lich = random_bytes(M17_LICH_CODED_BYTES);
+    auto payload = random_bytes(M17_STREAM_PAYLOAD_BITS / 8);
+    uint8_t dibits[M17_FRAME_SYMBOLS];
+    ASSERT_EQ(m17_encode_stream(lich.data(), payload.data(), dibits), 0);
+
+    std::vector<uint8_t> bits;
+    for (int i = 0; i < M17_LICH_CODED_BYTES * 8; i++) {
+        bits.push_back((lich[i / 8] >> (7 - i % 8)) & 1);
+    }
+    auto coded = conv_encode(payload, M17_STREAM_PAYLOAD_BITS, M17_PUNCTURE_STREAM);
+    ASSERT_EQ(coded.size(), (size_t)M17_STREAM_CODED_BITS);
+    bits.insert(bits.end(), coded.begin(), coded.end());
+    EXPECT_EQ(std::vector<uint8_t>(dibits, dibits + M17_FRAME_SYMBOLS),
+              reference_frame(M17_SYNC_STREAM, bits));
+}
+
+TEST_F(TestM17Encoder, PacketRoundTripsThroughViterbi)
+{
+    for (int frame = 0; frame < 20; frame++) {
+        auto data = random_bytes(M17_PACKET_PAYLOAD_BITS / 8 + 1);
+        // Bits below the six metadata bits are not sent
+        uint8_t dibits[M17_FRAME_SYMBOLS];
+        ASSERT_EQ(m17_encode_packet(data.data(), dibits), 0);
+        data.back() &= 0xFC;
+
+        // Sync word 0x75FF
+        const uint8_t sync[M17_SYNC_SYMBOLS] = { 1, 3, 1, 1, 3, 3, 3, 3 };
+        EXPECT_EQ(memcmp(dibits, sync, sizeof(sync)), 0);
+
+        auto soft = to_soft(dibits);
+        std::vector<uint8_t> coded(M17_FRAME_CODED_BITS);
+        ASSERT_EQ(m17_deinterleave_soft(soft.data(), coded.data()), 0);
+        std::vector<uint8_t> decoded(data.size());
+        int32_t cost = m17_viterbi_decode(coded.data(), M17_PACKET_CODED_BITS,
+                                          M17_PUNCTURE_PACKET, decoded.data(),
+                                          M17_PACKET_PAYLOAD_BITS);
+        EXPECT_EQ(decoded, data);
+        EXPECT_GE(cost, 0);
+
+        // A run of hard errors spread by the interleaver
+        for (int i = 100; i < 110; i++) {
+            soft[i] = 255 - soft[i];
+        }
+        m17_deinterleave_soft(soft.data(), coded.data());
+        m17_viterbi_decode(coded.data(), M17_PACKET_CODED_BITS, M17_PUNCTURE_PACKET,
+                           decoded.data(), M17_PACKET_PAYLOAD_BITS);
+        EXPECT_EQ(decoded, data) << "frame " << frame;
+    }
+}
+
+TEST_F(TestM17Encoder, PreambleEotAndSymbols)
+{
+    uint8_t dibits[M17_FRAME_SYMBOLS];
+    float symbols[M17_FRAME_SYMBOLS];
+
+    m17_encode_preamble(dibits);
+    m17_dibits_to_symbols(dibits, M17_FRAME_SYMBOLS, symbols);
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i++) {
+        EXPECT_EQ(symbols[i], (i & 1) ? -3.0f : 3.0f);
+    }
+
+    // 0x555D: +3 +3 +3 +3 +3 +3 -3 +3, over and over
+    m17_encode_eot(dibits);
+    m17_dibits_to_symbols(dibits, M17_FRAME_SYMBOLS, symbols);
+    for (int i = 0; i < M17_FRAME_SYMBOLS; i++) {
+        EXPECT_EQ(symbols[i], (i % 8 == 6) ? -3.0f : 3.0f) << i;
+    }
+
+    EXPECT_EQ(m17_encode_lsf(nullptr, dibits), -1);
+    EXPECT_EQ(m17_encode_stream(dibits, nullptr, dibits), -1);
+    EXPECT_EQ(m17_deinterleave_soft(dibits, nullptr), -1);
+}
@@ -0,0 +1,243 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_ax25_bridge.h>
+#include <gnuradio/m17_bridge/m17_lich.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// LSF with real addresses, packet type and a valid CRC
+std::vector<uint8_t> make_lsf(const char* dst, const char* src, uint8_t meta)
+{
+    std::vector<uint8_t> lsf(M17_LICH_LSF_LEN, 0);
+    m17_callsign_encode(dst, &lsf[0]);
+    m17_callsign_encode(src, &lsf[M17_ADDR_LEN]);
+    lsf[13] = 0x02;
+    lsf[14] = meta;
+    uint16_t crc = m17_crc(lsf.data(), lsf.size() - 2);
+    lsf[28] = crc >> 8;
+    lsf[29] = crc & 0xFF;
+    return lsf;
+}
+
+std::vector<uint8_t> lich(const std::vector<uint8_t>& lsf, uint8_t counter)
+{
+    std::vector<uint8_t> coded(M17_LICH_CODED_BYTES);
+    EXPECT_EQ(m17_lich_encode(lsf.data(), counter, coded.data()), 0);
+    return coded;
+}
+
+// Flips bit n of each of the four codewords for every n in bits
+void flip(std::vector<uint8_t>& coded, std::initializer_list<int> bits)
+{
+    for (int word = 0; word < 4; word++) {
+        for (int bit : bits) {
+            int position = word * 24 + bit;
+            coded[position / 8] ^= 0x80 >> (position % 8);
+        }
+    }
+}
+
+} // namespace
+
+class TestM17Lich : public ::testing::Test
+{
+protected:
+    void SetUp() override { ASSERT_EQ(m17_lsf_cache_init(&cache, 1000), 0); }
+
+    m17_lsf_cache_t cache; //!< Cache under test
+    uint8_t lsf[M17_LICH_LSF_LEN];
+};
+
+TEST_F(TestM17Lich, GolayCorrectsThreeErrorsAndDetectsFour)
+{
+    for (uint32_t data = 0; data < 4096; data++) {
+        uint32_t codeword = m17_golay_encode(data);
+        EXPECT_EQ(codeword >> 12, data);
+
+        // Every codeword differs from zero in at least eight bits
+        if (data) {
+            EXPECT_GE(__builtin_popcount(codeword), 8);
+        }
+
+        uint16_t decoded = 0;
+        ASSERT_EQ(m17_golay_decode(codeword, &decoded), 0);
+        EXPECT_EQ(decoded, data);
+    }
+
+    uint32_t codeword = m17_golay_encode(0xA5C);
+    for (int a = 0; a < 24; a++) {
+        for (int b = a + 1; b < 24; b++) {
+            uint16_t decoded = 0;
+            int c = (b + 7) % 24;
+            uint32_t error = (1u << a) | (1u << b) | (c != a && c != b ? 1u << c : 0);
+            EXPECT_EQ(m17_golay_decode(codeword ^ error, &decoded), __builtin_popcount(error));
+            EXPECT_EQ(decoded, 0xA5C);
+
+            int d = (a + 11) % 24;
+            if (__builtin_popcount(error | (1u << d)) == 4) {
+                EXPECT_EQ(m17_golay_decode(codeword ^ error ^ (1u << d), &decoded), -1);
+            }
+        }
+    }
+    EXPECT_EQ(m17_golay_decode(codeword, nullptr), -1);
+}
+
+TEST_F(TestM17Lich, LichChunksRoundTrip)
+{
+    auto frame = make_lsf("@ALL", "N0CALL", 0x00);
+    for (uint8_t counter = 0; counter < M17_LICH_CHUNKS; counter++) {
+        auto coded = lich(frame, counter);
+        flip(coded, { 1, 9, 20 });
+
+        uint8_t chunk[M17_LICH_CHUNK_LEN];
+        EXPECT_EQ(m17_lich_decode(coded.data(), chunk), 12);
+        EXPECT_EQ(memcmp(chunk, &frame[counter * M17_LICH_LSF_BYTES], M17_LICH_LSF_BYTES), 0);
+        EXPECT_EQ(chunk[M17_LICH_LSF_BYTES], counter << M17_LICH_COUNTER_SHIFT);
+    }
+    EXPECT_EQ(m17_lich_encode(frame.data(), M17_LICH_CHUNKS, lsf), -1);
+}
+
+TEST_F(TestM17Lich, CacheAssemblesThenConfirms)
+{
+    auto frame = make_lsf("SP5WWP", "N0CALL", 0x11);
+
+    // Joining mid-superframe: counters 2..5, 0, 1
+    for (int i = 0; i < M17_LICH_CHUNKS; i++) {
+        int result = m17_lsf_cache_push(&cache, 7, lich(frame, (i + 2) % 6).data(), 40 * i, lsf);
+        EXPECT_EQ(result, i < 5 ? M17_LSF_CACHE_PENDING : M17_LSF_CACHE_COMPLETE);
+    }
+    EXPECT_EQ(std::vector<uint8_t>(lsf, lsf + M17_LICH_LSF_LEN), frame);
+
+    // Later superframes: the expected LICH, even with a few bit errors,
+    // confirms without decoding
+    for (int i = 0; i < 12; i++) {
+        auto coded = lich(frame, (i + 2) % 6);
+        coded[i] ^= 0x11;
+        memset(lsf, 0, sizeof(lsf));
+        EXPECT_EQ(m17_lsf_cache_push(&cache, 7, coded.data(), 240 + 40 * i, lsf),
+                  M17_LSF_CACHE_CONFIRMED);
+        EXPECT_EQ(std::vector<uint8_t>(lsf, lsf + M17_LICH_LSF_LEN), frame);
+    }
+
+    // More errors need the Golay decoder, and a skipped frame is only out
+    // of sequence
+    auto coded = lich(frame, 3);
+    flip(coded, { 0, 5 });
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 7, coded.data(), 800, lsf), M17_LSF_CACHE_CONFIRMED);
+
+    m17_lsf_cache_stats_t stats;
+    ASSERT_EQ(m17_lsf_cache_get_stats(&cache, &stats), 0);
+    EXPECT_EQ(stats.chunks, 19u);
+    EXPECT_EQ(stats.lsfs, 1u);
+    EXPECT_EQ(stats.confirmed, 13u);
+    EXPECT_EQ(stats.fast_matches, 12u);
+    EXPECT_EQ(stats.corrected_bits, 8u);
+}
+
+TEST_F(TestM17Lich, CacheFollowsChangesAndRejectsBadChunks)
+{
+    auto first = make_lsf("SP5WWP", "N0CALL", 0x00);
+    auto second = make_lsf("SP5WWP", "N0CALL", 0x42);
+    ASSERT_EQ(m17_lsf_cache_seed(&cache, 1, first.data(), 0), 0);
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 1, lich(first, 0).data(), 40, lsf),
+              M17_LSF_CACHE_CONFIRMED);
+
+    // A chunk of a different LSF starts over: the two differ in chunks 2
+    // (metadata) and 5 (CRC)
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 1, lich(second, 1).data(), 80, lsf),
+              M17_LSF_CACHE_CONFIRMED);
+    int result = 0;
+    for (int i = 0; i < M17_LICH_CHUNKS; i++) {
+        result = m17_lsf_cache_push(&cache, 1, lich(second, (i + 2) % 6).data(), 120 + 40 * i, lsf);
+    }
+    EXPECT_EQ(result, M17_LSF_CACHE_COMPLETE);
+    EXPECT_EQ(std::vector<uint8_t>(lsf, lsf + M17_LICH_LSF_LEN), second);
+
+    // Beyond repair, or a counter past 5
+    auto coded = lich(second, 0);
+    flip(coded, { 2, 3, 4, 6 });
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 2, coded.data(), 400, lsf), -1);
+    // Chunk 01 02 03 04 05 E0: counter 7
+    const uint16_t words[4] = { 0x010, 0x203, 0x040, 0x5E0 };
+    std::vector<uint8_t> bad(M17_LICH_CODED_BYTES);
+    for (int i = 0; i < 4; i++) {
+        uint32_t codeword = m17_golay_encode(words[i]);
+        bad[3 * i] = codeword >> 16;
+        bad[3 * i + 1] = codeword >> 8;
+        bad[3 * i + 2] = codeword;
+    }
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 2, bad.data(), 400, lsf), -1);
+
+    // Six chunks whose CRC fails keep collecting
+    auto broken = second;
+    broken[20] ^= 0x01;
+    for (int i = 0; i < M17_LICH_CHUNKS; i++) {
+        EXPECT_EQ(m17_lsf_cache_push(&cache, 3, lich(broken, i).data(), 400, lsf),
+                  M17_LSF_CACHE_PENDING);
+    }
+    EXPECT_EQ(m17_lsf_cache_seed(&cache, 3, broken.data(), 400), -1);
+
+    m17_lsf_cache_stats_t stats;
+    m17_lsf_cache_get_stats(&cache, &stats);
+    EXPECT_EQ(stats.changes, 1u);
+    EXPECT_EQ(stats.rejected, 2u);
+    EXPECT_EQ(stats.crc_errors, 1u);
+
+    // Streams gone quiet time out
+    EXPECT_EQ(m17_lsf_cache_push(&cache, 1, lich(second, 1).data(), 5000, lsf),
+              M17_LSF_CACHE_PENDING);
+    m17_lsf_cache_get_stats(&cache, &stats);
+    EXPECT_EQ(stats.timeouts, 3u);
+    EXPECT_EQ(m17_lsf_cache_end(&cache, 1), 0);
+    EXPECT_EQ(m17_lsf_cache_end(&cache, 1), -1);
+}
+
+TEST_F(TestM17Lich, BridgeRecoversLsfFromStreamFrames)
+{
+    m17_ax25_bridge_t bridge;
+    ASSERT_EQ(m17_ax25_bridge_init(&bridge), 0);
+    auto frame = make_lsf("SP5WWP", "N0CALL", 0x00);
+
+    std::vector<uint8_t> stream(M17_BRIDGE_STREAM_LEN, 0);
+    stream[0] = 0x5D;
+    stream[1] = 0x5F;
+    stream[2] = M17_FRAME_TYPE_STREAM;
+    for (int fn = 0; fn < 12; fn++) {
+        auto coded = lich(frame, fn % 6);
+        memcpy(&stream[M17_STREAM_LICH_OFFSET], coded.data(), coded.size());
+        stream[M17_STREAM_FN_OFFSET + 1] = fn;
+        EXPECT_EQ(m17_ax25_bridge_process_m17_stream(&bridge, stream.data(), stream.size()), 0);
+    }
+    m17_lsf_cache_stats_t stats;
+    m17_lsf_cache_get_stats(&bridge.lsf_cache, &stats);
+    EXPECT_EQ(stats.lsfs, 1u);
+    EXPECT_EQ(stats.fast_matches, 6u);
+    EXPECT_TRUE(bridge.state.m17_active);
+
+    // The last frame ends the stream; the next one starts from its LSF frame
+    stream[M17_STREAM_FN_OFFSET] = M17_STREAM_FN_EOS;
+    memcpy(&stream[M17_STREAM_LICH_OFFSET], lich(frame, 0).data(), M17_LICH_CODED_BYTES);
+    m17_ax25_bridge_process_m17_stream(&bridge, stream.data(), stream.size());
+    std::vector<uint8_t> lsf_frame = { 0x5D, 0x5F, M17_FRAME_TYPE_LSF };
+    lsf_frame.insert(lsf_frame.end(), frame.begin(), frame.end());
+    ASSERT_EQ(m17_ax25_bridge_process_m17_lsf(&bridge, lsf_frame.data(), lsf_frame.size()), 0);
+    stream[M17_STREAM_FN_OFFSET] = 0;
+    memcpy(&stream[M17_STREAM_LICH_OFFSET], lich(frame, 0).data(), M17_LICH_CODED_BYTES);
+    m17_ax25_bridge_process_m17_stream(&bridge, stream.data(), stream.size());
+    m17_lsf_cache_get_stats(&bridge.lsf_cache, &stats);
+    EXPECT_EQ(stats.lsfs, 1u);
+    EXPECT_EQ(stats.fast_matches, 8u);
+    m17_ax25_bridge_cleanup(&bridge);
+}
@@ -0,0 +1,398 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_ax25_bridge.h>
+#include <gnuradio/m17_bridge/m17_packet.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> make_data(size_t length, int seed)
+{
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < length; i++) {
+        data[i] = static_cast<uint8_t>(seed + i * 13);
+    }
+    return data;
+}
+
+std::vector<uint8_t> encode(uint8_t protocol, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> frames(M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN);
+    int count = m17_packet_encode(protocol, data.data(), data.size(), frames.data(), frames.size());
+    EXPECT_GT(count, 0);
+    frames.resize(count > 0 ? count * M17_PACKET_FRAME_LEN : 0);
+    return frames;
+}
+
+const uint8_t* frame_at(const std::vector<uint8_t>& frames, int index)
+{
+    return &frames[index * M17_PACKET_FRAME_LEN];
+}
+
+} // namespace
+
+class TestM17Packet : public ::testing::Test
+{
+protected:
+    void SetUp() override { ASSERT_EQ(m17_packet_reasm_init(&reasm, 2, 1000), 0); }
+
+    void TearDown() override { m17_packet_reasm_free(&reasm); }
+
+    m17_packet_reasm_t reasm; //!< Two-slot reassembler under test
+    m17_packet_t packet;      //!< Last packet completed
+};
+
+TEST_F(TestM17Packet, CrcMatchesSpecificationVectors)
+{
+    const uint8_t digits[] = "123456789";
+    std::vector<uint8_t> ramp(256);
+    for (int i = 0; i < 256; i++) {
+        ramp[i] = static_cast<uint8_t>(i);
+    }
+
+    EXPECT_EQ(m17_crc(digits, 0), 0xFFFF);
+    EXPECT_EQ(m17_crc(reinterpret_cast<const uint8_t*>("A"), 1), 0x206E);
+    EXPECT_EQ(m17_crc(digits, 9), 0x772B);
+    EXPECT_EQ(m17_crc(ramp.data(), ramp.size()), 0x1C31);
+}
+
+TEST_F(TestM17Packet, SegmentsIntoCountedFrames)
+{
+    // Protocol byte + 822 data bytes + CRC fill all 33 frames exactly
+    auto data = make_data(M17_PACKET_MAX_DATA, 1);
+    auto frames = encode(M17_PACKET_PROTO_RAW, data);
+    ASSERT_EQ(frames.size(), (size_t)M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN);
+    for (int i = 0; i < M17_PACKET_MAX_FRAMES - 1; i++) {
+        EXPECT_EQ(frame_at(frames, i)[M17_PACKET_CHUNK_LEN], i << 2);
+    }
+    EXPECT_EQ(frame_at(frames, M17_PACKET_MAX_FRAMES - 1)[M17_PACKET_CHUNK_LEN],
+              M17_PACKET_META_EOF | (25 << 2));
+
+    // A short packet is one padded frame whose metadata counts the bytes used
+    uint8_t text[] = { 'h', 'i' };
+    uint8_t frame[M17_PACKET_FRAME_LEN];
+    ASSERT_EQ(m17_packet_encode(M17_PACKET_PROTO_SMS, text, 2, frame, sizeof(frame)), 1);
+    EXPECT_EQ(frame[0], M17_PACKET_PROTO_SMS);
+    EXPECT_EQ(frame[1], 'h');
+    uint16_t crc = m17_crc(frame, 3);
+    EXPECT_EQ(frame[3], crc >> 8);
+    EXPECT_EQ(frame[4], crc & 0xFF);
+    EXPECT_EQ(frame[5], 0);
+    EXPECT_EQ(frame[M17_PACKET_CHUNK_LEN], M17_PACKET_META_EOF | (5 << 2));
+
+    EXPECT_EQ(m17_packet_frame_count(M17_PACKET_MAX_DATA + 1), 0);
+    std::vector<uint8_t> too_long(M17_PACKET_MAX_DATA + 1);
+    EXPECT_EQ(m17_packet_encode(0, too_long.data(), too_long.size(), frames.data(), frames.size()),
+              -1);
+    EXPECT_EQ(m17_packet_encode(0, text, 2, frame, sizeof(frame) - 1), -1);
+}
+
+TEST_F(TestM17Packet, ReassemblesEveryLength)
+{
+    for (size_t length = 0; length <= M17_PACKET_MAX_DATA; length++) {
+        auto data = make_data(length, (int)length);
+        auto frames = encode(M17_PACKET_PROTO_APRS, data);
+        int count = frames.size() / M17_PACKET_FRAME_LEN;
+        ASSERT_EQ(count, m17_packet_frame_count(length));
+
+        for (int i = 0; i < count - 1; i++) {
+            ASSERT_EQ(m17_packet_reasm_push(&reasm, 7, frame_at(frames, i), 0, &packet), 0);
+        }
+        ASSERT_EQ(m17_packet_reasm_push(&reasm, 7, frame_at(frames, count - 1), 0, &packet), 1);
+        ASSERT_EQ(packet.protocol, M17_PACKET_PROTO_APRS);
+        ASSERT_EQ(packet.length, length);
+        if (length > 0) {
+            // data.data() may be null for an empty vector
+            ASSERT_EQ(memcmp(packet.data, data.data(), length), 0);
+        }
+    }
+    EXPECT_EQ(m17_packet_reasm_active(&reasm), 0);
+}
+
+TEST_F(TestM17Packet, InterleavedSendersAndErrors)
+{
+    auto a = make_data(100, 1);
+    auto b = make_data(60, 2);
+    auto fa = encode(M17_PACKET_PROTO_RAW, a);
+    auto fb = encode(M17_PACKET_PROTO_RAW, b);
+    ASSERT_EQ(fa.size() / M17_PACKET_FRAME_LEN, 5u);
+    ASSERT_EQ(fb.size() / M17_PACKET_FRAME_LEN, 3u);
+
+    // Two senders interleaved frame by frame
+    int done = 0;
+    for (int i = 0; i < 5; i++) {
+        int result = m17_packet_reasm_push(&reasm, 1, frame_at(fa, i), 10 * i, &packet);
+        if (result == 1) {
+            EXPECT_EQ(packet.length, 100);
+            done++;
+        }
+        if (i < 3) {
+            result = m17_packet_reasm_push(&reasm, 2, frame_at(fb, i), 10 * i + 5, &packet);
+            if (result == 1) {
+                EXPECT_EQ(packet.length, 60);
+                done++;
+            }
+        }
+    }
+    EXPECT_EQ(done, 2);
+
+    // A lost frame: the rest of the packet is refused
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 1, frame_at(fa, 0), 100, &packet), 0);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 1, frame_at(fa, 2), 110, &packet), -1);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 1, frame_at(fa, 3), 120, &packet), -1);
+
+    // A corrupted chunk fails the CRC
+    auto bad = fb;
+    bad[M17_PACKET_FRAME_LEN + 3] ^= 0x10;
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(m17_packet_reasm_push(&reasm, 2, frame_at(bad, i), 200, &packet), 0);
+    }
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 2, frame_at(bad, 2), 200, &packet), -1);
+
+    m17_packet_stats_t stats;
+    ASSERT_EQ(m17_packet_reasm_get_stats(&reasm, &stats), 0);
+    EXPECT_EQ(stats.packets, 2u);
+    EXPECT_EQ(stats.sequence_errors, 2u);
+    EXPECT_EQ(stats.crc_errors, 1u);
+    EXPECT_EQ(m17_packet_reasm_active(&reasm), 0);
+}
+
+TEST_F(TestM17Packet, StalePacketsTimeOutOrYieldTheirSlot)
+{
+    auto data = make_data(100, 3);
+    auto frames = encode(M17_PACKET_PROTO_RAW, data);
+
+    // Two partial packets fill both slots; a third sender takes the older one
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 1, frame_at(frames, 0), 0, &packet), 0);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 2, frame_at(frames, 0), 10, &packet), 0);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 3, frame_at(frames, 0), 20, &packet), 0);
+    EXPECT_EQ(m17_packet_reasm_active(&reasm), 2);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 1, frame_at(frames, 1), 30, &packet), -1);
+
+    // Sender 3 finishes in time; sender 2 goes quiet and is timed out
+    for (int i = 1; i < 5; i++) {
+        EXPECT_EQ(m17_packet_reasm_push(&reasm, 3, frame_at(frames, i), 20 + 40 * i, &packet),
+                  i == 4 ? 1 : 0);
+    }
+    EXPECT_EQ(m17_packet_reasm_expire(&reasm, 1010), 0);
+    EXPECT_EQ(m17_packet_reasm_expire(&reasm, 1011), 1);
+    EXPECT_EQ(m17_packet_reasm_push(&reasm, 2, frame_at(frames, 1), 1020, &packet), -1);
+
+    m17_packet_stats_t stats;
+    m17_packet_reasm_get_stats(&reasm, &stats);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_EQ(stats.packets, 1u);
+}
+
+TEST_F(TestM17Packet, FullLengthAPRSFrameCrossesToAX25)
+{
+    // UI frame with the longest information field AX.25 allows
+    ax25_address_t src, dst;
+    ax25_set_address(&src, "N0CALL", 7, false);
+    ax25_set_address(&dst, "APRS", 0, true);
+    auto info = make_data(AX25_MAX_INFO, 4);
+    ax25_frame_t ui;
+    ASSERT_EQ(ax25_create_frame(&ui, &src, &dst, AX25_CTRL_UI, AX25_PID_NONE, info.data(),
+                                info.size()),
+              0);
+    std::vector<uint8_t> encoded(AX25_MAX_ADDRS * AX25_ADDR_LEN + 4 + AX25_MAX_INFO);
+    uint16_t encoded_len = encoded.size();
+    ASSERT_EQ(ax25_encode_frame(&ui, encoded.data(), &encoded_len), 0);
+    encoded.resize(encoded_len);
+
+    // Across M17 as an AX.25 packet, FCS left behind
+    std::vector<uint8_t> body(encoded.begin(), encoded.end() - 2);
+    auto frames = encode(M17_PACKET_PROTO_AX25, body);
+    int count = frames.size() / M17_PACKET_FRAME_LEN;
+    EXPECT_EQ(count, 11);
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        result = m17_packet_reasm_push(&reasm, 0, frame_at(frames, i), 40 * i, &packet);
+    }
+    ASSERT_EQ(result, 1);
+
+    // Rebuilt with flags and a fresh FCS, identical to the original
+    m17_ax25_bridge_t bridge;
+    ASSERT_EQ(m17_ax25_bridge_init(&bridge), 0);
+    uint8_t ax25[AX25_MAX_ADDRS * AX25_ADDR_LEN + 8 + AX25_MAX_INFO];
+    uint16_t ax25_len = sizeof(ax25);
+    ASSERT_EQ(m17_ax25_bridge_packet_to_ax25(&bridge, &packet, ax25, &ax25_len), 0);
+    ASSERT_EQ(ax25_len, encoded.size() + 2);
+    EXPECT_EQ(ax25[0], AX25_FLAG);
+    EXPECT_EQ(ax25[ax25_len - 1], AX25_FLAG);
+    EXPECT_EQ(memcmp(&ax25[1], encoded.data(), encoded.size()), 0);
+
+    // Single-frame packets of other protocols become UI frames from the bridge
+    uint8_t text[] = { 'h', 'e', 'l', 'l', 'o' };
+    uint8_t bridge_frame[M17_BRIDGE_PACKET_LEN] = { 0x5D, 0x5F, M17_FRAME_TYPE_PACKET };
+    ASSERT_EQ(m17_packet_encode(M17_PACKET_PROTO_RAW, text, sizeof(text),
+                                &bridge_frame[M17_PACKET_FRAME_OFFSET], M17_PACKET_FRAME_LEN),
+              1);
+    ax25_len = sizeof(ax25);
+    ASSERT_EQ(m17_ax25_bridge_convert_m17_to_ax25(&bridge, bridge_frame, sizeof(bridge_frame), ax25,
+                                                  &ax25_len),
+              0);
+    ax25_frame_view_t view;
+    ASSERT_EQ(ax25_frame_view_init(&view, &ax25[1], ax25_len - 2), 0);
+    EXPECT_TRUE(ax25_frame_view_check_fcs(&view));
+    EXPECT_EQ(ax25_frame_view_control(&view), AX25_CTRL_UI);
+    uint16_t info_len = 0;
+    const uint8_t* frame_info = ax25_frame_view_info(&view, &info_len);
+    ASSERT_EQ(info_len, sizeof(text));
+    EXPECT_EQ(memcmp(frame_info, text, sizeof(text)), 0);
+
+    // A corrupted packet frame is refused
+    bridge_frame[M17_PACKET_FRAME_OFFSET + 2] ^= 0x01;
+    ax25_len = sizeof(ax25);
+    EXPECT_EQ(m17_ax25_bridge_convert_m17_to_ax25(&bridge, bridge_frame, sizeof(bridge_frame), ax25,
+                                                  &ax25_len),
+              -1);
+    m17_ax25_bridge_cleanup(&bridge);
+}
+
+TEST_F(TestM17Packet, BatchesShortFramesIntoOnePacket)
+{
+    // Three APRS-sized frames inside a 250 ms window
+    m17_packet_batch_t batch;
+    ASSERT_EQ(m17_packet_batch_init(&batch, 200), 0);
+    std::vector<std::vector<uint8_t>> sent = { make_data(40, 1), make_data(75, 2),
+                                               make_data(30, 3) };
+    for (size_t i = 0; i < sent.size(); i++) {
+        ASSERT_EQ(m17_packet_batch_add(&batch, sent[i].data(), sent[i].size(), 100 + 50 * i), 0);
+        EXPECT_FALSE(m17_packet_batch_due(&batch, 250, 100 + 50 * i));
+    }
+    EXPECT_TRUE(m17_packet_batch_due(&batch, 250, 350));
+
+    // 40 + 75 + 30 bytes and three length prefixes
+    std::vector<uint8_t> frames(M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN);
+    int count = m17_packet_batch_flush(&batch, frames.data(), frames.size());
+    ASSERT_EQ(count, m17_packet_frame_count(151));
+    EXPECT_EQ(m17_packet_batch_flush(&batch, frames.data(), frames.size()), 0);
+    EXPECT_FALSE(m17_packet_batch_due(&batch, 250, 1000));
+
+    m17_packet_batch_stats_t stats;
+    ASSERT_EQ(m17_packet_batch_get_stats(&batch, &stats), 0);
+    EXPECT_EQ(stats.frames, 3u);
+    EXPECT_EQ(stats.packets, 1u);
+    EXPECT_EQ(stats.airtime_ms, m17_packet_airtime_ms(151));
+    EXPECT_EQ(stats.airtime_saved_ms, m17_packet_airtime_ms(40) + m17_packet_airtime_ms(75) +
+                                          m17_packet_airtime_ms(30) - m17_packet_airtime_ms(151));
+    EXPECT_EQ(m17_packet_airtime_ms(40), (3u + 2u) * M17_FRAME_MS);
+
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        result = m17_packet_reasm_push(&reasm, 0, frame_at(frames, i), 0, &packet);
+    }
+    ASSERT_EQ(result, 1);
+    ASSERT_EQ(packet.protocol, M17_PACKET_PROTO_AX25_BATCH);
+
+    uint16_t offset = 0;
+    const uint8_t* frame;
+    uint16_t length;
+    for (const auto& expected : sent) {
+        ASSERT_EQ(m17_packet_batch_next(&packet, &offset, &frame, &length), 1);
+        ASSERT_EQ(length, expected.size());
+        EXPECT_EQ(memcmp(frame, expected.data(), length), 0);
+    }
+    EXPECT_EQ(m17_packet_batch_next(&packet, &offset, &frame, &length), 0);
+
+    // A length running past the end is refused
+    packet.data[0] = 0x01;
+    offset = 0;
+    EXPECT_EQ(m17_packet_batch_next(&packet, &offset, &frame, &length), -1);
+}
+
+TEST_F(TestM17Packet, BatchRefusesOverflowAndSendsLoneFramesPlain)
+{
+    m17_packet_batch_t batch;
+    EXPECT_EQ(m17_packet_batch_init(&batch, M17_PACKET_MAX_DATA + 1), -1);
+    ASSERT_EQ(m17_packet_batch_init(&batch, 100), 0);
+
+    auto first = make_data(60, 1);
+    auto second = make_data(40, 2);
+    ASSERT_EQ(m17_packet_batch_add(&batch, first.data(), first.size(), 0), 0);
+    EXPECT_EQ(m17_packet_batch_add(&batch, second.data(), second.size(), 0), -1);
+
+    // One frame alone is an ordinary AX.25 packet, nothing saved
+    std::vector<uint8_t> frames(M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN);
+    int count = m17_packet_batch_flush(&batch, frames.data(), frames.size());
+    ASSERT_EQ(count, 3);
+    for (int i = 0; i < count; i++) {
+        m17_packet_reasm_push(&reasm, 0, frame_at(frames, i), 0, &packet);
+    }
+    EXPECT_EQ(packet.protocol, M17_PACKET_PROTO_AX25);
+    ASSERT_EQ(packet.length, first.size());
+    EXPECT_EQ(memcmp(packet.data, first.data(), first.size()), 0);
+
+    m17_packet_batch_stats_t stats;
+    m17_packet_batch_get_stats(&batch, &stats);
+    EXPECT_EQ(stats.airtime_saved_ms, 0u);
+
+    EXPECT_EQ(m17_packet_batch_add(&batch, second.data(), second.size(), 0), 0);
+    EXPECT_EQ(m17_packet_batch_set_max_length(&batch, 2), -1);
+}
+
+TEST_F(TestM17Packet, BridgeUnpacksBatchedFrames)
+{
+    ax25_address_t src, dst;
+    ax25_set_address(&src, "N0CALL", 7, false);
+    ax25_set_address(&dst, "APRS", 0, true);
+
+    m17_packet_batch_t batch;
+    ASSERT_EQ(m17_packet_batch_init(&batch, M17_PACKET_MAX_DATA), 0);
+    std::vector<std::vector<uint8_t>> encoded;
+    for (int i = 0; i < 4; i++) {
+        auto info = make_data(30 + 15 * i, i);
+        ax25_frame_t ui;
+        ASSERT_EQ(ax25_create_frame(&ui, &src, &dst, AX25_CTRL_UI, AX25_PID_NONE, info.data(),
+                                    info.size()),
+                  0);
+        std::vector<uint8_t> bytes(AX25_MAX_ADDRS * AX25_ADDR_LEN + 4 + AX25_MAX_INFO);
+        uint16_t bytes_len = bytes.size();
+        ASSERT_EQ(ax25_encode_frame(&ui, bytes.data(), &bytes_len), 0);
+        bytes.resize(bytes_len);
+        encoded.push_back(bytes);
+        ASSERT_EQ(m17_packet_batch_add(&batch, bytes.data(), bytes.size() - 2, 0), 0);
+    }
+
+    std::vector<uint8_t> frames(M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_LEN);
+    int count = m17_packet_batch_flush(&batch, frames.data(), frames.size());
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        result = m17_packet_reasm_push(&reasm, 0, frame_at(frames, i), 0, &packet);
+    }
+    ASSERT_EQ(result, 1);
+
+    // Each frame comes back flagged with its own FCS, back to back
+    m17_ax25_bridge_t bridge;
+    ASSERT_EQ(m17_ax25_bridge_init(&bridge), 0);
+    uint8_t ax25[M17_BRIDGE_PACKET_AX25_MAX];
+    uint16_t ax25_len = sizeof(ax25);
+    ASSERT_EQ(m17_ax25_bridge_packet_to_ax25(&bridge, &packet, ax25, &ax25_len), 0);
+    size_t pos = 0;
+    for (const auto& expected : encoded) {
+        ASSERT_LE(pos + expected.size() + 2, ax25_len);
+        EXPECT_EQ(ax25[pos], AX25_FLAG);
+        EXPECT_EQ(memcmp(&ax25[pos + 1], expected.data(), expected.size()), 0);
+        EXPECT_EQ(ax25[pos + expected.size() + 1], AX25_FLAG);
+        pos += expected.size() + 2;
+    }
+    EXPECT_EQ(pos, ax25_len);
+
+    // Too small a buffer for all of them fails rather than truncating
+    ax25_len = pos - 1;
+    EXPECT_EQ(m17_ax25_bridge_packet_to_ax25(&bridge, &packet, ax25, &ax25_len), -1);
+    m17_ax25_bridge_cleanup(&bridge);
+}
@@ -0,0 +1,203 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_encoder.h>
+#include <gnuradio/m17_bridge/m17_sync.h>
+#include <gnuradio/m17_bridge/m17_viterbi.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+uint32_t rng_state = 1;
+
+uint32_t next_random()
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+std::vector<uint8_t> random_bytes(size_t length)
+{
+    std::vector<uint8_t> data(length);
+    for (auto& byte : data) {
+        byte = next_random() & 0xFF;
+    }
+    return data;
+}
+
+void append_symbols(std::vector<float>& symbols, const uint8_t* dibits, size_t count)
+{
+    size_t start = symbols.size();
+    symbols.resize(start + count);
+    m17_dibits_to_symbols(dibits, count, &symbols[start]);
+}
+
+// Preamble, an LSF and three packet frames; syncs at 192, 384, 576, 768
+std::vector<float> transmission()
+{
+    std::vector<float> symbols;
+    uint8_t dibits[M17_FRAME_SYMBOLS];
+    m17_encode_preamble(dibits);
+    append_symbols(symbols, dibits, M17_FRAME_SYMBOLS);
+    auto lsf = random_bytes(M17_LSF_PAYLOAD_BITS / 8);
+    m17_encode_lsf(lsf.data(), dibits);
+    append_symbols(symbols, dibits, M17_FRAME_SYMBOLS);
+    for (int frame = 0; frame < 3; frame++) {
+        auto packet = random_bytes(26);
+        packet[25] &= 0xFC;
+        m17_encode_packet(packet.data(), dibits);
+        append_symbols(symbols, dibits, M17_FRAME_SYMBOLS);
+    }
+    return symbols;
+}
+
+// Runs the search over symbols in calls of the given sizes (the last
+// one repeating), giving peaks with offsets from the start of symbols
+std::vector<m17_sync_hit_t> search_in_calls(const std::vector<float>& symbols,
+                                            const std::vector<size_t>& calls,
+                                            float threshold = 0.9f)
+{
+    m17_sync_search_t search;
+    m17_sync_search_init(&search);
+
+    std::vector<m17_sync_hit_t> found;
+    size_t total = symbols.size() - M17_SYNC_SYMBOLS;
+    size_t done = 0;
+    for (size_t call = 0; done < total; call++) {
+        size_t count = std::min(calls[std::min(call, calls.size() - 1)], total - done);
+        std::vector<m17_sync_hit_t> hits(M17_SYNC_MAX_HITS(count));
+        int n = m17_sync_search(&search, &symbols[done], count, threshold, hits.data(),
+                                hits.size());
+        EXPECT_GE(n, 0);
+        for (int h = 0; h < n; h++) {
+            hits[h].offset += done;
+            found.push_back(hits[h]);
+        }
+        done += count;
+    }
+    return found;
+}
+
+void expect_transmission_syncs(const std::vector<m17_sync_hit_t>& found)
+{
+    ASSERT_EQ(found.size(), 4u);
+    for (size_t f = 0; f < found.size(); f++) {
+        EXPECT_EQ(found[f].offset, (f + 1) * M17_FRAME_SYMBOLS);
+        EXPECT_EQ(found[f].type, f == 0 ? M17_SYNC_TYPE_LSF : M17_SYNC_TYPE_PACKET);
+        EXPECT_NEAR(found[f].strength, 1.0f, 1e-5f);
+    }
+}
+
+} // namespace
+
+class TestM17Sync : public ::testing::Test
+{
+protected:
+    void SetUp() override { rng_state = 1; }
+};
+
+TEST_F(TestM17Sync, EachSyncWordInQuietInput)
+{
+    const uint16_t words[M17_SYNC_TYPES] = { M17_SYNC_LSF, M17_SYNC_STREAM, M17_SYNC_PACKET,
+                                             M17_SYNC_BERT };
+    for (int s = 0; s < M17_SYNC_TYPES; s++) {
+        // Half amplitude: correlation is normalised to the input level
+        std::vector<float> symbols(100, 0.0f);
+        uint8_t dibits[M17_SYNC_SYMBOLS];
+        for (int k = 0; k < M17_SYNC_SYMBOLS; k++) {
+            dibits[k] = (words[s] >> (14 - 2 * k)) & 3;
+        }
+        m17_dibits_to_symbols(dibits, M17_SYNC_SYMBOLS, &symbols[40]);
+        for (auto& symbol : symbols) {
+            symbol *= 0.5f;
+        }
+
+        auto found = search_in_calls(symbols, { symbols.size() });
+        ASSERT_EQ(found.size(), 1u) << "sync " << s;
+        EXPECT_EQ(found[0].offset, 40u);
+        EXPECT_EQ(found[0].type, (m17_sync_type_t)s);
+        EXPECT_NEAR(found[0].strength, 1.0f, 1e-5f);
+    }
+}
+
+TEST_F(TestM17Sync, FindsEveryFrameOfATransmission)
+{
+    // One call spans several correlation blocks
+    expect_transmission_syncs(search_in_calls(transmission(), { 2000 }));
+}
+
+TEST_F(TestM17Sync, SyncWordSplitAcrossCalls)
+{
+    auto symbols = transmission();
+
+    // The first call ends anywhere from just before the LSF sync word to
+    // just after it, so its windows straddle the two calls
+    for (size_t split = 180; split <= 210; split++) {
+        SCOPED_TRACE(split);
+        expect_transmission_syncs(search_in_calls(symbols, { split, 2000 }));
+    }
+
+    // Many short calls, as a scheduler might hand out
+    expect_transmission_syncs(search_in_calls(symbols, { 1 }));
+    expect_transmission_syncs(search_in_calls(symbols, { 7 }));
+    expect_transmission_syncs(search_in_calls(symbols, { 61 }));
+}
+
+TEST_F(TestM17Sync, ToleratesSymbolSlip)
+{
+    // The receiver's clock runs fast: two symbols of the LSF go missing,
+    // so the first packet sync comes early
+    auto symbols = transmission();
+    size_t slip = M17_SYNC_SLIP_SYMBOLS;
+    symbols.erase(symbols.begin() + 2 * M17_FRAME_SYMBOLS - slip,
+                  symbols.begin() + 2 * M17_FRAME_SYMBOLS);
+
+    auto found = search_in_calls(symbols, { 100 });
+    ASSERT_EQ(found.size(), 4u);
+    EXPECT_EQ(found[0].offset, (size_t)M17_FRAME_SYMBOLS);
+    for (size_t f = 1; f < found.size(); f++) {
+        EXPECT_EQ(found[f].offset, (f + 1) * M17_FRAME_SYMBOLS - slip);
+        EXPECT_EQ(found[f].type, M17_SYNC_TYPE_PACKET);
+    }
+}
+
+TEST_F(TestM17Sync, ThresholdAndArguments)
+{
+    std::vector<float> quiet(300, 0.0f);
+    EXPECT_TRUE(search_in_calls(quiet, { 300 }).empty());
+
+    // A sync word with one symbol flipped correlates at 6/8
+    std::vector<float> symbols(100, 0.0f);
+    uint8_t dibits[M17_SYNC_SYMBOLS];
+    for (int k = 0; k < M17_SYNC_SYMBOLS; k++) {
+        dibits[k] = (M17_SYNC_STREAM >> (14 - 2 * k)) & 3;
+    }
+    m17_dibits_to_symbols(dibits, M17_SYNC_SYMBOLS, &symbols[40]);
+    symbols[43] = -symbols[43];
+    EXPECT_TRUE(search_in_calls(symbols, { 100 }, 0.9f).empty());
+    auto found = search_in_calls(symbols, { 100 }, 0.7f);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].offset, 40u);
+    EXPECT_EQ(found[0].type, M17_SYNC_TYPE_STREAM);
+    EXPECT_NEAR(found[0].strength, 0.75f, 1e-5f);
+
+    m17_sync_search_t search;
+    m17_sync_search_init(&search);
+    m17_sync_hit_t hits[M17_SYNC_MAX_HITS(400)];
+    EXPECT_EQ(M17_SYNC_MAX_HITS(400), 3);
+    symbols.resize(400 + M17_SYNC_SYMBOLS);
+    EXPECT_EQ(m17_sync_search(&search, symbols.data(), 400, 0.9f, hits, 2), -1);
+    EXPECT_EQ(m17_sync_search(nullptr, symbols.data(), 400, 0.9f, hits, 3), -1);
+    EXPECT_EQ(m17_sync_search(&search, nullptr, 400, 0.9f, hits, 3), -1);
+    EXPECT_EQ(m17_sync_search(&search, symbols.data(), 400, 0.9f, nullptr, 3), -1);
+}
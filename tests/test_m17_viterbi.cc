@@ -0,0 +1,211 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/m17_viterbi.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct frame_type {
+    m17_puncture_t puncture;
+    uint16_t payload_bits;
+    uint16_t coded_bits;
+};
+
+const frame_type frame_types[] = {
+    { M17_PUNCTURE_LSF, M17_LSF_PAYLOAD_BITS, M17_LSF_CODED_BITS },
+    { M17_PUNCTURE_STREAM, M17_STREAM_PAYLOAD_BITS, M17_STREAM_CODED_BITS },
+    { M17_PUNCTURE_PACKET, M17_PACKET_PAYLOAD_BITS, M17_PACKET_CODED_BITS },
+};
+
+const m17_viterbi_impl_t impls[] = { M17_VITERBI_SCALAR, M17_VITERBI_SSE2, M17_VITERBI_AVX2 };
+
+uint32_t rng_state = 1;
+
+uint32_t next_random()
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+std::vector<uint8_t> random_payload(uint16_t num_bits)
+{
+    std::vector<uint8_t> data((num_bits + 7) / 8);
+    for (auto& byte : data) {
+        byte = next_random() & 0xFF;
+    }
+    if (num_bits % 8) {
+        data.back() &= 0xFF << (8 - num_bits % 8);
+    }
+    return data;
+}
+
+// Coded bits as soft values: confident, with noise of up to +/-noise,
+// and every flip_every-th bit inverted
+std::vector<uint8_t> to_soft(const std::vector<uint8_t>& coded, int noise, int flip_every)
+{
+    std::vector<uint8_t> soft(coded.size());
+    for (size_t i = 0; i < coded.size(); i++) {
+        bool bit = coded[i];
+        if (flip_every && (int)(i % flip_every) == flip_every / 2) {
+            bit = !bit;
+        }
+        int value = bit ? 224 : 32;
+        if (noise) {
+            value += (int)(next_random() % (2 * noise + 1)) - noise;
+        }
+        soft[i] = value < 0 ? 0 : value > 255 ? 255 : value;
+    }
+    return soft;
+}
+
+std::vector<uint8_t> encode(const frame_type& type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> coded(2 * (M17_CONV_MAX_BITS + M17_CONV_TAIL_BITS));
+    int count = m17_conv_encode(data.data(), type.payload_bits, type.puncture, coded.data(),
+                                coded.size());
+    EXPECT_EQ(count, type.coded_bits);
+    coded.resize(count > 0 ? count : 0);
+    return coded;
+}
+
+} // namespace
+
+class TestM17Viterbi : public ::testing::Test
+{
+protected:
+    void SetUp() override { rng_state = 1; }
+
+    void TearDown() override { m17_viterbi_set_impl(M17_VITERBI_AUTO); }
+};
+
+TEST_F(TestM17Viterbi, PunctureLengthsMatchFrameSizes)
+{
+    for (const auto& type : frame_types) {
+        EXPECT_EQ(m17_conv_coded_bits(type.puncture, type.payload_bits), type.coded_bits);
+    }
+    EXPECT_EQ(m17_conv_coded_bits(M17_PUNCTURE_NONE, 100), 208);
+    EXPECT_EQ(m17_conv_coded_bits(M17_PUNCTURE_LSF, 0), 0);
+    EXPECT_EQ(m17_conv_coded_bits(M17_PUNCTURE_LSF, M17_CONV_MAX_BITS + 1), 0);
+}
+
+TEST_F(TestM17Viterbi, EncoderImpulseResponse)
+{
+    // A single 1 followed by the tail: G1 = 1 + D^3 + D^4, G2 = 1 + D + D^2 + D^4
+    uint8_t data[1] = { 0x80 };
+    uint8_t coded[10];
+    ASSERT_EQ(m17_conv_encode(data, 1, M17_PUNCTURE_NONE, coded, sizeof(coded)), 10);
+    const uint8_t expected[10] = { 1, 1, 0, 1, 0, 1, 1, 0, 1, 1 };
+    EXPECT_EQ(memcmp(coded, expected, sizeof(expected)), 0);
+
+    EXPECT_EQ(m17_conv_encode(data, 1, M17_PUNCTURE_NONE, coded, 9), -1);
+}
+
+TEST_F(TestM17Viterbi, CleanFramesDecodeWithZeroCost)
+{
+    for (auto impl : impls) {
+        if (!m17_viterbi_impl_supported(impl)) {
+            continue;
+        }
+        ASSERT_EQ(m17_viterbi_set_impl(impl), 0);
+        EXPECT_EQ(m17_viterbi_get_impl(), impl);
+
+        for (const auto& type : frame_types) {
+            auto data = random_payload(type.payload_bits);
+            auto coded = encode(type, data);
+            std::vector<uint8_t> soft(coded.size());
+            for (size_t i = 0; i < coded.size(); i++) {
+                soft[i] = coded[i] ? 255 : 0;
+            }
+
+            std::vector<uint8_t> decoded(data.size());
+            EXPECT_EQ(m17_viterbi_decode(soft.data(), soft.size(), type.puncture, decoded.data(),
+                                         type.payload_bits),
+                      0);
+            EXPECT_EQ(decoded, data) << "impl " << impl << " puncture " << type.puncture;
+        }
+    }
+}
+
+TEST_F(TestM17Viterbi, CorrectsErrorsAndErasures)
+{
+    for (const auto& type : frame_types) {
+        for (int frame = 0; frame < 20; frame++) {
+            auto data = random_payload(type.payload_bits);
+            auto coded = encode(type, data);
+
+            // One hard error in 30 coded bits, all of them noisy
+            auto soft = to_soft(coded, 40, 30);
+            std::vector<uint8_t> decoded(data.size());
+            int32_t cost = m17_viterbi_decode(soft.data(), soft.size(), type.puncture,
+                                              decoded.data(), type.payload_bits);
+            EXPECT_GT(cost, 0);
+            EXPECT_EQ(decoded, data) << "puncture " << type.puncture << " frame " << frame;
+
+            // Every tenth bit erased instead
+            soft = to_soft(coded, 0, 0);
+            for (size_t i = 5; i < soft.size(); i += 10) {
+                soft[i] = M17_SOFT_ERASURE;
+            }
+            m17_viterbi_decode(soft.data(), soft.size(), type.puncture, decoded.data(),
+                               type.payload_bits);
+            EXPECT_EQ(decoded, data);
+        }
+    }
+}
+
+TEST_F(TestM17Viterbi, ImplementationsAgreeOnNoisyFrames)
+{
+    for (const auto& type : frame_types) {
+        for (int frame = 0; frame < 50; frame++) {
+            // Heavy noise: decoding fails often, but identically
+            auto coded = encode(type, random_payload(type.payload_bits));
+            auto soft = to_soft(coded, 200, 7);
+
+            std::vector<uint8_t> reference;
+            int32_t reference_cost = 0;
+            for (auto impl : impls) {
+                if (!m17_viterbi_impl_supported(impl)) {
+                    continue;
+                }
+                ASSERT_EQ(m17_viterbi_set_impl(impl), 0);
+                std::vector<uint8_t> decoded((type.payload_bits + 7) / 8);
+                int32_t cost = m17_viterbi_decode(soft.data(), soft.size(), type.puncture,
+                                                  decoded.data(), type.payload_bits);
+                if (impl == M17_VITERBI_SCALAR) {
+                    reference = decoded;
+                    reference_cost = cost;
+                    continue;
+                }
+                EXPECT_EQ(decoded, reference) << "impl " << impl;
+                EXPECT_EQ(cost, reference_cost) << "impl " << impl;
+            }
+        }
+    }
+}
+
+TEST_F(TestM17Viterbi, RejectsWrongLengths)
+{
+    uint8_t soft[M17_LSF_CODED_BITS] = { 0 };
+    uint8_t data[M17_LSF_PAYLOAD_BITS / 8];
+    EXPECT_EQ(m17_viterbi_decode(soft, M17_LSF_CODED_BITS - 1, M17_PUNCTURE_LSF, data,
+                                 M17_LSF_PAYLOAD_BITS),
+              -1);
+    EXPECT_EQ(m17_viterbi_decode(soft, M17_LSF_CODED_BITS, M17_PUNCTURE_STREAM, data,
+                                 M17_LSF_PAYLOAD_BITS),
+              -1);
+    EXPECT_EQ(m17_viterbi_decode(nullptr, M17_LSF_CODED_BITS, M17_PUNCTURE_LSF, data,
+                                 M17_LSF_PAYLOAD_BITS),
+              -1);
+    EXPECT_EQ(m17_viterbi_set_impl((m17_viterbi_impl_t)42), -1);
+}
@@ -9,8 +9,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/ax25_protocol.h>
+#include <gnuradio/m17_bridge/m17_ax25_bridge.h>
+#include <gnuradio/m17_bridge/m17_packet.h>
 #include <gnuradio/m17_bridge/protocol_converter.h>
 
+#include <string>
+#include <vector>
+
 class TestProtocolConverter : public ::testing::Test
 {
 protected:
@@ -75,3 +81,61 @@ TEST_F(TestProtocolConverter, FeatureSetting)
     // These should not throw exceptions
     SUCCEED();
 }
+
+TEST_F(TestProtocolConverter, M17ToAX25UsesCurrentRoute)
+{
+    auto block = gr::m17_bridge::protocol_converter::make(
+        "N0CALL", "APRS", "N0CALL", "APRS", false, false);
+    block->set_conversion_mode(gr::m17_bridge::protocol_converter::CONVERSION_M17_TO_AX25);
+
+    // One raw-data M17 packet frame carrying the payload
+    std::vector<uint8_t> payload;
+    for (int i = 2; i < 22; i++) {
+        payload.push_back(i);
+    }
+    uint8_t packet[M17_PACKET_FRAME_LEN];
+    ASSERT_EQ(m17_packet_encode(M17_PACKET_PROTO_RAW, payload.data(), payload.size(), packet,
+                                sizeof(packet)),
+              1);
+    std::vector<uint8_t> m17_in = { 0x5D, 0x5F, M17_FRAME_TYPE_PACKET };
+    m17_in.insert(m17_in.end(), packet, packet + sizeof(packet));
+    m17_in.resize(64, 0x00);
+    std::vector<uint8_t> ax25_in(64, 0x00);
+    std::vector<uint8_t> m17_out(64), ax25_out(64);
+
+    // Expected frame: flag, addresses, UI control, PID, payload, FCS over
+    // the addresses through the payload, flag
+    auto expected = [&](const char* dst, const char* src) {
+        std::vector<uint8_t> frame;
+        std::string d(dst), s(src);
+        d.resize(6, '\0');
+        s.resize(6, '\0');
+        for (char c : d) frame.push_back(c << 1);
+        frame.push_back(0xE0); // Command bit, reserved bits, SSID 0
+        for (char c : s) frame.push_back(c << 1);
+        frame.push_back(0x61); // Reserved bits, SSID 0, last address
+        frame.push_back(0x03);
+        frame.push_back(0xF0);
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        uint16_t fcs = ax25_calculate_fcs(frame.data(), frame.size());
+        frame.insert(frame.begin(), 0x7E);
+        frame.push_back(fcs & 0xFF);
+        frame.push_back(fcs >> 8);
+        frame.push_back(0x7E);
+        return frame;
+    };
+
+    auto run = [&]() {
+        gr_vector_const_void_star in = { m17_in.data(), ax25_in.data() };
+        gr_vector_void_star out = { m17_out.data(), ax25_out.data() };
+        int produced = block->work(64, in, out);
+        return std::vector<uint8_t>(ax25_out.begin(), ax25_out.begin() + produced);
+    };
+
+    ASSERT_EQ(run(), expected("APRS", "N0CALL"));
+
+    // Setters invalidate the cached route header
+    block->set_ax25_destination("CQ");
+    block->set_ax25_callsign("W1AW");
+    ASSERT_EQ(run(), expected("CQ", "W1AW"));
+}
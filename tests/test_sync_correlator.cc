@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/sync_correlator.h>
+
+#include <stdexcept>
+
+class TestSyncCorrelator : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Set up test fixtures
+    }
+    
+    void TearDown() override
+    {
+        // Clean up test fixtures
+    }
+};
+
+TEST_F(TestSyncCorrelator, Construction)
+{
+    auto correlator = gr::m17_bridge::sync_correlator::make(0.8f);
+    ASSERT_NE(correlator, nullptr);
+    EXPECT_FLOAT_EQ(correlator->threshold(), 0.8f);
+    EXPECT_EQ(correlator->syncs_found(), 0u);
+
+    // Eight symbols of window and one to see past the last output
+    EXPECT_EQ(correlator->history(), 9u);
+
+    correlator->set_threshold(0.95f);
+    EXPECT_FLOAT_EQ(correlator->threshold(), 0.95f);
+}
+
+TEST_F(TestSyncCorrelator, ThresholdRange)
+{
+    using gr::m17_bridge::sync_correlator;
+
+    EXPECT_THROW(sync_correlator::make(0.0f), std::invalid_argument);
+    EXPECT_THROW(sync_correlator::make(1.5f), std::invalid_argument);
+
+    auto correlator = sync_correlator::make();
+    EXPECT_THROW(correlator->set_threshold(-0.5f), std::invalid_argument);
+    EXPECT_FLOAT_EQ(correlator->threshold(), 0.9f);
+}
@@ -0,0 +1,116 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/timer_wheel.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+struct probe {
+    timer_wheel_timer_t timer;   //!< Embedded timer
+    timer_wheel_t* wheel;        //!< Wheel the timer runs on
+    uint64_t due_ms;             //!< Expected expiry time
+    uint64_t fired_ms = 0;       //!< Wheel time at the callback
+    int fired = 0;               //!< Callback count
+    uint32_t period_ms = 0;      //!< Re-arm interval (0 = one-shot)
+};
+
+void on_expire(void* ctx, timer_wheel_timer_t*)
+{
+    auto* p = static_cast<probe*>(ctx);
+    p->fired++;
+    p->fired_ms = timer_wheel_now(p->wheel);
+    if (p->period_ms) {
+        timer_wheel_arm(p->wheel, &p->timer, p->period_ms);
+    }
+}
+
+} // namespace
+
+TEST(TestTimerWheel, FiresOnTimeAcrossAllLevels)
+{
+    timer_wheel_t wheel;
+    ASSERT_EQ(timer_wheel_init(&wheel, 1, 5000), 0);
+
+    // Delays on every level, including past the top wheel's range
+    std::mt19937 rng(42);
+    const int count = 20000;
+    std::vector<probe> probes(count);
+    for (int i = 0; i < count; i++) {
+        uint32_t delay = 1 + rng() % (1u << (4 + (i % 21)));
+        probes[i].wheel = &wheel;
+        probes[i].due_ms = 5000 + delay;
+        timer_wheel_timer_init(&probes[i].timer, on_expire, &probes[i]);
+        ASSERT_EQ(timer_wheel_arm(&wheel, &probes[i].timer, delay), 0);
+    }
+
+    // Advance in uneven steps; every timer fires once, at its own tick
+    uint64_t now = 5000;
+    const uint64_t end = 5000 + (1u << 24) + 2;
+    while (now < end) {
+        now += 1 + rng() % 5000;
+        timer_wheel_advance(&wheel, now);
+    }
+    for (const auto& p : probes) {
+        ASSERT_EQ(p.fired, 1);
+        EXPECT_EQ(p.fired_ms, p.due_ms);
+    }
+    EXPECT_EQ(wheel.armed, 0u);
+
+    timer_wheel_stats_t stats;
+    ASSERT_EQ(timer_wheel_get_stats(&wheel, &stats), 0);
+    EXPECT_EQ(stats.expired, (uint64_t)count);
+    EXPECT_LE(stats.cascaded, (uint64_t)count * (TIMER_WHEEL_LEVELS - 1) + count / 2);
+}
+
+TEST(TestTimerWheel, CancelAndRearm)
+{
+    timer_wheel_t wheel;
+    ASSERT_EQ(timer_wheel_init(&wheel, 10, 0), 0);
+
+    probe once, cancelled, periodic, moved;
+    for (probe* p : { &once, &cancelled, &periodic, &moved }) {
+        p->wheel = &wheel;
+        timer_wheel_timer_init(&p->timer, on_expire, p);
+    }
+    periodic.period_ms = 100;
+
+    timer_wheel_arm(&wheel, &once.timer, 25); // Rounded up to 30 ms
+    timer_wheel_arm(&wheel, &cancelled.timer, 50);
+    timer_wheel_arm(&wheel, &periodic.timer, 100);
+    timer_wheel_arm(&wheel, &moved.timer, 5000);
+    EXPECT_TRUE(timer_wheel_armed(&cancelled.timer));
+    timer_wheel_cancel(&wheel, &cancelled.timer);
+    EXPECT_FALSE(timer_wheel_armed(&cancelled.timer));
+    timer_wheel_arm(&wheel, &moved.timer, 200); // Re-arming moves the timer
+
+    EXPECT_EQ(timer_wheel_advance(&wheel, 29), 0);
+    EXPECT_EQ(timer_wheel_advance(&wheel, 30), 1);
+    EXPECT_EQ(once.fired_ms, 30u);
+
+    timer_wheel_advance(&wheel, 1000);
+    EXPECT_EQ(once.fired, 1);
+    EXPECT_EQ(cancelled.fired, 0);
+    EXPECT_EQ(moved.fired, 1);
+    EXPECT_EQ(moved.fired_ms, 200u);
+    EXPECT_EQ(periodic.fired, 10);
+    EXPECT_EQ(periodic.fired_ms, 1000u);
+    EXPECT_EQ(wheel.armed, 1u);
+
+    timer_wheel_cancel(&wheel, &periodic.timer);
+    EXPECT_EQ(wheel.armed, 0u);
+
+    // With nothing armed, time jumps ahead without stepping through ticks
+    EXPECT_EQ(timer_wheel_advance(&wheel, 86400000), 0);
+    EXPECT_EQ(timer_wheel_now(&wheel), 86400000u);
+}
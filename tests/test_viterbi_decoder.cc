@@ -0,0 +1,52 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2024 M17 Bridge Project
+ *
+ * This file is part of GNU Radio
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gnuradio/m17_bridge/viterbi_decoder.h>
+
+#include <stdexcept>
+
+class TestViterbiDecoder : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Set up test fixtures
+    }
+    
+    void TearDown() override
+    {
+        // Clean up test fixtures
+    }
+};
+
+TEST_F(TestViterbiDecoder, FrameSizes)
+{
+    using gr::m17_bridge::viterbi_decoder;
+
+    auto lsf = viterbi_decoder::make(viterbi_decoder::FRAME_LSF);
+    ASSERT_NE(lsf, nullptr);
+    EXPECT_EQ(lsf->coded_bits(), 368);
+    EXPECT_EQ(lsf->payload_bytes(), 30);
+
+    auto stream = viterbi_decoder::make(viterbi_decoder::FRAME_STREAM);
+    EXPECT_EQ(stream->coded_bits(), 272);
+    EXPECT_EQ(stream->payload_bytes(), 18);
+
+    auto packet = viterbi_decoder::make(viterbi_decoder::FRAME_PACKET);
+    EXPECT_EQ(packet->coded_bits(), 368);
+    EXPECT_EQ(packet->payload_bytes(), 26);
+    EXPECT_EQ(packet->last_cost(), 0);
+}
+
+TEST_F(TestViterbiDecoder, UnknownFrameType)
+{
+    EXPECT_THROW(gr::m17_bridge::viterbi_decoder::make(3), std::invalid_argument);
+}